@@ -309,6 +309,12 @@ class ArrayMetadata {
    */
   bool check_attribute_dimension_names() const;
 
+  /**
+   * Returns false if some attribute has an unknown filter, or filters
+   * without a compressor, and true otherwise.
+   */
+  bool check_attribute_filters() const;
+
   /**
    * Returns false if double delta compression is used with real attributes
    * or coordinates and true otherwise.
@@ -34,10 +34,12 @@
 #define TILEDB_ATTRIBUTE_H
 
 #include <string>
+#include <vector>
 
 #include "buffer.h"
 #include "compressor.h"
 #include "datatype.h"
+#include "filter.h"
 #include "status.h"
 
 namespace tiledb {
@@ -74,6 +76,12 @@ class Attribute {
   /*                 API               */
   /* ********************************* */
 
+  /**
+   * Appends a filter to the filter pipeline, which is run on the attribute
+   * tiles before the compressor.
+   */
+  void add_filter(Filter filter);
+
   /**
    * Returns the size in bytes of one cell for this attribute. If the attribute
    * is variable-sized, this function returns the size in bytes of an offset.
@@ -100,6 +108,9 @@ class Attribute {
   /** Dumps the attribute contents in ASCII form in the selected output. */
   void dump(FILE* out) const;
 
+  /** Returns the filter pipeline, in the order the filters are run. */
+  const std::vector<Filter>& filters() const;
+
   /** Returns the attribute name. */
   const std::string& name() const;
 
@@ -143,6 +154,9 @@ class Attribute {
   /** The attribute compression level. */
   int compression_level_;
 
+  /** The filters run on the attribute tiles before the compressor. */
+  std::vector<Filter> filters_;
+
   /** The attribute name. */
   std::string name_;
 
@@ -179,7 +179,8 @@ class Domain {
   /**
    * Checks the cell order of the input coordinates. Note that, in the presence
    * of a regular tile grid, this function assumes that the cells are in the
-   * same regular tile.
+   * same regular tile. In the Hilbert cell order, the cells with the same
+   * Hilbert key (see *hilbert_key*) are in row-major order.
    *
    * @tparam T The coordinates type.
    * @param coords_a The first input coordinates.
@@ -349,6 +350,19 @@ class Domain {
   template <class T>
   void get_tile_subarray(const T* tile_coords, T* tile_subarray) const;
 
+  /**
+   * Returns the Hilbert key of the input coordinates, i.e., their position
+   * along a Hilbert curve that fills the domain. Each dimension is mapped
+   * linearly onto a grid of *2^bits* positions, where *bits* is
+   * *64 / dim_num* (up to 32), so distinct coordinates may share a key.
+   *
+   * @tparam T The coordinates type.
+   * @param coords The coordinates.
+   * @return The Hilbert key.
+   */
+  template <class T>
+  uint64_t hilbert_key(const T* coords) const;
+
   /**
    * Initializes the domain.
    *
@@ -701,6 +715,21 @@ class Domain {
   template <class T>
   void get_next_tile_coords_col(const T* domain, T* tile_coords) const;
 
+  /**
+   * Retrieves the next tile coordinates along the array tile order within a
+   * given tile domain. Applicable only to **dense** arrays, and focusing on
+   * the **Morton** tile order. If there are no more tiles, the first
+   * coordinate is set past the end of the tile domain.
+   *
+   * @tparam T The coordinates type.
+   * @param domain The targeted domain.
+   * @param tile_coords The input tile coordinates, which the function modifies
+   *     to store the next tile coordinates at termination.
+   * @return void
+   */
+  template <class T>
+  void get_next_tile_coords_morton(const T* domain, T* tile_coords) const;
+
   /**
    * Retrieves the next tile coordinates along the array tile order within a
    * given tile domain. Applicable only to **dense** arrays, and focusing on
@@ -774,6 +803,36 @@ class Domain {
   template <class T>
   uint64_t get_tile_pos_col(const T* domain, const T* tile_coords) const;
 
+  /**
+   * Returns the tile position along the array tile order within the input
+   * domain. Applicable only to **dense** arrays, and focusing on the
+   * **Morton** tile order.
+   *
+   * @tparam T The domain type.
+   * @param tile_coords The tile coordinates.
+   * @return The tile position of *tile_coords* along the tile order of the
+   *     array inside the array domain.
+   */
+  template <class T>
+  uint64_t get_tile_pos_morton(const T* tile_coords) const;
+
+  /**
+   * Returns the tile position along the array tile order within the input
+   * domain. Applicable only to **dense** arrays, and focusing on the
+   * **Morton** tile order. The Morton order is that of the tile coordinates
+   * in the array domain, so that all the sub-domains agree on it.
+   *
+   * @tparam T The domain type.
+   * @param domain The input domain, which is a cell domain partitioned into
+   *     regular tiles in the same manner as that of the array domain
+   *     (however *domain* may be a sub-domain of the array domain).
+   * @param tile_coords The tile coordinates, relative to *domain*.
+   * @return The tile position of *tile_coords* along the tile order of the
+   *     array inside the input domain.
+   */
+  template <class T>
+  uint64_t get_tile_pos_morton(const T* domain, const T* tile_coords) const;
+
   /**
    * Returns the tile position along the array tile order within the input
    * domain. Applicable only to **dense** arrays, and focusing on the
@@ -803,6 +862,39 @@ class Domain {
   template <class T>
   uint64_t get_tile_pos_row(const T* domain, const T* tile_coords) const;
 
+  /**
+   * Computes the tile coordinates that follow the input ones in Morton
+   * order within a tile domain. The Morton order interleaves the bits of the
+   * coordinates, starting from the most significant bit of the first
+   * dimension.
+   *
+   * @tparam N The number of dimensions, or 0 if it is given at runtime.
+   * @param dim_num The number of dimensions.
+   * @param domain The tile domain, with one [low, high] pair per dimension.
+   * @param tile_coords The tile coordinates, which must lie in *domain*,
+   *     replaced by the next ones.
+   * @return *false* if there are no more tiles in the domain.
+   */
+  template <unsigned int N>
+  static bool morton_next(
+      unsigned int dim_num, const uint64_t* domain, uint64_t* tile_coords);
+
+  /**
+   * Computes the number of tiles of a tile domain that precede the input
+   * tile coordinates in Morton order.
+   *
+   * @tparam N The number of dimensions, or 0 if it is given at runtime.
+   * @param dim_num The number of dimensions.
+   * @param domain The tile domain, with one [low, high] pair per dimension.
+   * @param tile_coords The tile coordinates.
+   * @return The number of preceding tiles.
+   */
+  template <unsigned int N>
+  static uint64_t morton_rank(
+      unsigned int dim_num,
+      const uint64_t* domain,
+      const uint64_t* tile_coords);
+
   /** Return the number of cells in a column tile slab of an input subarray. */
   template <class T>
   uint64_t tile_slab_col_cell_num(const T* subarray) const;
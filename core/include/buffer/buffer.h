@@ -52,7 +52,9 @@ class Buffer {
   Buffer();
 
   /**
-   * Constructor. Initializes a buffer with the input data and size.
+   * Constructor. Initializes a buffer with the input data and size. The
+   * data size is also the allocated size, therefore the buffer can be written
+   * up to it (e.g., after resetting its size).
    *
    * @param data The internal data of the buffer.
    * @param size The size of the data.
@@ -135,6 +135,13 @@ typedef enum {
 #undef TILEDB_COMPRESSOR_ENUM
 } tiledb_compressor_t;
 
+/** Filter type, applied to the tiles before compression. */
+typedef enum {
+#define TILEDB_FILTER_ENUM(id) TILEDB_##id
+#include "tiledb_enum.inc"
+#undef TILEDB_FILTER_ENUM
+} tiledb_filter_t;
+
 /** Walk traversal order. */
 typedef enum {
 #define TILEDB_WALK_ORDER_ENUM(id) TILEDB_##id
@@ -162,6 +169,9 @@ TILEDB_EXPORT void tiledb_version(int* major, int* minor, int* rev);
 /** A TileDB context. */
 typedef struct tiledb_ctx_t tiledb_ctx_t;
 
+/** A TileDB config. */
+typedef struct tiledb_config_t tiledb_config_t;
+
 /** A TileDB error. **/
 typedef struct tiledb_error_t tiledb_error_t;
 
@@ -279,6 +289,134 @@ TILEDB_EXPORT int tiledb_config_set_write_method(
     tiledb_ctx_t* ctx, tiledb_config_t* config, tiledb_io_t write_method);
 =======
 TILEDB_EXPORT int tiledb_ctx_free(tiledb_ctx_t* ctx);
+
+/**
+ * Sets a configuration to a TileDB context. The config is copied, so it can
+ * be freed or modified afterwards without affecting the context.
+ *
+ * @param ctx The TileDB context.
+ * @param config The config to be set.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_ctx_set_config(
+    tiledb_ctx_t* ctx, tiledb_config_t* config);
+
+/* ********************************* */
+/*              CONFIG               */
+/* ********************************* */
+
+/**
+ * Creates a TileDB config with the default parameters.
+ *
+ * @param ctx The TileDB context.
+ * @param config The config to be created.
+ * @return TILEDB_OK for success and TILEDB_OOM or TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_config_create(
+    tiledb_ctx_t* ctx, tiledb_config_t** config);
+
+/**
+ * Destroys a TileDB config, freeing-up memory.
+ *
+ * @param ctx The TileDB context.
+ * @param config The config to be freed.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_config_free(
+    tiledb_ctx_t* ctx, tiledb_config_t* config);
+
+/**
+ * Sets the number of threads of the thread pool of the context, which
+ * executes the async queries, along with the parallel parts of all queries.
+ *
+ * @param ctx The TileDB context.
+ * @param config The config.
+ * @param thread_pool_size The number of threads. Zero (default) sets it to
+ *     the number of hardware threads.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_config_set_thread_pool_size(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, unsigned int thread_pool_size);
+
+/**
+ * Sets the size of the cache that keeps the array and fragment metadata of
+ * the arrays after they are closed, so that subsequent queries do not have
+ * to load them again. A zero size disables the cache.
+ *
+ * @param ctx The TileDB context.
+ * @param config The config.
+ * @param metadata_cache_size The cache size (in bytes).
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_config_set_metadata_cache_size(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, uint64_t metadata_cache_size);
+
+/**
+ * Sets the size of the cache of decompressed tiles. The cache is shared by
+ * the whole process, therefore its size is the largest size set to the
+ * contexts that are alive. A zero size disables the cache, unless another
+ * context sets a larger size.
+ *
+ * @param ctx The TileDB context.
+ * @param config The config.
+ * @param tile_cache_size The cache size (in bytes).
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_config_set_tile_cache_size(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, uint64_t tile_cache_size);
+
+/**
+ * Sets the maximum gap between two tiles of the same file for them to be
+ * fetched with a single coalesced read, along with the data in between.
+ *
+ * @param ctx The TileDB context.
+ * @param config The config.
+ * @param tile_coalesce_gap_size The gap (in bytes). Zero coalesces only
+ *     adjacent tiles.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_config_set_tile_coalesce_gap_size(
+    tiledb_ctx_t* ctx,
+    tiledb_config_t* config,
+    uint64_t tile_coalesce_gap_size);
+
+/**
+ * Enables or disables the prefetching of the files that are read
+ * sequentially (enabled by default).
+ *
+ * @param ctx The TileDB context.
+ * @param config The config.
+ * @param read_ahead Non-zero to enable prefetching, zero to disable it.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_config_set_read_ahead(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, int read_ahead);
+
+/**
+ * Sets the number of threads that fetch and decompress the tiles of a read
+ * query in parallel, across its attributes and fragments. The default of 1
+ * reads the tiles on the calling thread.
+ *
+ * @param ctx The TileDB context.
+ * @param config The config.
+ * @param read_thread_num The number of threads. Zero is treated as 1.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_config_set_read_thread_num(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, unsigned int read_thread_num);
+
+/**
+ * Sets the size of the chunks that tiles are compressed in. The chunks of
+ * a tile are compressed and decompressed in parallel.
+ *
+ * @param ctx The TileDB context.
+ * @param config The config.
+ * @param tile_chunk_size The chunk size (in bytes), which is rounded down to
+ *     a multiple of the cell size. Zero restores the default size.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_config_set_tile_chunk_size(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, uint64_t tile_chunk_size);
 >>>>>>> upstream/dev
 
 /* ********************************* */
@@ -371,6 +509,23 @@ TILEDB_EXPORT int tiledb_attribute_set_compressor(
     tiledb_compressor_t compressor,
     int compression_level);
 
+/**
+ * Appends a filter to the filter pipeline of an attribute. The filters are
+ * applied to the attribute tiles in the order they are added, before the
+ * compressor, and reversed in the opposite order after decompression.
+ * For instance, a delta filter followed by a bit-shuffle filter and the
+ * TILEDB_LZ4 compressor store the deltas of the values, with their bits
+ * transposed, compressed with LZ4. An attribute with filters must also
+ * have a compressor.
+ *
+ * @param ctx The TileDB context.
+ * @param attr The target attribute.
+ * @param filter The filter to be appended.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_attribute_add_filter(
+    tiledb_ctx_t* ctx, tiledb_attribute_t* attr, tiledb_filter_t filter);
+
 /**
  * Sets the number of values per cell for an attribute.
  *
@@ -419,6 +574,34 @@ TILEDB_EXPORT int tiledb_attribute_get_compressor(
     tiledb_compressor_t* compressor,
     int* compression_level);
 
+/**
+ * Retrieves the number of filters in the filter pipeline of an attribute.
+ *
+ * @param ctx The TileDB context.
+ * @param attr The attribute.
+ * @param filter_num The number of filters to be retrieved.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_attribute_get_filter_num(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    unsigned int* filter_num);
+
+/**
+ * Retrieves a filter from the filter pipeline of an attribute.
+ *
+ * @param ctx The TileDB context.
+ * @param attr The attribute.
+ * @param index The position of the filter in the pipeline.
+ * @param filter The filter to be retrieved.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_attribute_get_filter(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    unsigned int index,
+    tiledb_filter_t* filter);
+
 /**
  * Retrieves the number of values per cell for this attribute.
  *
@@ -697,7 +880,9 @@ TILEDB_EXPORT int tiledb_array_metadata_set_capacity(
     uint64_t capacity);
 
 /**
- * Sets the cell order.
+ * Sets the cell order. Sparse arrays may also use TILEDB_HILBERT, which
+ * orders the cells along a Hilbert curve, so that the tiles are spatially
+ * clustered.
  *
  * @param ctx The TileDB context.
  * @param array_metadata The array metadata.
@@ -710,7 +895,9 @@ TILEDB_EXPORT int tiledb_array_metadata_set_cell_order(
     tiledb_layout_t cell_order);
 
 /**
- * Sets the tile order.
+ * Sets the tile order. Dense arrays may also use TILEDB_MORTON, which
+ * orders the tiles along a Z-order curve, so that the tiles of a subarray
+ * spanning several tile rows lie close to each other in the files.
  *
  * @param ctx The TileDB context.
  * @param array_metadata The array metadata.
@@ -1058,6 +1245,19 @@ TILEDB_EXPORT int tiledb_query_reset_buffers(
     void** buffers,
     uint64_t* buffer_sizes);
 
+/**
+ * Sets the number of threads that fetch and decompress the tiles of a read
+ * query, overriding the one set in the config of the context.
+ *
+ * @param ctx The TileDB context.
+ * @param query The query.
+ * @param read_thread_num The number of threads. Zero restores the number
+ *     set in the config.
+ * @return TILEDB_OK upon success, and TILEDB_ERR upon error.
+ */
+TILEDB_EXPORT int tiledb_query_set_read_thread_num(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, unsigned int read_thread_num);
+
 /**
  * Retrieves the status of a query.
  *
@@ -62,45 +62,55 @@ class DoubleDelta {
    *
    * The output buffer will contain the following after compression:
    *
-   * bitsize | n | in_0 | in_1 | b_2 | abs(dd_2) | b_3 | abs(dd_3) | ...
-   *   ...   | b_n | abs(dd_n)
+   * format | n | in_0 | in_1 | bitsize_0 | block_0 | bitsize_1 | block_1 | ...
    *
    * where:
-   *  - *bitsize* (char) is the minimum number of bits required to represent
-   *    any abs(dd_i).
+   *  - *format* (char) is 0xFF, which distinguishes the format from that
+   *    of the previous versions (see below).
    *  - *n* (uint64_t) is the number of values in the input buffer.
-   *  - **b_i** is the sign of dd_i
-   *  - **dd_i** is equal to (in_{i} - in_{i-1}) - (in_{i-1} - in_{i-2})
+   *  - **dd_i** is equal to (in_{i} - in_{i-1}) - (in_{i-1} - in_{i-2}),
+   *    computed modulo 2^64 and zigzag encoded (i.e., the sign becomes the
+   *    least significant bit).
+   *  - *block_j* holds the double deltas dd_{2+256j}, ..., dd_{2+256j+255}
+   *    packed with *bitsize_j* (uint8_t) bits each, which is the minimum
+   *    number of bits required to represent any of them. The double deltas
+   *    of a block are packed into 4 interleaved lanes of 64-bit words, the
+   *    k-th double delta going to lane k % 4, so that the four lanes are
+   *    packed and unpacked together with SIMD instructions. The last block
+   *    may hold fewer double deltas, which are packed sequentially.
    *
-   *  In case the bitsize is equal to the size of the data type plus one (for
-   *  the sign), then it does not make sense to compress and, thus, the
-   *  algorithm simply copies the input to the output, though after *bitsize*
-   *  and *n* that are always written to the output buffer.
+   *  The double deltas are computed and packed with AVX2 instructions if the
+   *  CPU supports them, and with scalar code otherwise.
    *
-   *  The algorithm populates and writes to the output buffer a 64-bit chunk
-   *  at a time. Therefore, the output buffer may end up having a worst-case
-   *  overhead of 1 (bitsize) + 8 (n) + 8 (last, potentially almost empty chunk)
-   *  bytes.
+   *  In case the compressed values would not be smaller than the input, the
+   *  algorithm simply copies the input to the output after a bitsize equal
+   *  to the size of the data type and *n*, in the format of the previous
+   *  versions. Therefore, the output buffer may end up having a worst-case
+   *  overhead of 1 (bitsize) + 8 (n) bytes.
    *
    * @param type The type of the input values.
    * @param input_buffer Input buffer to read from.
    * @param output_buffer Output buffer to write to the compressed data.
    * @return Status
-   *
-   * @note The function will fail with an error in two cases: (i) the output
-   *     buffer incurs a memory allocation error, and (ii) some double delta
-   *     value is out of bounds. Note that all double deltas are represented
-   *     as int64_t. Therefore, the out of bounds case occurs when adding
-   *     two huge positive numbers (e.g., INT64_MAX) resulting in a negative
-   *     value, or adding to very small negative numbers (e.g., -INT64_MAX),
-   *     resulting in a positive number. However, both these two cases are
-   *     extreme.
    */
   static Status compress(
       Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer);
 
   /**
-   * Decompression function.
+   * Decompression function. It also decompresses the format of the previous
+   * versions, which is the following:
+   *
+   * bitsize | n | in_0 | in_1 | b_2 | abs(dd_2) | b_3 | abs(dd_3) | ...
+   *   ...   | b_n | abs(dd_n)
+   *
+   * where:
+   *  - *bitsize* (char) is the minimum number of bits required to represent
+   *    any abs(dd_i), or the size of the data type if the values are not
+   *    compressed.
+   *  - **b_i** is the sign of dd_i.
+   *
+   * The signs and absolute double deltas are packed into 64-bit chunks,
+   * starting from their most significant bits.
    *
    * @param type The type of the original decompressed values.
    * @param input_buffer Input buffer to read from.
@@ -123,28 +133,49 @@ class DoubleDelta {
   static Status compress(ConstBuffer* input_buffer, Buffer* output_buffer);
 
   /**
-   * Calculates the bitsize all the double deltas will have. Note that
-   * the sign bit is not counted.
+   * Decompression function.
    *
    * @tparam The datatype of the values.
-   * @param in The input buffer.
-   * @param num The number of values in the buffer.
-   * @param bitsize The bitsize of the double deltas to be retrieved.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write the decompressed data to.
    * @return Status
    */
   template <class T>
-  static Status compute_bitsize(T* in, uint64_t num, int* bitsize);
+  static Status decompress(ConstBuffer* input_buffer, Buffer* output_buffer);
 
   /**
-   * Decompression function.
+   * Decompresses the values in the format of the previous versions, after
+   * the bitsize and the number of values have been read.
    *
    * @tparam The datatype of the values.
+   * @param bitsize The bitsize of the double deltas.
+   * @param num The number of values.
    * @param input_buffer Input buffer to read from.
    * @param output_buffer Output buffer to write the decompressed data to.
    * @return Status
    */
   template <class T>
-  static Status decompress(ConstBuffer* input_buffer, Buffer* output_buffer);
+  static Status decompress_legacy(
+      int bitsize,
+      uint64_t num,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
+  /**
+   * Loads the values a block of double deltas is computed from, widened to
+   * 64 bits.
+   *
+   * @tparam The datatype of the values.
+   * @param in The input values.
+   * @param num The number of input values.
+   * @param block The block index.
+   * @param values The values of the block, i.e., the two values preceding
+   *     the first double delta of the block and those of its double deltas.
+   * @return The number of double deltas in the block.
+   */
+  template <class T>
+  static uint64_t load_block(
+      const T* in, uint64_t num, uint64_t block, uint64_t* values);
 
   /**
    * Reads/reconstructs a double delta value from a compressed buffer.
@@ -164,27 +195,6 @@ class DoubleDelta {
       int bitsize,
       uint64_t* chunk,
       int* bit_in_chunk);
-
-  /**
-   * Writes a double delta value to a buffer, after reducing its bitsize
-   * to match the input one.
-   *
-   * @param buff The output buffer.
-   * @param double_delta The double delta value to write.
-   * @param bitsize The bitsize the double delta value will reduce to
-   *     before being written to the buffer.
-   * @param chunk The function writes to the buffer in whole 64-bit chunks.
-   *     This parameters represents some state about the current chunk.
-   * @param bit_in_chunk Part of the chunk state. Stores the current bit
-   *     in the chunk the next write will start from.
-   * @return Status
-   */
-  static Status write_double_delta(
-      Buffer* buff,
-      int64_t double_delta,
-      int bitsize,
-      uint64_t* chunk,
-      int* bit_in_chunk);
 };
 
 }  // namespace tiledb
@@ -0,0 +1,178 @@
+/**
+ * @file   filter_pipeline.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class FilterPipeline.
+ */
+
+#ifndef TILEDB_FILTER_PIPELINE_H
+#define TILEDB_FILTER_PIPELINE_H
+
+#include <vector>
+
+#include "buffer.h"
+#include "const_buffer.h"
+#include "datatype.h"
+#include "filter.h"
+#include "status.h"
+
+namespace tiledb {
+
+/**
+ * Runs a pipeline of filters on tile data, which prepares the data for the
+ * compressor that follows. Every filter preserves the data size. The filters
+ * work on the values of the tile datatype, and leave any trailing bytes
+ * that do not form a whole value (or a whole group of 8 values, for the
+ * bit shuffle) intact:
+ *  - DELTA replaces each value with its difference from the previous one,
+ *    computed on the bits of the value as an unsigned integer, so that
+ *    floats are reversible too.
+ *  - BYTESHUFFLE stores the first bytes of all values, followed by their
+ *    second bytes, and so on.
+ *  - BITSHUFFLE stores the first bits of all values, followed by their
+ *    second bits, and so on, transposing 8 values at a time.
+ */
+class FilterPipeline {
+ public:
+  /* ****************************** */
+  /*               API              */
+  /* ****************************** */
+
+  /**
+   * Runs the filters on the input in order.
+   *
+   * @param filters The filters.
+   * @param type The type of the values.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write the filtered data to.
+   * @return Status
+   */
+  static Status run_forward(
+      const std::vector<Filter>& filters,
+      Datatype type,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
+  /**
+   * Reverses the filters on the input, in the opposite order.
+   *
+   * @param filters The filters.
+   * @param type The type of the values.
+   * @param input_buffer Input buffer to read the filtered data from.
+   * @param output_buffer Output buffer to write the original data to.
+   * @return Status
+   */
+  static Status run_reverse(
+      const std::vector<Filter>& filters,
+      Datatype type,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
+ private:
+  /* ****************************** */
+  /*         PRIVATE METHODS        */
+  /* ****************************** */
+
+  /** Shuffles the bits of the values. */
+  static void bitshuffle(
+      uint64_t value_size, const char* in, uint64_t nbytes, char* out);
+
+  /** Reverses *bitshuffle*. */
+  static void bitunshuffle(
+      uint64_t value_size, const char* in, uint64_t nbytes, char* out);
+
+  /** Shuffles the bytes of the values. */
+  static void byteshuffle(
+      uint64_t value_size, const char* in, uint64_t nbytes, char* out);
+
+  /** Reverses *byteshuffle*. */
+  static void byteunshuffle(
+      uint64_t value_size, const char* in, uint64_t nbytes, char* out);
+
+  /**
+   * Replaces the values with their deltas.
+   *
+   * @tparam T The unsigned integer type of the value size.
+   * @param in The input data.
+   * @param nbytes The size of the data.
+   * @param out The output data.
+   * @return void
+   */
+  template <class T>
+  static void delta(const char* in, uint64_t nbytes, char* out);
+
+  /** Reverses *delta*. */
+  template <class T>
+  static void undelta(const char* in, uint64_t nbytes, char* out);
+
+  /**
+   * Runs a single filter, or reverses it.
+   *
+   * @param filter The filter.
+   * @param reverse If *true* the filter is reversed.
+   * @param value_size The size of a value.
+   * @param in The input data.
+   * @param nbytes The size of the data.
+   * @param out The output data, which must not overlap the input.
+   * @return Status
+   */
+  static Status run(
+      Filter filter,
+      bool reverse,
+      uint64_t value_size,
+      const char* in,
+      uint64_t nbytes,
+      char* out);
+
+  /**
+   * Runs the filters, or reverses them in the opposite order.
+   *
+   * @param filters The filters.
+   * @param reverse If *true* the filters are reversed.
+   * @param type The type of the values.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write to.
+   * @return Status
+   */
+  static Status run(
+      const std::vector<Filter>& filters,
+      bool reverse,
+      Datatype type,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
+  /**
+   * Transposes the 8x8 bit matrix whose rows are the bytes of the input,
+   * starting from the least significant.
+   */
+  static uint64_t transpose_bits(uint64_t x);
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_FILTER_PIPELINE_H
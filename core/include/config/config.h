@@ -34,6 +34,10 @@
 #define TILEDB_CONFIGURATOR_H
 
 #include "io_method.h"
+
+#include <cinttypes>
+#include <string>
+
 #ifdef HAVE_MPI
 #include <mpi.h>
 #endif
@@ -73,10 +77,11 @@ class Config {
    * @param mpi_comm The MPI communicator.
    * @param read_method The method for reading data from a file.
    *     It can be one of the following:
-   *        - TILEDB_IO_METHOD_READ
+   *        - TILEDB_IO_METHOD_READ (default)
    *          TileDB will use POSIX read.
    *        - TILEDB_IO_METHOD_MMAP
-   *          TileDB will use mmap.
+   *          TileDB will use mmap. The files must not change while they
+   *          are being read.
    *        - TILEDB_IO_METHOD_MPI
    *          TileDB will use MPI-IO read.
    * @param write_method The method for writing data to a file.
@@ -85,6 +90,9 @@ class Config {
    *          TileDB will use POSIX write.
    *        - TILEDB_IO_METHOD_MPI
    *          TileDB will use MPI-IO write.
+   *        - TILEDB_IO_METHOD_DIRECT
+   *          TileDB will write the fragment data files with direct I/O,
+   *          bypassing the page cache.
    * @return void.
    */
   void init(MPI_Comm* mpi_comm, IOMethod read_method, IOMethod write_method);
@@ -94,10 +102,11 @@ class Config {
    *
    * @param read_method The method for reading data from a file.
    *     It can be one of the following:
-   *        - TILEDB_IO_METHOD_READ
+   *        - TILEDB_IO_METHOD_READ (default)
    *          TileDB will use POSIX read.
    *        - TILEDB_IO_METHOD_MMAP
-   *          TileDB will use mmap.
+   *          TileDB will use mmap. The files must not change while they
+   *          are being read.
    *        - TILEDB_IO_METHOD_MPI
    *          TileDB will use MPI-IO read.
    * @param write_method The method for writing data to a file.
@@ -106,6 +115,9 @@ class Config {
    *          TileDB will use POSIX write.
    *        - TILEDB_IO_METHOD_MPI
    *          TileDB will use MPI-IO write.
+   *        - TILEDB_IO_METHOD_DIRECT
+   *          TileDB will write the fragment data files with direct I/O,
+   *          bypassing the page cache.
    * @return void.
    */
   void init(IOMethod read_method, IOMethod write_method);
@@ -120,6 +132,36 @@ class Config {
   void set_mpi_comm(MPI_Comm* mpi_comm);
 #endif
 
+  /**
+   * Sets the spilling of the in-memory ("mem://") files to disk, which
+   * takes place once their total size would exceed *max_size*. The
+   * in-memory files are shared by the whole process, and so is this
+   * setting, which is applied when the config is set to a storage manager.
+   *
+   * @param max_size The maximum total size of the in-memory files.
+   * @param dir The POSIX directory the files are spilled to. Spilling is
+   *     disabled if it is empty (default).
+   */
+  void set_mem_spill(uint64_t max_size, const std::string& dir);
+
+  /**
+   * Sets the size of the cache that keeps the array and fragment metadata
+   * of the arrays after they are closed, so that subsequent queries do not
+   * have to load them again. A zero size disables the cache.
+   *
+   * @param metadata_cache_size The cache size (in bytes).
+   */
+  void set_metadata_cache_size(uint64_t metadata_cache_size);
+
+  /**
+   * Enables or disables the prefetching of the files that are read
+   * sequentially (enabled by default). Prefetching helps streaming reads,
+   * but it wastes I/O on workloads whose reads only look sequential.
+   *
+   * @param read_ahead *True* to enable prefetching.
+   */
+  void set_read_ahead(bool read_ahead);
+
   /**
    * Sets the read method.
    *
@@ -127,6 +169,60 @@ class Config {
    */
   void set_read_method(IOMethod read_method);
 
+  /**
+   * Sets the number of threads that fetch and decompress the tiles of a
+   * read query in parallel, across its attributes and fragments. A value of
+   * 1 reads the tiles on the calling thread.
+   *
+   * @param read_thread_num The number of threads.
+   */
+  void set_read_thread_num(unsigned int read_thread_num);
+
+  /**
+   * Sets the number of threads of the thread pool of the storage manager,
+   * which executes the async queries concurrently, along with the parallel
+   * parts of all queries (e.g., tile compression).
+   *
+   * @param thread_pool_size The number of threads. Zero (default) sets it to
+   *     the number of hardware threads.
+   */
+  void set_thread_pool_size(unsigned int thread_pool_size);
+
+  /**
+   * Sets the size of the cache of decompressed tiles. The cache is shared by
+   * the whole process, therefore its size is the largest size set to the
+   * storage managers (i.e., contexts) that are alive, which is applied when
+   * the config is set to a storage manager. A zero size disables the cache
+   * only if no other storage manager requests a larger one.
+   *
+   * @param tile_cache_size The cache size (in bytes).
+   */
+  void set_tile_cache_size(uint64_t tile_cache_size);
+
+  /**
+   * Sets the size of the chunks the tiles are split into upon compression.
+   * The chunks of a tile are compressed and decompressed in parallel,
+   * therefore smaller chunks (e.g., 64KB-1MB) let larger tiles use more
+   * threads, at the cost of a somewhat lower compression ratio. The chunk
+   * size is recorded with the tiles, so it only affects subsequent writes.
+   *
+   * @param tile_chunk_size The chunk size (in bytes). Zero restores the
+   *     default, whereas sizes over INT_MAX are capped to it.
+   */
+  void set_tile_chunk_size(uint64_t tile_chunk_size);
+
+  /**
+   * Sets the maximum gap between two tiles of the same file for them to be
+   * fetched with a single coalesced read, along with the data in between.
+   * Larger gaps save I/O requests at the cost of reading data that the
+   * query does not need. The gap that pays off depends on the storage
+   * (e.g., it is larger for disks with expensive seeks than for SSDs).
+   *
+   * @param tile_coalesce_gap_size The gap (in bytes). Zero coalesces only
+   *     adjacent tiles.
+   */
+  void set_tile_coalesce_gap_size(uint64_t tile_coalesce_gap_size);
+
   /**
    * Sets the write method.
    *
@@ -143,9 +239,36 @@ class Config {
   MPI_Comm* mpi_comm() const;
 #endif
 
+  /** Returns the directory the in-memory files are spilled to. */
+  const std::string& mem_spill_dir() const;
+
+  /** Returns the size beyond which the in-memory files are spilled. */
+  uint64_t mem_spill_size() const;
+
+  /** Returns the size of the cache of the closed array metadata. */
+  uint64_t metadata_cache_size() const;
+
+  /** Returns *true* if the sequentially read files are prefetched. */
+  bool read_ahead() const;
+
   /** Returns the read method. */
   IOMethod read_method() const;
 
+  /** Returns the number of threads that fetch the tiles of a read query. */
+  unsigned int read_thread_num() const;
+
+  /** Returns the number of threads of the thread pool. */
+  unsigned int thread_pool_size() const;
+
+  /** Returns the size of the cache of decompressed tiles. */
+  uint64_t tile_cache_size() const;
+
+  /** Returns the size of the chunks the tiles are compressed in. */
+  uint64_t tile_chunk_size() const;
+
+  /** Returns the maximum gap between tiles fetched by one coalesced read. */
+  uint64_t tile_coalesce_gap_size() const;
+
   /** Returns the write method. */
   IOMethod write_method() const;
 
@@ -159,18 +282,46 @@ class Config {
   MPI_Comm* mpi_comm_;
 #endif
 
+  /** The POSIX directory the in-memory files are spilled to. */
+  std::string mem_spill_dir_;
+
+  /** The total size of the in-memory files beyond which they are spilled. */
+  uint64_t mem_spill_size_;
+
+  /** The size (in bytes) of the cache of the closed array metadata. */
+  uint64_t metadata_cache_size_;
+
+  /** *True* if the sequentially read files are prefetched. */
+  bool read_ahead_;
+
   /**
    * The method for reading data from a file.
    * It can be one of the following:
-   *    - TILEDB_IO_METHOD_READ
+   *    - TILEDB_IO_METHOD_READ (default)
    *      TileDB will use POSIX read.
    *    - TILEDB_IO_METHOD_MMAP
-   *      TileDB will use mmap.
+   *      TileDB will use mmap. The files must not change while they are
+   *      being read.
    *    - TILEDB_IO_METHOD_MPI
    *      TileDB will use MPI-IO read.
    */
   IOMethod read_method_;
 
+  /** The number of threads that fetch the tiles of a read query. */
+  unsigned int read_thread_num_;
+
+  /** The number of threads of the thread pool (zero for hardware threads). */
+  unsigned int thread_pool_size_;
+
+  /** The size (in bytes) of the cache of decompressed tiles. */
+  uint64_t tile_cache_size_;
+
+  /** The size (in bytes) of the chunks the tiles are compressed in. */
+  uint64_t tile_chunk_size_;
+
+  /** The maximum gap (in bytes) between tiles fetched by one read. */
+  uint64_t tile_coalesce_gap_size_;
+
   /**
    * The method for writing data to a file.
    * It can be one of the following:
@@ -178,6 +329,9 @@ class Config {
    *      TileDB will use POSIX write.
    *    - TILEDB_IO_METHOD_MPI
    *      TileDB will use MPI-IO write.
+   *    - TILEDB_IO_METHOD_DIRECT
+   *      TileDB will write the fragment data files with direct I/O,
+   *      bypassing the page cache.
    */
   IOMethod write_method_;
 };
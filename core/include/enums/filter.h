@@ -0,0 +1,62 @@
+/**
+ * @file filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This defines the tiledb Filter enum that maps to tiledb_filter_t C-api
+ * enum.
+ */
+
+#ifndef TILEDB_FILTER_H
+#define TILEDB_FILTER_H
+
+#include "constants.h"
+
+namespace tiledb {
+
+/** Defines the filter type. */
+enum class Filter : char {
+#define TILEDB_FILTER_ENUM(id) id
+#include "tiledb_enum.inc"
+#undef TILEDB_FILTER_ENUM
+};
+
+/** Returns the string representation of the input filter. */
+inline const char* filter_str(Filter type) {
+  switch (type) {
+    case Filter::DELTA:
+      return constants::delta_str;
+    case Filter::BYTESHUFFLE:
+      return constants::byteshuffle_str;
+    case Filter::BITSHUFFLE:
+      return constants::bitshuffle_str;
+  }
+}
+
+}  // namespace tiledb
+
+#endif  // TILEDB_FILTER_H
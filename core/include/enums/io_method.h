@@ -0,0 +1,47 @@
+/**
+ * @file io_method.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file defines the tiledb IOMethod enum, which determines how TileDB
+ * reads from and writes to files.
+ */
+
+#ifndef TILEDB_IO_METHOD_H
+#define TILEDB_IO_METHOD_H
+
+namespace tiledb {
+
+/** Defines the method used for reading from or writing to files. */
+enum class IOMethod : char {
+#define TILEDB_IO_METHOD_ENUM(id) id
+#include "tiledb_enum.inc"
+#undef TILEDB_IO_METHOD_ENUM
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_IO_METHOD_H
@@ -0,0 +1,195 @@
+/**
+ * @file   async_io.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class AsyncIO.
+ */
+
+#ifndef TILEDB_ASYNC_IO_H
+#define TILEDB_ASYNC_IO_H
+
+#include <sys/uio.h>
+#include <mutex>
+#include <vector>
+
+#include "status.h"
+
+namespace tiledb {
+
+/**
+ * Executes batches of positional reads and writes on POSIX file descriptors,
+ * keeping many of them in flight at once so that devices that need a deep
+ * queue (e.g., NVMe) can reach their bandwidth. It uses io_uring when the
+ * kernel supports it, falls back to Linux native AIO otherwise, and finally
+ * to plain synchronous `preadv`/`pwritev` calls.
+ *
+ * The class is thread-safe. Each batch runs on a kernel context of its own,
+ * taken from a pool of idle contexts, so concurrent batches do not wait for
+ * each other.
+ */
+class AsyncIO {
+ public:
+  /* ********************************* */
+  /*           TYPE DEFINITIONS        */
+  /* ********************************* */
+
+  /** The kernel interface used for submitting the requests. */
+  enum class Backend : char {
+    /** io_uring (Linux 5.1+). */
+    IO_URING,
+    /** Linux native AIO (`io_submit`). */
+    LINUX_AIO,
+    /** Synchronous `preadv`/`pwritev`, one request at a time. */
+    SYNC
+  };
+
+  /** A positional read or write request. */
+  struct Request {
+    /** The file descriptor. */
+    int fd_;
+    /** The file offset the request starts from. */
+    uint64_t offset_;
+    /** The buffers to read into or write from, in file order. */
+    std::vector<iovec> iov_;
+    /** *true* for a write, *false* for a read. */
+    bool write_;
+  };
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor. It sets up the best backend the kernel supports.
+   *
+   * @param queue_depth The maximum number of requests in flight.
+   */
+  explicit AsyncIO(unsigned int queue_depth);
+
+  /** Destructor. */
+  ~AsyncIO();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Returns the backend in use. */
+  Backend backend() const;
+
+  /**
+   * Submits all the input requests and waits for them to complete. Requests
+   * that are partially served are resubmitted for their remaining bytes.
+   * Upon error, the function still waits for all the requests in flight
+   * before returning, so that the buffers can be safely released.
+   *
+   * @param requests The requests to execute. Their buffer vectors are
+   *     consumed in the process.
+   * @return Status
+   */
+  Status execute(std::vector<Request>* requests);
+
+ private:
+  /* ********************************* */
+  /*          PRIVATE TYPES            */
+  /* ********************************* */
+
+  /** The kernel state of a batch (defined in the source file). */
+  struct Context;
+
+  /** The state of an io_uring instance (defined in the source file). */
+  struct Uring;
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The backend in use. */
+  Backend backend_;
+
+  /** The idle contexts. */
+  std::vector<Context*> contexts_;
+
+  /** Protects the idle contexts. */
+  std::mutex mtx_;
+
+  /** The maximum number of requests in flight. */
+  unsigned int queue_depth_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Takes an idle context, or creates a new one. Returns *nullptr* if the
+   * backend is SYNC or a new context cannot be created, in which case the
+   * batch runs synchronously.
+   */
+  Context* acquire_context();
+
+  /**
+   * Accounts for *nbytes* transferred by a request, trimming its served
+   * buffers. Returns *true* if the request is complete.
+   */
+  static bool advance(Request* request, uint64_t nbytes);
+
+  /**
+   * Handles the completion of a request.
+   *
+   * @param request The request.
+   * @param res The number of bytes transferred, or a negated *errno* value.
+   * @param resubmit Set to *true* if the request must be resubmitted, either
+   *     because it was partially served or because of a transient error.
+   * @return Status
+   */
+  static Status complete(Request* request, int64_t res, bool* resubmit);
+
+  /** Releases the kernel resources of a context and deletes it. */
+  static void destroy_context(Context* context);
+
+  /** Executes the requests with Linux AIO on the input context. */
+  Status execute_aio(Context* context, std::vector<Request>* requests);
+
+  /** Executes the requests synchronously. */
+  Status execute_sync(std::vector<Request>* requests);
+
+  /** Executes the requests with io_uring on the input context. */
+  Status execute_uring(Context* context, std::vector<Request>* requests);
+
+  /** Tries to set up Linux AIO on a context. Returns *true* on success. */
+  bool init_aio(Context* context);
+
+  /** Tries to set up io_uring on a context. Returns *true* on success. */
+  bool init_uring(Context* context);
+
+  /** Returns a context to the idle pool. */
+  void release_context(Context* context);
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_ASYNC_IO_H
@@ -0,0 +1,178 @@
+/**
+ * @file   fd_cache.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class FDCache.
+ */
+
+#ifndef TILEDB_FD_CACHE_H
+#define TILEDB_FD_CACHE_H
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "status.h"
+
+namespace tiledb {
+
+/**
+ * A bounded, thread-safe cache of open POSIX file descriptors, evicted in
+ * LRU order. A descriptor handed out by `acquire` stays valid until the
+ * matching `release`, even if it is evicted or invalidated in the meantime;
+ * it is closed once its last user releases it.
+ */
+class FDCache {
+ public:
+  /* ********************************* */
+  /*           TYPE DEFINITIONS        */
+  /* ********************************* */
+
+  /** The access mode a descriptor is opened with. */
+  enum class Mode : char {
+    /** Read-only (`O_RDONLY`). */
+    READ,
+    /** Append, creating the file if needed (`O_WRONLY | O_APPEND | O_CREAT`).*/
+    APPEND,
+    /**
+     * Positional writes that bypass the page cache, creating the file if
+     * needed (`O_WRONLY | O_CREAT | O_DIRECT`). If the filesystem does not
+     * support direct I/O, the file is opened without `O_DIRECT`.
+     */
+    DIRECT
+  };
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param max_size The maximum number of cached descriptors.
+   */
+  explicit FDCache(uint64_t max_size);
+
+  /** Destructor. Closes all cached descriptors. */
+  ~FDCache();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Retrieves a descriptor for the input file, opening it on a miss. Every
+   * successful call must be paired with a `release` of the same descriptor.
+   *
+   * @param path The file path.
+   * @param mode The access mode.
+   * @param fd The retrieved descriptor.
+   * @return Status
+   */
+  Status acquire(const std::string& path, Mode mode, int* fd);
+
+  /** Closes all cached descriptors that are not currently in use. */
+  void clear();
+
+  /**
+   * Drops all descriptors of the input path, as well as of any path nested
+   * under it (so that a directory can be invalidated at once). Descriptors
+   * currently in use are closed upon their release.
+   *
+   * @param path The file or directory path.
+   */
+  void invalidate(const std::string& path);
+
+  /**
+   * Releases a descriptor retrieved with `acquire`.
+   *
+   * @param fd The descriptor.
+   * @return Status
+   */
+  Status release(int fd);
+
+ private:
+  /* ********************************* */
+  /*          PRIVATE TYPES            */
+  /* ********************************* */
+
+  /** A cached descriptor. */
+  struct Entry {
+    /** The descriptor. */
+    int fd_;
+    /** The cache key (i.e., the mode followed by the path). */
+    std::string key_;
+    /** Position in the LRU list (valid only if `cached_` is *true*). */
+    std::list<Entry*>::iterator lru_it_;
+    /** Number of users currently holding the descriptor. */
+    uint64_t ref_cnt_;
+    /** *False* if the entry was evicted or invalidated. */
+    bool cached_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** Maps a key to a cached entry. */
+  std::map<std::string, Entry*> entries_;
+
+  /** The cached entries, most recently used first. */
+  std::list<Entry*> lru_;
+
+  /** Maximum number of cached descriptors. */
+  uint64_t max_size_;
+
+  /** Protects all the members. */
+  std::mutex mtx_;
+
+  /** Maps a descriptor currently in use to its entry. */
+  std::unordered_map<int, Entry*> used_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Removes an entry from the cache, closing its descriptor if it is
+   * not in use.
+   */
+  Status drop(Entry* entry);
+
+  /** Evicts least recently used entries until the cache is within bounds. */
+  Status evict();
+
+  /** Returns the cache key of a path/mode pair. */
+  static std::string key(const std::string& path, Mode mode);
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_FD_CACHE_H
@@ -0,0 +1,310 @@
+/**
+ * @file   mem_filesystem.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class MemFilesystem.
+ */
+
+#ifndef TILEDB_MEM_FILESYSTEM_H
+#define TILEDB_MEM_FILESYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "status.h"
+
+namespace tiledb {
+
+/**
+ * An in-process filesystem that stores a tree of directories and files in
+ * main memory, backing the "mem://" URIs. The paths it operates on are the
+ * URI paths following "mem://" (e.g., "/my/array"); the root "/" always
+ * exists. All functions are thread-safe: the tree structure is protected by
+ * one mutex, whereas each file has its own mutex, so that different files
+ * can be read and written concurrently.
+ *
+ * Once the total size of the files held in memory would exceed a configured
+ * limit (see *set_spill*), the file being written is spilled to a POSIX file
+ * in the spill directory, where it stays until it is removed.
+ */
+class MemFilesystem {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  MemFilesystem();
+
+  /** Destructor. Removes any spilled files. */
+  ~MemFilesystem();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Creates a new directory. Its parent must exist.
+   *
+   * @param path The path of the directory.
+   * @return Status
+   */
+  Status create_dir(const std::string& path);
+
+  /**
+   * Creates an empty file, if it does not exist. Its parent must exist.
+   *
+   * @param path The path of the file.
+   * @return Status
+   */
+  Status create_file(const std::string& path);
+
+  /**
+   * Retrieves the size of a file.
+   *
+   * @param path The path of the file.
+   * @param size The file size to be retrieved.
+   * @return Status
+   */
+  Status file_size(const std::string& path, uint64_t* size) const;
+
+  /**
+   * Locks a file, blocking until the lock is acquired.
+   *
+   * @param path The path of the file.
+   * @param fd Set to a handle that records the lock type, which must be
+   *     passed to *filelock_unlock*.
+   * @param shared *True* if it is a shared lock, *false* if it is an
+   *     exclusive lock.
+   * @return Status
+   */
+  Status filelock_lock(const std::string& path, int* fd, bool shared) const;
+
+  /**
+   * Unlocks a file.
+   *
+   * @param path The path of the file.
+   * @param fd The handle returned by *filelock_lock*.
+   * @return Status
+   */
+  Status filelock_unlock(const std::string& path, int fd) const;
+
+  /** Checks if the input path is an existing directory. */
+  bool is_dir(const std::string& path) const;
+
+  /** Checks if the input path is an existing file. */
+  bool is_file(const std::string& path) const;
+
+  /**
+   * Lists the contents of a directory.
+   *
+   * @param path The path of the directory.
+   * @param paths The paths of the directory children, in sorted order.
+   * @return Status
+   */
+  Status ls(const std::string& path, std::vector<std::string>* paths) const;
+
+  /**
+   * Moves a file or directory, replacing any existing file or directory at
+   * the new path.
+   *
+   * @param old_path The old path.
+   * @param new_path The new path, whose parent must exist.
+   * @return Status
+   */
+  Status move_path(const std::string& old_path, const std::string& new_path);
+
+  /**
+   * Reads from a file.
+   *
+   * @param path The path of the file.
+   * @param offset The offset where the read begins.
+   * @param buffer The buffer to read into.
+   * @param nbytes The number of bytes to read.
+   * @return Status
+   */
+  Status read_from_file(
+      const std::string& path,
+      uint64_t offset,
+      void* buffer,
+      uint64_t nbytes) const;
+
+  /**
+   * Removes a file or directory (recursively).
+   *
+   * @param path The path to remove.
+   * @return Status
+   */
+  Status remove_path(const std::string& path);
+
+  /**
+   * Removes a file.
+   *
+   * @param path The path of the file.
+   * @return Status
+   */
+  Status remove_file(const std::string& path);
+
+  /**
+   * Enables spilling files to disk once the files in memory exceed the
+   * input size. Spilling is disabled if *dir* is empty.
+   *
+   * @param max_size The maximum total size of the files held in memory.
+   * @param dir The POSIX directory the files are spilled to.
+   */
+  void set_spill(uint64_t max_size, const std::string& dir);
+
+  /**
+   * Truncates (or extends with zeros) a file to the input size.
+   *
+   * @param path The path of the file.
+   * @param size The new file size.
+   * @return Status
+   */
+  Status truncate_file(const std::string& path, uint64_t size);
+
+  /**
+   * Appends data to a file, creating it if it does not exist.
+   *
+   * @param path The path of the file.
+   * @param buffer The data to write.
+   * @param nbytes The size of the data.
+   * @return Status
+   */
+  Status write_to_file(
+      const std::string& path, const void* buffer, uint64_t nbytes);
+
+ private:
+  /* ********************************* */
+  /*          PRIVATE TYPES            */
+  /* ********************************* */
+
+  /** A directory or file of the tree. */
+  struct Node {
+    /** Constructor. */
+    Node(bool is_dir, std::atomic<uint64_t>* mem_size);
+
+    /** Destructor. Releases the file memory or removes the spilled file. */
+    ~Node();
+
+    /** *True* for a directory, *false* for a file. */
+    bool is_dir_;
+    /** The directory children, keyed on their names. */
+    std::map<std::string, std::shared_ptr<Node>> children_;
+    /** The file data (empty if the file is spilled). */
+    std::vector<char> data_;
+    /** The path of the POSIX file the file was spilled to (if any). */
+    std::string spill_path_;
+    /** The file size. */
+    uint64_t size_;
+    /** The total size of the files in memory, updated by the node. */
+    std::atomic<uint64_t>* mem_size_;
+    /** Protects the file data and lock state. */
+    std::mutex mtx_;
+    /** Signals the release of a file lock. */
+    std::condition_variable cv_;
+    /** *True* if the file is locked with an exclusive lock. */
+    bool exclusive_lock_;
+    /** Number of shared locks on the file. */
+    unsigned int shared_locks_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The total size of the files held in memory. */
+  std::atomic<uint64_t> mem_size_;
+
+  /** Protects the tree structure and the spill settings. */
+  mutable std::mutex mtx_;
+
+  /** The root directory. */
+  std::shared_ptr<Node> root_;
+
+  /** Counter used to name the spilled files uniquely. */
+  std::atomic<uint64_t> spill_cnt_;
+
+  /** The POSIX directory files are spilled to (empty to disable). */
+  std::string spill_dir_;
+
+  /** The maximum total size of the files held in memory. */
+  uint64_t spill_max_size_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Returns the file at the input path, or *nullptr* if it does not
+   * exist. The tree mutex is acquired internally.
+   */
+  std::shared_ptr<Node> file(const std::string& path) const;
+
+  /**
+   * Returns the node at the input path, or *nullptr* if it does not exist.
+   * The tree mutex must be held by the caller.
+   */
+  std::shared_ptr<Node> lookup(const std::string& path) const;
+
+  /**
+   * Returns the parent directory of the input path (or *nullptr* if it
+   * does not exist) and sets *name* to the last path component. The tree
+   * mutex must be held by the caller.
+   */
+  std::shared_ptr<Node> lookup_parent(
+      const std::string& path, std::string* name) const;
+
+  /**
+   * Moves the data of a file to a new file in the input spill directory.
+   * The file mutex must be held by the caller.
+   */
+  Status spill(Node* node, const std::string& dir);
+
+  /** Splits a path into its non-empty components. */
+  static std::vector<std::string> tokenize(const std::string& path);
+};
+
+/* ********************************* */
+/*              GLOBAL               */
+/* ********************************* */
+
+/**
+ * Returns the in-memory filesystem, which is shared by all storage managers
+ * of the process.
+ */
+MemFilesystem& global_mem_filesystem();
+
+}  // namespace tiledb
+
+#endif  // TILEDB_MEM_FILESYSTEM_H
@@ -34,6 +34,7 @@
 #define TILEDB_POSIX_FILESYSTEM_H
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <string>
 #include <vector>
 
@@ -147,6 +148,18 @@ bool is_file(const std::string& path);
  */
 Status ls(const std::string& path, std::vector<std::string>* paths);
 
+/**
+ * Maps an entire file in main memory in read-only mode. The mapping is
+ * shared, so it is backed directly by the page cache.
+ *
+ * @param path The name of the file.
+ * @param data The address of the mapped region. It is set to *nullptr* if
+ *     the file is empty, in which case nothing is mapped.
+ * @param size The size of the mapped region (i.e., the file size).
+ * @return Status
+ */
+Status map_file(const std::string& path, void** data, uint64_t* size);
+
 /**
  * Move a given filesystem path.
  *
@@ -181,6 +194,31 @@ void purge_dots_from_path(std::string* path);
 Status read_from_file(
     const std::string& path, uint64_t offset, void* buffer, uint64_t nbytes);
 
+/**
+ * Reads data from an open file into a buffer. The file offset of the
+ * descriptor is not modified, so the descriptor may be shared by concurrent
+ * readers.
+ *
+ * @param fd The file descriptor.
+ * @param offset The offset in the file from which the read will start.
+ * @param buffer The buffer into which the data will be written.
+ * @param nbytes The size of the data to be read from the file.
+ * @return Status.
+ */
+Status read_from_file(int fd, uint64_t offset, void* buffer, uint64_t nbytes);
+
+/**
+ * Reads a contiguous region of an open file into multiple buffers with a
+ * single positional vectored read (`preadv`). The file offset of the
+ * descriptor is not modified.
+ *
+ * @param fd The file descriptor.
+ * @param offset The offset in the file from which the read will start.
+ * @param iov The buffers that the region is scattered into, in file order.
+ * @return Status.
+ */
+Status read_from_file(int fd, uint64_t offset, std::vector<iovec> iov);
+
 /**
  * Syncs a file or directory.
  *
@@ -189,6 +227,33 @@ Status read_from_file(
  */
 Status sync(const std::string& path);
 
+/**
+ * Syncs the data of an open file, along with the metadata needed to
+ * retrieve them (e.g., the file size).
+ *
+ * @param fd The file descriptor.
+ * @return Status
+ */
+Status sync(int fd);
+
+/**
+ * Truncates (or extends with zeros) a file to the input size.
+ *
+ * @param path The name of the file.
+ * @param size The new file size.
+ * @return Status
+ */
+Status truncate_file(const std::string& path, uint64_t size);
+
+/**
+ * Unmaps a region previously mapped with *map_file*.
+ *
+ * @param data The address of the mapped region.
+ * @param size The size of the mapped region.
+ * @return Status
+ */
+Status unmap_file(void* data, uint64_t size);
+
 /**
  * Writes the input buffer to a file.
  *
@@ -203,6 +268,31 @@ Status sync(const std::string& path);
 Status write_to_file(
     const std::string& path, const void* buffer, uint64_t buffer_size);
 
+/**
+ * Appends the input buffer to a file opened with `O_APPEND`.
+ *
+ * @param fd The file descriptor.
+ * @param buffer The input buffer.
+ * @param buffer_size The size of the input buffer.
+ * @return Status
+ */
+Status write_to_file(int fd, const void* buffer, uint64_t buffer_size);
+
+/**
+ * Writes the input buffer to an open file at the input offset. The file
+ * offset of the descriptor is not modified. If the file was opened with
+ * `O_DIRECT`, the buffer address, the offset and the size must be aligned
+ * to the logical block size of the device.
+ *
+ * @param fd The file descriptor.
+ * @param offset The offset in the file where the write will start.
+ * @param buffer The input buffer.
+ * @param buffer_size The size of the input buffer.
+ * @return Status
+ */
+Status write_to_file(
+    int fd, uint64_t offset, const void* buffer, uint64_t buffer_size);
+
 }  // namespace posix
 
 }  // namespace tiledb
@@ -0,0 +1,226 @@
+/**
+ * @file   read_ahead.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class ReadAhead.
+ */
+
+#ifndef TILEDB_READ_AHEAD_H
+#define TILEDB_READ_AHEAD_H
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fd_cache.h"
+#include "status.h"
+
+namespace tiledb {
+
+/**
+ * Prefetches POSIX files that are read sequentially. The engine tracks the
+ * reads of each file (see *access*). Once two consecutive reads of a file
+ * move forward within its read-ahead window, the reads are considered
+ * sequential and the data following the last read, up to the window size,
+ * are fetched in chunks of constants::read_ahead_chunk_size bytes by a
+ * background thread. The window starts at constants::read_ahead_min_size and
+ * doubles with every sequential read up to constants::read_ahead_max_size;
+ * a non-sequential read halves it and drops the prefetched data. At most
+ * constants::read_ahead_file_num files are tracked, evicted in LRU order,
+ * which bounds the memory used to about *read_ahead_file_num* times the
+ * maximum window. Prefetching can be disabled altogether (see
+ * *set_enabled*).
+ */
+class ReadAhead {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param fd_cache The cache providing the file descriptors for the
+   *     prefetching reads.
+   */
+  explicit ReadAhead(FDCache* fd_cache);
+
+  /**
+   * Destructor. Waits for the prefetch in progress to finish, whereas the
+   * queued prefetches are discarded (and their chunks marked as failed).
+   */
+  ~ReadAhead();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Records a read of a file, prefetching the data that follow it if the
+   * reads of the file are sequential.
+   *
+   * @param path The file path.
+   * @param offset The offset where the read starts.
+   * @param nbytes The number of bytes read.
+   */
+  void access(const std::string& path, uint64_t offset, uint64_t nbytes);
+
+  /**
+   * Drops the state of the input path, as well as of any path nested under
+   * it. It must be invoked whenever a file is modified.
+   *
+   * @param path The file or directory path.
+   */
+  void invalidate(const std::string& path);
+
+  /**
+   * Reads from a file if the data have been prefetched (or are being
+   * prefetched, in which case it waits for them). The data that are still
+   * queued for prefetching (e.g., behind the prefetches of other files) are
+   * fetched on the calling thread instead.
+   *
+   * @param path The file path.
+   * @param offset The offset where the read starts.
+   * @param buffer The buffer to read into.
+   * @param nbytes The number of bytes to read.
+   * @return *True* if the read was served, *false* otherwise.
+   */
+  bool read(
+      const std::string& path, uint64_t offset, void* buffer, uint64_t nbytes);
+
+  /**
+   * Enables or disables prefetching (enabled by default). Disabling it drops
+   * the state of all the tracked files.
+   *
+   * @param enabled *True* to enable prefetching.
+   */
+  void set_enabled(bool enabled);
+
+ private:
+  /* ********************************* */
+  /*          PRIVATE TYPES            */
+  /* ********************************* */
+
+  /** A prefetched file region. */
+  struct Chunk {
+    /** The offset in the file where the region starts. */
+    uint64_t offset_;
+    /** The size of the region. */
+    uint64_t size_;
+    /** The region data (filled in by the background thread). */
+    std::vector<char> data_;
+    /** *True* once the region has been read. */
+    bool done_;
+    /** *True* if the region was read successfully. */
+    bool ok_;
+    /** *True* if the region is no longer needed. */
+    bool dropped_;
+    /** *True* once the region has started being fetched. */
+    bool started_;
+  };
+
+  /** The read-ahead state of a file. */
+  struct File {
+    /** The prefetched regions, sorted and contiguous. */
+    std::deque<std::shared_ptr<Chunk>> chunks_;
+    /** The file size (*UINT64_MAX* until the first prefetch). */
+    uint64_t file_size_;
+    /** The value of *tick_* upon the last access (for LRU eviction). */
+    uint64_t last_access_;
+    /** The offset right after the last read. */
+    uint64_t next_offset_;
+    /** The number of consecutive sequential reads. */
+    unsigned int seq_num_;
+    /** The current read-ahead window. */
+    uint64_t window_;
+  };
+
+  /** A prefetch request. */
+  struct Task {
+    /** The file path. */
+    std::string path_;
+    /** The region to fetch. */
+    std::shared_ptr<Chunk> chunk_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** Signals new tasks, finished chunks and the thread termination. */
+  std::condition_variable cv_;
+
+  /** *True* if prefetching is enabled. */
+  bool enabled_;
+
+  /** The file descriptor cache (not owned). */
+  FDCache* fd_cache_;
+
+  /** The tracked files, keyed on their paths. */
+  std::map<std::string, File> files_;
+
+  /** Protects all the members. */
+  std::mutex mtx_;
+
+  /** *True* if the background thread must terminate. */
+  bool stop_;
+
+  /** The pending prefetch requests. */
+  std::deque<Task> tasks_;
+
+  /** The background thread (started upon the first prefetch). */
+  std::thread thread_;
+
+  /** Access counter. */
+  uint64_t tick_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Marks the chunks of a file as dropped and clears them. */
+  static void drop_chunks(File* file);
+
+  /** Evicts the least recently accessed file. */
+  void evict();
+
+  /** Fetches a chunk from a file. */
+  void fetch(const std::string& path, Chunk* chunk);
+
+  /** The background thread loop, which serves the prefetch requests. */
+  void run();
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_READ_AHEAD_H
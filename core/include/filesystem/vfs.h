@@ -33,8 +33,13 @@
 #ifndef TILEDB_VFS_H
 #define TILEDB_VFS_H
 
+#include "async_io.h"
 #include "buffer.h"
+#include "fd_cache.h"
+#include "mem_filesystem.h"
+#include "read_ahead.h"
 #include "status.h"
+#include "thread_pool.h"
 #include "uri.h"
 
 #include <string>
@@ -52,6 +57,20 @@ namespace tiledb {
  */
 class VFS {
  public:
+  /* ********************************* */
+  /*          TYPE DEFINITIONS         */
+  /* ********************************* */
+
+  /** A file region to be read into a buffer. */
+  struct ReadRegion {
+    /** The offset in the file where the region starts. */
+    uint64_t offset_;
+    /** The size of the region. */
+    uint64_t nbytes_;
+    /** The buffer the region is read into. */
+    void* buffer_;
+  };
+
   /* ********************************* */
   /*     CONSTRUCTORS & DESTRUCTORS    */
   /* ********************************* */
@@ -136,6 +155,15 @@ class VFS {
    */
   Status file_size(const URI& uri, uint64_t* size) const;
 
+  /**
+   * Drops the cached descriptors and the prefetched data of a POSIX path,
+   * as well as of any path nested under it, e.g., because it was modified
+   * outside this VFS.
+   *
+   * @param uri The URI of the file or directory.
+   */
+  void invalidate(const URI& uri) const;
+
   /**
    * Checks if a directory exists.
    *
@@ -161,6 +189,19 @@ class VFS {
    */
   Status ls(const URI& parent, std::vector<URI>* uris) const;
 
+  /**
+   * Maps an entire file in main memory in read-only mode. Only POSIX files
+   * can be mapped; for any other filesystem an error is returned and the
+   * caller should fall back to *read_from_file*.
+   *
+   * @param uri The URI of the file.
+   * @param data The address of the mapped region. It is set to *nullptr* if
+   *     the file is empty.
+   * @param size The size of the mapped region.
+   * @return Status
+   */
+  Status map_file(const URI& uri, void** data, uint64_t* size) const;
+
   /**
    * Renames a TileDB resource path.
    *
@@ -180,7 +221,8 @@ class VFS {
   //  Status read_from_file(const URI& uri, Buffer** buff);
 
   /**
-   * Reads from a file.
+   * Reads from a file. Sequential reads of POSIX files are served from the
+   * data prefetched by the read-ahead engine (see ReadAhead).
    *
    * @param uri The URI of the file.
    * @param offset The offset where the read begins.
@@ -192,13 +234,77 @@ class VFS {
       const URI& uri, uint64_t offset, void* buffer, uint64_t nbytes) const;
 
   /**
-   * Syncs (flushes) a file.
+   * Reads multiple regions of a file, each into its own buffer. For POSIX
+   * files, regions that are adjacent in the file are fetched with a single
+   * vectored read, regardless of their order in the input, and all these
+   * reads are submitted asynchronously at once (see AsyncIO). Regions that
+   * have been prefetched by the read-ahead engine are copied instead.
+   *
+   * @param uri The URI of the file.
+   * @param regions The regions to read.
+   * @return Status
+   */
+  Status read_batch(
+      const URI& uri, const std::vector<ReadRegion>& regions) const;
+
+  /**
+   * Sets the limit on the memory held by the "mem://" files, beyond which
+   * they are spilled to disk (see MemFilesystem::set_spill). The setting
+   * applies to all the storage managers of the process.
+   *
+   * @param max_size The maximum total size of the in-memory files.
+   * @param dir The POSIX directory the files are spilled to; spilling is
+   *     disabled if it is empty.
+   */
+  void set_mem_spill(uint64_t max_size, const std::string& dir);
+
+  /**
+   * Enables or disables the prefetching of the POSIX files that are read
+   * sequentially (see ReadAhead).
+   *
+   * @param enabled *True* to enable prefetching.
+   */
+  void set_read_ahead(bool enabled);
+
+  /**
+   * Syncs (flushes) a file. Any cached descriptors of the file are closed.
    *
    * @param uri The URI of the file.
    * @return Status
    */
   Status sync(const URI& uri) const;
 
+  /**
+   * Syncs (flushes) multiple files concurrently, reusing any cached
+   * descriptors. Only the file data and size are synced, therefore the
+   * parent directories must be synced separately (once) if the files are
+   * new. Files that do not exist are ignored.
+   *
+   * @param uris The URIs of the files.
+   * @param thread_pool The thread pool that syncs the files.
+   * @return Status
+   */
+  Status sync_batch(
+      const std::vector<URI>& uris, ThreadPool* thread_pool) const;
+
+  /**
+   * Truncates a file to the input size.
+   *
+   * @param uri The URI of the file.
+   * @param size The new file size.
+   * @return Status
+   */
+  Status truncate_file(const URI& uri, uint64_t size) const;
+
+  /**
+   * Unmaps a region previously mapped with *map_file*.
+   *
+   * @param data The address of the mapped region.
+   * @param size The size of the mapped region.
+   * @return Status
+   */
+  Status unmap_file(void* data, uint64_t size) const;
+
   /**
    * Writes the contents of a buffer into a file.
    *
@@ -210,10 +316,41 @@ class VFS {
   Status write_to_file(
       const URI& uri, const void* buffer, uint64_t buffer_size) const;
 
+  /**
+   * Writes a buffer at the input offset of a POSIX file, bypassing the page
+   * cache (`O_DIRECT`) where the filesystem supports it. The buffer address,
+   * the offset and the size must be multiples of
+   * constants::direct_io_alignment. The file is created if it does not exist.
+   *
+   * @param uri The URI of the file.
+   * @param offset The offset in the file where the write starts.
+   * @param buffer The buffer to write from.
+   * @param buffer_size The buffer size.
+   * @return Status
+   */
+  Status write_to_file_direct(
+      const URI& uri,
+      uint64_t offset,
+      const void* buffer,
+      uint64_t buffer_size) const;
+
  private:
   /* ********************************* */
   /*         PRIVATE ATTRIBUTES        */
   /* ********************************* */
+
+  /** Executes batches of POSIX reads with many requests in flight. */
+  AsyncIO* async_io_;
+
+  /** Caches the descriptors of the POSIX files being read or appended. */
+  FDCache* fd_cache_;
+
+  /** The in-memory filesystem of the "mem://" URIs (shared, not owned). */
+  MemFilesystem* mem_fs_;
+
+  /** Prefetches the POSIX files that are read sequentially. */
+  ReadAhead* read_ahead_;
+
 #ifdef HAVE_HDFS
   hdfsFS hdfs_;
 #endif
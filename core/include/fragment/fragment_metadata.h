@@ -37,14 +37,29 @@
 #include "array_metadata.h"
 #include "buffer.h"
 #include "query_type.h"
+#include "rtree.h"
 #include "status.h"
 
 #include <zlib.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace tiledb {
 
-/** Stores the metadata structures of a fragment. */
+class StorageManager;
+
+/**
+ * Stores the metadata structures of a fragment.
+ *
+ * The metadata are stored in sections (see *serialize*), which are loaded
+ * from the fragment metadata file on demand, so that a query loads only the
+ * tile offsets of the attributes it accesses. The basic section (holding the
+ * non-empty domain and the tile number) is also stored uncompressed in the
+ * file footer, and is always loaded.
+ */
 class FragmentMetadata {
  public:
   /* ********************************* */
@@ -128,12 +143,14 @@ class FragmentMetadata {
   bool dense() const;
 
   /**
-   * Loads the fragment metadata structures from the input binary buffer.
+   * Loads all the fragment metadata structures from the input binary buffer,
+   * which holds a fragment metadata file of the original, single-tile format.
    *
+   * @param storage_manager The storage manager that loaded the file.
    * @param buff The binary buffer to deserialize from.
    * @return Status
    */
-  Status deserialize(ConstBuffer* buff);
+  Status deserialize(StorageManager* storage_manager, ConstBuffer* buff);
 
   /** Returns the (expanded) domain in which the fragment is constrained. */
   const void* domain() const;
@@ -150,22 +167,104 @@ class FragmentMetadata {
    */
   Status init(const void* non_empty_domain);
 
+  /**
+   * Initializes the fragment metadata for loading its sections on demand
+   * from the fragment metadata file.
+   *
+   * @param storage_manager The storage manager used to read the file.
+   * @param section_offsets The offsets of the sections in the file.
+   * @param basic The basic section, read from the file footer.
+   * @return Status
+   */
+  Status init_sections(
+      StorageManager* storage_manager,
+      const std::vector<uint64_t>& section_offsets,
+      ConstBuffer* basic);
+
   /** Returns the number of cells in the last tile. */
   uint64_t last_tile_cell_num() const;
 
+  /** Loads the bounding coordinates, if they are not loaded already. */
+  Status load_bounding_coords();
+
+  /** Loads the MBRs, if they are not loaded already. */
+  Status load_mbrs();
+
+  /**
+   * Loads the tile offsets of the input attribute, if they are not loaded
+   * already.
+   *
+   * @param attribute_id The attribute id.
+   * @return Status
+   */
+  Status load_tile_offsets(unsigned int attribute_id);
+
+  /**
+   * Loads the variable tile offsets of the input attribute, if they are not
+   * loaded already.
+   *
+   * @param attribute_id The attribute id.
+   * @return Status
+   */
+  Status load_tile_var_offsets(unsigned int attribute_id);
+
+  /**
+   * Loads the variable tile sizes of the input attribute, if they are not
+   * loaded already.
+   *
+   * @param attribute_id The attribute id.
+   * @return Status
+   */
+  Status load_tile_var_sizes(unsigned int attribute_id);
+
+  /**
+   * Maps a data file of the fragment in main memory (read-only). A file is
+   * mapped once, upon the first request, and the mapping is then shared by
+   * all the queries that read the fragment, until the metadata are deleted
+   * (i.e., until the storage manager drops the array entry).
+   *
+   * @param uri The URI of the data file.
+   * @param data Set to the mapped data (*nullptr* if the file is empty).
+   * @param size Set to the size of the mapped data.
+   * @return Status
+   */
+  Status map_file(const URI& uri, void** data, uint64_t* size);
+
   /** Returns the MBRs. */
   const std::vector<void*>& mbrs() const;
 
+  /**
+   * Returns the (approximate) size of the main memory occupied by the
+   * loaded fragment metadata.
+   */
+  uint64_t memory_size() const;
+
   /** Returns the non-empty domain in which the fragment is constrained. */
   const void* non_empty_domain() const;
 
   /**
-   * Serializes the metadata structures into a binary buffer.
+   * Checks if the non-empty domain of the fragment overlaps the input
+   * subarray. A *nullptr* subarray stands for the whole array domain.
+   */
+  bool overlaps(const void* subarray) const;
+
+  /**
+   * Returns the R-tree over the MBRs, which is built once the MBRs are
+   * loaded. It is *nullptr* for dense fragments and before loading.
+   */
+  const RTree* rtree() const;
+
+  /** Returns the number of sections of the fragment metadata. */
+  unsigned int section_num() const;
+
+  /**
+   * Serializes a section of the metadata structures into a binary buffer.
    *
+   * @param section The section to serialize.
    * @param buff The buffer to serialize into.
    * @return Status
    */
-  Status serialize(Buffer* buff);
+  Status serialize(unsigned int section, Buffer* buff);
 
   /**
    * Simply sets the number of cells for the last tile.
@@ -218,6 +317,15 @@ class FragmentMetadata {
   /** The MBRs (applicable only to the sparse case with irregular tiles). */
   std::vector<void*> mbrs_;
 
+  /**
+   * The data files mapped in main memory, along with their mapped data and
+   * size (see *map_file*).
+   */
+  std::map<std::string, std::pair<void*, uint64_t>> mapped_files_;
+
+  /** Protects the loading of the sections and the mapping of the files. */
+  mutable std::mutex mtx_;
+
   /** The offsets of the next tile for each attribute. */
   std::vector<uint64_t> next_tile_offsets_;
 
@@ -230,6 +338,21 @@ class FragmentMetadata {
    */
   void* non_empty_domain_;
 
+  /** The R-tree over the MBRs (sparse fragments only). */
+  RTree* rtree_;
+
+  /** Indicates for each section whether it is loaded. */
+  std::vector<bool> section_loaded_;
+
+  /** The offsets of the sections in the fragment metadata file. */
+  std::vector<uint64_t> section_offsets_;
+
+  /** The storage manager used to load the sections. */
+  StorageManager* storage_manager_;
+
+  /** The number of tiles (meaningful only in the sparse case). */
+  uint64_t tile_num_;
+
   /**
    * The tile offsets in their corresponding attribute files. Meaningful only
    * when there is compression.
@@ -253,60 +376,107 @@ class FragmentMetadata {
   /* ********************************* */
 
   /**
-   * Loads the bounding coordinates from the fragment metadata buffer.
+   * Builds the R-tree over the loaded MBRs of a sparse fragment.
+   *
+   * @return Status
+   */
+  Status build_rtree();
+
+  /**
+   * Deserializes a section of the metadata structures from a binary buffer.
+   *
+   * @param section The section to deserialize.
+   * @param buff The buffer to deserialize from.
+   * @return Status
+   */
+  Status deserialize(unsigned int section, ConstBuffer* buff);
+
+  /**
+   * Expands the non-empty domain of a sparse fragment to include an MBR,
+   * so that it ends up as the union of the fragment MBRs.
+   *
+   * @param mbr The MBR.
+   */
+  void expand_non_empty_domain(const void* mbr);
+
+  /**
+   * Expands the non-empty domain of a sparse fragment to include an MBR.
+   *
+   * @tparam T The coordinates type.
+   * @param mbr The MBR.
+   */
+  template <class T>
+  void expand_non_empty_domain(const T* mbr);
+
+  /**
+   * Loads a section from the fragment metadata file, if it is not loaded
+   * already.
+   *
+   * @param section The section to load.
+   * @return Status
+   */
+  Status load_section(unsigned int section);
+
+  /**
+   * Reads the bounding coordinates from the fragment metadata buffer.
    *
    * @param buff Metadata buffer.
    * @return Status
    */
-  Status load_bounding_coords(ConstBuffer* buff);
+  Status read_bounding_coords(ConstBuffer* buff);
 
   /**
-   * Loads the cell number of the last tile from the fragment metadata buffer.
+   * Reads the cell number of the last tile from the fragment metadata buffer.
    *
    * @param buff Metadata buffer.
    * @return Status
    */
-  Status load_last_tile_cell_num(ConstBuffer* buff);
+  Status read_last_tile_cell_num(ConstBuffer* buff);
 
   /**
-   * Loads the MBRs from the fragment metadata buffer.
+   * Reads the MBRs from the fragment metadata buffer.
    *
    * @param buff Metadata buffer.
    * @return Status
    */
-  Status load_mbrs(ConstBuffer* buff);
+  Status read_mbrs(ConstBuffer* buff);
 
   /**
-   * Loads the non-empty domain from the fragment metadata buffer.
+   * Reads the non-empty domain from the fragment metadata buffer.
    *
    * @param buff Metadata buffer.
    * @return Status
    */
-  Status load_non_empty_domain(ConstBuffer* buff);
+  Status read_non_empty_domain(ConstBuffer* buff);
 
   /**
-   * Loads the tile offsets from the fragment metadata buffer.
+   * Reads the tile offsets of an attribute from the fragment metadata buffer.
    *
+   * @param attribute_id The attribute id.
    * @param buff Metadata buffer.
    * @return Status
    */
-  Status load_tile_offsets(ConstBuffer* buff);
+  Status read_tile_offsets(unsigned int attribute_id, ConstBuffer* buff);
 
   /**
-   * Loads the variable tile offsets from the fragment metadata buffer.
+   * Reads the variable tile offsets of an attribute from the fragment
+   * metadata buffer.
    *
+   * @param attribute_id The attribute id.
    * @param buff Metadata buffer.
    * @return Status
    */
-  Status load_tile_var_offsets(ConstBuffer* buff);
+  Status read_tile_var_offsets(unsigned int attribute_id, ConstBuffer* buff);
 
   /**
-   * Loads the variable tile sizes from the fragment metadata.
+   * Reads the variable tile sizes of an attribute from the fragment metadata
+   * buffer.
    *
+   * @param attribute_id The attribute id.
    * @param buff Metadata buffer.
    * @return Status
    */
-  Status load_tile_var_sizes(ConstBuffer* buff);
+  Status read_tile_var_sizes(unsigned int attribute_id, ConstBuffer* buff);
 
   /**
    * Writes the bounding coordinates to the fragment metadata buffer.
@@ -341,28 +511,33 @@ class FragmentMetadata {
   Status write_non_empty_domain(Buffer* buff);
 
   /**
-   * Writes the tile offsets to the fragment metadata buffer.
+   * Writes the tile offsets of an attribute to the fragment metadata buffer.
    *
+   * @param attribute_id The attribute id.
    * @param buff Metadata buffer.
    * @return Status
    */
-  Status write_tile_offsets(Buffer* buff);
+  Status write_tile_offsets(unsigned int attribute_id, Buffer* buff);
 
   /**
-   * Writes the variable tile offsets to the fragment metadata buffer.
+   * Writes the variable tile offsets of an attribute to the fragment
+   * metadata buffer.
    *
+   * @param attribute_id The attribute id.
    * @param buff Metadata buffer.
    * @return Status
    */
-  Status write_tile_var_offsets(Buffer* buff);
+  Status write_tile_var_offsets(unsigned int attribute_id, Buffer* buff);
 
   /**
-   * Writes the variable tile sizes to the fragment metadata buffer.
+   * Writes the variable tile sizes of an attribute to the fragment
+   * metadata buffer.
    *
+   * @param attribute_id The attribute id.
    * @param buff Metadata buffer.
    * @return Status
    */
-  Status write_tile_var_sizes(Buffer* buff);
+  Status write_tile_var_sizes(unsigned int attribute_id, Buffer* buff);
 };
 
 }  // namespace tiledb
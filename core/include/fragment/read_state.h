@@ -39,6 +39,7 @@
 #include "fragment.h"
 #include "fragment_metadata.h"
 #include "tile.h"
+#include "tile_cache.h"
 #include "tile_io.h"
 
 namespace tiledb {
@@ -145,6 +146,17 @@ class ReadState {
   /** Returns *true* if the read operation is finished for this fragment. */
   bool done() const;
 
+  /**
+   * Fetches and decompresses a tile of an attribute, unless it is already
+   * fetched, so that the cells can later be copied from it. Tiles of
+   * different attributes can be fetched concurrently.
+   *
+   * @param attribute_id The attribute id.
+   * @param tile_i The tile position in the fragment.
+   * @return Status
+   */
+  Status fetch_tile(unsigned int attribute_id, uint64_t tile_i);
+
   /**
    * Copies the bounding coordinates of the current search tile into the input
    * *bounding_coords*.
@@ -297,6 +309,12 @@ class ReadState {
    */
   bool mbr_overlaps_tile() const;
 
+  /**
+   * Returns the sorted positions of the fragment tiles that overlap the
+   * query subarray, i.e., the plan for coalescing tile reads.
+   */
+  const std::vector<uint64_t>& overlapping_tiles() const;
+
   /** Returns *true* if the read buffers overflowed for the input attribute. */
   bool overflow(unsigned int attribute_id) const;
 
@@ -320,6 +338,15 @@ class ReadState {
   /** The number of array attributes. */
   unsigned int attribute_num_;
 
+  /**
+   * The pinned tile cache entries aliased by the local tile buffers (see
+   * *tiles_*), or *nullptr* for the buffers that hold their own data.
+   */
+  std::vector<TileCache::Entry*> cached_tiles_;
+
+  /** The pinned tile cache entries aliased by the variable-sized tiles. */
+  std::vector<TileCache::Entry*> cached_tiles_var_;
+
   /** The size of the array coordinates. */
   uint64_t coords_size_;
 
@@ -358,6 +385,12 @@ class ReadState {
   /** Indicates buffer overflow for each attribute. */
   std::vector<bool> overflow_;
 
+  /**
+   * The sorted positions of the fragment tiles that overlap the query
+   * subarray. It serves as the plan for coalescing tile reads.
+   */
+  std::vector<uint64_t> overlapping_tiles_;
+
   /** The query for which the read state was created. */
   Query* query_;
 
@@ -450,35 +483,33 @@ class ReadState {
       uint64_t* bytes_var_to_copy);
 
   /**
-   * Computes the size of a compressed tile with input parameters.
+   * Computes the positions of the fragment tiles that overlap the query
+   * subarray, which are stored in overlapping_tiles_.
    *
-   * @param tile_i The tile index.
-   * @param attribute_id The attribute id.
-   * @param tile_io The tile I/O object.
-   * @param tile_compressed_size The size to be retrieved.
-   * @return Status
+   * @return void
    */
-  Status compute_tile_compressed_size(
-      uint64_t tile_i,
-      unsigned int attribute_id,
-      TileIO* tile_io,
-      uint64_t* tile_compressed_size) const;
+  void compute_overlapping_tiles();
 
   /**
-   * Computes the size of a compressed variable-sized tile with input
-   * parameters.
+   * Computes the positions of the fragment tiles that overlap the query
+   * subarray, focusing on dense fragments.
    *
-   * @param tile_i The tile index.
-   * @param attribute_id The attribute id.
-   * @param tile_io The tile I/O object.
-   * @param tile_compressed_size The size to be retrieved.
-   * @return Status
+   * @tparam T The coordinates type.
+   * @return void
    */
-  Status compute_tile_compressed_var_size(
-      uint64_t tile_i,
-      unsigned int attribute_id,
-      TileIO* tile_io,
-      uint64_t* tile_compressed_size) const;
+  template <class T>
+  void compute_overlapping_tiles_dense();
+
+  /**
+   * Computes the positions of the fragment tiles that overlap the query
+   * subarray, focusing on sparse fragments. These are the tiles in the
+   * tile search range whose MBR overlaps the subarray.
+   *
+   * @tparam T The coordinates type.
+   * @return void
+   */
+  template <class T>
+  void compute_overlapping_tiles_sparse();
 
   /**
    * Computes the ranges of tile positions that need to be searched for finding
@@ -599,6 +630,25 @@ class ReadState {
   /** Returns *true* if the file of the input attribute is empty. */
   bool is_empty_attribute(unsigned int attribute_id) const;
 
+  /**
+   * Maps a data file of the fragment in main memory through the fragment
+   * metadata, which own the mapping and share it across all the queries,
+   * and sets the mapping to the input Tile I/O objects. If the file fails
+   * to be mapped, the error is logged and its tiles are read with regular
+   * I/O instead.
+   *
+   * @param uri The URI of the data file.
+   * @param tile_io The Tile I/O objects that read from the file.
+   */
+  void map_file(const URI& uri, const std::vector<TileIO*>& tile_io);
+
+  /**
+   * Maps the non-empty files of the attributes being read (and of the
+   * coordinates) in main memory, if the configured read method is
+   * IOMethod::MMAP.
+   */
+  void map_files();
+
   /**
    * Reads from a tile based on the input parameters.
    *
@@ -654,6 +704,15 @@ class ReadState {
    */
   void shift_var_offsets(
       void* buffer, uint64_t offset_num, uint64_t new_start_offset);
+
+  /**
+   * Unpins the tile cache entries aliased by the tiles of the input
+   * attribute, which are then no longer considered fetched.
+   *
+   * @param attribute_id The attribute id.
+   * @return void
+   */
+  void unpin_tiles(unsigned int attribute_id);
 };
 
 }  // namespace tiledb
@@ -0,0 +1,190 @@
+/**
+ * @file   rtree.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class RTree.
+ */
+
+#ifndef TILEDB_RTREE_H
+#define TILEDB_RTREE_H
+
+#include <vector>
+
+#include "datatype.h"
+#include "status.h"
+
+namespace tiledb {
+
+/**
+ * A static R-tree over the MBRs of the tiles of a sparse fragment, bulk
+ * loaded with the Sort-Tile-Recursive (STR) algorithm. The leaves are the
+ * tile MBRs, which are not copied; the tree stores the tile positions in
+ * leaf order, along with the MBRs of the internal nodes.
+ */
+class RTree {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param type The type of the coordinates.
+   * @param dim_num The number of dimensions.
+   * @param fanout The maximum number of children of a node.
+   */
+  RTree(Datatype type, unsigned int dim_num, unsigned int fanout);
+
+  /** Destructor. */
+  ~RTree();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Builds the tree.
+   *
+   * @param mbrs The tile MBRs, each holding a [low, high] pair of
+   *     coordinates per dimension. They must outlive the tree.
+   * @return Status
+   */
+  Status build(const std::vector<void*>* mbrs);
+
+  /**
+   * Returns the (approximate) size of the main memory occupied by the tree,
+   * excluding the tile MBRs.
+   */
+  uint64_t memory_size() const;
+
+  /**
+   * Retrieves the positions of the tiles whose MBR overlaps the input
+   * subarray.
+   *
+   * @param subarray The subarray, which has the same layout as an MBR.
+   * @param tile_pos The tile positions, in ascending order.
+   * @return void
+   */
+  void query(const void* subarray, std::vector<uint64_t>* tile_pos) const;
+
+ private:
+  /* ********************************* */
+  /*          PRIVATE TYPES            */
+  /* ********************************* */
+
+  /** The internal nodes of a tree level. */
+  struct Level {
+    /** The end of the range of the children of each node. */
+    std::vector<uint64_t> child_end_;
+    /** The start of the range of the children of each node. */
+    std::vector<uint64_t> child_start_;
+    /** The MBRs of the nodes. */
+    std::vector<char> mbrs_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The number of dimensions. */
+  unsigned int dim_num_;
+
+  /** The maximum number of children of a node. */
+  unsigned int fanout_;
+
+  /** The tile positions, in leaf order. */
+  std::vector<uint64_t> leaves_;
+
+  /**
+   * The levels of internal nodes, from the one above the leaves up to the
+   * root. The children of the nodes of a level are the nodes of the level
+   * below, or the leaves.
+   */
+  std::vector<Level> levels_;
+
+  /** The tile MBRs. */
+  const std::vector<void*>* mbrs_;
+
+  /** The type of the coordinates. */
+  Datatype type_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Builds the tree.
+   *
+   * @tparam T The coordinates type.
+   * @return void
+   */
+  template <class T>
+  void build();
+
+  /** Checks if two MBRs overlap. */
+  template <class T>
+  bool overlap(const T* a, const T* b) const;
+
+  /**
+   * Retrieves the positions of the tiles whose MBR overlaps the input
+   * subarray.
+   *
+   * @tparam T The coordinates type.
+   * @param subarray The subarray.
+   * @param tile_pos The tile positions, in ascending order.
+   * @return void
+   */
+  template <class T>
+  void search(const T* subarray, std::vector<uint64_t>* tile_pos) const;
+
+  /**
+   * Sorts a range of entries in STR order, i.e., into slabs along the
+   * first dimension, each sorted recursively along the next dimensions,
+   * so that consecutive runs of *fanout_* entries are spatially close.
+   *
+   * @tparam T The coordinates type.
+   * @param mbrs The entry MBRs.
+   * @param begin The start of the range.
+   * @param end The end of the range.
+   * @param dim The dimension to sort along.
+   * @param entries The entries to sort.
+   * @return void
+   */
+  template <class T>
+  void str_sort(
+      const std::vector<const T*>& mbrs,
+      uint64_t begin,
+      uint64_t end,
+      unsigned int dim,
+      std::vector<uint64_t>* entries) const;
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_RTREE_H
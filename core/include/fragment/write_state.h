@@ -91,6 +91,22 @@ class WriteState {
   Status write(void** buffers, uint64_t* buffer_sizes);
 
  private:
+  /* ********************************* */
+  /*          PRIVATE TYPES            */
+  /* ********************************* */
+
+  /** A full tile queued for compression, before it is written to its file. */
+  struct QueuedTile {
+    /** The id of the attribute the tile belongs to. */
+    unsigned int attribute_id_;
+    /** The buffer that receives the compressed tile. */
+    Buffer* buffer_;
+    /** The tile. */
+    Tile* tile_;
+    /** Whether the tile holds the values of a variable-sized attribute. */
+    bool var_;
+  };
+
   /* ********************************* */
   /*         PRIVATE ATTRIBUTES        */
   /* ********************************* */
@@ -114,6 +130,12 @@ class WriteState {
   /** The MBR of the tile currently being populated. */
   void* mbr_;
 
+  /** The full tiles waiting to be compressed, in the order they filled up. */
+  std::vector<QueuedTile> queued_tiles_;
+
+  /** The total size of the queued tiles. */
+  uint64_t queued_size_;
+
   /** Auxiliary variable used whenever a tile id needs to be computed. */
   void* tile_coords_aux_;
 
@@ -157,6 +179,29 @@ class WriteState {
   /** Initializes the internal Tile I/O structures. */
   void init_tile_io();
 
+  /**
+   * Creates an empty tile for the input attribute.
+   *
+   * @param attribute_id The id of the attribute the tile belongs to.
+   * @param var If *true*, the tile holds the values of a variable-sized
+   *     attribute, otherwise the fixed-sized cells (i.e., the offsets of
+   *     a variable-sized attribute).
+   * @return The new tile.
+   */
+  Tile* new_tile(unsigned int attribute_id, bool var) const;
+
+  /**
+   * Queues the current tile of the input attribute for compression,
+   * replacing it with an empty one. The queued tiles are compressed and
+   * written once they exceed constants::tile_compression_batch_size bytes,
+   * or at the end of each write operation (see *write_queued_tiles*).
+   *
+   * @param attribute_id The id of the attribute this operation focuses on.
+   * @param var If *true*, the variable-sized tile is queued.
+   * @return Status
+   */
+  Status queue_tile(unsigned int attribute_id, bool var);
+
   /**
    * Sorts the input cell coordinates according to the order specified in the
    * array schema. This is not done in place; the sorted positions are stored
@@ -165,9 +210,9 @@ class WriteState {
    * @param buffer The buffer holding the cell coordinates.
    * @param buffer_size The size (in bytes) of *buffer*.
    * @param cell_pos The sorted cell positions.
-   * @return void
+   * @return Status
    */
-  void sort_cell_pos(
+  Status sort_cell_pos(
       const void* buffer,
       uint64_t buffer_size,
       std::vector<uint64_t>* cell_pos) const;
@@ -181,10 +226,10 @@ class WriteState {
    * @param buffer The buffer holding the cell coordinates.
    * @param buffer_size The size (in bytes) of *buffer*.
    * @param cell_pos The sorted cell positions.
-   * @return void
+   * @return Status
    */
   template <class T>
-  void sort_cell_pos(
+  Status sort_cell_pos(
       const void* buffer,
       uint64_t buffer_size,
       std::vector<uint64_t>* cell_pos) const;
@@ -265,6 +310,16 @@ class WriteState {
    */
   Status write_last_tile();
 
+  /**
+   * Compresses the queued tiles in parallel in the thread pool of the
+   * storage manager, and then writes them to their files in the order they
+   * were queued, appending their offsets (and variable tile sizes) to the
+   * fragment metadata.
+   *
+   * @return Status
+   */
+  Status write_queued_tiles();
+
   /**
    * Performs the write operation for the case of a sparse fragment when the
    * coordinates are unsorted.
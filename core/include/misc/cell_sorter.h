@@ -0,0 +1,225 @@
+/**
+ * @file   cell_sorter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class CellSorter.
+ */
+
+#ifndef TILEDB_CELL_SORTER_H
+#define TILEDB_CELL_SORTER_H
+
+#include <cinttypes>
+#include <vector>
+
+#include "domain.h"
+#include "layout.h"
+#include "status.h"
+#include "thread_pool.h"
+
+namespace tiledb {
+
+/**
+ * Sorts the positions of the cells of a coordinates buffer, optionally first
+ * on the cell tile ids and then on the coordinates in row-major, column-major
+ * or Hilbert order.
+ *
+ * Each cell is encoded into a 64-bit key that preserves the order: the
+ * coordinates are mapped to unsigned integers (flipping the sign bit of
+ * signed integers, and all bits of negative floats), offset by their minimum
+ * and packed together with the tile id, using just the bits their range
+ * needs. In the Hilbert order, the Hilbert key of the cell takes the place of
+ * the coordinates, and the cells with the same key are then sorted in
+ * row-major order. The keys are sorted with a parallel LSD radix sort. If
+ * they do not fit in 64 bits, the cells are sorted with comparators instead.
+ */
+class CellSorter {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param thread_pool The thread pool that runs the sort.
+   * @param domain The domain of the cells.
+   * @param cell_order The order of the coordinates, which must be
+   *     row-major, column-major or Hilbert.
+   */
+  CellSorter(ThreadPool* thread_pool, const Domain* domain, Layout cell_order);
+
+  /** Destructor. */
+  ~CellSorter();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Sorts the cell positions. The cells with identical coordinates (and
+   * tile ids) keep their input order if the keys fit in 64 bits.
+   *
+   * @tparam T The coordinates type.
+   * @param coords The coordinates of the cells.
+   * @param cell_num The number of cells.
+   * @param ids The tile ids of the cells, or *nullptr* if the cells are
+   *     sorted on their coordinates only.
+   * @param cell_pos The sorted cell positions.
+   * @return Status
+   */
+  template <class T>
+  Status sort(
+      const T* coords,
+      uint64_t cell_num,
+      const std::vector<uint64_t>* ids,
+      std::vector<uint64_t>* cell_pos) const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The order of the coordinates. */
+  Layout cell_order_;
+
+  /** The number of dimensions. */
+  unsigned int dim_num_;
+
+  /** The domain of the cells. */
+  const Domain* domain_;
+
+  /** The thread pool that runs the sort. */
+  ThreadPool* thread_pool_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Returns the number of chunks the cells are split into. */
+  uint64_t chunk_num(uint64_t cell_num) const;
+
+  /**
+   * Sorts the cell positions with the comparators of comparators.h, or on
+   * the Hilbert keys in the Hilbert order.
+   *
+   * @tparam T The coordinates type.
+   * @param coords The coordinates of the cells.
+   * @param ids The tile ids of the cells, or *nullptr*.
+   * @param hilbert_keys The Hilbert keys of the cells (Hilbert order only).
+   * @param cell_pos The cell positions to sort.
+   * @return void
+   */
+  template <class T>
+  void comparator_sort(
+      const T* coords,
+      const std::vector<uint64_t>* ids,
+      const std::vector<uint64_t>& hilbert_keys,
+      std::vector<uint64_t>* cell_pos) const;
+
+  /**
+   * Computes the Hilbert keys of the cells.
+   *
+   * @tparam T The coordinates type.
+   * @param coords The coordinates of the cells.
+   * @param cell_num The number of cells.
+   * @param hilbert_keys The Hilbert keys.
+   * @return Status
+   */
+  template <class T>
+  Status compute_hilbert_keys(
+      const T* coords,
+      uint64_t cell_num,
+      std::vector<uint64_t>* hilbert_keys) const;
+
+  /**
+   * Computes the order-preserving keys of the cells.
+   *
+   * @tparam T The coordinates type.
+   * @param coords The coordinates of the cells.
+   * @param cell_num The number of cells.
+   * @param ids The tile ids of the cells, or *nullptr*.
+   * @param hilbert_keys The Hilbert keys of the cells (Hilbert order only).
+   * @param keys The keys.
+   * @param bit_num The number of significant bits of the keys. It is set
+   *     beyond 64 if the keys do not fit in 64 bits, in which case *keys* is
+   *     left empty.
+   * @return Status
+   */
+  template <class T>
+  Status compute_keys(
+      const T* coords,
+      uint64_t cell_num,
+      const std::vector<uint64_t>* ids,
+      const std::vector<uint64_t>& hilbert_keys,
+      std::vector<uint64_t>* keys,
+      unsigned int* bit_num) const;
+
+  /** Maps a value to an unsigned integer of the same order. */
+  static uint64_t ordered_key(float value);
+
+  /** Maps a value to an unsigned integer of the same order. */
+  static uint64_t ordered_key(double value);
+
+  /** Maps a value to an unsigned integer of the same order. */
+  template <class T>
+  static uint64_t ordered_key(T value);
+
+  /**
+   * Sorts the cell positions on their keys with an LSD radix sort, which
+   * is stable. The digits in which all keys agree are skipped.
+   *
+   * @param bit_num The number of significant bits of the keys.
+   * @param keys The keys, which are sorted along with the positions.
+   * @param cell_pos The cell positions to sort.
+   * @return Status
+   */
+  Status radix_sort(
+      unsigned int bit_num,
+      std::vector<uint64_t>* keys,
+      std::vector<uint64_t>* cell_pos) const;
+
+  /**
+   * Sorts the runs of cells with equal keys in row-major order, which breaks
+   * the ties of the Hilbert order.
+   *
+   * @tparam T The coordinates type.
+   * @param coords The coordinates of the cells.
+   * @param keys The sorted keys.
+   * @param cell_pos The sorted cell positions.
+   * @return void
+   */
+  template <class T>
+  void sort_ties(
+      const T* coords,
+      const std::vector<uint64_t>& keys,
+      std::vector<uint64_t>* cell_pos) const;
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_CELL_SORTER_H
@@ -48,6 +48,18 @@ extern const char* array_filelock_name;
 /** The array metadata file name. */
 extern const char* array_metadata_filename;
 
+/**
+ * The interval (in microseconds) at which asynchronous I/O completions are
+ * polled after the kernel fails to wait for them.
+ */
+extern const unsigned int async_io_poll_interval;
+
+/**
+ * The maximum number of asynchronous I/O requests the VFS keeps in flight
+ * when reading a batch of file regions.
+ */
+extern const unsigned int async_io_queue_depth;
+
 /** The default tile capacity. */
 extern const uint64_t capacity;
 
@@ -57,6 +69,9 @@ extern const uint64_t cell_var_offset_size;
 /** The type of a variable cell offset. */
 extern const Datatype cell_var_offset_type;
 
+/** The minimum number of cells sorted by each thread in a radix sort. */
+extern const uint64_t cell_sort_min_chunk_cell_num;
+
 /** A special value indicating varibale size. */
 extern const uint64_t var_size;
 
@@ -78,6 +93,18 @@ extern int coords_compression_level;
 /** Special name reserved for the coordinates attribute. */
 extern const char* coords;
 
+/**
+ * The alignment (in bytes) of the buffers, file offsets and sizes of the
+ * direct I/O writes.
+ */
+extern const uint64_t direct_io_alignment;
+
+/**
+ * The size of the staging buffer that accumulates the tiles of a file
+ * written with direct I/O. It must be a multiple of direct_io_alignment.
+ */
+extern const uint64_t direct_io_buffer_size;
+
 /** The special value for an empty int32. */
 extern const int empty_int32;
 
@@ -111,12 +138,30 @@ extern const uint32_t empty_uint32;
 /** The special value for an empty uint64. */
 extern const uint64_t empty_uint64;
 
+/** The maximum number of file descriptors cached by the VFS. */
+extern const uint64_t fd_cache_size;
+
 /** The file suffix used in TileDB. */
 extern const char* file_suffix;
 
 /** The fragment metadata file name. */
 extern const char* fragment_metadata_filename;
 
+/** Marks the end of a fragment metadata file that has a footer. */
+extern const uint64_t fragment_metadata_magic;
+
+/**
+ * The format version of the fragment metadata files with a footer. Files
+ * without a footer have the original, single-tile format.
+ */
+extern const uint32_t fragment_metadata_version;
+
+/**
+ * The total size of the write-behind buffers of a fragment being written,
+ * which is divided among the files of the fragment.
+ */
+extern const uint64_t fragment_write_buffer_size;
+
 /** Default datatype for a generic tile. */
 extern const Datatype generic_tile_datatype;
 
@@ -141,15 +186,48 @@ extern const uint64_t consolidation_buffer_size;
 /** The maximum number of bytes written in a single I/O. */
 extern const uint64_t max_write_bytes;
 
+/**
+ * The default size (in bytes) of the cache that keeps the metadata of the
+ * closed arrays.
+ */
+extern const uint64_t metadata_cache_size;
+
 /** The maximum name length. */
 extern const unsigned name_max_len;
 
+/** The size of each read issued by the read-ahead engine. */
+extern const uint64_t read_ahead_chunk_size;
+
+/** The maximum number of files tracked by the read-ahead engine. */
+extern const unsigned int read_ahead_file_num;
+
+/** The maximum read-ahead window of a file. */
+extern const uint64_t read_ahead_max_size;
+
+/** The initial (and minimum) read-ahead window of a file. */
+extern const uint64_t read_ahead_min_size;
+
+/** The default number of threads that fetch the tiles of a read query. */
+extern const unsigned int read_thread_num;
+
+/** The maximum number of children of an R-tree node. */
+extern const unsigned int rtree_fanout;
+
 /** The size of the buffer that holds the sorted cells. */
 extern const uint64_t sorted_buffer_size;
 
 /** The size of the buffer that holds the sorted variable cells. */
 extern const uint64_t sorted_buffer_var_size;
 
+/** The maximum number of threads that sync files concurrently. */
+extern const unsigned int sync_thread_num;
+
+/**
+ * The default number of threads of the thread pool of a storage manager.
+ * Zero stands for the number of hardware threads.
+ */
+extern const unsigned int thread_pool_size;
+
 /** Special value indicating a variable number of elements. */
 extern const unsigned int var_num;
 
@@ -192,6 +270,15 @@ extern const char* bzip2_str;
 /** String describing DOUBLE_DELTA. */
 extern const char* double_delta_str;
 
+/** String describing the DELTA filter. */
+extern const char* delta_str;
+
+/** String describing the BYTESHUFFLE filter. */
+extern const char* byteshuffle_str;
+
+/** String describing the BITSHUFFLE filter. */
+extern const char* bitshuffle_str;
+
 /** The string representation for type int32. */
 extern const char* int32_str;
 
@@ -243,15 +330,54 @@ extern const char* global_order_str;
 /** The string representation for the unordered layout. */
 extern const char* unordered_str;
 
+/** The string representation for the Hilbert layout. */
+extern const char* hilbert_str;
+
+/** The string representation for the Morton layout. */
+extern const char* morton_str;
+
 /** The string representation of null. */
 extern const char* null_str;
 
 /** The version in format { major, minor, revision }. */
 extern const int version[3];
 
-/** The size of a tile chunk. */
+/** The default size of the chunks a tile is compressed in. */
 extern const uint64_t tile_chunk_size;
 
+/** The default size (in bytes) of the shared decompressed-tile cache. */
+extern const uint64_t tile_cache_size;
+
+/** The number of independently locked shards of the tile cache. */
+extern const unsigned int tile_cache_shard_num;
+
+/**
+ * The default maximum gap (in bytes) between two tiles of the same file for
+ * them to be fetched with a single coalesced read.
+ */
+extern const uint64_t tile_coalesce_gap_size;
+
+/** The maximum size of a coalesced tile read. */
+extern const uint64_t tile_coalesce_max_size;
+
+/**
+ * The maximum number of separate file regions that a coalesced tile read
+ * fetches at once.
+ */
+extern const unsigned int tile_coalesce_region_num;
+
+/**
+ * The total size of the full tiles a write accumulates before compressing
+ * them all at once.
+ */
+extern const uint64_t tile_compression_batch_size;
+
+/**
+ * The maximum size of the buffer that accumulates the written tiles of a
+ * file before they are appended to it.
+ */
+extern const uint64_t tile_write_buffer_size;
+
 }  // namespace constants
 
 }  // namespace tiledb
@@ -100,6 +100,21 @@ class URI {
    */
   bool is_hdfs() const;
 
+  /**
+   * Checks if the input path is in-memory (see MemFilesystem).
+   *
+   * @param path The path to be checked.
+   * @return The result of the check.
+   */
+  static bool is_mem(const std::string& path);
+
+  /**
+   * Checks if the URI is in-memory (see MemFilesystem).
+   *
+   * @return The result of the check.
+   */
+  bool is_mem() const;
+
   /**
    * Checks if the input path is S3.
    *
@@ -131,7 +146,7 @@ class URI {
 
   /** Returns the URI path, stripping the resource. For examples,
    *  "file:///my/path/" is the URI, this function will return
-   *  "/my/path/".
+   *  "/my/path/". The same holds for "mem:///my/path/".
    */
   std::string to_path() const;
 
@@ -247,6 +247,18 @@ bool is_positive_integer(const char* s);
 template <class T>
 bool is_unary_subarray(const T* subarray, unsigned int dim_num);
 
+/**
+ * Checks if two ranges overlap.
+ *
+ * @tparam The domain type
+ * @param range_A The first range.
+ * @param range_B The second range.
+ * @param dim_num The number of dimensions.
+ * @return True if range_A and range_B have at least one common point.
+ */
+template <class T>
+bool overlap(const T* range_A, const T* range_B, unsigned int dim_num);
+
 /**
  * Checks if a string starts with a certain prefix.
  *
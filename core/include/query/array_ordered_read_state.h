@@ -198,6 +198,9 @@ class ArrayOrderedReadState {
   /** The internal async queries. */
   Query* async_query_[2];
 
+  /** The ids of the thread pool tasks that process the async queries. */
+  uint64_t async_task_id_[2];
+
   /** Wait for async conditions, one for each local buffer. */
   bool async_wait_[2];
 
@@ -394,7 +397,10 @@ class ArrayOrderedReadState {
    */
   Status async_submit_query(unsigned int id);
 
-  /** Waits for async conditions on the input tile slab id. */
+  /**
+   * Waits for async conditions on the input tile slab id. In the meantime,
+   * it executes the tasks queued in the thread pool.
+   */
   void async_wait(unsigned int id);
 
   /**
@@ -577,6 +583,28 @@ class ArrayOrderedReadState {
   template <class T>
   void calculate_tile_slab_info_col(unsigned int id);
 
+  /**
+   * Calculates tile slab info for the case where the **array** tile order is
+   * Morton
+   *
+   * @tparam T The domain type.
+   * @param data Essentially a pointer to a ASRS_Data object.
+   * @return void
+   */
+  template <class T>
+  static void* calculate_tile_slab_info_morton(void* data);
+
+  /**
+   * Calculates the info used in the copy_tile_slab() function, for the case
+   * where the **array** tile order is Morton.
+   *
+   * @tparam T The domain type.
+   * @param id The tile slab id.
+   * @return void.
+   */
+  template <class T>
+  void calculate_tile_slab_info_morton(unsigned int id);
+
   /**
    * Calculates tile slab info for the case where the **array** tile order is
    * row-major
@@ -847,9 +875,12 @@ class ArrayOrderedReadState {
   /**
    * It sorts the positions of the cells based on the coordinates
    * of the current tile slab to be copied.
+   *
+   * @tparam T The domain type.
+   * @return Status
    */
   template <class T>
-  void sort_cell_pos();
+  Status sort_cell_pos();
 
   /**
    * Calculates the new tile and local buffer offset for the new (already
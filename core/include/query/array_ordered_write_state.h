@@ -180,6 +180,9 @@ class ArrayOrderedWriteState {
   /** The async queries. */
   Query* async_query_[2];
 
+  /** The ids of the thread pool tasks that process the async queries. */
+  uint64_t async_task_id_[2];
+
   /** Wait for async flags, one for each local buffer. */
   bool async_wait_[2];
 
@@ -326,7 +329,10 @@ class ArrayOrderedWriteState {
    */
   Status async_submit_query(unsigned int async_id);
 
-  /** Waits on an async condition on the input tile slab id. */
+  /**
+   * Waits on an async condition on the input tile slab id. In the meantime,
+   * it executes the tasks queued in the thread pool.
+   */
   void async_wait(unsigned int id);
 
   /**
@@ -480,6 +486,28 @@ class ArrayOrderedWriteState {
   template <class T>
   void calculate_tile_slab_info_col(unsigned int id);
 
+  /**
+   * Calculates tile slab info for the case where the **array** tile order is
+   * Morton
+   *
+   * @tparam T The domain type.
+   * @param data Essentially a pointer to a ASWS_Data object.
+   * @return void
+   */
+  template <class T>
+  static void* calculate_tile_slab_info_morton(void* data);
+
+  /**
+   * Calculates the info used in the copy_tile_slab() function, for the case
+   * where the **array** tile order is Morton.
+   *
+   * @tparam T The domain type.
+   * @param id The tile slab id.
+   * @return void.
+   */
+  template <class T>
+  void calculate_tile_slab_info_morton(unsigned int id);
+
   /**
    * Calculates tile slab info for the case where the **array** tile order is
    * row-major
@@ -649,7 +677,8 @@ class ArrayOrderedWriteState {
   /**
    * Returns true if every async write should create a separate fragment.
    * This happens when the cells in two different writes do not appear
-   * contiguous along the global cell order.
+   * contiguous along the global cell order, e.g., always in the Morton tile
+   * order, which interleaves the tiles of consecutive tile slabs.
    */
   bool separate_fragments() const;
 
@@ -415,6 +415,25 @@ class ArrayReadState {
   template <class T>
   FragmentCellRanges empty_fragment_cell_ranges() const;
 
+  /**
+   * Fetches and decompresses in parallel the tiles of the current read round
+   * of each unfinished attribute, across all fragments, so that the cells
+   * are then copied from memory.
+   *
+   * @param finished Indicates for each query attribute whether its read is
+   *     finished, i.e., done or overflowed.
+   * @return Status
+   */
+  Status fetch_tiles(const std::vector<bool>& finished);
+
+  /**
+   * Gets the next fragment cell ranges that are relevant in the current read
+   * round, invoking the templated function for the array type.
+   *
+   * @return Status
+   */
+  Status get_next_fragment_cell_ranges();
+
   /**
    * Gets the next fragment cell ranges that are relevant in the current read
    * round, focusing on the dense case.
@@ -547,6 +566,18 @@ class ArrayReadState {
       void* buffer_var,
       uint64_t* buffer_var_size);
 
+  /**
+   * Performs a read operation, advancing all the query attributes one read
+   * round at a time and fetching the tiles of each round in parallel (see
+   * *fetch_tiles*). The results are the same as those of *read_dense* and
+   * *read_sparse*.
+   *
+   * @param buffers See read().
+   * @param buffer_sizes See read().
+   * @return Status
+   */
+  Status read_parallel(void** buffers, uint64_t* buffer_sizes);
+
   /**
    * Performs a read operation in a **sparse** array.
    *
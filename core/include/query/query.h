@@ -229,6 +229,12 @@ class Query {
    */
   Status read(void** buffers, uint64_t* buffer_sizes);
 
+  /**
+   * Returns the number of threads that fetch the tiles of the query, which
+   * defaults to the one in the storage manager config.
+   */
+  unsigned int read_thread_num() const;
+
   /** Sets the query buffers. */
   void set_buffers(void** buffers, uint64_t* buffer_sizes);
 
@@ -238,6 +244,13 @@ class Query {
    */
   void set_callback(void* (*callback)(void*), void* callback_data);
 
+  /**
+   * Sets the number of threads that fetch the tiles of the query, overriding
+   * the one in the storage manager config. A value of 0 restores the config
+   * value.
+   */
+  void set_read_thread_num(unsigned int read_thread_num);
+
   /** Sets the query status. */
   void set_status(QueryStatus status);
 
@@ -339,6 +352,12 @@ class Query {
   /** The cell layout. */
   Layout layout_;
 
+  /**
+   * The number of threads that fetch the tiles of the query (0 to use the
+   * storage manager config).
+   */
+  unsigned int read_thread_num_;
+
   /** The storage manager. */
   StorageManager* storage_manager_;
 
@@ -373,6 +392,9 @@ class Query {
    * .__thread-id_timestamp. For instance,
    *  __6426153_1458759561320
    *
+   * The timestamps of the fragment names strictly increase within the
+   * process, even if several fragments are created in the same millisecond.
+   *
    * Note that this is a temporary name, initiated by a new write process.
    * After the new fragmemt is finalized, the array will change its name
    * by removing the leading '.' character.
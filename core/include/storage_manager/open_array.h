@@ -64,6 +64,12 @@ class OpenArray {
   /** Returns the array metadata. */
   const ArrayMetadata* array_metadata() const;
 
+  /**
+   * Returns the size of the array metadata file from which the array
+   * metadata were loaded.
+   */
+  uint64_t array_metadata_file_size() const;
+
   /** Returns the array URI. */
   const URI& array_uri() const;
 
@@ -76,6 +82,15 @@ class OpenArray {
   /** Adds a new entry to the fragment metadata map. */
   void fragment_metadata_add(FragmentMetadata* metadata);
 
+  /**
+   * Deletes the metadata that is not used by any query, of the fragments
+   * that contain or are contained in the input URI.
+   */
+  void fragment_metadata_evict(const URI& uri);
+
+  /** Returns *true* if the metadata of the input fragment is loaded. */
+  bool fragment_metadata_exists(const URI& fragment_uri) const;
+
   /**
    * Returns the stored metadata for a particular fragment uri (nullptr if not
    * found). If found, it also increments the respective counter of the
@@ -84,22 +99,42 @@ class OpenArray {
   FragmentMetadata* fragment_metadata_get(const URI& fragment_uri);
 
   /**
-   * Removes the metadata of the input fragment from the fragment metadata
-   * map.
+   * Releases the metadata of the input fragment, which stays loaded (for
+   * subsequent queries) until it is evicted.
    */
   void fragment_metadata_rm(const URI& fragment_uri);
 
+  /**
+   * Deletes the metadata that is not used by any query, of the fragments
+   * that are not included in the input list (e.g., because they were
+   * deleted by a consolidation).
+   */
+  void fragment_metadata_retain(const std::vector<URI>& fragment_uris);
+
   /** Increments the counter indicating the times this array has been opened. */
   void incr_cnt();
 
+  /**
+   * Returns the (approximate) size of the main memory occupied by the
+   * loaded fragment metadata.
+   */
+  uint64_t memory_size() const;
+
   /** Locks the array mutex. */
   void mtx_lock();
 
   /** Unlocks the array mutex. */
   void mtx_unlock();
 
-  /** Sets an array metadata. */
-  void set_array_metadata(const ArrayMetadata* array_metadata);
+  /**
+   * Sets an array metadata.
+   *
+   * @param array_metadata The array metadata.
+   * @param file_size The size of the array metadata file from which the
+   *     array metadata were loaded.
+   */
+  void set_array_metadata(
+      const ArrayMetadata* array_metadata, uint64_t file_size);
 
  private:
   /* ********************************* */
@@ -109,6 +144,9 @@ class OpenArray {
   /** The array metadata. */
   const ArrayMetadata* array_metadata_;
 
+  /** The size of the array metadata file. */
+  uint64_t array_metadata_file_size_;
+
   /** Counts the number of queries that opened the array. */
   uint64_t cnt_;
 
@@ -38,9 +38,7 @@
 #include <list>
 #include <map>
 #include <mutex>
-#include <queue>
 #include <string>
-#include <thread>
 
 <<<<<<< HEAD
 #include "array.h"
@@ -48,6 +46,7 @@
 #include "config.h"
 =======
 #include "array_metadata.h"
+#include "config.h"
 #include "consolidator.h"
 #include "locked_array.h"
 #include "object_type.h"
@@ -55,6 +54,7 @@
 #include "query.h"
 >>>>>>> upstream/dev
 #include "status.h"
+#include "thread_pool.h"
 #include "uri.h"
 #include "vfs.h"
 #include "walk_order.h"
@@ -145,15 +145,19 @@ class StorageManager {
   Status array_unlock(const URI& array_uri, bool shared);
 
   /**
-   * Pushes an async query to the queue.
+   * Queues an async query for execution in the thread pool. Both the user
+   * async queries and the internal ones (submitted as part of some other
+   * query) are queued this way.
    *
    * @param query The async query.
-   * @param i The index of the thread that executes the function. If it is
-   *    equal to 0, it means a user query, whereas if it is 1 it means an
-   *    internal query.
+   * @param task_id If not *nullptr*, it is set to the id of the thread pool
+   *     task that processes the query (see ThreadPool::execute).
    * @return Status
    */
-  Status async_push_query(Query* query, int i);
+  Status async_push_query(Query* query, uint64_t* task_id = nullptr);
+
+  /** Returns the configuration parameters. */
+  const Config* config() const;
 
   /** Creates a directory with the input URI. */
   Status create_dir(const URI& uri);
@@ -162,13 +166,13 @@ class StorageManager {
   Status create_file(const URI& uri);
 
   /** Deletes a fragment directory. */
-  Status delete_fragment(const URI& uri) const;
+  Status delete_fragment(const URI& uri);
 
   /** Safely removes a TileDB resource. */
-  Status remove_path(const URI& uri) const;
+  Status remove_path(const URI& uri);
 
   /** Safely moves a TileDB resource. */
-  Status move(const URI& old_uri, const URI& new_uri, bool force = false) const;
+  Status move(const URI& old_uri, const URI& new_uri, bool force = false);
 
   /** Retrieves the size of the input URI file. */
   Status file_size(const URI& uri, uint64_t* size) const;
@@ -182,10 +186,9 @@ class StorageManager {
   Status group_create(const std::string& group) const;
 
   /**
-   * Initializes the storage manager. It spawns two threads. The first is for
-   * handling user asynchronous queries (submitted via the *query_submit_async*
-   * function. The second handles internal asynchronous queries as part of some
-   * either sync or async query.
+   * Initializes the storage manager. It spawns the threads of the thread
+   * pool, which execute the async queries (see *async_push_query*) along
+   * with the parallel parts of all queries.
    *
    * @return Status
    */
@@ -218,6 +221,29 @@ class StorageManager {
    */
   Status load(FragmentMetadata* metadata);
 
+  /**
+   * Maps a file in main memory in read-only mode.
+   *
+   * @param uri The URI of the file to map.
+   * @param data The address of the mapped region. It is set to *nullptr*
+   *     if the file is empty.
+   * @param size The size of the mapped region.
+   * @return Status
+   */
+  Status map_file(const URI& uri, void** data, uint64_t* size) const;
+
+  /**
+   * Returns *true* if the metadata of the input array are cached, i.e., if
+   * the array is closed but its entry is kept (see *closed_arrays_*).
+   *
+   * @param array_uri The array URI.
+   * @return bool
+   */
+  bool metadata_cached(const URI& array_uri);
+
+  /** Returns the memory size of the cached metadata of the closed arrays. */
+  uint64_t metadata_cache_size();
+
   /**
    * TODO: DOC
    * @param old_uri
@@ -357,6 +383,17 @@ class StorageManager {
   Status query_submit_async(
       Query* query, void* (*callback)(void*), void* callback_data);
 
+  /**
+   * Reads multiple regions of a file, each into its own buffer (see
+   * VFS::read_batch).
+   *
+   * @param uri The URI file to read from.
+   * @param regions The regions to read.
+   * @return Status.
+   */
+  Status read_batch(
+      const URI& uri, const std::vector<VFS::ReadRegion>& regions) const;
+
   /**
    * Reads from a file into the input buffer.
    *
@@ -370,6 +407,16 @@ class StorageManager {
   Status read_from_file(
       const URI& uri, uint64_t offset, Buffer* buffer, uint64_t nbytes) const;
 
+  /**
+   * Sets new configuration parameters. It must not be called while queries
+   * are in progress. The spill settings of the in-memory files are applied
+   * to the whole process (see Config::set_mem_spill).
+   *
+   * @param config The configuration parameters to clone.
+   * @return Status
+   */
+  Status set_config(const Config* config);
+
   /**
    * Stores an array metadata into persistent storage.
    *
@@ -392,6 +439,30 @@ class StorageManager {
    */
   Status sync(const URI& uri);
 
+  /**
+   * Syncs multiple files concurrently (see VFS::sync_batch). Their parent
+   * directory must be synced separately.
+   */
+  Status sync_batch(const std::vector<URI>& uris);
+
+  /**
+   * Returns the thread pool, which executes the async queries, as well as
+   * the parallel parts of all queries (see ThreadPool::parallel_for).
+   */
+  ThreadPool* thread_pool() const;
+
+  /** Truncates a file to the input size. */
+  Status truncate_file(const URI& uri, uint64_t size) const;
+
+  /**
+   * Unmaps a region previously mapped with *map_file*.
+   *
+   * @param data The address of the mapped region.
+   * @param size The size of the mapped region.
+   * @return Status
+   */
+  Status unmap_file(void* data, uint64_t size) const;
+
   /**
    * Writes the contents of a buffer into a URI file.
    *
@@ -401,37 +472,35 @@ class StorageManager {
    */
   Status write_to_file(const URI& uri, Buffer* buffer) const;
 
+  /**
+   * Writes a buffer at the input file offset with direct I/O (see
+   * VFS::write_to_file_direct).
+   *
+   * @param uri The file to write into.
+   * @param offset The file offset to write at.
+   * @param buffer The buffer to write from.
+   * @param buffer_size The size of the buffer.
+   * @return Status.
+   */
+  Status write_to_file_direct(
+      const URI& uri,
+      uint64_t offset,
+      const void* buffer,
+      uint64_t buffer_size) const;
+
  private:
   /* ********************************* */
   /*        PRIVATE ATTRIBUTES         */
   /* ********************************* */
 
   /**
-   * Async condition variable. The first is for user async queries, the second
-   * for internal async queries.
-   * */
-  std::condition_variable async_cv_[2];
-
-  /** If true, the async thread will be eventually terminated. */
-  bool async_done_;
-
-  /**
-   * Async query queue. The first is for user queries, the second for
-   * internal queries. The queries are processed in a FIFO manner.
+   * The URIs of the closed arrays whose entries are kept in *open_arrays_*
+   * as a metadata cache, in least to most recently closed order.
    */
-  std::queue<Query*> async_queue_[2];
+  std::list<std::string> closed_arrays_;
 
-  /**
-   * Async mutex. The first is for the user queries thread, the second for
-   * the internal queries thread.
-   */
-  std::mutex async_mtx_[2];
-
-  /**
-   * Threads that handle all async queries. The first is for user queries,
-   * the second for internal queries.
-   */
-  std::thread* async_thread_[2];
+  /** The TileDB configuration parameters. */
+  Config* config_;
 
   /** Object that handles array consolidation. */
   Consolidator* consolidator_;
@@ -453,10 +522,15 @@ class StorageManager {
 
   /**
    * Stores the currently open arrays. An array is *opened* when a new query is
-   * initialized via *query_init* for a particular array.
+   * initialized via *query_init* for a particular array. The entries of the
+   * closed arrays are kept (see *closed_arrays_*), so that their metadata
+   * need not be loaded again, within the configured metadata cache size.
    */
   std::map<std::string, OpenArray*> open_arrays_;
 
+  /** The thread pool, sized by the configuration parameters. */
+  ThreadPool* thread_pool_;
+
   /**
    * Virtual filesystem handler. It directs queries to the appropriate
    * filesystem backend. Note that this is stateful.
@@ -495,42 +569,69 @@ class StorageManager {
       OpenArray* open_array,
       const std::vector<FragmentMetadata*>& fragment_metadata);
 
+  /** Handles a single async query. */
+  void async_process_query(Query* query);
+
   /**
-   * Starts listening to async queries.
-   *
-   * @param storage_manager The storage manager object that handles the
-   *     async query threads.
-   * @param i The index of the thread to execute the function. If it is
-   *     equal to 0, it means a user query, whereas if it is 1 it means an
-   *     internal query.
+   * Retrieves the fragment URI's of an open array. The directories whose
+   * fragment metadata is loaded in the open array are known to be fragments,
+   * and are not checked again. The overlap with the query subarray is checked
+   * once the footers of the fragment metadata are loaded (see
+   * *open_array_load_fragment_metadata*).
    */
-  static void async_start(StorageManager* storage_manager, int i = 0);
+  Status get_fragment_uris(
+      const OpenArray* open_array, std::vector<URI>* fragment_uris) const;
 
-  /** Stops listening to async queries. */
-  void async_stop();
+  /**
+   * Reads the footer of a fragment metadata file, which holds the basic
+   * section and indexes all the sections. Files of the original format have
+   * no footer.
+   *
+   * @param metadata The fragment metadata the file belongs to.
+   * @param has_footer Set to *true* if the file has a footer.
+   * @param section_offsets The offsets of the sections in the file, if the
+   *     file has a footer.
+   * @param basic The basic section, if the file has a footer.
+   * @return Status
+   */
+  Status load_fragment_metadata_footer(
+      FragmentMetadata* metadata,
+      bool* has_footer,
+      std::vector<uint64_t>* section_offsets,
+      Buffer* basic) const;
 
-  /** Handles a single async query. */
-  void async_process_query(Query* query);
+  /**
+   * Deletes the least recently closed array entries, until the metadata of
+   * the closed arrays fits in the input budget. The open array mutex must be
+   * held by the caller.
+   *
+   * @param budget The metadata cache budget (in bytes).
+   * @return void
+   */
+  void metadata_cache_evict(uint64_t budget);
 
   /**
-   * Starts handling async queries.
+   * Returns *false* if the cached entry of a closed array is stale, i.e., if
+   * its array metadata file changed since the array metadata were loaded
+   * (e.g., because the array was deleted and created again by another
+   * process). Only the file size is checked, so that the check is cheap.
    *
-   * @param i The index of the thread that executes the function. If it is
-   * equal to 0, it means a user query, whereas if it is 1 it means an
-   * internal query.
+   * @param array_uri The array URI.
+   * @param open_array The cached entry of the array.
+   * @return bool
    */
-  void async_process_queries(int i);
+  bool metadata_cache_is_valid(
+      const URI& array_uri, const OpenArray* open_array) const;
 
   /**
-   * Retrieves the fragment URI's of an array that overlap with a give
-   * subarray.
+   * Removes the cached metadata of the arrays and fragments that contain or
+   * are contained in the input URI, e.g., because it is deleted. The metadata
+   * used by open queries stays loaded.
+   *
+   * @param uri The URI to invalidate.
+   * @return void
    */
-  // TODO: Currently, no overlap check is performed with the subarray
-  // TODO: and all fragments are retrieved. To be fixed soon.
-  Status get_fragment_uris(
-      const URI& array_uri,
-      const void* subarray,
-      std::vector<URI>* fragment_uris) const;
+  void metadata_cache_invalidate(const URI& uri);
 
   /** Retrieves an open array entry for the given array URI. */
   Status open_array_get_entry(const URI& array_uri, OpenArray** open_array);
@@ -538,7 +639,11 @@ class StorageManager {
   /** Loads the array metadata into an open array. */
   Status open_array_load_metadata(const URI& array_uri, OpenArray* open_array);
 
-  /** Retrieves the fragment metadata of an open array for a given subarray. */
+  /**
+   * Retrieves the fragment metadata of an open array for a given subarray.
+   * The fragments whose non-empty domain does not overlap the subarray are
+   * left out, but their metadata stays cached in the open array.
+   */
   Status open_array_load_fragment_metadata(
       OpenArray* open_array,
       const void* subarray,
@@ -0,0 +1,170 @@
+/**
+ * @file   thread_pool.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class ThreadPool.
+ */
+
+#ifndef TILEDB_THREAD_POOL_H
+#define TILEDB_THREAD_POOL_H
+
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "status.h"
+
+namespace tiledb {
+
+/**
+ * A pool of threads that execute tasks in FIFO order. It runs the async
+ * queries of a storage manager, as well as the parallel loops of the
+ * queries (see *parallel_for*).
+ *
+ * The task queue is protected by a single mutex, which is only held while
+ * a task is pushed or popped, never while it is executed.
+ */
+class ThreadPool {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. The pool has no threads until *set_thread_num*. */
+  ThreadPool();
+
+  /**
+   * Destructor. It waits for the tasks being executed to finish, whereas
+   * the queued ones are discarded.
+   */
+  ~ThreadPool();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Queues a task for execution.
+   *
+   * @param task The task.
+   * @param task_id If not *nullptr*, it is set to the id of the task, which
+   *     can be passed to *execute*.
+   * @return Status
+   */
+  Status enqueue(std::function<void()>&& task, uint64_t* task_id = nullptr);
+
+  /**
+   * Executes a queued task on the calling thread, if it is still queued. A
+   * thread that waits for a queued task (e.g., an internal async query)
+   * should do this instead of blocking, so that the wait cannot stall the
+   * pool. The other queued tasks are left to the threads of the pool.
+   *
+   * @param task_id The id of the task, as set by *enqueue*.
+   * @return *true* if the task was executed, *false* if it was no longer
+   *     queued.
+   */
+  bool execute(uint64_t task_id);
+
+  /**
+   * Invokes a function on every index of [0, task_num) in parallel, on the
+   * calling thread along with up to *max_thread_num - 1* threads of the
+   * pool, and waits until all invocations finish. As the calling thread
+   * takes part, this may be nested (i.e., invoked by a task of the pool)
+   * without exhausting the pool.
+   *
+   * @param task_num The number of indices.
+   * @param func The function, which receives the index.
+   * @param max_thread_num The maximum number of threads to use.
+   * @return Status The first error returned by *func*, if any.
+   */
+  Status parallel_for(
+      uint64_t task_num,
+      const std::function<Status(uint64_t)>& func,
+      unsigned int max_thread_num = UINT_MAX);
+
+  /**
+   * Sets the number of threads, spawning new ones or terminating the
+   * excess ones after they finish their current task. It must not be
+   * invoked by a task of the pool.
+   *
+   * @param thread_num The number of threads. Zero sets it to the number of
+   *     hardware threads.
+   * @return Status
+   */
+  Status set_thread_num(unsigned int thread_num);
+
+  /** Returns the number of threads. */
+  unsigned int thread_num() const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** Signaled when a task is queued, or when threads must terminate. */
+  std::condition_variable cv_;
+
+  /** Protects the task queue and *thread_num_*. */
+  mutable std::mutex mtx_;
+
+  /** The id of the next queued task. */
+  uint64_t next_task_id_;
+
+  /** Serializes the changes of the number of threads. */
+  std::mutex resize_mtx_;
+
+  /** The queued tasks along with their ids, in FIFO order. */
+  std::deque<std::pair<uint64_t, std::function<void()>>> tasks_;
+
+  /** The number of threads. Those with an index beyond it terminate. */
+  unsigned int thread_num_;
+
+  /** The threads, in index order. */
+  std::vector<std::thread> threads_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Executes queued tasks until the thread must terminate.
+   *
+   * @param i The thread index.
+   * @return void
+   */
+  void worker(unsigned int i);
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_THREAD_POOL_H
@@ -0,0 +1,258 @@
+/**
+ * @file   tile_cache.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class TileCache.
+ */
+
+#ifndef TILEDB_TILE_CACHE_H
+#define TILEDB_TILE_CACHE_H
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "status.h"
+#include "uri.h"
+
+namespace tiledb {
+
+/**
+ * A cache of decompressed tiles, shared by all the queries of the process.
+ * Each tile is identified by its fragment, attribute, position in the
+ * fragment and whether it holds the variable-sized values of the attribute
+ * (see *key*).
+ *
+ * The entries are spread over independently locked shards, each of which
+ * evicts its least recently used entries once it exceeds its share of the
+ * cache budget. A reader pins the entry it copies from, which protects it
+ * from eviction and invalidation until it is unpinned.
+ *
+ * As the cache is shared, each storage manager requests a budget (see
+ * *request_budget*) and the cache keeps the largest budget requested by the
+ * storage managers that are alive, so that no storage manager shrinks (or
+ * disables) the cache under the others.
+ */
+class TileCache {
+ public:
+  /* ********************************* */
+  /*           PUBLIC TYPES            */
+  /* ********************************* */
+
+  /** A cached tile. */
+  struct Entry {
+    /** The tile data. */
+    void* data_;
+    /** The entry key. */
+    std::string key_;
+    /** The position of the entry in the LRU list of its shard. */
+    std::list<Entry*>::iterator lru_it_;
+    /** The number of readers that have pinned the entry. */
+    unsigned int pin_cnt_;
+    /** *True* if the entry was removed from the cache while pinned. */
+    bool removed_;
+    /** The index of the shard that holds the entry. */
+    unsigned int shard_;
+    /** The tile size. */
+    uint64_t size_;
+  };
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. The budget is set to *constants::tile_cache_size*. */
+  TileCache();
+
+  /** Destructor. */
+  ~TileCache();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Returns the cache budget (in bytes). */
+  uint64_t budget() const;
+
+  /**
+   * Inserts a copy of a tile into the cache, evicting the least recently
+   * used entries of its shard if necessary. Tiles that do not fit in the
+   * budget of a shard are not cached.
+   *
+   * @param key The tile key.
+   * @param data The tile data.
+   * @param size The tile size.
+   * @return Status
+   */
+  Status insert(const std::string& key, const void* data, uint64_t size);
+
+  /**
+   * Removes the entries of all the tiles stored under the input URI, e.g.,
+   * of a fragment or array that is deleted or moved.
+   *
+   * @param uri The URI whose tiles are invalidated.
+   */
+  void invalidate(const URI& uri);
+
+  /**
+   * Returns the key of a tile.
+   *
+   * @param fragment_uri The URI of the tile fragment.
+   * @param attribute_id The id of the tile attribute.
+   * @param tile_i The position of the tile in the fragment.
+   * @param var *True* if it is the tile of the variable-sized values.
+   * @return The tile key.
+   */
+  static std::string key(
+      const URI& fragment_uri,
+      unsigned int attribute_id,
+      uint64_t tile_i,
+      bool var);
+
+  /**
+   * Looks up a tile and pins its entry.
+   *
+   * @param key The tile key.
+   * @return The pinned entry, or *nullptr* on a miss.
+   */
+  Entry* pin(const std::string& key);
+
+  /**
+   * Withdraws the budget requested by an owner (see *request_budget*). Once
+   * no budget is requested, the budget reverts to constants::tile_cache_size.
+   *
+   * @param owner The owner of the request.
+   */
+  void release_budget(const void* owner);
+
+  /**
+   * Requests a cache budget on behalf of an owner (e.g., a storage manager),
+   * replacing its previous request. The cache budget is set to the largest
+   * requested budget.
+   *
+   * @param owner The owner of the request.
+   * @param budget The requested budget (in bytes).
+   */
+  void request_budget(const void* owner, uint64_t budget);
+
+  /**
+   * Sets the cache budget, evicting entries if necessary. A zero budget
+   * disables the cache. It is overridden by the subsequent budget requests
+   * (see *request_budget*).
+   *
+   * @param budget The budget (in bytes).
+   */
+  void set_budget(uint64_t budget);
+
+  /** Returns the total size of the cached tiles. */
+  uint64_t size() const;
+
+  /**
+   * Unpins an entry returned by *pin*.
+   *
+   * @param entry The entry to unpin.
+   */
+  void unpin(Entry* entry);
+
+ private:
+  /* ********************************* */
+  /*          PRIVATE TYPES            */
+  /* ********************************* */
+
+  /** An independently locked part of the cache. */
+  struct Shard {
+    /** The entries, keyed on the tile keys. */
+    std::unordered_map<std::string, Entry*> entries_;
+    /** The entries in most to least recently used order. */
+    std::list<Entry*> lru_;
+    /** Protects the shard. */
+    std::mutex mtx_;
+    /** The total size of the tiles of the shard. */
+    uint64_t size_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The cache budget (in bytes). */
+  std::atomic<uint64_t> budget_;
+
+  /** The requested budgets, keyed on their owners. */
+  std::map<const void*, uint64_t> budget_requests_;
+
+  /** Protects the budget requests. */
+  std::mutex budget_requests_mtx_;
+
+  /** The cache shards. */
+  std::vector<Shard*> shards_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Sets the budget to the largest requested budget. The mutex of the
+   * budget requests must be held by the caller.
+   */
+  void apply_budget_requests();
+
+  /**
+   * Evicts the least recently used unpinned entries of a shard, until the
+   * shard fits in its budget along with *size* more bytes. The shard mutex
+   * must be held by the caller.
+   */
+  void evict(Shard* shard, uint64_t size);
+
+  /**
+   * Removes an entry from its shard, deleting it unless it is pinned. The
+   * shard mutex must be held by the caller.
+   */
+  void remove(Shard* shard, Entry* entry);
+
+  /** Returns the budget of each shard. */
+  uint64_t shard_budget() const;
+};
+
+/* ********************************* */
+/*              GLOBAL               */
+/* ********************************* */
+
+/**
+ * Returns the tile cache, which is shared by all storage managers of the
+ * process.
+ */
+TileCache& global_tile_cache();
+
+}  // namespace tiledb
+
+#endif  // TILEDB_TILE_CACHE_H
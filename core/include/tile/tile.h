@@ -36,9 +36,11 @@
 #include "attribute.h"
 #include "buffer.h"
 #include "const_buffer.h"
+#include "filter.h"
 #include "status.h"
 
 #include <cinttypes>
+#include <vector>
 
 namespace tiledb {
 
@@ -131,6 +133,20 @@ class Tile {
   /** Advances the buffer offset. */
   void advance_offset(uint64_t nbytes);
 
+  /**
+   * Makes the tile alias the input data, instead of storing its own copy.
+   * The data must remain valid and unmodified while the tile uses them.
+   * Any subsequent *realloc* makes the tile store its own data again.
+   *
+   * @param data The data to alias.
+   * @param size The size of the data.
+   * @return void
+   */
+  void alias(void* data, uint64_t size);
+
+  /** Returns *true* if the tile aliases external data. */
+  bool aliased() const;
+
   /** Returns the internal buffer. */
   Buffer* buffer() const;
 
@@ -149,12 +165,21 @@ class Tile {
   /** Returns the tile data. */
   void* data() const;
 
+  /**
+   * If the tile aliases external data, it copies them into its own buffer,
+   * so that they can be safely modified.
+   */
+  Status detach();
+
   /** Returns the number of dimensions (0 if this is an attribute tile). */
   unsigned int dim_num() const;
 
   /** Checks if the tile is empty. */
   bool empty() const;
 
+  /** Returns the filters run on the tile before compression. */
+  const std::vector<Filter>& filters() const;
+
   /** Checks if the tile is full. */
   bool full() const;
 
@@ -173,6 +198,9 @@ class Tile {
   /** Resets the tile size. */
   void reset_size();
 
+  /** Sets the filters run on the tile before compression. */
+  void set_filters(const std::vector<Filter>& filters);
+
   /** Sets the tile offset. */
   void set_offset(uint64_t offset);
 
@@ -234,6 +262,9 @@ class Tile {
   /*         PRIVATE ATTRIBUTES        */
   /* ********************************* */
 
+  /** *true* if the tile aliases external data (see *alias*). */
+  bool aliased_;
+
   /** Local buffer that stores the tile data. */
   Buffer* buffer_;
 
@@ -252,6 +283,9 @@ class Tile {
    */
   unsigned int dim_num_;
 
+  /** The filters run on the tile before compression. */
+  std::vector<Filter> filters_;
+
   /**
    * If *true* the tile object will delete *buff* upon
    * destruction, otherwise it will not delete it.
@@ -43,6 +43,9 @@
 #include "tile.h"
 #include "uri.h"
 
+#include <functional>
+#include <vector>
+
 namespace tiledb {
 
 class StorageManager;
@@ -79,9 +82,30 @@ class TileIO {
   /*                API                */
   /* ********************************* */
 
+  /**
+   * Compresses a tile into a buffer, without writing it to the file (see
+   * *write_compressed*). The buffer is left empty if the tile is not
+   * compressed. It may be invoked concurrently, as long as each invocation
+   * uses a different tile and buffer.
+   *
+   * @param tile The tile to be compressed.
+   * @param buffer The buffer that will hold the compressed tile.
+   * @return Status
+   */
+  Status compress(Tile* tile, Buffer* buffer) const;
+
   /** Retrieves the size of the file. */
   Status file_size(uint64_t* size) const;
 
+  /**
+   * Writes any tile data that are still buffered or staged in main memory
+   * (see *write* and *set_direct_write*) to the file. It must be invoked
+   * after the last tile write.
+   *
+   * @return Status
+   */
+  Status flush();
+
   /**
    * Reads into a tile from the file.
    *
@@ -97,6 +121,31 @@ class TileIO {
       uint64_t compressed_size,
       uint64_t tile_size);
 
+  /**
+   * Reads into a tile from the file, coalescing the read with those of
+   * other tiles that lie nearby in the file and are about to be read as well.
+   * Specifically, if the tile is not in the data fetched by the previous
+   * coalesced read, the tiles of *tile_plan* that follow it are fetched along
+   * with it. Tiles that lie within Config::tile_coalesce_gap_size bytes of
+   * each other are fetched in a single contiguous region, and the resulting
+   * regions (up to constants::tile_coalesce_region_num) are all read at once
+   * with asynchronous I/O. The total read does not exceed
+   * constants::tile_coalesce_max_size bytes.
+   *
+   * @param tile The tile to read into.
+   * @param tile_i The position of the tile in the file.
+   * @param tile_offsets The file offsets of all the tiles in the file.
+   * @param tile_plan The sorted positions of the tiles that will be read.
+   * @param tile_size The size of the decompressed tile.
+   * @return Status.
+   */
+  Status read(
+      Tile* tile,
+      uint64_t tile_i,
+      const std::vector<uint64_t>& tile_offsets,
+      const std::vector<uint64_t>& tile_plan,
+      uint64_t tile_size);
+
   /**
    * Reads a generic tile from the file. This means that there are not tile
    * metadata kept anywhere except for the file. Therefore, the function
@@ -130,7 +179,47 @@ class TileIO {
       uint64_t* header_size);
 
   /**
-   * Writes (appends) a tile into the file.
+   * Makes the subsequent tile writes bypass the page cache, if the file is
+   * a new POSIX file. The tiles are accumulated in a staging buffer of
+   * constants::direct_io_buffer_size bytes aligned to
+   * constants::direct_io_alignment, which is written to the file with
+   * direct I/O whenever it fills up. The last, partially filled buffer is
+   * written upon *flush*, padded to the alignment, after which the file is
+   * truncated to its actual size.
+   *
+   * @return Status
+   */
+  Status set_direct_write();
+
+  /**
+   * Sets the file data mapped in main memory (read-only). Subsequent
+   * coalesced reads (see *read*) are then served directly from the
+   * mapped data: uncompressed tiles alias them, whereas compressed tiles are
+   * decompressed from them. The mapping is not owned by this object (the
+   * fragment metadata own it, see *FragmentMetadata::map_file*), and it must
+   * outlive both this object and the tiles read.
+   *
+   * @param data The mapped file data.
+   * @param size The size of the mapped file data.
+   */
+  void set_mapped_file(void* data, uint64_t size);
+
+  /**
+   * Sets the maximum size of the write-behind buffer (see *write*). By
+   * default, it is constants::tile_write_buffer_size. It must be invoked
+   * before the first tile write.
+   *
+   * @param size The maximum buffer size.
+   */
+  void set_write_buffer_size(uint64_t size);
+
+  /**
+   * Writes (appends) a tile into the file. The tile is actually accumulated
+   * with the subsequent ones in a write-behind buffer of up to
+   * *write_buffer_size* bytes (see *set_write_buffer_size*), which is
+   * appended to the file as a whole when it fills up or upon *flush*. The
+   * buffer grows with the buffered tiles, rather than being allocated in
+   * full upfront. Larger tiles are appended directly.
    *
    * @param tile The tile to be written.
    * @param bytes_written The actual number of bytes written. This may be
@@ -140,6 +229,17 @@ class TileIO {
    */
   Status write(Tile* tile, uint64_t* bytes_written);
 
+  /**
+   * Writes (appends) a tile previously compressed with *compress* into the
+   * file, in the same manner as *write*.
+   *
+   * @param tile The tile to be written.
+   * @param buffer The buffer holding the compressed tile.
+   * @param bytes_written The actual number of bytes written.
+   * @return Status.
+   */
+  Status write_compressed(Tile* tile, Buffer* buffer, uint64_t* bytes_written);
+
   /**
    * Writes a tile generically to the file. This means that a header will be
    * prepended to the file before writing the tile contents. The reason is
@@ -147,9 +247,11 @@ class TileIO {
    * other thant the file itself.
    *
    * @param tile The tile to be written.
+   * @param bytes_written The number of bytes written to the file, including
+   *     the header.
    * @return Status
    */
-  Status write_generic(Tile* tile);
+  Status write_generic(Tile* tile, uint64_t* bytes_written);
 
   /**
    * Writes the generic tile header to the file.
@@ -157,11 +259,27 @@ class TileIO {
    * @param tile The tile whose header will be written.
    * @param compressed_size The size that the (potentially) compressed tile
    *     will occupy in the file.
+   * @param header_size The size of the header written to the file.
    * @return Status
    */
-  Status write_generic_tile_header(Tile* tile, uint64_t compressed_size);
+  Status write_generic_tile_header(
+      Tile* tile, uint64_t compressed_size, uint64_t* header_size);
 
  private:
+  /* ********************************* */
+  /*          PRIVATE TYPES            */
+  /* ********************************* */
+
+  /** A contiguous file region fetched by a coalesced read. */
+  struct Segment {
+    /** The file offset the region starts from. */
+    uint64_t file_offset_;
+    /** The size of the region. */
+    uint64_t size_;
+    /** The offset of the region data in *coalesced_buffer_*. */
+    uint64_t buffer_offset_;
+  };
+
   /* ********************************* */
   /*         PRIVATE ATTRIBUTES        */
   /* ********************************* */
@@ -175,6 +293,48 @@ class TileIO {
    */
   Buffer* buffer_;
 
+  /** The data fetched by the last coalesced read. */
+  Buffer* coalesced_buffer_;
+
+  /**
+   * The file regions fetched by the last coalesced read, sorted on their
+   * file offsets.
+   */
+  std::vector<Segment> coalesced_segments_;
+
+  /**
+   * The file size, cached upon the first coalesced read (the files read
+   * this way belong to finalized fragments and never change).
+   */
+  uint64_t file_size_;
+
+  /**
+   * The mapped file data (*nullptr* if the file is not mapped). The mapping
+   * is not owned by this object.
+   */
+  void* mapped_data_;
+
+  /**
+   * Aligned buffer that stages the tiles written with direct I/O
+   * (*nullptr* if direct I/O is not used).
+   */
+  void* staging_buffer_;
+
+  /** The file offset the staged data will be written at. */
+  uint64_t staging_offset_;
+
+  /** The size of the staged data. */
+  uint64_t staging_size_;
+
+  /**
+   * The write-behind buffer that accumulates the written tiles (*nullptr*
+   * until the first write).
+   */
+  Buffer* write_buffer_;
+
+  /** The maximum size of the write-behind buffer. */
+  uint64_t write_buffer_size_;
+
 <<<<<<< HEAD
   /** Config object. */
   const Config* config_;
@@ -188,23 +348,39 @@ class TileIO {
   /* ********************************* */
 
   /**
-   * Compresses a tile. The compressed data are written in buffer_.
+   * Compresses a tile. The compressed data are appended to *buffer*.
    * Note that a coordinates tile must be split into one tile per
    * dimension. In that case *compress_one_tile* will be invoked
    * for each dimension sub-tile.
    *
    * @param tile The tile to be compressed.
+   * @param buffer The buffer the compressed data are written to.
    * @return Status
    */
-  Status compress_tile(Tile* tile);
+  Status compress_tile(Tile* tile, Buffer* buffer) const;
 
   /**
-   * Compresses a single tile. The compressed data are written in buffer_.
+   * Compresses a single tile. The compressed data are appended to *buffer*.
+   * The tile is split into chunks (see *compute_chunking_info*), which are
+   * compressed in parallel.
    *
    * @param tile The tile to be compressed.
+   * @param buffer The buffer the compressed data are written to.
    * @return Status
    */
-  Status compress_one_tile(Tile* tile);
+  Status compress_one_tile(Tile* tile, Buffer* buffer) const;
+
+  /**
+   * Runs the filters of the tile on a tile chunk, and compresses their
+   * output with the compressor of the tile.
+   *
+   * @param tile The tile the chunk belongs to.
+   * @param input_buffer The chunk data.
+   * @param output_buffer The buffer the compressed chunk is written to.
+   * @return Status
+   */
+  Status compress_chunk(
+      Tile* tile, ConstBuffer* input_buffer, Buffer* output_buffer) const;
 
   /**
    * Computes necessary info for chunking a tile upon compression.
@@ -219,29 +395,84 @@ class TileIO {
       Tile* tile,
       uint64_t* chunk_num,
       uint64_t* max_chunk_size,
-      uint64_t* overhead);
+      uint64_t* overhead) const;
 
   /**
-   * Decompresses buffer_ into a tile.
+   * Decompresses a buffer into a tile.
    * Note that a coordinates tile was split into one tile per
    * dimension. In that case *decompress_one_tile* will be invoked
    * for each dimension sub-tile.
    *
+   * @param buffer The buffer with the compressed data.
    * @param tile The tile where the decompressed data will be stored.
    * @return Status
    */
-  Status decompress_tile(Tile* tile);
+  Status decompress_tile(Buffer* buffer, Tile* tile) const;
 
   /**
-   * Decompresses buffer_ into a tile.
+   * Decompresses a buffer into a tile. The chunks of the tile are
+   * decompressed in parallel, each directly into its position in the tile.
    *
+   * @param buffer The buffer with the compressed data.
    * @param tile The tile where the decompressed data will be stored.
    * @return Status
    */
-  Status decompress_one_tile(Tile* tile);
+  Status decompress_one_tile(Buffer* buffer, Tile* tile) const;
+
+  /**
+   * Decompresses a tile chunk with the compressor of the tile, and reverses
+   * the filters of the tile on the decompressed data.
+   *
+   * @param tile The tile the chunk belongs to.
+   * @param input_buffer The compressed chunk.
+   * @param output_buffer The buffer the chunk is decompressed into.
+   * @return Status
+   */
+  Status decompress_chunk(
+      Tile* tile, ConstBuffer* input_buffer, Buffer* output_buffer) const;
+
+  /**
+   * Invokes a function on the chunks of a tile, in parallel in the thread
+   * pool of the storage manager.
+   *
+   * @param chunk_num The number of chunks.
+   * @param func The function, which receives the chunk index.
+   * @return Status
+   */
+  Status for_each_chunk(
+      uint64_t chunk_num, const std::function<Status(uint64_t)>& func) const;
 
   /** Computes the compression overhead on *nbytes* of the input tile. */
   uint64_t overhead(Tile* tile, uint64_t nbytes) const;
+
+  /**
+   * Appends data to the direct I/O staging buffer, writing the buffer to
+   * the file every time it fills up.
+   *
+   * @param data The data to append.
+   * @param nbytes The size of the data.
+   * @return Status
+   */
+  Status stage(const void* data, uint64_t nbytes);
+
+  /**
+   * Reads into a tile from (potentially compressed) tile data that are
+   * already in main memory.
+   *
+   * @param tile The tile to read into.
+   * @param data The tile data.
+   * @param compressed_size The size of the tile data.
+   * @param tile_size The size of the decompressed tile.
+   * @param alias If *true* and the tile is not compressed, the tile aliases
+   *     *data* instead of copying them.
+   * @return Status
+   */
+  Status read_from_memory(
+      Tile* tile,
+      void* data,
+      uint64_t compressed_size,
+      uint64_t tile_size,
+      bool alias);
 };
 
 }  // namespace tiledb
@@ -212,6 +212,38 @@ Status ArrayMetadata::check() const {
     return LOG_STATUS(Status::ArrayMetadataError(
         "Array metadata check failed; No attributes provided"));
 
+  if (cell_order_ != Layout::ROW_MAJOR && cell_order_ != Layout::COL_MAJOR &&
+      cell_order_ != Layout::HILBERT)
+    return LOG_STATUS(Status::ArrayMetadataError(
+        "Array metadata check failed; The cell order must be row-major, "
+        "column-major or Hilbert"));
+
+  if (cell_order_ == Layout::HILBERT && array_type_ == ArrayType::DENSE)
+    return LOG_STATUS(Status::ArrayMetadataError(
+        "Array metadata check failed; The Hilbert cell order can be used "
+        "only in sparse arrays"));
+
+  if (cell_order_ == Layout::HILBERT && dim_num() > 64)
+    return LOG_STATUS(Status::ArrayMetadataError(
+        "Array metadata check failed; The Hilbert cell order can be used "
+        "with up to 64 dimensions"));
+
+  if (tile_order_ != Layout::ROW_MAJOR && tile_order_ != Layout::COL_MAJOR &&
+      tile_order_ != Layout::MORTON)
+    return LOG_STATUS(Status::ArrayMetadataError(
+        "Array metadata check failed; The tile order must be row-major, "
+        "column-major or Morton"));
+
+  if (tile_order_ == Layout::MORTON && array_type_ == ArrayType::SPARSE)
+    return LOG_STATUS(Status::ArrayMetadataError(
+        "Array metadata check failed; The Morton tile order can be used "
+        "only in dense arrays"));
+
+  if (!check_attribute_filters())
+    return LOG_STATUS(Status::ArrayMetadataError(
+        "Array metadata check failed; Attribute filters are invalid or "
+        "used without a compressor"));
+
   if (!check_double_delta_compressor())
     return LOG_STATUS(Status::ArrayMetadataError(
         "Array metadata check failed; Double delta compression can be used "
@@ -331,6 +363,13 @@ Status ArrayMetadata::get_attribute_ids(
 //   attribute #1
 //   attribute #2
 //   ...
+// attribute filters (absent in arrays created by previous versions)
+//   filter_num #1 (unsigned int)
+//     filter #1.1 (char)
+//     filter #1.2 (char)
+//     ...
+//   filter_num #2 (unsigned int)
+//   ...
 Status ArrayMetadata::serialize(Buffer* buff) const {
   // Write version
   RETURN_NOT_OK(buff->write(constants::version, sizeof(constants::version)));
@@ -366,6 +405,16 @@ Status ArrayMetadata::serialize(Buffer* buff) const {
   for (auto& attr : attributes_)
     RETURN_NOT_OK(attr->serialize(buff));
 
+  // Write attribute filters
+  for (auto& attr : attributes_) {
+    auto filter_num = (unsigned int)attr->filters().size();
+    RETURN_NOT_OK(buff->write(&filter_num, sizeof(unsigned int)));
+    for (auto filter : attr->filters()) {
+      auto filter_c = (char)filter;
+      RETURN_NOT_OK(buff->write(&filter_c, sizeof(char)));
+    }
+  }
+
   return Status::Ok();
 }
 
@@ -423,6 +472,13 @@ void ArrayMetadata::add_attribute(const Attribute* attr) {
 //   attribute #1
 //   attribute #2
 //   ...
+// attribute filters (absent in arrays created by previous versions)
+//   filter_num #1 (unsigned int)
+//     filter #1.1 (char)
+//     filter #1.2 (char)
+//     ...
+//   filter_num #2 (unsigned int)
+//   ...
 Status ArrayMetadata::deserialize(ConstBuffer* buff) {
   // Load version
   RETURN_NOT_OK(buff->read(version_, sizeof(version_)));
@@ -469,6 +525,19 @@ Status ArrayMetadata::deserialize(ConstBuffer* buff) {
     attributes_.emplace_back(attr);
   }
 
+  // Load attribute filters
+  if (!buff->end()) {
+    for (auto& attr : attributes_) {
+      unsigned int filter_num;
+      RETURN_NOT_OK(buff->read(&filter_num, sizeof(unsigned int)));
+      for (unsigned int i = 0; i < filter_num; ++i) {
+        char filter;
+        RETURN_NOT_OK(buff->read(&filter, sizeof(char)));
+        attr->add_filter((Filter)filter);
+      }
+    }
+  }
+
   // Initialize the rest of the object members
   RETURN_NOT_OK(init());
 
@@ -541,6 +610,21 @@ bool ArrayMetadata::check_attribute_dimension_names() const {
   return (names.size() == attribute_num_ + dim_num);
 }
 
+bool ArrayMetadata::check_attribute_filters() const {
+  for (auto attr : attributes_) {
+    if (!attr->filters().empty() &&
+        attr->compressor() == Compressor::NO_COMPRESSION)
+      return false;
+    for (auto filter : attr->filters()) {
+      if (filter != Filter::DELTA && filter != Filter::BYTESHUFFLE &&
+          filter != Filter::BITSHUFFLE)
+        return false;
+    }
+  }
+
+  return true;
+}
+
 bool ArrayMetadata::check_double_delta_compressor() const {
   // Check coordinates
   if ((domain_->type() == Datatype::FLOAT32 ||
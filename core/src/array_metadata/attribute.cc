@@ -71,6 +71,7 @@ Attribute::Attribute(const Attribute* attr) {
   cell_val_num_ = attr->cell_val_num();
   compressor_ = attr->compressor();
   compression_level_ = attr->compression_level();
+  filters_ = attr->filters();
 }
 
 Attribute::~Attribute() = default;
@@ -79,6 +80,10 @@ Attribute::~Attribute() = default;
 /*                API                */
 /* ********************************* */
 
+void Attribute::add_filter(Filter filter) {
+  filters_.push_back(filter);
+}
+
 uint64_t Attribute::cell_size() const {
   if (var_size())
 <<<<<<< HEAD:core/src/array/attribute.cc
@@ -146,6 +151,12 @@ void Attribute::dump(FILE* out) const {
   fprintf(out, "- Type: %s\n", type_s);
   fprintf(out, "- Compressor: %s\n", compressor_s);
   fprintf(out, "- Compression level: %d\n", compression_level_);
+  if (!filters_.empty()) {
+    fprintf(out, "- Filters: %s", filter_str(filters_[0]));
+    for (size_t i = 1; i < filters_.size(); ++i)
+      fprintf(out, ", %s", filter_str(filters_[i]));
+    fprintf(out, "\n");
+  }
 
   if (!var_size())
     fprintf(out, "- Cell val num: %u\n", cell_val_num_);
@@ -153,6 +164,10 @@ void Attribute::dump(FILE* out) const {
     fprintf(out, "- Cell val num: var\n");
 }
 
+const std::vector<Filter>& Attribute::filters() const {
+  return filters_;
+}
+
 const std::string& Attribute::name() const {
   return name_;
 }
@@ -34,6 +34,7 @@
 #include "const_buffer.h"
 #include "logger.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -152,7 +153,13 @@ int Domain::cell_order_cmp(const T* coords_a, const T* coords_b) const {
   if (std::memcmp(coords_a, coords_b, dim_num_ * datatype_size(type_)) == 0)
     return 0;
 
-  // Check for precedence
+  // Check for precedence, breaking Hilbert key ties in row-major order
+  if (cell_order_ == Layout::HILBERT) {
+    uint64_t key_a = hilbert_key(coords_a);
+    uint64_t key_b = hilbert_key(coords_b);
+    if (key_a != key_b)
+      return (key_a < key_b) ? -1 : 1;
+  }
   if (cell_order_ == Layout::COL_MAJOR) {  // COLUMN-MAJOR
     for (unsigned int i = dim_num_ - 1;; --i) {
       if (coords_a[i] < coords_b[i])
@@ -162,7 +169,9 @@ int Domain::cell_order_cmp(const T* coords_a, const T* coords_b) const {
       if (i == 0)
         break;
     }
-  } else if (cell_order_ == Layout::ROW_MAJOR) {  // ROW-MAJOR
+  } else if (
+      cell_order_ == Layout::ROW_MAJOR ||
+      cell_order_ == Layout::HILBERT) {  // ROW-MAJOR
     for (unsigned int i = 0; i < dim_num_; ++i) {
       if (coords_a[i] < coords_b[i])
         return -1;
@@ -321,6 +330,8 @@ void Domain::get_next_tile_coords(const T* domain, T* tile_coords) const {
     get_next_tile_coords_row(domain, tile_coords);
   else if (tile_order_ == Layout::COL_MAJOR)
     get_next_tile_coords_col(domain, tile_coords);
+  else if (tile_order_ == Layout::MORTON)
+    get_next_tile_coords_morton(domain, tile_coords);
   else  // Sanity check
     assert(0);
 }
@@ -371,8 +382,10 @@ uint64_t Domain::get_tile_pos(const T* tile_coords) const {
   // Invoke the proper function based on the tile order
   if (tile_order_ == Layout::ROW_MAJOR)
     return get_tile_pos_row(tile_coords);
+  if (tile_order_ == Layout::MORTON)
+    return get_tile_pos_morton(tile_coords);
 
-  // ROW MAJOR
+  // COL_MAJOR
   return get_tile_pos_col(tile_coords);
 }
 
@@ -384,6 +397,8 @@ uint64_t Domain::get_tile_pos(const T* domain, const T* tile_coords) const {
   // Invoke the proper function based on the tile order
   if (tile_order_ == Layout::ROW_MAJOR)
     return get_tile_pos_row(domain, tile_coords);
+  if (tile_order_ == Layout::MORTON)
+    return get_tile_pos_morton(domain, tile_coords);
   // COL_MAJOR
   return get_tile_pos_col(domain, tile_coords);
 }
@@ -401,6 +416,60 @@ void Domain::get_tile_subarray(const T* tile_coords, T* tile_subarray) const {
   }
 }
 
+template <class T>
+uint64_t Domain::hilbert_key(const T* coords) const {
+  // For easy reference
+  auto domain = static_cast<const T*>(domain_);
+  unsigned int bits = std::min(64 / dim_num_, 32u);
+  if (bits == 0)
+    return 0;
+  uint64_t max = ((uint64_t)1 << bits) - 1;
+
+  // Map the coordinates onto the grid, monotonically
+  uint64_t x[64];
+  for (unsigned int i = 0; i < dim_num_; ++i) {
+    double range = (double)domain[2 * i + 1] - (double)domain[2 * i];
+    double offset = std::max((double)coords[i] - (double)domain[2 * i], 0.0);
+    if (range > (double)max)
+      offset = offset / range * (double)max;
+    x[i] = std::min((uint64_t)offset, max);
+  }
+
+  // Transpose the grid coordinates into the Hilbert index (J. Skilling,
+  // "Programming the Hilbert curve", 2004)
+  uint64_t m = (uint64_t)1 << (bits - 1);
+  for (uint64_t q = m; q > 1; q >>= 1) {
+    uint64_t p = q - 1;
+    for (unsigned int i = 0; i < dim_num_; ++i) {
+      if (x[i] & q) {
+        x[0] ^= p;
+      } else {
+        uint64_t t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  for (unsigned int i = 1; i < dim_num_; ++i)
+    x[i] ^= x[i - 1];
+  uint64_t t = 0;
+  for (uint64_t q = m; q > 1; q >>= 1) {
+    if (x[dim_num_ - 1] & q)
+      t ^= q - 1;
+  }
+  for (unsigned int i = 0; i < dim_num_; ++i)
+    x[i] ^= t;
+
+  // Interleave the bits of the transposed index, most significant first
+  uint64_t key = 0;
+  for (unsigned int b = bits; b-- > 0;) {
+    for (unsigned int i = 0; i < dim_num_; ++i)
+      key = (key << 1) | ((x[i] >> b) & 1);
+  }
+
+  return key;
+}
+
 Status Domain::init(Layout cell_order, Layout tile_order) {
   // Set cell and tile order
   cell_order_ = cell_order;
@@ -588,8 +657,8 @@ unsigned int Domain::subarray_overlap(
     }
   }
 
-  // Check contig overlap
-  if (overlap == 2 && dim_num_ > 1) {
+  // Check contig overlap (the Hilbert cell order is never contiguous)
+  if (overlap == 2 && dim_num_ > 1 && cell_order_ != Layout::HILBERT) {
     overlap = 3;
     if (cell_order_ == Layout::ROW_MAJOR) {  // Row major
       for (unsigned int i = 1; i < dim_num_; ++i) {
@@ -835,6 +904,10 @@ Datatype Domain::type() const {
 /* ****************************** */
 
 void Domain::compute_cell_num_per_tile() {
+  // Applicable only to non-NULL space tiles
+  if (tile_extents_ == nullptr)
+    return;
+
   // Invoke the proper templated function
   switch (type_) {
     case Datatype::INT32:
@@ -1137,6 +1210,38 @@ void Domain::get_next_tile_coords_col(const T* domain, T* tile_coords) const {
   }
 }
 
+template <class T>
+void Domain::get_next_tile_coords_morton(
+    const T* domain, T* tile_coords) const {
+  // Convert to unsigned tile coordinates, on the stack for up to 3 dimensions
+  uint64_t stack_buf[9];
+  std::vector<uint64_t> heap_buf((dim_num_ > 3) ? 3 * dim_num_ : 0);
+  uint64_t* morton_domain = (dim_num_ > 3) ? heap_buf.data() : stack_buf;
+  uint64_t* coords = morton_domain + 2 * dim_num_;
+  for (unsigned int i = 0; i < dim_num_; ++i) {
+    morton_domain[2 * i] = (uint64_t)domain[2 * i];
+    morton_domain[2 * i + 1] = (uint64_t)domain[2 * i + 1];
+    coords[i] = (uint64_t)tile_coords[i];
+  }
+
+  bool next;
+  if (dim_num_ == 2)
+    next = morton_next<2>(dim_num_, morton_domain, coords);
+  else if (dim_num_ == 3)
+    next = morton_next<3>(dim_num_, morton_domain, coords);
+  else
+    next = morton_next<0>(dim_num_, morton_domain, coords);
+
+  // Move past the end of the domain if there are no more tiles
+  if (!next) {
+    tile_coords[0] = domain[1] + 1;
+    return;
+  }
+
+  for (unsigned int i = 0; i < dim_num_; ++i)
+    tile_coords[i] = (T)coords[i];
+}
+
 template <class T>
 void Domain::get_next_tile_coords_row(const T* domain, T* tile_coords) const {
   unsigned int i = dim_num_ - 1;
@@ -1183,6 +1288,59 @@ uint64_t Domain::get_tile_pos_col(const T* domain, const T* tile_coords) const {
   return pos;
 }
 
+template <class T>
+uint64_t Domain::get_tile_pos_morton(const T* tile_coords) const {
+  // For easy reference
+  auto tile_domain = static_cast<const T*>(tile_domain_);
+
+  // Convert to unsigned tile coordinates, on the stack for up to 3 dimensions
+  uint64_t stack_buf[9];
+  std::vector<uint64_t> heap_buf((dim_num_ > 3) ? 3 * dim_num_ : 0);
+  uint64_t* morton_domain = (dim_num_ > 3) ? heap_buf.data() : stack_buf;
+  uint64_t* coords = morton_domain + 2 * dim_num_;
+  for (unsigned int i = 0; i < dim_num_; ++i) {
+    morton_domain[2 * i] = (uint64_t)tile_domain[2 * i];
+    morton_domain[2 * i + 1] = (uint64_t)tile_domain[2 * i + 1];
+    coords[i] = (uint64_t)tile_coords[i];
+  }
+
+  if (dim_num_ == 2)
+    return morton_rank<2>(dim_num_, morton_domain, coords);
+  if (dim_num_ == 3)
+    return morton_rank<3>(dim_num_, morton_domain, coords);
+  return morton_rank<0>(dim_num_, morton_domain, coords);
+}
+
+template <class T>
+uint64_t Domain::get_tile_pos_morton(
+    const T* domain, const T* tile_coords) const {
+  // For easy reference
+  auto array_domain = static_cast<const T*>(domain_);
+  auto tile_extents = static_cast<const T*>(tile_extents_);
+
+  // Map the input domain and tile coordinates to the tile coordinates of the
+  // array domain, on the stack for up to 3 dimensions
+  uint64_t stack_buf[9];
+  std::vector<uint64_t> heap_buf((dim_num_ > 3) ? 3 * dim_num_ : 0);
+  uint64_t* morton_domain = (dim_num_ > 3) ? heap_buf.data() : stack_buf;
+  uint64_t* coords = morton_domain + 2 * dim_num_;
+  for (unsigned int i = 0; i < dim_num_; ++i) {
+    auto offset = (uint64_t)((domain[2 * i] - array_domain[2 * i]) /
+                             tile_extents[i]);
+    auto tile_num = (uint64_t)((domain[2 * i + 1] - domain[2 * i] + 1) /
+                               tile_extents[i]);
+    morton_domain[2 * i] = offset;
+    morton_domain[2 * i + 1] = offset + tile_num - 1;
+    coords[i] = offset + (uint64_t)tile_coords[i];
+  }
+
+  if (dim_num_ == 2)
+    return morton_rank<2>(dim_num_, morton_domain, coords);
+  if (dim_num_ == 3)
+    return morton_rank<3>(dim_num_, morton_domain, coords);
+  return morton_rank<0>(dim_num_, morton_domain, coords);
+}
+
 template <class T>
 uint64_t Domain::get_tile_pos_row(const T* tile_coords) const {
   // Calculate position
@@ -1223,6 +1381,113 @@ uint64_t Domain::get_tile_pos_row(const T* domain, const T* tile_coords) const {
   return pos;
 }
 
+template <unsigned int N>
+bool Domain::morton_next(
+    unsigned int dim_num, const uint64_t* domain, uint64_t* tile_coords) {
+  // For easy reference
+  const unsigned int n = (N == 0) ? dim_num : N;
+  uint64_t stack_buf[3 * ((N == 0) ? 1 : N)];
+  std::vector<uint64_t> heap_buf((N == 0) ? 3 * n : 0);
+  uint64_t* cell = (N == 0) ? heap_buf.data() : stack_buf;
+  uint64_t* next = cell + 2 * n;
+
+  // The number of bits of the largest coordinate
+  uint64_t max = 0;
+  for (unsigned int i = 0; i < n; ++i)
+    max |= domain[2 * i + 1];
+  unsigned int bits = 0;
+  while (bits < 64 && (max >> bits) != 0)
+    ++bits;
+
+  // Descend the Morton cells that contain the tile. Every time the tile is in
+  // the lower half of a cell, the upper half follows it; the next tile is the
+  // first one in the domain within the last such half
+  for (unsigned int i = 0; i < n; ++i) {
+    cell[2 * i] = 0;
+    cell[2 * i + 1] = (bits == 64) ? UINT64_MAX : ((uint64_t)1 << bits) - 1;
+  }
+  bool found = false;
+  for (unsigned int b = bits; b-- > 0;) {
+    for (unsigned int d = 0; d < n; ++d) {
+      uint64_t mid = cell[2 * d] + ((uint64_t)1 << b);
+      if ((tile_coords[d] >> b) & 1) {
+        cell[2 * d] = mid;
+        continue;
+      }
+
+      bool overlap = true;
+      for (unsigned int i = 0; i < n && overlap; ++i) {
+        uint64_t low = (i == d) ? mid : cell[2 * i];
+        overlap = std::max(low, domain[2 * i]) <=
+                  std::min(cell[2 * i + 1], domain[2 * i + 1]);
+      }
+      if (overlap) {
+        found = true;
+        for (unsigned int i = 0; i < n; ++i)
+          next[i] = std::max((i == d) ? mid : cell[2 * i], domain[2 * i]);
+      }
+      cell[2 * d + 1] = mid - 1;
+    }
+  }
+
+  if (!found)
+    return false;
+
+  for (unsigned int i = 0; i < n; ++i)
+    tile_coords[i] = next[i];
+  return true;
+}
+
+template <unsigned int N>
+uint64_t Domain::morton_rank(
+    unsigned int dim_num,
+    const uint64_t* domain,
+    const uint64_t* tile_coords) {
+  // For easy reference
+  const unsigned int n = (N == 0) ? dim_num : N;
+  uint64_t stack_buf[2 * ((N == 0) ? 1 : N)];
+  std::vector<uint64_t> heap_buf((N == 0) ? 2 * n : 0);
+  uint64_t* cell = (N == 0) ? heap_buf.data() : stack_buf;
+
+  // The number of bits of the largest coordinate
+  uint64_t max = 0;
+  for (unsigned int i = 0; i < n; ++i)
+    max |= domain[2 * i + 1];
+  unsigned int bits = 0;
+  while (bits < 64 && (max >> bits) != 0)
+    ++bits;
+
+  // Descend the Morton cells that contain the tile. Every time the tile is in
+  // the upper half of a cell, the tiles of the domain in the lower half
+  // precede it
+  for (unsigned int i = 0; i < n; ++i) {
+    cell[2 * i] = 0;
+    cell[2 * i + 1] = (bits == 64) ? UINT64_MAX : ((uint64_t)1 << bits) - 1;
+  }
+  uint64_t rank = 0;
+  for (unsigned int b = bits; b-- > 0;) {
+    for (unsigned int d = 0; d < n; ++d) {
+      uint64_t mid = cell[2 * d] + ((uint64_t)1 << b);
+      if (((tile_coords[d] >> b) & 1) == 0) {
+        cell[2 * d + 1] = mid - 1;
+        continue;
+      }
+
+      uint64_t tile_num = 1;
+      for (unsigned int i = 0; i < n && tile_num != 0; ++i) {
+        uint64_t low = std::max(cell[2 * i], domain[2 * i]);
+        uint64_t high =
+            std::min((i == d) ? mid - 1 : cell[2 * i + 1], domain[2 * i + 1]);
+        tile_num *= (low <= high) ? high - low + 1 : 0;
+      }
+      rank += tile_num;
+      cell[2 * d] = mid;
+    }
+  }
+
+  return rank;
+}
+
 template <class T>
 uint64_t Domain::tile_slab_col_cell_num(const T* subarray) const {
   // For easy reference
@@ -1441,6 +1706,17 @@ template void Domain::get_tile_subarray<uint32_t>(
 template void Domain::get_tile_subarray<uint64_t>(
     const uint64_t* tile_coords, uint64_t* tile_subarray) const;
 
+template uint64_t Domain::hilbert_key<int>(const int* coords) const;
+template uint64_t Domain::hilbert_key<int64_t>(const int64_t* coords) const;
+template uint64_t Domain::hilbert_key<float>(const float* coords) const;
+template uint64_t Domain::hilbert_key<double>(const double* coords) const;
+template uint64_t Domain::hilbert_key<int8_t>(const int8_t* coords) const;
+template uint64_t Domain::hilbert_key<uint8_t>(const uint8_t* coords) const;
+template uint64_t Domain::hilbert_key<int16_t>(const int16_t* coords) const;
+template uint64_t Domain::hilbert_key<uint16_t>(const uint16_t* coords) const;
+template uint64_t Domain::hilbert_key<uint32_t>(const uint32_t* coords) const;
+template uint64_t Domain::hilbert_key<uint64_t>(const uint64_t* coords) const;
+
 template bool Domain::is_contained_in_tile_slab_col<int>(
     const int* range) const;
 template bool Domain::is_contained_in_tile_slab_col<int64_t>(
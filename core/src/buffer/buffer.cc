@@ -61,7 +61,7 @@ Buffer::Buffer(void* data, uint64_t size, bool owns_data)
     , owns_data_(owns_data)
     , size_(size) {
   offset_ = 0;
-  alloced_size_ = 0;
+  alloced_size_ = size;
   owns_data_ = false;
 }
 
@@ -93,6 +93,10 @@ struct tiledb_config_t {
   tiledb::Config* config_;
 =======
   std::mutex* mtx_;
+};
+
+struct tiledb_config_t {
+  tiledb::Config* config_;
 >>>>>>> upstream/dev
 };
 
@@ -177,6 +181,14 @@ inline int sanity_check(tiledb_ctx_t* ctx, const tiledb_config_t* config) {
 }
 
 =======
+inline int sanity_check(tiledb_ctx_t* ctx, const tiledb_config_t* config) {
+  if (config == nullptr || config->config_ == nullptr) {
+    save_error(ctx, tiledb::Status::Error("Invalid TileDB config struct"));
+    return TILEDB_ERR;
+  }
+  return TILEDB_OK;
+}
+
 >>>>>>> upstream/dev
 inline int sanity_check(tiledb_ctx_t* ctx, const tiledb_error_t* err) {
   if (err == nullptr || err->status_ == nullptr) {
@@ -324,16 +336,140 @@ int tiledb_config_create(tiledb_ctx_t* ctx, tiledb_config_t** config) {
         ctx,
         tiledb::Status::Error("Failed to allocate config object in struct"));
     return TILEDB_OOM;
+  }
+
+  // Always succeeds
+  return TILEDB_OK;
+}
 =======
     delete ctx->mtx_;
     std::free(ctx);
->>>>>>> upstream/dev
   }
 
   // Always succeeds
   return TILEDB_OK;
 }
 
+int tiledb_ctx_set_config(tiledb_ctx_t* ctx, tiledb_config_t* config) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, config) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (save_error(ctx, ctx->storage_manager_->set_config(config->config_)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+/* ********************************* */
+/*              CONFIG               */
+/* ********************************* */
+
+int tiledb_config_create(tiledb_ctx_t* ctx, tiledb_config_t** config) {
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Create a config struct
+  *config = (tiledb_config_t*)std::malloc(sizeof(tiledb_config_t));
+  if (*config == nullptr) {
+    save_error(
+        ctx, tiledb::Status::Error("Failed to allocate TileDB config struct"));
+    return TILEDB_OOM;
+  }
+
+  // Create a new Config object with the default parameters
+  (*config)->config_ = new tiledb::Config();
+  if ((*config)->config_ == nullptr) {
+    std::free(*config);
+    *config = nullptr;
+    save_error(
+        ctx,
+        tiledb::Status::Error(
+            "Failed to allocate TileDB config object in struct"));
+    return TILEDB_OOM;
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_config_free(tiledb_ctx_t* ctx, tiledb_config_t* config) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, config) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  delete config->config_;
+  std::free(config);
+
+  return TILEDB_OK;
+}
+
+int tiledb_config_set_thread_pool_size(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, unsigned int thread_pool_size) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, config) == TILEDB_ERR)
+    return TILEDB_ERR;
+  config->config_->set_thread_pool_size(thread_pool_size);
+  return TILEDB_OK;
+}
+
+int tiledb_config_set_metadata_cache_size(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, uint64_t metadata_cache_size) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, config) == TILEDB_ERR)
+    return TILEDB_ERR;
+  config->config_->set_metadata_cache_size(metadata_cache_size);
+  return TILEDB_OK;
+}
+
+int tiledb_config_set_tile_cache_size(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, uint64_t tile_cache_size) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, config) == TILEDB_ERR)
+    return TILEDB_ERR;
+  config->config_->set_tile_cache_size(tile_cache_size);
+  return TILEDB_OK;
+}
+
+int tiledb_config_set_tile_coalesce_gap_size(
+    tiledb_ctx_t* ctx,
+    tiledb_config_t* config,
+    uint64_t tile_coalesce_gap_size) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, config) == TILEDB_ERR)
+    return TILEDB_ERR;
+  config->config_->set_tile_coalesce_gap_size(tile_coalesce_gap_size);
+  return TILEDB_OK;
+}
+
+int tiledb_config_set_read_ahead(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, int read_ahead) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, config) == TILEDB_ERR)
+    return TILEDB_ERR;
+  config->config_->set_read_ahead(read_ahead != 0);
+  return TILEDB_OK;
+}
+
+int tiledb_config_set_read_thread_num(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, unsigned int read_thread_num) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, config) == TILEDB_ERR)
+    return TILEDB_ERR;
+  config->config_->set_read_thread_num(read_thread_num);
+  return TILEDB_OK;
+}
+
+int tiledb_config_set_tile_chunk_size(
+    tiledb_ctx_t* ctx, tiledb_config_t* config, uint64_t tile_chunk_size) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, config) == TILEDB_ERR)
+    return TILEDB_ERR;
+  config->config_->set_tile_chunk_size(tile_chunk_size);
+  return TILEDB_OK;
+}
+>>>>>>> upstream/dev
+
 /* ********************************* */
 /*              ERROR                */
 /* ********************************* */
@@ -484,6 +620,14 @@ int tiledb_attribute_set_compressor(
   return TILEDB_OK;
 }
 
+int tiledb_attribute_add_filter(
+    tiledb_ctx_t* ctx, tiledb_attribute_t* attr, tiledb_filter_t filter) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  attr->attr_->add_filter(static_cast<tiledb::Filter>(filter));
+  return TILEDB_OK;
+}
+
 int tiledb_attribute_set_cell_val_num(
     tiledb_ctx_t* ctx, tiledb_attribute_t* attr, unsigned int cell_val_num) {
   if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
@@ -522,6 +666,33 @@ int tiledb_attribute_get_compressor(
   return TILEDB_OK;
 }
 
+int tiledb_attribute_get_filter_num(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    unsigned int* filter_num) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  *filter_num = (unsigned int)attr->attr_->filters().size();
+  return TILEDB_OK;
+}
+
+int tiledb_attribute_get_filter(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    unsigned int index,
+    tiledb_filter_t* filter) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  if (index >= attr->attr_->filters().size()) {
+    save_error(
+        ctx,
+        tiledb::Status::Error("Cannot get attribute filter; Invalid index"));
+    return TILEDB_ERR;
+  }
+  *filter = static_cast<tiledb_filter_t>(attr->attr_->filters()[index]);
+  return TILEDB_OK;
+}
+
 int tiledb_attribute_get_cell_val_num(
     tiledb_ctx_t* ctx,
     const tiledb_attribute_t* attr,
@@ -1372,6 +1543,17 @@ int tiledb_query_reset_buffers(
   return TILEDB_OK;
 }
 
+int tiledb_query_set_read_thread_num(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, unsigned int read_thread_num) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  query->query_->set_read_thread_num(read_thread_num);
+
+  return TILEDB_OK;
+}
+
 int tiledb_query_get_status(
     tiledb_ctx_t* ctx, tiledb_query_t* query, tiledb_query_status_t* status) {
   // Sanity check
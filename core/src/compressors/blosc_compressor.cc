@@ -50,23 +50,27 @@ Status Blosc::compress(
     return LOG_STATUS(Status::CompressionError(
         "Failed compressing with Blosc; invalid buffer format"));
 
-  // Initialize Blosc compressor
-  if (blosc_set_compressor(compressor) < 0) {
+  // Check the Blosc compressor
+  if (blosc_compname_to_compcode(compressor) < 0) {
     return LOG_STATUS(Status::CompressionError(
         std::string(
             "Blosc compression error, failed to set Blosc compressor ") +
         compressor));
   }
 
-  // Compress
-  int rc = blosc_compress(
+  // Compress (the context variant does not use the global Blosc state, so
+  // tiles can be compressed concurrently)
+  int rc = blosc_compress_ctx(
       level < 0 ? Blosc::default_level() : level,
       1,  // shuffle
       type_size,
       input_buffer->size(),
       input_buffer->data(),
       output_buffer->cur_data(),
-      output_buffer->free_space());
+      output_buffer->free_space(),
+      compressor,
+      0,   // automatic block size
+      1);  // internal threads
 
   // Handle error
   if (rc < 0)
@@ -85,11 +89,12 @@ Status Blosc::decompress(ConstBuffer* input_buffer, Buffer* output_buffer) {
     return LOG_STATUS(Status::CompressionError(
         "Failed decompressing with Blosc; invalid buffer format"));
 
-  // Decompress
-  int rc = blosc_decompress(
+  // Decompress (the context variant is thread-safe)
+  int rc = blosc_decompress_ctx(
       input_buffer->data(),
       output_buffer->cur_data(),
-      output_buffer->free_space());
+      output_buffer->free_space(),
+      1);  // internal threads
 
   // Handle error
   if (rc <= 0)
@@ -33,24 +33,314 @@
 #include "dd_compressor.h"
 #include "logger.h"
 
+#include <cstring>
 #include <iostream>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DD_AVX2
+#include <immintrin.h>
+#endif
 
 /* ****************************** */
 /*             MACROS             */
 /* ****************************** */
 
-#define ABS(x) ((x) < 0) ? uint64_t(-(x)) : uint64_t(x)
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
-#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+#ifdef DD_AVX2
+#define DD_AVX2_TARGET __attribute__((target("avx2")))
+#endif
 
 namespace tiledb {
 
 const uint64_t DoubleDelta::OVERHEAD = 17;
 
 /* ****************************** */
-/*               API              */
+/*             KERNELS            */
 /* ****************************** */
 
+/**
+ * The value written in place of the bitsize, which marks the block format.
+ * The bitsizes of the previous format are in [1, 64].
+ */
+static const uint8_t DD_BLOCK_FORMAT = 0xFF;
+
+/** The number of interleaved lanes of a block. */
+static const uint64_t DD_LANE_NUM = 4;
+
+/** The number of double deltas in each lane of a block. */
+static const uint64_t DD_LANE_SIZE = 64;
+
+/** The number of double deltas in a block. */
+static const uint64_t DD_BLOCK_SIZE = DD_LANE_NUM * DD_LANE_SIZE;
+
+/**
+ * The kernels that encode, pack, unpack and decode the double deltas.
+ * The double deltas are zigzag encoded, so that small negative values have
+ * few significant bits. All arithmetic is modulo 2^64, which makes the
+ * double deltas of any values exactly reversible.
+ */
+struct DDKernels {
+  /**
+   * Computes the zigzag encoded double deltas of *values[2..num+1]* and
+   * returns the bitwise OR of all of them.
+   */
+  uint64_t (*encode)(const uint64_t* values, uint64_t num, uint64_t* zigzags);
+
+  /**
+   * Reconstructs *values[2..num+1]* from *values[0..1]* and the zigzag
+   * encoded double deltas.
+   */
+  void (*decode)(const uint64_t* zigzags, uint64_t num, uint64_t* values);
+
+  /** Packs a full block of zigzags into *DD_LANE_NUM * bitsize* words. */
+  void (*pack)(const uint64_t* zigzags, int bitsize, char* words);
+
+  /** Unpacks a full block of zigzags from *DD_LANE_NUM * bitsize* words. */
+  void (*unpack)(const char* words, int bitsize, uint64_t* zigzags);
+};
+
+/** Returns the number of bytes *num* zigzags of the input bitsize pack in. */
+static uint64_t dd_packed_size(uint64_t num, int bitsize) {
+  return (num * bitsize + 63) / 64 * sizeof(uint64_t);
+}
+
+/**
+ * Packs *num* zigzags, *stride* values apart, into consecutive bitsize
+ * fields of 64-bit words, which are *word_stride* words apart.
+ */
+static void dd_pack_lane(
+    const uint64_t* zigzags,
+    uint64_t num,
+    uint64_t stride,
+    int bitsize,
+    char* words,
+    uint64_t word_stride) {
+  uint64_t word = 0;
+  int offset = 0;
+  for (uint64_t i = 0; i < num; ++i) {
+    uint64_t zigzag = zigzags[i * stride];
+    word |= zigzag << offset;
+    offset += bitsize;
+    if (offset >= 64) {
+      std::memcpy(words, &word, sizeof(uint64_t));
+      words += word_stride * sizeof(uint64_t);
+      offset -= 64;
+      word = (offset > 0) ? zigzag >> (bitsize - offset) : 0;
+    }
+  }
+
+  // Write the last, partially filled word
+  if (offset > 0)
+    std::memcpy(words, &word, sizeof(uint64_t));
+}
+
+/** Inverse of *dd_pack_lane*. */
+static void dd_unpack_lane(
+    const char* words,
+    uint64_t word_stride,
+    int bitsize,
+    uint64_t num,
+    uint64_t stride,
+    uint64_t* zigzags) {
+  if (bitsize == 0) {
+    for (uint64_t i = 0; i < num; ++i)
+      zigzags[i * stride] = 0;
+    return;
+  }
+
+  uint64_t mask = (bitsize == 64) ? ~uint64_t(0) : (uint64_t(1) << bitsize) - 1;
+  uint64_t word;
+  std::memcpy(&word, words, sizeof(uint64_t));
+  int offset = 0;
+  for (uint64_t i = 0; i < num; ++i) {
+    uint64_t zigzag = word >> offset;
+    offset += bitsize;
+    if (offset >= 64) {
+      offset -= 64;
+      if (offset > 0 || i + 1 < num) {
+        words += word_stride * sizeof(uint64_t);
+        std::memcpy(&word, words, sizeof(uint64_t));
+      }
+      if (offset > 0)
+        zigzag |= word << (bitsize - offset);
+    }
+    zigzags[i * stride] = zigzag & mask;
+  }
+}
+
+static uint64_t dd_encode_scalar(
+    const uint64_t* values, uint64_t num, uint64_t* zigzags) {
+  uint64_t bits = 0;
+  for (uint64_t i = 0; i < num; ++i) {
+    uint64_t dd = values[i + 2] - 2 * values[i + 1] + values[i];
+    zigzags[i] = (dd << 1) ^ (0 - (dd >> 63));
+    bits |= zigzags[i];
+  }
+  return bits;
+}
+
+static void dd_decode_scalar(
+    const uint64_t* zigzags, uint64_t num, uint64_t* values) {
+  uint64_t delta = values[1] - values[0];
+  for (uint64_t i = 0; i < num; ++i) {
+    delta += (zigzags[i] >> 1) ^ (0 - (zigzags[i] & 1));
+    values[i + 2] = values[i + 1] + delta;
+  }
+}
+
+static void dd_pack_scalar(const uint64_t* zigzags, int bitsize, char* words) {
+  for (uint64_t l = 0; l < DD_LANE_NUM; ++l)
+    dd_pack_lane(
+        zigzags + l,
+        DD_LANE_SIZE,
+        DD_LANE_NUM,
+        bitsize,
+        words + l * sizeof(uint64_t),
+        DD_LANE_NUM);
+}
+
+static void dd_unpack_scalar(
+    const char* words, int bitsize, uint64_t* zigzags) {
+  for (uint64_t l = 0; l < DD_LANE_NUM; ++l)
+    dd_unpack_lane(
+        words + l * sizeof(uint64_t),
+        DD_LANE_NUM,
+        bitsize,
+        DD_LANE_SIZE,
+        DD_LANE_NUM,
+        zigzags + l);
+}
+
+#ifdef DD_AVX2
+
+/** Returns the inclusive prefix sum of the four 64-bit lanes. */
+DD_AVX2_TARGET static inline __m256i dd_prefix_sum_avx2(__m256i v) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i shifted = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 1, 0, 0));
+  v = _mm256_add_epi64(v, _mm256_blend_epi32(shifted, zero, 0x03));
+  shifted = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 0, 0));
+  return _mm256_add_epi64(v, _mm256_blend_epi32(shifted, zero, 0x0F));
+}
+
+DD_AVX2_TARGET static uint64_t dd_encode_avx2(
+    const uint64_t* values, uint64_t num, uint64_t* zigzags) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i bits = zero;
+  uint64_t i = 0;
+  for (; i + 4 <= num; i += 4) {
+    __m256i v0 = _mm256_loadu_si256((const __m256i*)(values + i));
+    __m256i v1 = _mm256_loadu_si256((const __m256i*)(values + i + 1));
+    __m256i v2 = _mm256_loadu_si256((const __m256i*)(values + i + 2));
+    __m256i dd =
+        _mm256_add_epi64(_mm256_sub_epi64(v2, _mm256_add_epi64(v1, v1)), v0);
+    __m256i zigzag = _mm256_xor_si256(
+        _mm256_slli_epi64(dd, 1), _mm256_cmpgt_epi64(zero, dd));
+    _mm256_storeu_si256((__m256i*)(zigzags + i), zigzag);
+    bits = _mm256_or_si256(bits, zigzag);
+  }
+
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i*)lanes, bits);
+  return lanes[0] | lanes[1] | lanes[2] | lanes[3] |
+         dd_encode_scalar(values + i, num - i, zigzags + i);
+}
+
+DD_AVX2_TARGET static void dd_decode_avx2(
+    const uint64_t* zigzags, uint64_t num, uint64_t* values) {
+  if (num < 4) {
+    dd_decode_scalar(zigzags, num, values);
+    return;
+  }
+
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi64x(1);
+  __m256i delta = _mm256_set1_epi64x(values[1] - values[0]);
+  __m256i value = _mm256_set1_epi64x(values[1]);
+  uint64_t i = 0;
+  for (; i + 4 <= num; i += 4) {
+    __m256i zigzag = _mm256_loadu_si256((const __m256i*)(zigzags + i));
+    __m256i dd = _mm256_xor_si256(
+        _mm256_srli_epi64(zigzag, 1),
+        _mm256_sub_epi64(zero, _mm256_and_si256(zigzag, one)));
+    delta = _mm256_add_epi64(dd_prefix_sum_avx2(dd), delta);
+    value = _mm256_add_epi64(dd_prefix_sum_avx2(delta), value);
+    _mm256_storeu_si256((__m256i*)(values + i + 2), value);
+
+    // Broadcast the last delta and value to the next four lanes
+    delta = _mm256_permute4x64_epi64(delta, _MM_SHUFFLE(3, 3, 3, 3));
+    value = _mm256_permute4x64_epi64(value, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+
+  dd_decode_scalar(zigzags + i, num - i, values + i);
+}
+
+DD_AVX2_TARGET static void dd_pack_avx2(
+    const uint64_t* zigzags, int bitsize, char* words) {
+  __m256i word = _mm256_setzero_si256();
+  int offset = 0;
+  for (uint64_t i = 0; i < DD_LANE_SIZE; ++i) {
+    __m256i zigzag =
+        _mm256_loadu_si256((const __m256i*)(zigzags + i * DD_LANE_NUM));
+    word = _mm256_or_si256(
+        word, _mm256_sll_epi64(zigzag, _mm_cvtsi32_si128(offset)));
+    offset += bitsize;
+    if (offset >= 64) {
+      _mm256_storeu_si256((__m256i*)words, word);
+      words += sizeof(__m256i);
+      offset -= 64;
+      // Shifts by 64 bits yield zero
+      word = _mm256_srl_epi64(zigzag, _mm_cvtsi32_si128(bitsize - offset));
+    }
+  }
+}
+
+DD_AVX2_TARGET static void dd_unpack_avx2(
+    const char* words, int bitsize, uint64_t* zigzags) {
+  const __m256i mask = _mm256_set1_epi64x(
+      (bitsize == 64) ? ~uint64_t(0) : (uint64_t(1) << bitsize) - 1);
+  __m256i word = (bitsize > 0) ?
+                     _mm256_loadu_si256((const __m256i*)words) :
+                     _mm256_setzero_si256();
+  int offset = 0;
+  for (uint64_t i = 0; i < DD_LANE_SIZE; ++i) {
+    __m256i zigzag = _mm256_srl_epi64(word, _mm_cvtsi32_si128(offset));
+    offset += bitsize;
+    if (offset >= 64) {
+      offset -= 64;
+      if (offset > 0 || i + 1 < DD_LANE_SIZE) {
+        words += sizeof(__m256i);
+        word = _mm256_loadu_si256((const __m256i*)words);
+      }
+      // The bits shifted in beyond the bitsize are masked out below
+      zigzag = _mm256_or_si256(
+          zigzag, _mm256_sll_epi64(word, _mm_cvtsi32_si128(bitsize - offset)));
+    }
+    _mm256_storeu_si256(
+        (__m256i*)(zigzags + i * DD_LANE_NUM), _mm256_and_si256(zigzag, mask));
+  }
+}
+
+#endif
+
+/** Returns the AVX2 kernels if the CPU supports them, else the scalar ones. */
+static const DDKernels& dd_kernels() {
+  static const DDKernels scalar = {
+      dd_encode_scalar, dd_decode_scalar, dd_pack_scalar, dd_unpack_scalar};
+#ifdef DD_AVX2
+  static const DDKernels avx2 = {
+      dd_encode_avx2, dd_decode_avx2, dd_pack_avx2, dd_unpack_avx2};
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (has_avx2)
+    return avx2;
+#endif
+  return scalar;
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
 Status DoubleDelta::compress(
     Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer) {
   switch (type) {
@@ -120,95 +410,146 @@ Status DoubleDelta::compress(ConstBuffer* input_buffer, Buffer* output_buffer) {
   uint64_t num = input_buffer->size() / value_size;
   assert(num > 0 && (input_buffer->size() % value_size == 0));
 
-  // Calculate bitsize (ignoring the sign bit)
-  auto in = (T*)input_buffer->data();
-  int bitsize;
-  RETURN_NOT_OK(compute_bitsize(in, num, &bitsize));
-  auto bitsize_c = (char)bitsize;
-
-  // Write bitsize and number of values
-  RETURN_NOT_OK(output_buffer->write(&bitsize_c, sizeof(char)));
-  RETURN_NOT_OK(output_buffer->write(&num, sizeof(uint64_t)));
+  // For easy reference
+  auto in = (const T*)input_buffer->data();
+  const DDKernels& kernels = dd_kernels();
+  uint64_t dd_num = (num > 2) ? num - 2 : 0;
+  uint64_t block_num = (dd_num + DD_BLOCK_SIZE - 1) / DD_BLOCK_SIZE;
+  uint64_t values[DD_BLOCK_SIZE + 2];
+  uint64_t zigzags[DD_BLOCK_SIZE];
+
+  // Calculate the bitsize of each block and the compressed size
+  std::vector<uint8_t> bitsizes(block_num);
+  uint64_t nbytes = sizeof(char) + sizeof(uint64_t) + MIN(num, 2) * value_size;
+  for (uint64_t b = 0; b < block_num; ++b) {
+    uint64_t block_size = load_block(in, num, b, values);
+    uint64_t bits = kernels.encode(values, block_size, zigzags);
+    int bitsize = 0;
+    for (; bits != 0; bits >>= 1)
+      ++bitsize;
+    bitsizes[b] = (uint8_t)bitsize;
+    nbytes += sizeof(uint8_t) + dd_packed_size(block_size, bitsize);
+  }
 
-  // Trivial case - no compression
-  if (bitsize >= sizeof(T) * 8 - 1) {
+  // Trivial case - no compression, in the format of the previous versions
+  if (nbytes >= sizeof(char) + sizeof(uint64_t) + input_buffer->size()) {
+    auto bitsize_c = (char)(value_size * 8);
+    RETURN_NOT_OK(output_buffer->write(&bitsize_c, sizeof(char)));
+    RETURN_NOT_OK(output_buffer->write(&num, sizeof(uint64_t)));
     RETURN_NOT_OK(output_buffer->write(in, input_buffer->size()));
     return Status::Ok();
   }
 
-  // Write first value
-  RETURN_NOT_OK(output_buffer->write(&in[0], value_size));
-  if (num == 1)
-    return Status::Ok();
-
-  // Write second value
-  RETURN_NOT_OK(output_buffer->write(&in[1], value_size));
-  if (num == 2)
-    return Status::Ok();
-
-  // Write double deltas
-  int64_t prev_delta = int64_t(in[1]) - int64_t(in[0]);
-  int bit_in_chunk = 63;  // Leftmost bit (MSB)
-  uint64_t chunk = 0;
-  int64_t cur_delta, dd;
-  for (uint64_t i = 2; i < num; ++i) {
-    cur_delta = int64_t(in[i]) - int64_t(in[i - 1]);
-    dd = cur_delta - prev_delta;
-    RETURN_NOT_OK(
-        write_double_delta(output_buffer, dd, bitsize, &chunk, &bit_in_chunk));
-    prev_delta = cur_delta;
+  // Reserve the space of the compressed values
+  if (output_buffer->offset() + nbytes > output_buffer->alloced_size())
+    RETURN_NOT_OK(output_buffer->realloc(output_buffer->offset() + nbytes));
+  auto out = (char*)output_buffer->cur_data();
+
+  // Write the format, the number of values and the first two values
+  *out = (char)DD_BLOCK_FORMAT;
+  out += sizeof(char);
+  std::memcpy(out, &num, sizeof(uint64_t));
+  out += sizeof(uint64_t);
+  std::memcpy(out, in, 2 * value_size);
+  out += 2 * value_size;
+
+  // Write the blocks of double deltas
+  for (uint64_t b = 0; b < block_num; ++b) {
+    uint64_t block_size = load_block(in, num, b, values);
+    kernels.encode(values, block_size, zigzags);
+    int bitsize = bitsizes[b];
+    *out = (char)bitsize;
+    out += sizeof(uint8_t);
+    if (block_size == DD_BLOCK_SIZE)
+      kernels.pack(zigzags, bitsize, out);
+    else
+      dd_pack_lane(zigzags, block_size, 1, bitsize, out, 1);
+    out += dd_packed_size(block_size, bitsize);
   }
 
-  // Write whatever is left in the chunk
-  if (bit_in_chunk < 63)
-    RETURN_NOT_OK(output_buffer->write(&chunk, sizeof(uint64_t)));
+  output_buffer->advance_offset(nbytes);
+  output_buffer->set_size(output_buffer->offset());
 
   return Status::Ok();
 }
 
 template <class T>
-Status DoubleDelta::compute_bitsize(T* in, uint64_t num, int* bitsize) {
-  // Find maximum absolute double delta
-  int64_t max = 0;
-  int64_t prev_delta = in[1] - in[0];
-  int64_t cur_delta, dd;
-  char delta_out_of_bounds = 0;
-  for (uint64_t i = 2; i < num; ++i) {
-    cur_delta = in[i] - in[i - 1];
-    dd = cur_delta - prev_delta;
-    delta_out_of_bounds |= (char)(cur_delta < 0 && prev_delta > 0 && dd > 0);
-    delta_out_of_bounds |= (char)(cur_delta > 0 && prev_delta < 0 && dd < 0);
-    max = MAX(ABS(dd), max);
-    prev_delta = cur_delta;
-  }
+Status DoubleDelta::decompress(
+    ConstBuffer* input_buffer, Buffer* output_buffer) {
+  // Read format and number of values
+  char bitsize_c;
+  uint64_t num;
+  uint64_t value_size = sizeof(T);
+  RETURN_NOT_OK(input_buffer->read(&bitsize_c, sizeof(char)));
+  RETURN_NOT_OK(input_buffer->read(&num, sizeof(uint64_t)));
+
+  // Reserve the space of the decompressed values
+  if (output_buffer->offset() + num * value_size >
+      output_buffer->alloced_size())
+    RETURN_NOT_OK(
+        output_buffer->realloc(output_buffer->offset() + num * value_size));
+
+  // Format of the previous versions
+  if ((uint8_t)bitsize_c != DD_BLOCK_FORMAT)
+    return decompress_legacy<T>(
+        (int)bitsize_c, num, input_buffer, output_buffer);
+
+  // The block format always has some double deltas
+  if (num < 3)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot decompress with DoubleDelta; Corrupted input buffer"));
+  auto out = (T*)output_buffer->cur_data();
 
-  // Handle error
-  if (delta_out_of_bounds) {
-    return LOG_STATUS(
-        Status::CompressionError("Cannot compress with DoubleDelta; Some "
-                                 "negative double delta is out of bounds"));
+  // Read the first two values
+  RETURN_NOT_OK(input_buffer->read(out, 2 * value_size));
+
+  // Decompress the blocks of double deltas
+  const DDKernels& kernels = dd_kernels();
+  uint64_t dd_num = num - 2;
+  uint64_t block_num = (dd_num + DD_BLOCK_SIZE - 1) / DD_BLOCK_SIZE;
+  uint64_t values[DD_BLOCK_SIZE + 2];
+  uint64_t zigzags[DD_BLOCK_SIZE];
+  values[0] = (uint64_t)(int64_t)out[0];
+  values[1] = (uint64_t)(int64_t)out[1];
+  for (uint64_t b = 0; b < block_num; ++b) {
+    uint8_t bitsize;
+    RETURN_NOT_OK(input_buffer->read(&bitsize, sizeof(uint8_t)));
+    uint64_t block_size = MIN(DD_BLOCK_SIZE, dd_num - b * DD_BLOCK_SIZE);
+    uint64_t packed_size = dd_packed_size(block_size, bitsize);
+    if (bitsize > 64 || packed_size > input_buffer->nbytes_left_to_read())
+      return LOG_STATUS(Status::CompressionError(
+          "Cannot decompress with DoubleDelta; Corrupted input buffer"));
+
+    // Unpack and decode the block
+    auto words = (const char*)input_buffer->data() + input_buffer->offset();
+    if (block_size == DD_BLOCK_SIZE)
+      kernels.unpack(words, bitsize, zigzags);
+    else
+      dd_unpack_lane(words, 1, bitsize, block_size, 1, zigzags);
+    input_buffer->advance_offset(packed_size);
+    kernels.decode(zigzags, block_size, values);
+
+    // Store the values and keep the last two for the next block
+    T* block_out = out + 2 + b * DD_BLOCK_SIZE;
+    for (uint64_t i = 0; i < block_size; ++i)
+      block_out[i] = (T)values[i + 2];
+    values[0] = values[block_size];
+    values[1] = values[block_size + 1];
   }
 
-  // Calculate bitsize of the maximum absolute double delta
-  *bitsize = 0;
-  do {
-    ++(*bitsize);
-    max >>= 1;
-  } while (max);
+  output_buffer->advance_offset(num * value_size);
+  output_buffer->set_size(output_buffer->offset());
 
   return Status::Ok();
 }
 
 template <class T>
-Status DoubleDelta::decompress(
-    ConstBuffer* input_buffer, Buffer* output_buffer) {
-  // Read bitsize and number of values
-  char bitsize_c;
-  uint64_t num;
+Status DoubleDelta::decompress_legacy(
+    int bitsize,
+    uint64_t num,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
   uint64_t value_size = sizeof(T);
-  RETURN_NOT_OK(input_buffer->read(&bitsize_c, sizeof(char)));
-  RETURN_NOT_OK(input_buffer->read(&num, sizeof(uint64_t)));
-  auto bitsize = (int)bitsize_c;
   auto out = (T*)output_buffer->cur_data();
 
   // Trivial case - no compression
@@ -248,6 +589,16 @@ Status DoubleDelta::decompress(
   return Status::Ok();
 }
 
+template <class T>
+uint64_t DoubleDelta::load_block(
+    const T* in, uint64_t num, uint64_t block, uint64_t* values) {
+  uint64_t first = block * DD_BLOCK_SIZE;
+  uint64_t block_size = MIN(DD_BLOCK_SIZE, num - 2 - first);
+  for (uint64_t i = 0; i < block_size + 2; ++i)
+    values[i] = (uint64_t)(int64_t)in[first + i];
+  return block_size;
+}
+
 Status DoubleDelta::read_double_delta(
     ConstBuffer* buff,
     int64_t* double_delta,
@@ -296,54 +647,6 @@ Status DoubleDelta::read_double_delta(
   return Status::Ok();
 }
 
-Status DoubleDelta::write_double_delta(
-    Buffer* buff,
-    int64_t double_delta,
-    int bitsize,
-    uint64_t* chunk,
-    int* bit_in_chunk) {
-  // Write sign
-  uint64_t to_or = (double_delta < 0) ? 1 : 0;
-  to_or <<= (*bit_in_chunk);
-  (*chunk) |= to_or;
-  --(*bit_in_chunk);
-
-  // Write chunk and reset
-  if (*bit_in_chunk < 0) {
-    RETURN_NOT_OK(buff->write(chunk, sizeof(uint64_t)));
-    *bit_in_chunk = 63;
-    *chunk = 0;
-  }
-
-  // Write rest of bits
-  int bits_left_to_write = bitsize;
-  int bit_in_dd = bitsize - 1;
-  int bits_to_fill_in_chunk = MIN((*bit_in_chunk) + 1, bits_left_to_write);
-  uint64_t abs_dd = ABS(double_delta);
-  uint64_t tmp_abs_dd;
-
-  while (bits_left_to_write > 0) {
-    if (bits_to_fill_in_chunk > 0) {
-      tmp_abs_dd = (abs_dd << (63 - bit_in_dd));
-      tmp_abs_dd >>= (63 - (*bit_in_chunk));
-      (*chunk) |= tmp_abs_dd;
-      (*bit_in_chunk) -= bits_to_fill_in_chunk;
-      bit_in_dd -= bits_to_fill_in_chunk;
-      bits_left_to_write -= bits_to_fill_in_chunk;
-    }
-
-    // Write chunk and reset
-    if (*bit_in_chunk < 0) {
-      RETURN_NOT_OK(buff->write(chunk, sizeof(uint64_t)));
-      *bit_in_chunk = 63;
-      *chunk = 0;
-      bits_to_fill_in_chunk = MIN((*bit_in_chunk) + 1, bits_left_to_write);
-    }
-  }
-
-  return Status::Ok();
-}
-
 // Explicit template instantiations
 
 template Status DoubleDelta::compress<char>(
@@ -0,0 +1,264 @@
+/**
+ * @file   filter_pipeline.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class FilterPipeline.
+ */
+
+#include "filter_pipeline.h"
+#include "logger.h"
+
+#include <cstring>
+
+namespace tiledb {
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status FilterPipeline::run_forward(
+    const std::vector<Filter>& filters,
+    Datatype type,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
+  return run(filters, false, type, input_buffer, output_buffer);
+}
+
+Status FilterPipeline::run_reverse(
+    const std::vector<Filter>& filters,
+    Datatype type,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
+  return run(filters, true, type, input_buffer, output_buffer);
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+void FilterPipeline::bitshuffle(
+    uint64_t value_size, const char* in, uint64_t nbytes, char* out) {
+  // The bits of each byte position of 8 values form 8 bytes, one in each of
+  // the 8 bit planes of the byte position
+  uint64_t group_num = nbytes / value_size / 8;
+  auto in_u = (const unsigned char*)in;
+  for (uint64_t g = 0; g < group_num; ++g) {
+    const unsigned char* group = in_u + g * 8 * value_size;
+    for (uint64_t b = 0; b < value_size; ++b) {
+      uint64_t x = 0;
+      for (unsigned int j = 0; j < 8; ++j)
+        x |= uint64_t(group[j * value_size + b]) << (8 * j);
+      x = transpose_bits(x);
+      for (unsigned int k = 0; k < 8; ++k)
+        out[(b * 8 + k) * group_num + g] = (char)(x >> (8 * k));
+    }
+  }
+
+  // Copy the rest
+  uint64_t shuffled = group_num * 8 * value_size;
+  std::memcpy(out + shuffled, in + shuffled, nbytes - shuffled);
+}
+
+void FilterPipeline::bitunshuffle(
+    uint64_t value_size, const char* in, uint64_t nbytes, char* out) {
+  uint64_t group_num = nbytes / value_size / 8;
+  auto in_u = (const unsigned char*)in;
+  for (uint64_t g = 0; g < group_num; ++g) {
+    char* group = out + g * 8 * value_size;
+    for (uint64_t b = 0; b < value_size; ++b) {
+      uint64_t x = 0;
+      for (unsigned int k = 0; k < 8; ++k)
+        x |= uint64_t(in_u[(b * 8 + k) * group_num + g]) << (8 * k);
+      x = transpose_bits(x);
+      for (unsigned int j = 0; j < 8; ++j)
+        group[j * value_size + b] = (char)(x >> (8 * j));
+    }
+  }
+
+  // Copy the rest
+  uint64_t shuffled = group_num * 8 * value_size;
+  std::memcpy(out + shuffled, in + shuffled, nbytes - shuffled);
+}
+
+void FilterPipeline::byteshuffle(
+    uint64_t value_size, const char* in, uint64_t nbytes, char* out) {
+  uint64_t value_num = nbytes / value_size;
+  for (uint64_t b = 0; b < value_size; ++b) {
+    char* plane = out + b * value_num;
+    for (uint64_t i = 0; i < value_num; ++i)
+      plane[i] = in[i * value_size + b];
+  }
+
+  // Copy the rest
+  uint64_t shuffled = value_num * value_size;
+  std::memcpy(out + shuffled, in + shuffled, nbytes - shuffled);
+}
+
+void FilterPipeline::byteunshuffle(
+    uint64_t value_size, const char* in, uint64_t nbytes, char* out) {
+  uint64_t value_num = nbytes / value_size;
+  for (uint64_t b = 0; b < value_size; ++b) {
+    const char* plane = in + b * value_num;
+    for (uint64_t i = 0; i < value_num; ++i)
+      out[i * value_size + b] = plane[i];
+  }
+
+  // Copy the rest
+  uint64_t shuffled = value_num * value_size;
+  std::memcpy(out + shuffled, in + shuffled, nbytes - shuffled);
+}
+
+template <class T>
+void FilterPipeline::delta(const char* in, uint64_t nbytes, char* out) {
+  uint64_t value_num = nbytes / sizeof(T);
+  T prev = 0, value;
+  for (uint64_t i = 0; i < value_num; ++i) {
+    std::memcpy(&value, in + i * sizeof(T), sizeof(T));
+    T diff = value - prev;
+    std::memcpy(out + i * sizeof(T), &diff, sizeof(T));
+    prev = value;
+  }
+
+  // Copy the rest
+  uint64_t filtered = value_num * sizeof(T);
+  std::memcpy(out + filtered, in + filtered, nbytes - filtered);
+}
+
+template <class T>
+void FilterPipeline::undelta(const char* in, uint64_t nbytes, char* out) {
+  uint64_t value_num = nbytes / sizeof(T);
+  T value = 0, diff;
+  for (uint64_t i = 0; i < value_num; ++i) {
+    std::memcpy(&diff, in + i * sizeof(T), sizeof(T));
+    value += diff;
+    std::memcpy(out + i * sizeof(T), &value, sizeof(T));
+  }
+
+  // Copy the rest
+  uint64_t filtered = value_num * sizeof(T);
+  std::memcpy(out + filtered, in + filtered, nbytes - filtered);
+}
+
+Status FilterPipeline::run(
+    Filter filter,
+    bool reverse,
+    uint64_t value_size,
+    const char* in,
+    uint64_t nbytes,
+    char* out) {
+  switch (filter) {
+    case Filter::DELTA:
+      switch (value_size) {
+        case 1:
+          (reverse) ? undelta<uint8_t>(in, nbytes, out) :
+                      delta<uint8_t>(in, nbytes, out);
+          return Status::Ok();
+        case 2:
+          (reverse) ? undelta<uint16_t>(in, nbytes, out) :
+                      delta<uint16_t>(in, nbytes, out);
+          return Status::Ok();
+        case 4:
+          (reverse) ? undelta<uint32_t>(in, nbytes, out) :
+                      delta<uint32_t>(in, nbytes, out);
+          return Status::Ok();
+        case 8:
+          (reverse) ? undelta<uint64_t>(in, nbytes, out) :
+                      delta<uint64_t>(in, nbytes, out);
+          return Status::Ok();
+        default:
+          break;
+      }
+      break;
+    case Filter::BYTESHUFFLE:
+      (reverse) ? byteunshuffle(value_size, in, nbytes, out) :
+                  byteshuffle(value_size, in, nbytes, out);
+      return Status::Ok();
+    case Filter::BITSHUFFLE:
+      (reverse) ? bitunshuffle(value_size, in, nbytes, out) :
+                  bitshuffle(value_size, in, nbytes, out);
+      return Status::Ok();
+  }
+
+  return LOG_STATUS(Status::CompressionError(
+      "Cannot run filter pipeline; Unsupported filter"));
+}
+
+Status FilterPipeline::run(
+    const std::vector<Filter>& filters,
+    bool reverse,
+    Datatype type,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
+  // For easy reference
+  uint64_t nbytes = input_buffer->nbytes_left_to_read();
+  uint64_t value_size = datatype_size(type);
+  auto filter_num = (unsigned int)filters.size();
+
+  // Reserve the space of the output
+  if (output_buffer->offset() + nbytes > output_buffer->alloced_size())
+    RETURN_NOT_OK(output_buffer->realloc(output_buffer->offset() + nbytes));
+  auto out = (char*)output_buffer->cur_data();
+
+  // Run the filters, each from the output of the previous one. The
+  // intermediate outputs alternate between two scratch buffers.
+  std::vector<char> scratch[2];
+  auto in = (const char*)input_buffer->data() + input_buffer->offset();
+  for (unsigned int i = 0; i < filter_num; ++i) {
+    Filter filter = filters[(reverse) ? filter_num - 1 - i : i];
+    char* stage_out = out;
+    if (i + 1 < filter_num) {
+      scratch[i % 2].resize(nbytes);
+      stage_out = scratch[i % 2].data();
+    }
+    RETURN_NOT_OK(run(filter, reverse, value_size, in, nbytes, stage_out));
+    in = stage_out;
+  }
+  if (filter_num == 0)
+    std::memcpy(out, in, nbytes);
+
+  input_buffer->advance_offset(nbytes);
+  output_buffer->advance_offset(nbytes);
+  output_buffer->set_size(output_buffer->offset());
+
+  return Status::Ok();
+}
+
+uint64_t FilterPipeline::transpose_bits(uint64_t x) {
+  // Swap the bits at (row, column) and (column, row) in 2x2, 4x4 and 8x8
+  // blocks, where bit (8 * row + column) is at (row, column)
+  uint64_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x = x ^ t ^ (t << 28);
+  return x;
+}
+
+}  // namespace tiledb
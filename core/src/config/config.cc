@@ -31,6 +31,10 @@
  */
 
 #include "config.h"
+#include "constants.h"
+
+#include <algorithm>
+#include <climits>
 
 namespace tiledb {
 
@@ -40,8 +44,16 @@ namespace tiledb {
 
 Config::Config() {
   // Default values
-  read_method_ = IOMethod::MMAP;
+  read_method_ = IOMethod::READ;
   write_method_ = IOMethod::WRITE;
+  mem_spill_size_ = UINT64_MAX;
+  metadata_cache_size_ = constants::metadata_cache_size;
+  read_ahead_ = true;
+  read_thread_num_ = constants::read_thread_num;
+  thread_pool_size_ = constants::thread_pool_size;
+  tile_cache_size_ = constants::tile_cache_size;
+  tile_chunk_size_ = constants::tile_chunk_size;
+  tile_coalesce_gap_size_ = constants::tile_coalesce_gap_size;
 #ifdef HAVE_MPI
   mpi_comm_ = nullptr;
 #endif
@@ -52,14 +64,31 @@ Config::Config(const Config* config) {
 #ifdef HAVE_MPI
     mpi_comm_ = nullptr;
 #endif
-    read_method_ = IOMethod::MMAP;
+    read_method_ = IOMethod::READ;
     write_method_ = IOMethod::WRITE;
+    mem_spill_size_ = UINT64_MAX;
+    metadata_cache_size_ = constants::metadata_cache_size;
+    read_ahead_ = true;
+    read_thread_num_ = constants::read_thread_num;
+    thread_pool_size_ = constants::thread_pool_size;
+    tile_cache_size_ = constants::tile_cache_size;
+    tile_chunk_size_ = constants::tile_chunk_size;
+    tile_coalesce_gap_size_ = constants::tile_coalesce_gap_size;
   } else {  // Clone
 #ifdef HAVE_MPI
     mpi_comm_ = config->mpi_comm();
 #endif
     read_method_ = config->read_method();
     write_method_ = config->write_method();
+    mem_spill_dir_ = config->mem_spill_dir();
+    mem_spill_size_ = config->mem_spill_size();
+    metadata_cache_size_ = config->metadata_cache_size();
+    read_ahead_ = config->read_ahead();
+    read_thread_num_ = config->read_thread_num();
+    thread_pool_size_ = config->thread_pool_size();
+    tile_cache_size_ = config->tile_cache_size();
+    tile_chunk_size_ = config->tile_chunk_size();
+    tile_coalesce_gap_size_ = config->tile_coalesce_gap_size();
   }
 }
 
@@ -84,11 +113,12 @@ void Config::init(
   read_method_ = read_method;
   if (read_method_ != IOMethod::READ && read_method_ != IOMethod::MMAP &&
       read_method_ != IOMethod::MPI)
-    read_method_ = IOMethod::MMAP;  // Use default
+    read_method_ = IOMethod::READ;  // Use default
 
   // Initialize write method
   write_method_ = write_method;
-  if (write_method_ != IOMethod::WRITE && write_method_ != IOMethod::MPI)
+  if (write_method_ != IOMethod::WRITE && write_method_ != IOMethod::MPI &&
+      write_method_ != IOMethod::DIRECT)
     write_method_ = IOMethod::WRITE;  // Use default
 }
 
@@ -98,10 +128,46 @@ void Config::set_mpi_comm(MPI_Comm* mpi_comm) {
 }
 #endif
 
+void Config::set_mem_spill(uint64_t max_size, const std::string& dir) {
+  mem_spill_size_ = max_size;
+  mem_spill_dir_ = dir;
+}
+
+void Config::set_metadata_cache_size(uint64_t metadata_cache_size) {
+  metadata_cache_size_ = metadata_cache_size;
+}
+
+void Config::set_read_ahead(bool read_ahead) {
+  read_ahead_ = read_ahead;
+}
+
 void Config::set_read_method(IOMethod read_method) {
   read_method_ = read_method;
 }
 
+void Config::set_read_thread_num(unsigned int read_thread_num) {
+  read_thread_num_ = (read_thread_num == 0) ? 1 : read_thread_num;
+}
+
+void Config::set_thread_pool_size(unsigned int thread_pool_size) {
+  thread_pool_size_ = thread_pool_size;
+}
+
+void Config::set_tile_cache_size(uint64_t tile_cache_size) {
+  tile_cache_size_ = tile_cache_size;
+}
+
+void Config::set_tile_chunk_size(uint64_t tile_chunk_size) {
+  if (tile_chunk_size == 0)
+    tile_chunk_size_ = constants::tile_chunk_size;
+  else
+    tile_chunk_size_ = std::min<uint64_t>(tile_chunk_size, INT_MAX);
+}
+
+void Config::set_tile_coalesce_gap_size(uint64_t tile_coalesce_gap_size) {
+  tile_coalesce_gap_size_ = tile_coalesce_gap_size;
+}
+
 void Config::set_write_method(IOMethod write_method) {
   write_method_ = write_method;
 }
@@ -112,10 +178,46 @@ MPI_Comm* Config::mpi_comm() const {
 }
 #endif
 
+const std::string& Config::mem_spill_dir() const {
+  return mem_spill_dir_;
+}
+
+uint64_t Config::mem_spill_size() const {
+  return mem_spill_size_;
+}
+
+uint64_t Config::metadata_cache_size() const {
+  return metadata_cache_size_;
+}
+
+bool Config::read_ahead() const {
+  return read_ahead_;
+}
+
 IOMethod Config::read_method() const {
   return read_method_;
 }
 
+unsigned int Config::read_thread_num() const {
+  return read_thread_num_;
+}
+
+unsigned int Config::thread_pool_size() const {
+  return thread_pool_size_;
+}
+
+uint64_t Config::tile_cache_size() const {
+  return tile_cache_size_;
+}
+
+uint64_t Config::tile_chunk_size() const {
+  return tile_chunk_size_;
+}
+
+uint64_t Config::tile_coalesce_gap_size() const {
+  return tile_coalesce_gap_size_;
+}
+
 IOMethod Config::write_method() const {
   return write_method_;
 }
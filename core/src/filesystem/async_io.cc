@@ -0,0 +1,579 @@
+/**
+ * @file   async_io.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class AsyncIO.
+ */
+
+#include "async_io.h"
+#include "constants.h"
+#include "logger.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#endif
+
+#ifdef HAVE_LINUX_AIO
+#include <linux/aio_abi.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <deque>
+
+/* ****************************** */
+/*             MACROS             */
+/* ****************************** */
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+namespace tiledb {
+
+/* ****************************** */
+/*          PRIVATE TYPES         */
+/* ****************************** */
+
+#ifdef HAVE_IO_URING
+struct AsyncIO::Uring {
+  /** The io_uring file descriptor. */
+  int fd_;
+  /** The mapped submission queue ring. */
+  void* sq_ring_;
+  /** The size of the mapped submission queue ring. */
+  size_t sq_ring_size_;
+  /** The mapped completion queue ring (may coincide with the sq ring). */
+  void* cq_ring_;
+  /** The size of the mapped completion queue ring. */
+  size_t cq_ring_size_;
+  /** The mapped submission queue entries. */
+  io_uring_sqe* sqes_;
+  /** The size of the mapped submission queue entries. */
+  size_t sqes_size_;
+  /** The number of submission queue entries. */
+  unsigned sq_entries_;
+  /** Pointers into the submission queue ring. */
+  unsigned *sq_head_, *sq_tail_, *sq_mask_, *sq_array_;
+  /** Pointers into the completion queue ring. */
+  unsigned *cq_head_, *cq_tail_, *cq_mask_;
+  /** The completion queue entries. */
+  io_uring_cqe* cqes_;
+};
+#else
+struct AsyncIO::Uring {};
+#endif
+
+struct AsyncIO::Context {
+  /** The Linux AIO context (valid if the backend is LINUX_AIO). */
+  unsigned long aio_ctx_;
+  /** The io_uring instance (non-null if the backend is IO_URING). */
+  Uring* uring_;
+};
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+AsyncIO::AsyncIO(unsigned int queue_depth) {
+  queue_depth_ = (queue_depth == 0) ? 1 : queue_depth;
+
+  // The first context determines the backend
+  auto context = new Context();
+  context->aio_ctx_ = 0;
+  context->uring_ = nullptr;
+  if (init_uring(context)) {
+    backend_ = Backend::IO_URING;
+  } else if (init_aio(context)) {
+    backend_ = Backend::LINUX_AIO;
+  } else {
+    backend_ = Backend::SYNC;
+    delete context;
+    return;
+  }
+  contexts_.push_back(context);
+}
+
+AsyncIO::~AsyncIO() {
+  for (auto context : contexts_)
+    destroy_context(context);
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+AsyncIO::Backend AsyncIO::backend() const {
+  return backend_;
+}
+
+Status AsyncIO::execute(std::vector<Request>* requests) {
+  // Batches run concurrently, each on its own context
+  Context* context = acquire_context();
+
+  Status st;
+  if (context == nullptr)
+    st = execute_sync(requests);
+  else if (backend_ == Backend::IO_URING)
+    st = execute_uring(context, requests);
+  else
+    st = execute_aio(context, requests);
+
+  if (context != nullptr)
+    release_context(context);
+
+  return st.ok() ? st : LOG_STATUS(st);
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+AsyncIO::Context* AsyncIO::acquire_context() {
+  if (backend_ == Backend::SYNC)
+    return nullptr;
+
+  // Reuse an idle context
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!contexts_.empty()) {
+      Context* context = contexts_.back();
+      contexts_.pop_back();
+      return context;
+    }
+  }
+
+  // Create a new one, or fall back to synchronous I/O if the kernel
+  // refuses (e.g., because of its AIO or memory-lock limits)
+  auto context = new Context();
+  context->aio_ctx_ = 0;
+  context->uring_ = nullptr;
+  bool ok = (backend_ == Backend::IO_URING) ? init_uring(context) :
+                                              init_aio(context);
+  if (!ok) {
+    delete context;
+    return nullptr;
+  }
+
+  return context;
+}
+
+bool AsyncIO::advance(Request* request, uint64_t nbytes) {
+  auto& iov = request->iov_;
+  request->offset_ += nbytes;
+
+  // Drop the buffers that were fully served and trim the next one
+  size_t i = 0;
+  while (i < iov.size()) {
+    if (nbytes < iov[i].iov_len) {
+      iov[i].iov_base = static_cast<char*>(iov[i].iov_base) + nbytes;
+      iov[i].iov_len -= nbytes;
+      break;
+    }
+    nbytes -= iov[i].iov_len;
+    ++i;
+  }
+  iov.erase(iov.begin(), iov.begin() + i);
+
+  return iov.empty();
+}
+
+Status AsyncIO::complete(Request* request, int64_t res, bool* resubmit) {
+  *resubmit = false;
+
+  // Transient errors
+  if (res == -EINTR || res == -EAGAIN) {
+    *resubmit = true;
+    return Status::Ok();
+  }
+
+  if (res < 0)
+    return Status::IOError(
+        std::string("Asynchronous ") + (request->write_ ? "write" : "read") +
+        " failed; " + strerror((int)-res));
+  if (res == 0)
+    return Status::IOError(
+        std::string("Asynchronous ") + (request->write_ ? "write" : "read") +
+        " failed; Unexpected end of file");
+
+  *resubmit = !advance(request, (uint64_t)res);
+  return Status::Ok();
+}
+
+void AsyncIO::destroy_context(Context* context) {
+#ifdef HAVE_IO_URING
+  auto uring = context->uring_;
+  if (uring != nullptr) {
+    munmap(uring->sqes_, uring->sqes_size_);
+    if (uring->cq_ring_ != uring->sq_ring_)
+      munmap(uring->cq_ring_, uring->cq_ring_size_);
+    munmap(uring->sq_ring_, uring->sq_ring_size_);
+    close(uring->fd_);
+  }
+#endif
+  delete context->uring_;
+
+#ifdef HAVE_LINUX_AIO
+  if (context->aio_ctx_ != 0)
+    syscall(__NR_io_destroy, (aio_context_t)context->aio_ctx_);
+#endif
+
+  delete context;
+}
+
+Status AsyncIO::execute_aio(Context* context, std::vector<Request>* requests) {
+#ifdef HAVE_LINUX_AIO
+  auto aio_ctx = (aio_context_t)context->aio_ctx_;
+  std::deque<size_t> pending;
+  for (size_t i = 0; i < requests->size(); ++i) {
+    if (!advance(&(*requests)[i], 0))
+      pending.push_back(i);
+  }
+
+  std::vector<iocb> cbs(requests->size());
+  std::vector<iocb*> batch;
+  std::vector<io_event> events(queue_depth_);
+  uint64_t inflight = 0;
+  Status st;
+  while (inflight > 0 || (st.ok() && !pending.empty())) {
+    // Prepare as many requests as the queue depth allows
+    batch.clear();
+    while (st.ok() && !pending.empty() &&
+           inflight + batch.size() < queue_depth_) {
+      size_t i = pending.front();
+      pending.pop_front();
+      auto& request = (*requests)[i];
+      auto& cb = cbs[i];
+      std::memset(&cb, 0, sizeof(cb));
+      cb.aio_data = i;
+      cb.aio_lio_opcode = request.write_ ? IOCB_CMD_PWRITEV : IOCB_CMD_PREADV;
+      cb.aio_fildes = (uint32_t)request.fd_;
+      cb.aio_buf = (uint64_t)(uintptr_t)request.iov_.data();
+      cb.aio_nbytes = MIN(request.iov_.size(), (size_t)IOV_MAX);
+      cb.aio_offset = (int64_t)request.offset_;
+      batch.push_back(&cb);
+    }
+
+    // Submit
+    size_t submitted = 0;
+    while (submitted < batch.size()) {
+      long ret = syscall(
+          __NR_io_submit,
+          aio_ctx,
+          (long)(batch.size() - submitted),
+          &batch[submitted]);
+      if (ret < 0 && errno == EINTR)
+        continue;
+      if (ret < 0 && errno == EAGAIN && inflight > 0)
+        break;
+      if (ret <= 0) {
+        st = Status::IOError(
+            std::string("Cannot submit asynchronous I/O; ") + strerror(errno));
+        break;
+      }
+      submitted += ret;
+      inflight += ret;
+    }
+    for (size_t j = batch.size(); j > submitted; --j)
+      pending.push_front(batch[j - 1]->aio_data);
+
+    if (inflight == 0)
+      continue;
+
+    // Wait for at least one completion
+    long ret = syscall(
+        __NR_io_getevents,
+        aio_ctx,
+        1L,
+        (long)queue_depth_,
+        events.data(),
+        nullptr);
+    if (ret < 0) {
+      if (errno == EINTR)
+        continue;
+      if (st.ok())
+        st = Status::IOError(
+            std::string("Cannot wait for asynchronous I/O; ") +
+            strerror(errno));
+
+      // Destroying the context cancels or waits for all the requests in
+      // flight, after which their buffers can be released. A fresh context
+      // replaces it
+      syscall(__NR_io_destroy, aio_ctx);
+      context->aio_ctx_ = 0;
+      init_aio(context);
+      return st;
+    }
+
+    for (long e = 0; e < ret; ++e) {
+      size_t i = events[e].data;
+      --inflight;
+      bool resubmit;
+      Status complete_st = complete(&(*requests)[i], events[e].res, &resubmit);
+      if (!complete_st.ok() && st.ok())
+        st = complete_st;
+      else if (resubmit && st.ok())
+        pending.push_back(i);
+    }
+  }
+
+  return st;
+#else
+  (void)context;
+  (void)requests;
+  return Status::IOError("TileDB was built without Linux AIO support");
+#endif
+}
+
+Status AsyncIO::execute_sync(std::vector<Request>* requests) {
+  for (auto& request : *requests) {
+    bool resubmit = !advance(&request, 0);
+    while (resubmit) {
+      int iov_num = (int)MIN(request.iov_.size(), (size_t)IOV_MAX);
+      int64_t res =
+          request.write_ ?
+              ::pwritev(
+                  request.fd_, request.iov_.data(), iov_num, request.offset_) :
+              ::preadv(
+                  request.fd_, request.iov_.data(), iov_num, request.offset_);
+      if (res < 0)
+        res = -errno;
+      RETURN_NOT_OK(complete(&request, res, &resubmit));
+    }
+  }
+
+  return Status::Ok();
+}
+
+Status AsyncIO::execute_uring(
+    Context* context, std::vector<Request>* requests) {
+#ifdef HAVE_IO_URING
+  auto& ring = *context->uring_;
+  uint64_t max_inflight = MIN(queue_depth_, ring.sq_entries_);
+
+  std::deque<size_t> pending;
+  for (size_t i = 0; i < requests->size(); ++i) {
+    if (!advance(&(*requests)[i], 0))
+      pending.push_back(i);
+  }
+
+  uint64_t inflight = 0;
+  Status st;
+  while (inflight > 0 || (st.ok() && !pending.empty())) {
+    // Fill the submission queue
+    unsigned tail = *ring.sq_tail_;
+    while (st.ok() && !pending.empty() && inflight < max_inflight) {
+      size_t i = pending.front();
+      pending.pop_front();
+      auto& request = (*requests)[i];
+      unsigned idx = tail & *ring.sq_mask_;
+      io_uring_sqe* sqe = &ring.sqes_[idx];
+      std::memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = request.write_ ? IORING_OP_WRITEV : IORING_OP_READV;
+      sqe->fd = request.fd_;
+      sqe->off = request.offset_;
+      sqe->addr = (uint64_t)(uintptr_t)request.iov_.data();
+      sqe->len = (uint32_t)MIN(request.iov_.size(), (size_t)IOV_MAX);
+      sqe->user_data = i;
+      ring.sq_array_[idx] = idx;
+      ++tail;
+      ++inflight;
+    }
+    __atomic_store_n(ring.sq_tail_, tail, __ATOMIC_RELEASE);
+
+    // Submit whatever the kernel has not consumed yet, and wait for at
+    // least one completion
+    unsigned to_submit =
+        tail - __atomic_load_n(ring.sq_head_, __ATOMIC_ACQUIRE);
+    int ret = (int)syscall(
+        __NR_io_uring_enter,
+        ring.fd_,
+        to_submit,
+        1,
+        IORING_ENTER_GETEVENTS,
+        nullptr,
+        0);
+    if (ret < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+        continue;
+      if (st.ok())
+        st = Status::IOError(
+            std::string("Cannot submit asynchronous I/O; ") +
+            strerror(errno));
+
+      // Take back the entries the kernel has not consumed, so that a later
+      // batch does not submit them. The submitted requests must still
+      // complete before their buffers can be released, so the completion
+      // queue is polled until then
+      unsigned sq_head = __atomic_load_n(ring.sq_head_, __ATOMIC_ACQUIRE);
+      inflight -= tail - sq_head;
+      __atomic_store_n(ring.sq_tail_, sq_head, __ATOMIC_RELEASE);
+      if (inflight > 0)
+        usleep(constants::async_io_poll_interval);
+    }
+
+    // Reap the completions
+    unsigned head = *ring.cq_head_;
+    unsigned cq_tail = __atomic_load_n(ring.cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != cq_tail; ++head) {
+      io_uring_cqe* cqe = &ring.cqes_[head & *ring.cq_mask_];
+      size_t i = cqe->user_data;
+      --inflight;
+      bool resubmit;
+      Status complete_st = complete(&(*requests)[i], cqe->res, &resubmit);
+      if (!complete_st.ok() && st.ok())
+        st = complete_st;
+      else if (resubmit && st.ok())
+        pending.push_back(i);
+    }
+    __atomic_store_n(ring.cq_head_, head, __ATOMIC_RELEASE);
+  }
+
+  return st;
+#else
+  (void)context;
+  (void)requests;
+  return Status::IOError("TileDB was built without io_uring support");
+#endif
+}
+
+bool AsyncIO::init_aio(Context* context) {
+#ifdef HAVE_LINUX_AIO
+  aio_context_t ctx = 0;
+  if (syscall(__NR_io_setup, queue_depth_, &ctx) != 0)
+    return false;
+  context->aio_ctx_ = ctx;
+  return true;
+#else
+  (void)context;
+  return false;
+#endif
+}
+
+bool AsyncIO::init_uring(Context* context) {
+#ifdef HAVE_IO_URING
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  int fd = (int)syscall(__NR_io_uring_setup, queue_depth_, &params);
+  if (fd < 0)
+    return false;
+
+  // Map the rings and the submission queue entries
+  size_t sq_ring_size =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  size_t cq_ring_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap)
+    sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+  void* sq_ring = mmap(
+      nullptr,
+      sq_ring_size,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      fd,
+      IORING_OFF_SQ_RING);
+  if (sq_ring == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+  void* cq_ring = sq_ring;
+  if (!single_mmap) {
+    cq_ring = mmap(
+        nullptr,
+        cq_ring_size,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE,
+        fd,
+        IORING_OFF_CQ_RING);
+    if (cq_ring == MAP_FAILED) {
+      munmap(sq_ring, sq_ring_size);
+      close(fd);
+      return false;
+    }
+  }
+  size_t sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = mmap(
+      nullptr,
+      sqes_size,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      fd,
+      IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    if (cq_ring != sq_ring)
+      munmap(cq_ring, cq_ring_size);
+    munmap(sq_ring, sq_ring_size);
+    close(fd);
+    return false;
+  }
+
+  auto uring = new Uring();
+  uring->fd_ = fd;
+  uring->sq_ring_ = sq_ring;
+  uring->sq_ring_size_ = sq_ring_size;
+  uring->cq_ring_ = cq_ring;
+  uring->cq_ring_size_ = cq_ring_size;
+  uring->sqes_ = static_cast<io_uring_sqe*>(sqes);
+  uring->sqes_size_ = sqes_size;
+  uring->sq_entries_ = params.sq_entries;
+  auto sq_c = static_cast<char*>(sq_ring);
+  uring->sq_head_ = (unsigned*)(sq_c + params.sq_off.head);
+  uring->sq_tail_ = (unsigned*)(sq_c + params.sq_off.tail);
+  uring->sq_mask_ = (unsigned*)(sq_c + params.sq_off.ring_mask);
+  uring->sq_array_ = (unsigned*)(sq_c + params.sq_off.array);
+  auto cq_c = static_cast<char*>(cq_ring);
+  uring->cq_head_ = (unsigned*)(cq_c + params.cq_off.head);
+  uring->cq_tail_ = (unsigned*)(cq_c + params.cq_off.tail);
+  uring->cq_mask_ = (unsigned*)(cq_c + params.cq_off.ring_mask);
+  uring->cqes_ = (io_uring_cqe*)(cq_c + params.cq_off.cqes);
+  context->uring_ = uring;
+
+  return true;
+#else
+  (void)context;
+  return false;
+#endif
+}
+
+void AsyncIO::release_context(Context* context) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  // A context that could not be recreated after an error is discarded
+  if (backend_ == Backend::LINUX_AIO && context->aio_ctx_ == 0) {
+    delete context;
+    return;
+  }
+  contexts_.push_back(context);
+}
+
+}  // namespace tiledb
@@ -0,0 +1,205 @@
+/**
+ * @file   fd_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class FDCache.
+ */
+
+#include "fd_cache.h"
+#include "logger.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+FDCache::FDCache(uint64_t max_size) {
+  max_size_ = max_size;
+}
+
+FDCache::~FDCache() {
+  // Entries in use that were already dropped from the cache. This runs
+  // first, because the cached entries are freed below
+  for (auto& it : used_) {
+    if (!it.second->cached_) {
+      ::close(it.second->fd_);
+      delete it.second;
+    }
+  }
+  for (auto& it : entries_) {
+    ::close(it.second->fd_);
+    delete it.second;
+  }
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status FDCache::acquire(const std::string& path, Mode mode, int* fd) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  // Hit
+  std::string k = key(path, mode);
+  auto it = entries_.find(k);
+  if (it != entries_.end()) {
+    Entry* entry = it->second;
+    lru_.splice(lru_.begin(), lru_, entry->lru_it_);
+    if (entry->ref_cnt_++ == 0)
+      used_[entry->fd_] = entry;
+    *fd = entry->fd_;
+    return Status::Ok();
+  }
+
+  // Miss
+  int new_fd = -1;
+  if (mode == Mode::READ) {
+    new_fd = ::open(path.c_str(), O_RDONLY);
+  } else if (mode == Mode::APPEND) {
+    new_fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, S_IRWXU);
+  } else {
+#ifdef O_DIRECT
+    new_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_DIRECT, S_IRWXU);
+    if (new_fd == -1 && errno == EINVAL)
+#endif
+      new_fd = ::open(path.c_str(), O_WRONLY | O_CREAT, S_IRWXU);
+  }
+  if (new_fd == -1)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot open file '") + path + "'; File opening error"));
+
+  auto entry = new Entry();
+  entry->fd_ = new_fd;
+  entry->key_ = k;
+  entry->ref_cnt_ = 1;
+  entry->cached_ = true;
+  lru_.push_front(entry);
+  entry->lru_it_ = lru_.begin();
+  entries_[k] = entry;
+  used_[new_fd] = entry;
+  *fd = new_fd;
+
+  // Eviction errors are logged and do not affect the acquired descriptor
+  evict();
+
+  return Status::Ok();
+}
+
+void FDCache::clear() {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  while (!lru_.empty())
+    drop(lru_.back());
+}
+
+void FDCache::invalidate(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  for (auto mode : {Mode::READ, Mode::APPEND, Mode::DIRECT}) {
+    std::string k = key(path, mode);
+    auto it = entries_.lower_bound(k);
+    while (it != entries_.end() && it->first.compare(0, k.size(), k) == 0) {
+      Entry* entry = it->second;
+      ++it;
+      if (entry->key_.size() == k.size() || entry->key_[k.size()] == '/')
+        drop(entry);
+    }
+  }
+}
+
+Status FDCache::release(int fd) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  auto it = used_.find(fd);
+  if (it == used_.end())
+    return LOG_STATUS(Status::IOError(
+        "Cannot release file descriptor; Descriptor not acquired"));
+
+  Entry* entry = it->second;
+  if (--entry->ref_cnt_ > 0)
+    return Status::Ok();
+  used_.erase(it);
+
+  // The entry was dropped while in use
+  if (!entry->cached_) {
+    int rc = ::close(entry->fd_);
+    delete entry;
+    if (rc != 0)
+      return LOG_STATUS(Status::IOError(
+          "Cannot release file descriptor; File closing error"));
+  }
+
+  return Status::Ok();
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+Status FDCache::drop(Entry* entry) {
+  entries_.erase(entry->key_);
+  lru_.erase(entry->lru_it_);
+  entry->cached_ = false;
+
+  // The last user closes the descriptor in `release`
+  if (entry->ref_cnt_ > 0)
+    return Status::Ok();
+
+  int rc = ::close(entry->fd_);
+  delete entry;
+  if (rc != 0)
+    return LOG_STATUS(
+        Status::IOError("Cannot evict file descriptor; File closing error"));
+
+  return Status::Ok();
+}
+
+Status FDCache::evict() {
+  while (lru_.size() > max_size_)
+    RETURN_NOT_OK(drop(lru_.back()));
+
+  return Status::Ok();
+}
+
+std::string FDCache::key(const std::string& path, Mode mode) {
+  char prefix = 'r';
+  if (mode == Mode::APPEND)
+    prefix = 'a';
+  else if (mode == Mode::DIRECT)
+    prefix = 'd';
+
+  return std::string(1, prefix) + path;
+}
+
+}  // namespace tiledb
@@ -0,0 +1,436 @@
+/**
+ * @file   mem_filesystem.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class MemFilesystem.
+ */
+
+
+#include "mem_filesystem.h"
+#include "logger.h"
+#include "posix_filesystem.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+MemFilesystem::MemFilesystem()
+    : mem_size_(0)
+    , spill_cnt_(0) {
+  root_ = std::make_shared<Node>(true, &mem_size_);
+  spill_max_size_ = UINT64_MAX;
+}
+
+MemFilesystem::~MemFilesystem() = default;
+
+MemFilesystem::Node::Node(bool is_dir, std::atomic<uint64_t>* mem_size) {
+  is_dir_ = is_dir;
+  size_ = 0;
+  mem_size_ = mem_size;
+  exclusive_lock_ = false;
+  shared_locks_ = 0;
+}
+
+MemFilesystem::Node::~Node() {
+  if (!spill_path_.empty())
+    posix::remove_file(spill_path_);
+  else
+    *mem_size_ -= data_.size();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status MemFilesystem::create_dir(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  std::string name;
+  auto parent = lookup_parent(path, &name);
+  if (parent == nullptr || !parent->is_dir_)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot create directory '") + path +
+        "'; Parent directory does not exist"));
+  if (parent->children_.count(name) != 0)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot create directory '") + path +
+        "'; Path already exists"));
+
+  parent->children_[name] = std::make_shared<Node>(true, &mem_size_);
+
+  return Status::Ok();
+}
+
+Status MemFilesystem::create_file(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  std::string name;
+  auto parent = lookup_parent(path, &name);
+  if (parent == nullptr || !parent->is_dir_)
+    return LOG_STATUS(Status::IOError(
+        std::string("Failed to create file '") + path +
+        "'; Parent directory does not exist"));
+  auto it = parent->children_.find(name);
+  if (it != parent->children_.end()) {
+    if (it->second->is_dir_)
+      return LOG_STATUS(Status::IOError(
+          std::string("Failed to create file '") + path +
+          "'; Path is a directory"));
+    return Status::Ok();
+  }
+
+  parent->children_[name] = std::make_shared<Node>(false, &mem_size_);
+
+  return Status::Ok();
+}
+
+Status MemFilesystem::file_size(const std::string& path, uint64_t* size) const {
+  auto node = file(path);
+  if (node == nullptr)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot get file size of '") + path +
+        "'; File does not exist"));
+
+  std::lock_guard<std::mutex> lock(node->mtx_);
+  *size = node->size_;
+
+  return Status::Ok();
+}
+
+Status MemFilesystem::filelock_lock(
+    const std::string& path, int* fd, bool shared) const {
+  auto node = file(path);
+  if (node == nullptr)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot open filelock '") + path +
+        "'; File does not exist"));
+
+  std::unique_lock<std::mutex> lk(node->mtx_);
+  if (shared) {
+    node->cv_.wait(lk, [&node] { return !node->exclusive_lock_; });
+    ++node->shared_locks_;
+  } else {
+    node->cv_.wait(lk, [&node] {
+      return !node->exclusive_lock_ && node->shared_locks_ == 0;
+    });
+    node->exclusive_lock_ = true;
+  }
+  *fd = shared ? 0 : 1;
+
+  return Status::Ok();
+}
+
+Status MemFilesystem::filelock_unlock(const std::string& path, int fd) const {
+  auto node = file(path);
+  if (node == nullptr)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot unlock filelock '") + path +
+        "'; File does not exist"));
+
+  std::lock_guard<std::mutex> lock(node->mtx_);
+  if (fd == 0) {
+    if (node->shared_locks_ > 0)
+      --node->shared_locks_;
+  } else {
+    node->exclusive_lock_ = false;
+  }
+  node->cv_.notify_all();
+
+  return Status::Ok();
+}
+
+bool MemFilesystem::is_dir(const std::string& path) const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto node = lookup(path);
+  return node != nullptr && node->is_dir_;
+}
+
+bool MemFilesystem::is_file(const std::string& path) const {
+  return file(path) != nullptr;
+}
+
+Status MemFilesystem::ls(
+    const std::string& path, std::vector<std::string>* paths) const {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  // Like POSIX, listing a non-existent directory yields nothing
+  auto node = lookup(path);
+  if (node == nullptr || !node->is_dir_)
+    return Status::Ok();
+
+  std::string prefix = path;
+  if (prefix.empty() || prefix.back() != '/')
+    prefix += "/";
+  for (auto& child : node->children_)
+    paths->push_back(prefix + child.first);
+
+  return Status::Ok();
+}
+
+Status MemFilesystem::move_path(
+    const std::string& old_path, const std::string& new_path) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  std::string old_name, new_name;
+  auto old_parent = lookup_parent(old_path, &old_name);
+  auto new_parent = lookup_parent(new_path, &new_name);
+  if (old_parent == nullptr || old_parent->children_.count(old_name) == 0)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot move path '") + old_path +
+        "'; Path does not exist"));
+  if (new_parent == nullptr || !new_parent->is_dir_)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot move path to '") + new_path +
+        "'; Parent directory does not exist"));
+
+  // A directory cannot be moved into itself
+  auto old_tokens = tokenize(old_path);
+  auto new_tokens = tokenize(new_path);
+  if (new_tokens.size() > old_tokens.size() &&
+      std::equal(old_tokens.begin(), old_tokens.end(), new_tokens.begin()))
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot move path '") + old_path + "' into itself"));
+
+  auto node = old_parent->children_[old_name];
+  old_parent->children_.erase(old_name);
+  new_parent->children_[new_name] = node;
+
+  return Status::Ok();
+}
+
+Status MemFilesystem::read_from_file(
+    const std::string& path,
+    uint64_t offset,
+    void* buffer,
+    uint64_t nbytes) const {
+  auto node = file(path);
+  if (node == nullptr)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot read from file '") + path +
+        "'; File does not exist"));
+
+  std::lock_guard<std::mutex> lock(node->mtx_);
+  if (offset + nbytes > node->size_)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot read from file '") + path +
+        "'; Read exceeds file size"));
+  if (!node->spill_path_.empty())
+    return posix::read_from_file(node->spill_path_, offset, buffer, nbytes);
+  std::memcpy(buffer, node->data_.data() + offset, nbytes);
+
+  return Status::Ok();
+}
+
+Status MemFilesystem::remove_path(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  // The nodes are freed once no longer in use by other threads
+  std::string name;
+  auto parent = lookup_parent(path, &name);
+  if (parent == nullptr || parent->children_.erase(name) == 0)
+    return LOG_STATUS(Status::IOError(
+        std::string("Failed to delete path '") + path +
+        "'; Path does not exist"));
+
+  return Status::Ok();
+}
+
+Status MemFilesystem::remove_file(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  std::string name;
+  auto parent = lookup_parent(path, &name);
+  auto node = lookup(path);
+  if (node == nullptr || node->is_dir_)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot delete file '") + path +
+        "'; File does not exist"));
+  parent->children_.erase(name);
+
+  return Status::Ok();
+}
+
+void MemFilesystem::set_spill(uint64_t max_size, const std::string& dir) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  spill_max_size_ = max_size;
+  spill_dir_ = dir;
+}
+
+Status MemFilesystem::truncate_file(const std::string& path, uint64_t size) {
+  auto node = file(path);
+  if (node == nullptr)
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot truncate file '") + path +
+        "'; File does not exist"));
+
+  std::lock_guard<std::mutex> lock(node->mtx_);
+  if (!node->spill_path_.empty()) {
+    RETURN_NOT_OK(posix::truncate_file(node->spill_path_, size));
+  } else {
+    mem_size_ -= node->data_.size();
+    node->data_.resize(size);
+    mem_size_ += size;
+  }
+  node->size_ = size;
+
+  return Status::Ok();
+}
+
+Status MemFilesystem::write_to_file(
+    const std::string& path, const void* buffer, uint64_t nbytes) {
+  // Retrieve the file, creating it if needed
+  std::shared_ptr<Node> node;
+  std::string spill_dir;
+  uint64_t spill_max_size;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::string name;
+    auto parent = lookup_parent(path, &name);
+    if (parent == nullptr || !parent->is_dir_)
+      return LOG_STATUS(Status::IOError(
+          std::string("Cannot write to file '") + path +
+          "'; Parent directory does not exist"));
+    auto it = parent->children_.find(name);
+    if (it == parent->children_.end()) {
+      node = std::make_shared<Node>(false, &mem_size_);
+      parent->children_[name] = node;
+    } else if (it->second->is_dir_) {
+      return LOG_STATUS(Status::IOError(
+          std::string("Cannot write to file '") + path +
+          "'; Path is a directory"));
+    } else {
+      node = it->second;
+    }
+    spill_dir = spill_dir_;
+    spill_max_size = spill_max_size_;
+  }
+
+  std::lock_guard<std::mutex> lock(node->mtx_);
+
+  // Spill the file if the memory limit would be exceeded
+  if (node->spill_path_.empty() && !spill_dir.empty() &&
+      mem_size_ + nbytes > spill_max_size)
+    RETURN_NOT_OK(spill(node.get(), spill_dir));
+
+  if (!node->spill_path_.empty()) {
+    RETURN_NOT_OK(posix::write_to_file(node->spill_path_, buffer, nbytes));
+  } else {
+    auto buffer_c = static_cast<const char*>(buffer);
+    node->data_.insert(node->data_.end(), buffer_c, buffer_c + nbytes);
+    mem_size_ += nbytes;
+  }
+  node->size_ += nbytes;
+
+  return Status::Ok();
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+std::shared_ptr<MemFilesystem::Node> MemFilesystem::file(
+    const std::string& path) const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto node = lookup(path);
+  if (node == nullptr || node->is_dir_)
+    return nullptr;
+  return node;
+}
+
+std::shared_ptr<MemFilesystem::Node> MemFilesystem::lookup(
+    const std::string& path) const {
+  auto node = root_;
+  for (const auto& token : tokenize(path)) {
+    auto it = node->children_.find(token);
+    if (it == node->children_.end())
+      return nullptr;
+    node = it->second;
+  }
+  return node;
+}
+
+std::shared_ptr<MemFilesystem::Node> MemFilesystem::lookup_parent(
+    const std::string& path, std::string* name) const {
+  auto tokens = tokenize(path);
+  if (tokens.empty())
+    return nullptr;
+
+  auto node = root_;
+  for (uint64_t i = 0; i < tokens.size() - 1; ++i) {
+    auto it = node->children_.find(tokens[i]);
+    if (it == node->children_.end())
+      return nullptr;
+    node = it->second;
+  }
+  *name = tokens.back();
+  return node;
+}
+
+Status MemFilesystem::spill(Node* node, const std::string& dir) {
+  std::string spill_path = dir + "/__mem_" + std::to_string(getpid()) + "_" +
+                           std::to_string(spill_cnt_++);
+  RETURN_NOT_OK(posix::write_to_file(
+      spill_path, node->data_.data(), node->data_.size()));
+
+  mem_size_ -= node->data_.size();
+  std::vector<char>().swap(node->data_);
+  node->spill_path_ = spill_path;
+
+  return Status::Ok();
+}
+
+std::vector<std::string> MemFilesystem::tokenize(const std::string& path) {
+  std::vector<std::string> tokens;
+  uint64_t start = 0;
+  while (start < path.size()) {
+    uint64_t end = path.find('/', start);
+    if (end == std::string::npos)
+      end = path.size();
+    if (end > start)
+      tokens.push_back(path.substr(start, end - start));
+    start = end + 1;
+  }
+  return tokens;
+}
+
+/* ****************************** */
+/*             GLOBAL             */
+/* ****************************** */
+
+MemFilesystem& global_mem_filesystem() {
+  static MemFilesystem mem_fs;
+  return mem_fs;
+}
+
+}  // namespace tiledb
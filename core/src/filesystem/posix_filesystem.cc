@@ -38,10 +38,18 @@
 #include <dirent.h>
 
 #include <ftw.h>
+#include <sys/mman.h>
 
+#include <climits>
 #include <fstream>
 #include <iostream>
 
+/* ****************************** */
+/*             MACROS             */
+/* ****************************** */
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
 namespace tiledb {
 
 namespace posix {
@@ -249,6 +257,42 @@ Status ls(const std::string& path, std::vector<std::string>* paths) {
   return Status::Ok();
 }
 
+Status map_file(const std::string& path, void** data, uint64_t* size) {
+  *data = nullptr;
+  *size = 0;
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot map file '") + path + "'; " + strerror(errno)));
+  }
+
+  struct stat st = {};
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot map file '") + path + "'; " + strerror(errno)));
+  }
+
+  // Nothing to map
+  if (st.st_size == 0) {
+    close(fd);
+    return Status::Ok();
+  }
+
+  // The mapping remains valid after the descriptor is closed
+  void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot map file '") + path + "'; " + strerror(errno)));
+  }
+
+  *data = addr;
+  *size = (uint64_t)st.st_size;
+  return Status::Ok();
+}
+
 Status move_path(const std::string& old_path, const std::string& new_path) {
   if (rename(old_path.c_str(), new_path.c_str()) != 0) {
     return LOG_STATUS(
@@ -320,13 +364,7 @@ Status read_from_file(
         Status::IOError("Cannot read from file; File opening error"));
   }
   // Read
-  lseek(fd, offset, SEEK_SET);
-  int64_t bytes_read = ::read(fd, buffer, nbytes);
-  if (bytes_read != int64_t(nbytes)) {
-    return LOG_STATUS(Status::IOError(
-        std::string("Cannot read from file '") + path.c_str() +
-        "'; File reading error"));
-  }
+  RETURN_NOT_OK_ELSE(read_from_file(fd, offset, buffer, nbytes), close(fd));
   // Close file
   if (close(fd)) {
     return LOG_STATUS(
@@ -335,6 +373,50 @@ Status read_from_file(
   return Status::Ok();
 }
 
+Status read_from_file(int fd, uint64_t offset, void* buffer, uint64_t nbytes) {
+  // pread may return fewer bytes than requested
+  auto buffer_c = static_cast<char*>(buffer);
+  while (nbytes > 0) {
+    int64_t bytes_read = ::pread(fd, buffer_c, nbytes, offset);
+    if (bytes_read <= 0)
+      return LOG_STATUS(
+          Status::IOError("Cannot read from file; File reading error"));
+    buffer_c += bytes_read;
+    offset += bytes_read;
+    nbytes -= bytes_read;
+  }
+  return Status::Ok();
+}
+
+Status read_from_file(int fd, uint64_t offset, std::vector<iovec> iov) {
+  // preadv accepts at most IOV_MAX buffers and may read fewer bytes than
+  // requested, in which case the remaining buffers are trimmed and re-read
+  uint64_t iov_start = 0;
+  while (iov_start < iov.size()) {
+    int iov_num = (int)MIN(iov.size() - iov_start, (uint64_t)IOV_MAX);
+    int64_t bytes_read = ::preadv(fd, &iov[iov_start], iov_num, offset);
+    if (bytes_read <= 0)
+      return LOG_STATUS(
+          Status::IOError("Cannot read from file; File reading error"));
+    offset += bytes_read;
+    while (bytes_read > 0) {
+      auto len = (int64_t)iov[iov_start].iov_len;
+      if (bytes_read < len) {
+        iov[iov_start].iov_base =
+            static_cast<char*>(iov[iov_start].iov_base) + bytes_read;
+        iov[iov_start].iov_len -= bytes_read;
+        break;
+      }
+      bytes_read -= len;
+      ++iov_start;
+    }
+    // Skip empty buffers
+    while (iov_start < iov.size() && iov[iov_start].iov_len == 0)
+      ++iov_start;
+  }
+  return Status::Ok();
+}
+
 Status sync(const std::string& path) {
   // Open file
   int fd = -1;
@@ -367,6 +449,40 @@ Status sync(const std::string& path) {
   return Status::Ok();
 }
 
+Status sync(int fd) {
+#ifdef __linux__
+  int rc = fdatasync(fd);
+#else
+  int rc = fsync(fd);
+#endif
+  if (rc != 0) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot sync file; ") + strerror(errno)));
+  }
+
+  return Status::Ok();
+}
+
+Status truncate_file(const std::string& path, uint64_t size) {
+  if (::truncate(path.c_str(), (off_t)size) != 0) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot truncate file '") + path + "'; " +
+        strerror(errno)));
+  }
+  return Status::Ok();
+}
+
+Status unmap_file(void* data, uint64_t size) {
+  if (data == nullptr)
+    return Status::Ok();
+
+  if (munmap(data, size) != 0) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot unmap file; ") + strerror(errno)));
+  }
+  return Status::Ok();
+}
+
 Status write_to_file(
     const std::string& path, const void* buffer, uint64_t buffer_size) {
   // Open file
@@ -377,30 +493,55 @@ Status write_to_file(
         "'; File opening error"));
   }
 
+  // Append data
+  RETURN_NOT_OK_ELSE(write_to_file(fd, buffer, buffer_size), close(fd));
+
+  // Close file
+  if (close(fd) != 0) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot write to file '") + path +
+        "'; File closing error"));
+  }
+
+  // Success
+  return Status::Ok();
+}
+
+Status write_to_file(int fd, const void* buffer, uint64_t buffer_size) {
   // Append data to the file in batches of constants::max_write_bytes
   // bytes at a time
+  auto buffer_c = static_cast<const char*>(buffer);
   int64_t bytes_written;
   while (buffer_size > constants::max_write_bytes) {
-    bytes_written = ::write(fd, buffer, constants::max_write_bytes);
-    if (bytes_written != constants::max_write_bytes) {
-      return LOG_STATUS(Status::IOError(
-          std::string("Cannot write to file '") + path +
-          "'; File writing error"));
-    }
+    bytes_written = ::write(fd, buffer_c, constants::max_write_bytes);
+    if (bytes_written != int64_t(constants::max_write_bytes))
+      return LOG_STATUS(
+          Status::IOError("Cannot write to file; File writing error"));
+    buffer_c += constants::max_write_bytes;
     buffer_size -= constants::max_write_bytes;
   }
-  bytes_written = ::write(fd, buffer, buffer_size);
-  if (bytes_written != int64_t(buffer_size)) {
-    return LOG_STATUS(Status::IOError(
-        std::string("Cannot write to file '") + path +
-        "'; File writing error"));
-  }
+  bytes_written = ::write(fd, buffer_c, buffer_size);
+  if (bytes_written != int64_t(buffer_size))
+    return LOG_STATUS(
+        Status::IOError("Cannot write to file; File writing error"));
 
-  // Close file
-  if (close(fd) != 0) {
-    return LOG_STATUS(Status::IOError(
-        std::string("Cannot write to file '") + path +
-        "'; File closing error"));
+  // Success
+  return Status::Ok();
+}
+
+Status write_to_file(
+    int fd, uint64_t offset, const void* buffer, uint64_t buffer_size) {
+  // pwrite may write fewer bytes than requested
+  auto buffer_c = static_cast<const char*>(buffer);
+  while (buffer_size > 0) {
+    int64_t bytes_written = ::pwrite(
+        fd, buffer_c, MIN(buffer_size, constants::max_write_bytes), offset);
+    if (bytes_written <= 0)
+      return LOG_STATUS(Status::IOError(
+          std::string("Cannot write to file; ") + strerror(errno)));
+    buffer_c += bytes_written;
+    offset += bytes_written;
+    buffer_size -= bytes_written;
   }
 
   // Success
@@ -0,0 +1,310 @@
+/**
+ * @file   read_ahead.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class ReadAhead.
+ */
+
+
+#include "read_ahead.h"
+#include "constants.h"
+#include "posix_filesystem.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+ReadAhead::ReadAhead(FDCache* fd_cache) {
+  enabled_ = true;
+  fd_cache_ = fd_cache;
+  stop_ = false;
+  tick_ = 0;
+}
+
+ReadAhead::~ReadAhead() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+
+    // Fail the queued chunks, so that no read waits for them
+    for (auto& task : tasks_) {
+      task.chunk_->started_ = true;
+      task.chunk_->done_ = true;
+    }
+    tasks_.clear();
+  }
+  cv_.notify_all();
+  if (thread_.joinable())
+    thread_.join();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void ReadAhead::access(
+    const std::string& path, uint64_t offset, uint64_t nbytes) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  if (!enabled_)
+    return;
+
+  // Start tracking the file
+  auto it = files_.find(path);
+  if (it == files_.end()) {
+    if (files_.size() >= constants::read_ahead_file_num)
+      evict();
+    File file;
+    file.file_size_ = UINT64_MAX;
+    file.next_offset_ = UINT64_MAX;
+    file.seq_num_ = 0;
+    file.window_ = constants::read_ahead_min_size;
+    it = files_.emplace(path, file).first;
+  }
+  File& file = it->second;
+  file.last_access_ = ++tick_;
+
+  // Adapt the window
+  if (offset >= file.next_offset_ &&
+      offset - file.next_offset_ <= file.window_) {
+    if (++file.seq_num_ > 1)
+      file.window_ =
+          std::min(2 * file.window_, constants::read_ahead_max_size);
+  } else {
+    if (file.next_offset_ != UINT64_MAX)
+      file.window_ =
+          std::max(file.window_ / 2, constants::read_ahead_min_size);
+    file.seq_num_ = 0;
+    drop_chunks(&file);
+  }
+  file.next_offset_ = offset + nbytes;
+  if (file.seq_num_ == 0)
+    return;
+
+  // Drop the chunks that were consumed
+  while (!file.chunks_.empty()) {
+    auto& chunk = file.chunks_.front();
+    if (chunk->offset_ + chunk->size_ > offset)
+      break;
+    chunk->dropped_ = true;
+    file.chunks_.pop_front();
+  }
+
+  // Refill the window once half of it has been consumed
+  uint64_t start = file.next_offset_;
+  if (!file.chunks_.empty()) {
+    auto& chunk = file.chunks_.back();
+    if (file.chunks_.front()->offset_ <= file.next_offset_ &&
+        chunk->offset_ + chunk->size_ >= file.next_offset_)
+      start = chunk->offset_ + chunk->size_;
+    else
+      drop_chunks(&file);
+  }
+  if (start >= file.next_offset_ + file.window_ / 2)
+    return;
+  if (file.file_size_ == UINT64_MAX &&
+      !posix::file_size(path, &file.file_size_).ok())
+    return;
+  uint64_t end =
+      std::min(file.next_offset_ + file.window_, file.file_size_);
+  if (start >= end)
+    return;
+  while (start < end) {
+    auto chunk = std::make_shared<Chunk>();
+    chunk->offset_ = start;
+    chunk->size_ = std::min(constants::read_ahead_chunk_size, end - start);
+    chunk->done_ = false;
+    chunk->ok_ = false;
+    chunk->dropped_ = false;
+    chunk->started_ = false;
+    file.chunks_.push_back(chunk);
+    tasks_.push_back({path, chunk});
+    start += chunk->size_;
+  }
+
+  if (!thread_.joinable())
+    thread_ = std::thread(&ReadAhead::run, this);
+  cv_.notify_all();
+}
+
+void ReadAhead::invalidate(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  auto it = files_.lower_bound(path);
+  while (it != files_.end() && it->first.compare(0, path.size(), path) == 0) {
+    if (it->first.size() == path.size() || it->first[path.size()] == '/') {
+      drop_chunks(&it->second);
+      it = files_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool ReadAhead::read(
+    const std::string& path, uint64_t offset, void* buffer, uint64_t nbytes) {
+  std::unique_lock<std::mutex> lk(mtx_);
+
+  auto it = files_.find(path);
+  if (it == files_.end() || nbytes == 0)
+    return false;
+
+  // Find the chunks covering the region
+  std::vector<std::shared_ptr<Chunk>> chunks;
+  uint64_t pos = offset, end = offset + nbytes;
+  for (auto& chunk : it->second.chunks_) {
+    if (chunk->offset_ + chunk->size_ <= pos)
+      continue;
+    if (chunk->offset_ > pos)
+      break;
+    chunks.push_back(chunk);
+    pos = chunk->offset_ + chunk->size_;
+    if (pos >= end)
+      break;
+  }
+  if (pos < end)
+    return false;
+
+  // Fetch the chunks that are still queued on the calling thread, rather
+  // than waiting behind the prefetches of other files
+  for (auto& chunk : chunks) {
+    if (chunk->started_)
+      continue;
+    chunk->started_ = true;
+    auto task = std::find_if(
+        tasks_.begin(), tasks_.end(), [&chunk](const Task& t) {
+          return t.chunk_ == chunk;
+        });
+    if (task != tasks_.end())
+      tasks_.erase(task);
+    lk.unlock();
+    fetch(path, chunk.get());
+    lk.lock();
+    chunk->done_ = true;
+    cv_.notify_all();
+  }
+
+  // Wait for the chunks being fetched by the background thread
+  cv_.wait(lk, [&chunks]() {
+    for (auto& chunk : chunks) {
+      if (!chunk->done_)
+        return false;
+    }
+    return true;
+  });
+
+  // Copy the data
+  auto buffer_c = static_cast<char*>(buffer);
+  pos = offset;
+  for (auto& chunk : chunks) {
+    if (!chunk->ok_)
+      return false;
+    uint64_t chunk_offset = pos - chunk->offset_;
+    uint64_t bytes_to_copy = std::min(chunk->size_ - chunk_offset, end - pos);
+    std::memcpy(
+        buffer_c + (pos - offset),
+        &chunk->data_[chunk_offset],
+        bytes_to_copy);
+    pos += bytes_to_copy;
+  }
+
+  return true;
+}
+
+void ReadAhead::set_enabled(bool enabled) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  enabled_ = enabled;
+  if (!enabled_) {
+    for (auto& it : files_)
+      drop_chunks(&it.second);
+    files_.clear();
+  }
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+void ReadAhead::drop_chunks(File* file) {
+  for (auto& chunk : file->chunks_)
+    chunk->dropped_ = true;
+  file->chunks_.clear();
+}
+
+void ReadAhead::evict() {
+  auto victim = files_.begin();
+  for (auto it = files_.begin(); it != files_.end(); ++it) {
+    if (it->second.last_access_ < victim->second.last_access_)
+      victim = it;
+  }
+  if (victim != files_.end()) {
+    drop_chunks(&victim->second);
+    files_.erase(victim);
+  }
+}
+
+void ReadAhead::fetch(const std::string& path, Chunk* chunk) {
+  std::vector<char> data(chunk->size_);
+  int fd;
+  if (!fd_cache_->acquire(path, FDCache::Mode::READ, &fd).ok())
+    return;
+  Status st = posix::read_from_file(fd, chunk->offset_, &data[0], chunk->size_);
+  fd_cache_->release(fd);
+  if (st.ok()) {
+    chunk->data_.swap(data);
+    chunk->ok_ = true;
+  }
+}
+
+void ReadAhead::run() {
+  std::unique_lock<std::mutex> lk(mtx_);
+  while (true) {
+    cv_.wait(lk, [this]() { return stop_ || !tasks_.empty(); });
+    if (stop_)
+      break;
+
+    Task task = tasks_.front();
+    tasks_.pop_front();
+    task.chunk_->started_ = true;
+    if (!task.chunk_->dropped_) {
+      lk.unlock();
+      fetch(task.path_, task.chunk_.get());
+      lk.lock();
+    }
+    task.chunk_->done_ = true;
+    cv_.notify_all();
+  }
+}
+
+}  // namespace tiledb
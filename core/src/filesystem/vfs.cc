@@ -31,10 +31,15 @@
  */
 
 #include "vfs.h"
+#include "constants.h"
 #include "hdfs_filesystem.h"
 #include "logger.h"
+#include "mem_filesystem.h"
 #include "posix_filesystem.h"
+#include "read_ahead.h"
 
+#include <algorithm>
+#include <climits>
 #include <iostream>
 
 namespace tiledb {
@@ -44,6 +49,10 @@ namespace tiledb {
 /* ********************************* */
 
 VFS::VFS() {
+  async_io_ = new AsyncIO(constants::async_io_queue_depth);
+  fd_cache_ = new FDCache(constants::fd_cache_size);
+  read_ahead_ = new ReadAhead(fd_cache_);
+  mem_fs_ = &global_mem_filesystem();
 #ifdef HAVE_HDFS
   Status st = hdfs::connect(hdfs_);
 #endif
@@ -55,6 +64,9 @@ VFS::~VFS() {
     // Status st = hdfs::disconnect(hdfs_);
   }
 #endif
+  delete async_io_;
+  delete read_ahead_;
+  delete fd_cache_;
 }
 
 /* ********************************* */
@@ -74,6 +86,9 @@ Status VFS::create_dir(const URI& uri) const {
   if (uri.is_posix()) {
     return posix::create_dir(uri.to_path());
   }
+  if (uri.is_mem()) {
+    return mem_fs_->create_dir(uri.to_path());
+  }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
     return hdfs::create_dir(hdfs_, uri);
@@ -89,6 +104,9 @@ Status VFS::create_file(const URI& uri) const {
   if (uri.is_posix()) {
     return posix::create_file(uri.to_path());
   }
+  if (uri.is_mem()) {
+    return mem_fs_->create_file(uri.to_path());
+  }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
     return hdfs::create_file(hdfs_, uri);
@@ -102,7 +120,11 @@ Status VFS::create_file(const URI& uri) const {
 
 Status VFS::remove_path(const URI& uri) const {
   if (uri.is_posix()) {
+    fd_cache_->invalidate(uri.to_path());
+    read_ahead_->invalidate(uri.to_path());
     return posix::remove_path(uri.to_path());
+  } else if (uri.is_mem()) {
+    return mem_fs_->remove_path(uri.to_path());
   } else if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
     return hdfs::remove_path(hdfs_, uri);
@@ -116,8 +138,13 @@ Status VFS::remove_path(const URI& uri) const {
 
 Status VFS::remove_file(const URI& uri) const {
   if (uri.is_posix()) {
+    fd_cache_->invalidate(uri.to_path());
+    read_ahead_->invalidate(uri.to_path());
     return posix::remove_file(uri.to_path());
   }
+  if (uri.is_mem()) {
+    return mem_fs_->remove_file(uri.to_path());
+  }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
     return hdfs::remove_file(hdfs_, uri);
@@ -131,6 +158,8 @@ Status VFS::remove_file(const URI& uri) const {
 Status VFS::filelock_lock(const URI& uri, int* fd, bool shared) const {
   if (uri.is_posix())
     return posix::filelock_lock(uri.to_path(), fd, shared);
+  if (uri.is_mem())
+    return mem_fs_->filelock_lock(uri.to_path(), fd, shared);
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
     return Status::Ok();
@@ -145,6 +174,9 @@ Status VFS::filelock_unlock(const URI& uri, int fd) const {
   if (uri.is_posix()) {
     return posix::filelock_unlock(fd);
   }
+  if (uri.is_mem()) {
+    return mem_fs_->filelock_unlock(uri.to_path(), fd);
+  }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
     return Status::Ok();
@@ -159,6 +191,9 @@ Status VFS::file_size(const URI& uri, uint64_t* size) const {
   if (uri.is_posix()) {
     return posix::file_size(uri.to_path(), size);
   }
+  if (uri.is_mem()) {
+    return mem_fs_->file_size(uri.to_path(), size);
+  }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
     return hdfs::file_size(hdfs_, uri, size);
@@ -169,10 +204,20 @@ Status VFS::file_size(const URI& uri, uint64_t* size) const {
   return Status::VFSError("Unsupported URI scheme: " + uri.to_string());
 }
 
+void VFS::invalidate(const URI& uri) const {
+  if (uri.is_posix()) {
+    fd_cache_->invalidate(uri.to_path());
+    read_ahead_->invalidate(uri.to_path());
+  }
+}
+
 bool VFS::is_dir(const URI& uri) const {
   if (uri.is_posix()) {
     return posix::is_dir(uri.to_path());
   }
+  if (uri.is_mem()) {
+    return mem_fs_->is_dir(uri.to_path());
+  }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
     return hdfs::is_dir(hdfs_, uri);
@@ -187,6 +232,9 @@ bool VFS::is_file(const URI& uri) const {
   if (uri.is_posix()) {
     return posix::is_file(uri.to_path());
   }
+  if (uri.is_mem()) {
+    return mem_fs_->is_file(uri.to_path());
+  }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
     return hdfs::is_file(hdfs_, uri);
@@ -201,6 +249,10 @@ Status VFS::ls(const URI& parent, std::vector<URI>* uris) const {
   std::vector<std::string> files;
   if (parent.is_posix()) {
     RETURN_NOT_OK(posix::ls(parent.to_path(), &files));
+  } else if (parent.is_mem()) {
+    RETURN_NOT_OK(mem_fs_->ls(parent.to_path(), &files));
+    for (auto& file : files)
+      file = "mem://" + file;
   } else if (parent.is_hdfs()) {
 #ifdef HAVE_HDFS
     RETURN_NOT_OK(hdfs::ls(hdfs_, parent, &files));
@@ -216,16 +268,34 @@ Status VFS::ls(const URI& parent, std::vector<URI>* uris) const {
   return Status::Ok();
 }
 
+Status VFS::map_file(const URI& uri, void** data, uint64_t* size) const {
+  if (uri.is_posix()) {
+    return posix::map_file(uri.to_path(), data, size);
+  }
+  return Status::VFSError(
+      "Cannot map file; Unsupported URI scheme: " + uri.to_string());
+}
+
 Status VFS::move_path(const URI& old_uri, const URI& new_uri) {
   if (old_uri.is_posix()) {
+    fd_cache_->invalidate(old_uri.to_path());
+    read_ahead_->invalidate(old_uri.to_path());
     if (new_uri.is_posix()) {
+      read_ahead_->invalidate(new_uri.to_path());
       return posix::move_path(old_uri.to_path(), new_uri.to_path());
     }
     if (new_uri.is_hdfs()) {
       return hdfs::put_path(old_uri, new_uri);
     }
   }
+  if (old_uri.is_mem() && new_uri.is_mem()) {
+    return mem_fs_->move_path(old_uri.to_path(), new_uri.to_path());
+  }
   if (old_uri.is_hdfs()) {
+    if (new_uri.is_posix()) {
+      fd_cache_->invalidate(new_uri.to_path());
+      read_ahead_->invalidate(new_uri.to_path());
+    }
     if (new_uri.is_hdfs()) {
 #ifdef HAVE_HDFS
       return hdfs::move_path(hdfs_, old_uri, new_uri);
@@ -242,10 +312,84 @@ Status VFS::move_path(const URI& old_uri, const URI& new_uri) {
       new_uri.to_string());
 }
 
+Status VFS::read_batch(
+    const URI& uri, const std::vector<ReadRegion>& regions) const {
+  if (!uri.is_posix()) {
+    for (auto& region : regions)
+      RETURN_NOT_OK(
+          read_from_file(uri, region.offset_, region.buffer_, region.nbytes_));
+    return Status::Ok();
+  }
+
+  // Serve the prefetched regions, and sort the rest on their file offsets
+  std::string path = uri.to_path();
+  std::vector<const ReadRegion*> sorted;
+  uint64_t start = UINT64_MAX, end = 0;
+  for (auto& region : regions) {
+    if (region.nbytes_ == 0)
+      continue;
+    start = std::min(start, region.offset_);
+    end = std::max(end, region.offset_ + region.nbytes_);
+    if (!read_ahead_->read(
+            path, region.offset_, region.buffer_, region.nbytes_))
+      sorted.push_back(&region);
+  }
+  if (start < end)
+    read_ahead_->access(path, start, end - start);
+  if (sorted.empty())
+    return Status::Ok();
+  std::sort(
+      sorted.begin(),
+      sorted.end(),
+      [](const ReadRegion* a, const ReadRegion* b) {
+        return a->offset_ < b->offset_;
+      });
+
+  int fd;
+  RETURN_NOT_OK(fd_cache_->acquire(path, FDCache::Mode::READ, &fd));
+
+  // Create one vectored read per run of adjacent regions
+  std::vector<AsyncIO::Request> requests;
+  uint64_t run_end = 0;
+  for (auto region : sorted) {
+    if (requests.empty() || region->offset_ != run_end ||
+        requests.back().iov_.size() == (size_t)IOV_MAX) {
+      AsyncIO::Request request;
+      request.fd_ = fd;
+      request.offset_ = region->offset_;
+      request.write_ = false;
+      requests.push_back(request);
+    }
+    iovec v;
+    v.iov_base = region->buffer_;
+    v.iov_len = region->nbytes_;
+    requests.back().iov_.push_back(v);
+    run_end = region->offset_ + region->nbytes_;
+  }
+
+  // Issue all the reads at once
+  RETURN_NOT_OK_ELSE(async_io_->execute(&requests), fd_cache_->release(fd));
+
+  return fd_cache_->release(fd);
+}
+
 Status VFS::read_from_file(
     const URI& uri, uint64_t offset, void* buffer, uint64_t nbytes) const {
   if (uri.is_posix()) {
-    return posix::read_from_file(uri.to_path(), offset, buffer, nbytes);
+    std::string path = uri.to_path();
+    if (!read_ahead_->read(path, offset, buffer, nbytes)) {
+      int fd;
+      RETURN_NOT_OK(fd_cache_->acquire(path, FDCache::Mode::READ, &fd));
+      RETURN_NOT_OK_ELSE(
+          posix::read_from_file(fd, offset, buffer, nbytes),
+          fd_cache_->release(fd));
+      RETURN_NOT_OK(fd_cache_->release(fd));
+    }
+    read_ahead_->access(path, offset, nbytes);
+    return Status::Ok();
+  }
+  if (uri.is_mem()) {
+    return mem_fs_->read_from_file(uri.to_path(), offset, buffer, nbytes);
   }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
@@ -257,10 +401,22 @@ Status VFS::read_from_file(
   return Status::VFSError("Unsupported URI schemes: " + uri.to_string());
 }
 
+void VFS::set_mem_spill(uint64_t max_size, const std::string& dir) {
+  mem_fs_->set_spill(max_size, dir);
+}
+
+void VFS::set_read_ahead(bool enabled) {
+  read_ahead_->set_enabled(enabled);
+}
+
 Status VFS::sync(const URI& uri) const {
   if (uri.is_posix()) {
+    fd_cache_->invalidate(uri.to_path());
     return posix::sync(uri.to_path());
   }
+  if (uri.is_mem()) {
+    return Status::Ok();
+  }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
     return Status::Ok();
@@ -271,10 +427,82 @@ Status VFS::sync(const URI& uri) const {
   return Status::VFSError("Unsupported URI schemes: " + uri.to_string());
 }
 
+Status VFS::sync_batch(
+    const std::vector<URI>& uris, ThreadPool* thread_pool) const {
+  // Acquire the descriptors of the POSIX files
+  std::vector<int> fds;
+  Status st;
+  for (const auto& uri : uris) {
+    if (uri.is_posix()) {
+      std::string path = uri.to_path();
+      if (!posix::is_file(path))
+        continue;
+      int fd;
+      st = fd_cache_->acquire(path, FDCache::Mode::APPEND, &fd);
+      if (!st.ok())
+        break;
+      fds.push_back(fd);
+    } else if (uri.is_mem()) {
+      continue;
+    } else if (uri.is_hdfs()) {
+#ifndef HAVE_HDFS
+      st = LOG_STATUS(
+          Status::VFSError("TileDB was built without HDFS support"));
+      break;
+#endif
+    } else {
+      st = LOG_STATUS(
+          Status::VFSError("Unsupported URI schemes: " + uri.to_string()));
+      break;
+    }
+  }
+
+  // Sync the files in parallel
+  if (st.ok())
+    st = thread_pool->parallel_for(
+        fds.size(),
+        [&fds](uint64_t i) { return posix::sync(fds[i]); },
+        constants::sync_thread_num);
+
+  // Release the descriptors
+  for (auto fd : fds) {
+    Status release_st = fd_cache_->release(fd);
+    if (st.ok())
+      st = release_st;
+  }
+
+  return st;
+}
+
+Status VFS::truncate_file(const URI& uri, uint64_t size) const {
+  if (uri.is_posix()) {
+    read_ahead_->invalidate(uri.to_path());
+    return posix::truncate_file(uri.to_path(), size);
+  }
+  if (uri.is_mem()) {
+    return mem_fs_->truncate_file(uri.to_path(), size);
+  }
+  return Status::VFSError(
+      "Cannot truncate file; Unsupported URI scheme: " + uri.to_string());
+}
+
+Status VFS::unmap_file(void* data, uint64_t size) const {
+  return posix::unmap_file(data, size);
+}
+
 Status VFS::write_to_file(
     const URI& uri, const void* buffer, uint64_t buffer_size) const {
   if (uri.is_posix()) {
-    return posix::write_to_file(uri.to_path(), buffer, buffer_size);
+    read_ahead_->invalidate(uri.to_path());
+    int fd;
+    RETURN_NOT_OK(
+        fd_cache_->acquire(uri.to_path(), FDCache::Mode::APPEND, &fd));
+    RETURN_NOT_OK_ELSE(
+        posix::write_to_file(fd, buffer, buffer_size), fd_cache_->release(fd));
+    return fd_cache_->release(fd);
+  }
+  if (uri.is_mem()) {
+    return mem_fs_->write_to_file(uri.to_path(), buffer, buffer_size);
   }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
@@ -286,4 +514,24 @@ Status VFS::write_to_file(
   return Status::VFSError("Unsupported URI schemes: " + uri.to_string());
 }
 
+Status VFS::write_to_file_direct(
+    const URI& uri,
+    uint64_t offset,
+    const void* buffer,
+    uint64_t buffer_size) const {
+  if (!uri.is_posix()) {
+    return Status::VFSError(
+        "Cannot write to file with direct I/O; Unsupported URI scheme: " +
+        uri.to_string());
+  }
+
+  read_ahead_->invalidate(uri.to_path());
+  int fd;
+  RETURN_NOT_OK(fd_cache_->acquire(uri.to_path(), FDCache::Mode::DIRECT, &fd));
+  RETURN_NOT_OK_ELSE(
+      posix::write_to_file(fd, offset, buffer, buffer_size),
+      fd_cache_->release(fd));
+  return fd_cache_->release(fd);
+}
+
 }  // namespace tiledb
@@ -214,6 +214,22 @@ Status Fragment::init(const URI& uri, FragmentMetadata* metadata) {
   metadata_ = metadata;
   dense_ = metadata_->dense();
 
+  // Load the metadata sections accessed by the query
+  const ArrayMetadata* array_metadata = query_->array_metadata();
+  unsigned int attribute_num = array_metadata->attribute_num();
+  for (auto attribute_id : query_->attribute_ids()) {
+    RETURN_NOT_OK(metadata_->load_tile_offsets(attribute_id));
+    if (array_metadata->var_size(attribute_id)) {
+      RETURN_NOT_OK(metadata_->load_tile_var_offsets(attribute_id));
+      RETURN_NOT_OK(metadata_->load_tile_var_sizes(attribute_id));
+    }
+  }
+  if (!dense_) {
+    RETURN_NOT_OK(metadata_->load_tile_offsets(attribute_num));
+    RETURN_NOT_OK(metadata_->load_mbrs());
+    RETURN_NOT_OK(metadata_->load_bounding_coords());
+  }
+
   read_state_ = new ReadState(this, query_, metadata_);
 
   // Success
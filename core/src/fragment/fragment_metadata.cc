@@ -33,7 +33,10 @@
 
 #include "fragment_metadata.h"
 #include "const_buffer.h"
+#include "constants.h"
 #include "logger.h"
+#include "tile_io.h"
+#include "utils.h"
 
 #include <cassert>
 #include <iostream>
@@ -57,7 +60,11 @@ FragmentMetadata::FragmentMetadata(
     , dense_(dense)
     , fragment_uri_(fragment_uri) {
   domain_ = nullptr;
+  last_tile_cell_num_ = 0;
   non_empty_domain_ = nullptr;
+  rtree_ = nullptr;
+  storage_manager_ = nullptr;
+  tile_num_ = 0;
 }
 
 FragmentMetadata::~FragmentMetadata() {
@@ -67,6 +74,8 @@ FragmentMetadata::~FragmentMetadata() {
   if (non_empty_domain_ != nullptr)
     std::free(non_empty_domain_);
 
+  delete rtree_;
+
   auto mbr_num = (uint64_t)mbrs_.size();
   for (int64_t i = 0; i < mbr_num; ++i)
     if (mbrs_[i] != nullptr)
@@ -76,6 +85,12 @@ FragmentMetadata::~FragmentMetadata() {
   for (int64_t i = 0; i < bounding_coords_num; ++i)
     if (bounding_coords_[i] != nullptr)
       std::free(bounding_coords_[i]);
+
+  for (auto& mapped_file : mapped_files_) {
+    if (mapped_file.second.first != nullptr)
+      storage_manager_->unmap_file(
+          mapped_file.second.first, mapped_file.second.second);
+  }
 }
 
 /* ****************************** */
@@ -100,6 +115,9 @@ void FragmentMetadata::append_mbr(const void* mbr) {
   void* new_mbr = std::malloc(mbr_size);
   std::memcpy(new_mbr, mbr, mbr_size);
   mbrs_.push_back(new_mbr);
+  ++tile_num_;
+
+  expand_non_empty_domain(mbr);
 }
 
 void FragmentMetadata::append_tile_offset(
@@ -181,16 +199,30 @@ bool FragmentMetadata::dense() const {
   return dense_;
 }
 
-Status FragmentMetadata::deserialize(ConstBuffer* buf) {
-  RETURN_NOT_OK(load_non_empty_domain(buf));
-  RETURN_NOT_OK(load_mbrs(buf));
-  RETURN_NOT_OK(load_bounding_coords(buf));
-  RETURN_NOT_OK(load_tile_offsets(buf));
-  RETURN_NOT_OK(load_tile_var_offsets(buf));
-  RETURN_NOT_OK(load_tile_var_sizes(buf));
-  RETURN_NOT_OK(load_last_tile_cell_num(buf));
+Status FragmentMetadata::deserialize(
+    StorageManager* storage_manager, ConstBuffer* buf) {
+  unsigned int attribute_num = array_metadata_->attribute_num();
+  storage_manager_ = storage_manager;
+  tile_offsets_.resize(attribute_num + 1);
+  tile_var_offsets_.resize(attribute_num);
+  tile_var_sizes_.resize(attribute_num);
 
-  return Status::Ok();
+  RETURN_NOT_OK(read_non_empty_domain(buf));
+  RETURN_NOT_OK(read_mbrs(buf));
+  RETURN_NOT_OK(read_bounding_coords(buf));
+  for (unsigned int i = 0; i < attribute_num + 1; ++i)
+    RETURN_NOT_OK(read_tile_offsets(i, buf));
+  for (unsigned int i = 0; i < attribute_num; ++i)
+    RETURN_NOT_OK(read_tile_var_offsets(i, buf));
+  for (unsigned int i = 0; i < attribute_num; ++i)
+    RETURN_NOT_OK(read_tile_var_sizes(i, buf));
+  RETURN_NOT_OK(read_last_tile_cell_num(buf));
+
+  // All the sections are loaded
+  tile_num_ = mbrs_.size();
+  section_loaded_.assign(section_num(), true);
+
+  return build_rtree();
 }
 
 const void* FragmentMetadata::domain() const {
@@ -241,6 +273,33 @@ Status FragmentMetadata::init(const void* non_empty_domain) {
   // Initialize variable tile sizes
   tile_var_sizes_.resize(attribute_num);
 
+  // All the sections are built in memory
+  tile_num_ = 0;
+  section_loaded_.assign(section_num(), true);
+
+  return Status::Ok();
+}
+
+Status FragmentMetadata::init_sections(
+    StorageManager* storage_manager,
+    const std::vector<uint64_t>& section_offsets,
+    ConstBuffer* basic) {
+  // For easy reference
+  unsigned int attribute_num = array_metadata_->attribute_num();
+
+  storage_manager_ = storage_manager;
+  section_offsets_ = section_offsets;
+  section_loaded_.assign(section_num(), false);
+
+  // Allocate the structures of the sections loaded on demand
+  tile_offsets_.resize(attribute_num + 1);
+  tile_var_offsets_.resize(attribute_num);
+  tile_var_sizes_.resize(attribute_num);
+
+  // Load the basic section
+  RETURN_NOT_OK(deserialize(0u, basic));
+  section_loaded_[0] = true;
+
   return Status::Ok();
 }
 
@@ -311,24 +370,187 @@ uint64_t FragmentMetadata::last_tile_cell_num() const {
 }
 >>>>>>> upstream/dev
 
+Status FragmentMetadata::load_bounding_coords() {
+  return load_section(2);
+}
+
+Status FragmentMetadata::load_mbrs() {
+  return load_section(1);
+}
+
+Status FragmentMetadata::load_tile_offsets(unsigned int attribute_id) {
+  return load_section(3 + attribute_id);
+}
+
+Status FragmentMetadata::load_tile_var_offsets(unsigned int attribute_id) {
+  return load_section(4 + array_metadata_->attribute_num() + attribute_id);
+}
+
+Status FragmentMetadata::load_tile_var_sizes(unsigned int attribute_id) {
+  return load_section(4 + 2 * array_metadata_->attribute_num() + attribute_id);
+}
+
+Status FragmentMetadata::map_file(
+    const URI& uri, void** data, uint64_t* size) {
+  std::unique_lock<std::mutex> lck(mtx_);
+
+  auto it = mapped_files_.find(uri.to_string());
+  if (it == mapped_files_.end()) {
+    if (storage_manager_ == nullptr)
+      return LOG_STATUS(Status::FragmentError(
+          "Cannot map file; Fragment metadata not loaded from storage"));
+    std::pair<void*, uint64_t> mapping(nullptr, 0);
+    RETURN_NOT_OK(
+        storage_manager_->map_file(uri, &mapping.first, &mapping.second));
+    it = mapped_files_.emplace(uri.to_string(), mapping).first;
+  }
+
+  *data = it->second.first;
+  *size = it->second.second;
+
+  return Status::Ok();
+}
+
 const std::vector<void*>& FragmentMetadata::mbrs() const {
   return mbrs_;
 }
 
+uint64_t FragmentMetadata::memory_size() const {
+  std::unique_lock<std::mutex> lck(mtx_);
+
+  // For easy reference
+  uint64_t domain_size = 2 * array_metadata_->coords_size();
+
+  uint64_t size = sizeof(FragmentMetadata) + 2 * domain_size;
+  size += (bounding_coords_.size() + mbrs_.size()) *
+          (domain_size + sizeof(void*));
+  size += (next_tile_offsets_.size() + next_tile_var_offsets_.size()) *
+          sizeof(uint64_t);
+  for (auto& offsets : tile_offsets_)
+    size += offsets.size() * sizeof(uint64_t);
+  for (auto& offsets : tile_var_offsets_)
+    size += offsets.size() * sizeof(uint64_t);
+  for (auto& sizes : tile_var_sizes_)
+    size += sizes.size() * sizeof(uint64_t);
+  if (rtree_ != nullptr)
+    size += rtree_->memory_size();
+
+  return size;
+}
+
 const void* FragmentMetadata::non_empty_domain() const {
   return non_empty_domain_;
 }
 
-Status FragmentMetadata::serialize(Buffer* buf) {
-  RETURN_NOT_OK(write_non_empty_domain(buf));
-  RETURN_NOT_OK(write_mbrs(buf));
-  RETURN_NOT_OK(write_bounding_coords(buf));
-  RETURN_NOT_OK(write_tile_offsets(buf));
-  RETURN_NOT_OK(write_tile_var_offsets(buf));
-  RETURN_NOT_OK(write_tile_var_sizes(buf));
-  RETURN_NOT_OK(write_last_tile_cell_num(buf));
+bool FragmentMetadata::overlaps(const void* subarray) const {
+  // For easy reference
+  Datatype coords_type = array_metadata_->coords_type();
+  unsigned int dim_num = array_metadata_->dim_num();
+
+  // Trivial case
+  if (subarray == nullptr || non_empty_domain_ == nullptr)
+    return true;
+
+  if (coords_type == Datatype::INT32) {
+    return utils::overlap(
+        static_cast<const int*>(subarray),
+        static_cast<const int*>(non_empty_domain_),
+        dim_num);
+  } else if (coords_type == Datatype::INT64) {
+    return utils::overlap(
+        static_cast<const int64_t*>(subarray),
+        static_cast<const int64_t*>(non_empty_domain_),
+        dim_num);
+  } else if (coords_type == Datatype::FLOAT32) {
+    return utils::overlap(
+        static_cast<const float*>(subarray),
+        static_cast<const float*>(non_empty_domain_),
+        dim_num);
+  } else if (coords_type == Datatype::FLOAT64) {
+    return utils::overlap(
+        static_cast<const double*>(subarray),
+        static_cast<const double*>(non_empty_domain_),
+        dim_num);
+  } else if (coords_type == Datatype::INT8) {
+    return utils::overlap(
+        static_cast<const int8_t*>(subarray),
+        static_cast<const int8_t*>(non_empty_domain_),
+        dim_num);
+  } else if (coords_type == Datatype::UINT8) {
+    return utils::overlap(
+        static_cast<const uint8_t*>(subarray),
+        static_cast<const uint8_t*>(non_empty_domain_),
+        dim_num);
+  } else if (coords_type == Datatype::INT16) {
+    return utils::overlap(
+        static_cast<const int16_t*>(subarray),
+        static_cast<const int16_t*>(non_empty_domain_),
+        dim_num);
+  } else if (coords_type == Datatype::UINT16) {
+    return utils::overlap(
+        static_cast<const uint16_t*>(subarray),
+        static_cast<const uint16_t*>(non_empty_domain_),
+        dim_num);
+  } else if (coords_type == Datatype::UINT32) {
+    return utils::overlap(
+        static_cast<const uint32_t*>(subarray),
+        static_cast<const uint32_t*>(non_empty_domain_),
+        dim_num);
+  } else if (coords_type == Datatype::UINT64) {
+    return utils::overlap(
+        static_cast<const uint64_t*>(subarray),
+        static_cast<const uint64_t*>(non_empty_domain_),
+        dim_num);
+  }
 
-  return Status::Ok();
+  // The code should never reach here
+  assert(0);
+  return true;
+}
+
+const RTree* FragmentMetadata::rtree() const {
+  return rtree_;
+}
+
+unsigned int FragmentMetadata::section_num() const {
+  return 4 + 3 * array_metadata_->attribute_num();
+}
+
+// ===== SECTIONS =====
+// basic: non_empty_domain, last_tile_cell_num, tile_num (uint64_t)
+// MBRs
+// bounding coordinates
+// tile offsets of attribute#0 ... tile offsets of attribute#<attribute_num>
+// variable tile offsets of attribute#0 ...
+//     variable tile offsets of attribute#<attribute_num-1>
+// variable tile sizes of attribute#0 ...
+//     variable tile sizes of attribute#<attribute_num-1>
+Status FragmentMetadata::serialize(unsigned int section, Buffer* buf) {
+  // For easy reference
+  unsigned int attribute_num = array_metadata_->attribute_num();
+
+  if (section == 0) {
+    RETURN_NOT_OK(write_non_empty_domain(buf));
+    RETURN_NOT_OK(write_last_tile_cell_num(buf));
+    Status st = buf->write(&tile_num_, sizeof(uint64_t));
+    if (!st.ok()) {
+      return LOG_STATUS(Status::FragmentMetadataError(
+          "Cannot serialize fragment metadata; Writing tile number failed"));
+    }
+    return Status::Ok();
+  }
+  if (section == 1)
+    return write_mbrs(buf);
+  if (section == 2)
+    return write_bounding_coords(buf);
+
+  section -= 3;
+  if (section < attribute_num + 1)
+    return write_tile_offsets(section, buf);
+  section -= attribute_num + 1;
+  if (section < attribute_num)
+    return write_tile_var_offsets(section, buf);
+  return write_tile_var_sizes(section - attribute_num, buf);
 }
 
 void FragmentMetadata::set_last_tile_cell_num(uint64_t cell_num) {
@@ -339,7 +561,7 @@ uint64_t FragmentMetadata::tile_num() const {
   if (dense_)
     return array_metadata_->domain()->tile_num(domain_);
 
-  return (uint64_t)mbrs_.size();
+  return tile_num_;
 }
 
 const std::vector<std::vector<uint64_t>>& FragmentMetadata::tile_offsets()
@@ -361,10 +583,143 @@ const std::vector<std::vector<uint64_t>>& FragmentMetadata::tile_var_sizes()
 /*        PRIVATE METHODS         */
 /* ****************************** */
 
+Status FragmentMetadata::build_rtree() {
+  if (dense_ || mbrs_.empty())
+    return Status::Ok();
+
+  delete rtree_;
+  rtree_ = new RTree(
+      array_metadata_->coords_type(),
+      array_metadata_->dim_num(),
+      constants::rtree_fanout);
+  return rtree_->build(&mbrs_);
+}
+
+// See *serialize* for the sections
+Status FragmentMetadata::deserialize(unsigned int section, ConstBuffer* buf) {
+  // For easy reference
+  unsigned int attribute_num = array_metadata_->attribute_num();
+
+  if (section == 0) {
+    RETURN_NOT_OK(read_non_empty_domain(buf));
+    RETURN_NOT_OK(read_last_tile_cell_num(buf));
+    Status st = buf->read(&tile_num_, sizeof(uint64_t));
+    if (!st.ok()) {
+      return LOG_STATUS(Status::FragmentMetadataError(
+          "Cannot load fragment metadata; Reading tile number failed"));
+    }
+    return Status::Ok();
+  }
+  if (section == 1) {
+    RETURN_NOT_OK(read_mbrs(buf));
+    return build_rtree();
+  }
+  if (section == 2)
+    return read_bounding_coords(buf);
+
+  section -= 3;
+  if (section < attribute_num + 1)
+    return read_tile_offsets(section, buf);
+  section -= attribute_num + 1;
+  if (section < attribute_num)
+    return read_tile_var_offsets(section, buf);
+  return read_tile_var_sizes(section - attribute_num, buf);
+}
+
+void FragmentMetadata::expand_non_empty_domain(const void* mbr) {
+  // Do nothing if the fragment was not initialized for writing
+  if (non_empty_domain_ == nullptr)
+    return;
+
+  Datatype coords_type = array_metadata_->coords_type();
+  switch (coords_type) {
+    case Datatype::INT32:
+      expand_non_empty_domain(static_cast<const int*>(mbr));
+      break;
+    case Datatype::INT64:
+      expand_non_empty_domain(static_cast<const int64_t*>(mbr));
+      break;
+    case Datatype::FLOAT32:
+      expand_non_empty_domain(static_cast<const float*>(mbr));
+      break;
+    case Datatype::FLOAT64:
+      expand_non_empty_domain(static_cast<const double*>(mbr));
+      break;
+    case Datatype::INT8:
+      expand_non_empty_domain(static_cast<const int8_t*>(mbr));
+      break;
+    case Datatype::UINT8:
+      expand_non_empty_domain(static_cast<const uint8_t*>(mbr));
+      break;
+    case Datatype::INT16:
+      expand_non_empty_domain(static_cast<const int16_t*>(mbr));
+      break;
+    case Datatype::UINT16:
+      expand_non_empty_domain(static_cast<const uint16_t*>(mbr));
+      break;
+    case Datatype::UINT32:
+      expand_non_empty_domain(static_cast<const uint32_t*>(mbr));
+      break;
+    case Datatype::UINT64:
+      expand_non_empty_domain(static_cast<const uint64_t*>(mbr));
+      break;
+    default:
+      assert(0);
+  }
+}
+
+template <class T>
+void FragmentMetadata::expand_non_empty_domain(const T* mbr) {
+  // For easy reference
+  unsigned int dim_num = array_metadata_->dim_num();
+  auto non_empty_domain = static_cast<T*>(non_empty_domain_);
+
+  // The first MBR replaces the subarray the fragment was initialized with
+  if (tile_num_ == 1) {
+    std::memcpy(non_empty_domain, mbr, 2 * dim_num * sizeof(T));
+    return;
+  }
+
+  for (unsigned int i = 0; i < dim_num; ++i) {
+    if (mbr[2 * i] < non_empty_domain[2 * i])
+      non_empty_domain[2 * i] = mbr[2 * i];
+    if (mbr[2 * i + 1] > non_empty_domain[2 * i + 1])
+      non_empty_domain[2 * i + 1] = mbr[2 * i + 1];
+  }
+}
+
+Status FragmentMetadata::load_section(unsigned int section) {
+  std::unique_lock<std::mutex> lck(mtx_);
+
+  if (section_loaded_[section])
+    return Status::Ok();
+
+  // Read the section tile
+  URI fragment_metadata_uri = fragment_uri_.join_path(
+      std::string(constants::fragment_metadata_filename));
+  auto tile = (Tile*)nullptr;
+  auto tile_io = new TileIO(storage_manager_, fragment_metadata_uri);
+  RETURN_NOT_OK_ELSE(
+      tile_io->read_generic(&tile, section_offsets_[section]), delete tile_io);
+
+  // Deserialize
+  tile->reset_offset();
+  auto cbuff = new ConstBuffer(tile->buffer());
+  Status st = deserialize(section, cbuff);
+  if (st.ok())
+    section_loaded_[section] = true;
+
+  delete cbuff;
+  delete tile;
+  delete tile_io;
+
+  return st;
+}
+
 // ===== FORMAT =====
 //  bounding_coords_num (uint64_t)
 //  bounding_coords_#1 (void*) bounding_coords_#2 (void*) ...
-Status FragmentMetadata::load_bounding_coords(ConstBuffer* buff) {
+Status FragmentMetadata::read_bounding_coords(ConstBuffer* buff) {
   uint64_t bounding_coords_size = 2 * array_metadata_->coords_size();
 
   // Get number of bounding coordinates
@@ -394,7 +749,7 @@ Status FragmentMetadata::load_bounding_coords(ConstBuffer* buff) {
 
 // ===== FORMAT =====
 // last_tile_cell_num (uint64_t)
-Status FragmentMetadata::load_last_tile_cell_num(ConstBuffer* buff) {
+Status FragmentMetadata::read_last_tile_cell_num(ConstBuffer* buff) {
   // Get last tile cell number
   Status st = buff->read(&last_tile_cell_num_, sizeof(uint64_t));
   if (!st.ok()) {
@@ -409,7 +764,7 @@ Status FragmentMetadata::load_last_tile_cell_num(ConstBuffer* buff) {
 // mbr_#1 (void*)
 // mbr_#2 (void*)
 // ...
-Status FragmentMetadata::load_mbrs(ConstBuffer* buff) {
+Status FragmentMetadata::read_mbrs(ConstBuffer* buff) {
   // Get number of MBRs
   uint64_t mbr_num = 0;
   Status st = buff->read(&mbr_num, sizeof(uint64_t));
@@ -438,7 +793,7 @@ Status FragmentMetadata::load_mbrs(ConstBuffer* buff) {
 // ===== FORMAT =====
 // non_empty_domain_size (uint64_t)
 // non_empty_domain (void*)
-Status FragmentMetadata::load_non_empty_domain(ConstBuffer* buff) {
+Status FragmentMetadata::read_non_empty_domain(ConstBuffer* buff) {
   // Get domain size
   uint64_t domain_size = 0;
   Status st = buff->read(&domain_size, sizeof(uint64_t));
@@ -473,122 +828,90 @@ Status FragmentMetadata::load_non_empty_domain(ConstBuffer* buff) {
 }
 
 // ===== FORMAT =====
-// tile_offsets_attr#0_num (uint64_t)
-// tile_offsets_attr#0_#1 (uint64_t) tile_offsets_attr#0_#2 (uint64_t) ...
-// ...
-// tile_offsets_attr#<attribute_num>_num (uint64_t)
-// tile_offsets_attr#<attribute_num>_#1 (uint64_t)
-// tile_offsets_attr#<attribute_num>_#2 (uint64_t) ...
-Status FragmentMetadata::load_tile_offsets(ConstBuffer* buff) {
-  Status st;
+// tile_offsets_attr#<attribute_id>_num (uint64_t)
+// tile_offsets_attr#<attribute_id>_#1 (uint64_t)
+// tile_offsets_attr#<attribute_id>_#2 (uint64_t) ...
+Status FragmentMetadata::read_tile_offsets(
+    unsigned int attribute_id, ConstBuffer* buff) {
+  // Get number of tile offsets
   uint64_t tile_offsets_num = 0;
-  unsigned int attribute_num = array_metadata_->attribute_num();
-
-  // Allocate tile offsets
-  tile_offsets_.resize(attribute_num + 1);
-
-  // For all attributes, get the tile offsets
-  for (unsigned int i = 0; i < attribute_num + 1; ++i) {
-    // Get number of tile offsets
-    st = buff->read(&tile_offsets_num, sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot load fragment metadata; Reading number of tile offsets "
-          "failed"));
-    }
+  Status st = buff->read(&tile_offsets_num, sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading number of tile offsets "
+        "failed"));
+  }
 
-    if (tile_offsets_num == 0)
-      continue;
+  if (tile_offsets_num == 0)
+    return Status::Ok();
 
-    // Get tile offsets
-    tile_offsets_[i].resize(tile_offsets_num);
-    st = buff->read(&tile_offsets_[i][0], tile_offsets_num * sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot load fragment metadata; Reading tile offsets failed"));
-    }
+  // Get tile offsets
+  auto& tile_offsets = tile_offsets_[attribute_id];
+  tile_offsets.resize(tile_offsets_num);
+  st = buff->read(&tile_offsets[0], tile_offsets_num * sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading tile offsets failed"));
   }
   return Status::Ok();
 }
 
 // ===== FORMAT =====
-// tile_var_offsets_attr#0_num (uint64_t)
-// tile_var_offsets_attr#0_#1 (uint64_t) tile_var_offsets_attr#0_#2 (uint64_t)
-// ...
-// ...
-// tile_var_offsets_attr#<attribute_num-1>_num(uint64_t)
-// tile_var_offsets_attr#<attribute_num-1>_#1 (uint64_t)
-//     tile_ver_offsets_attr#<attribute_num-1>_#2 (uint64_t) ...
-Status FragmentMetadata::load_tile_var_offsets(ConstBuffer* buff) {
-  Status st;
-  unsigned int attribute_num = array_metadata_->attribute_num();
+// tile_var_offsets_attr#<attribute_id>_num (uint64_t)
+// tile_var_offsets_attr#<attribute_id>_#1 (uint64_t)
+// tile_var_offsets_attr#<attribute_id>_#2 (uint64_t) ...
+Status FragmentMetadata::read_tile_var_offsets(
+    unsigned int attribute_id, ConstBuffer* buff) {
+  // Get number of tile offsets
   uint64_t tile_var_offsets_num = 0;
+  Status st = buff->read(&tile_var_offsets_num, sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading number of variable tile "
+        "offsets failed"));
+  }
 
-  // Allocate tile offsets
-  tile_var_offsets_.resize(attribute_num);
-
-  // For all attributes, get the variable tile offsets
-  for (unsigned int i = 0; i < attribute_num; ++i) {
-    // Get number of tile offsets
-    st = buff->read(&tile_var_offsets_num, sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot load fragment metadata; Reading number of variable tile "
-          "offsets failed"));
-    }
-
-    if (tile_var_offsets_num == 0)
-      continue;
+  if (tile_var_offsets_num == 0)
+    return Status::Ok();
 
-    // Get variable tile offsets
-    tile_var_offsets_[i].resize(tile_var_offsets_num);
-    st = buff->read(
-        &tile_var_offsets_[i][0], tile_var_offsets_num * sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot load fragment metadata; Reading variable tile offsets "
-          "failed"));
-    }
+  // Get variable tile offsets
+  auto& tile_var_offsets = tile_var_offsets_[attribute_id];
+  tile_var_offsets.resize(tile_var_offsets_num);
+  st = buff->read(
+      &tile_var_offsets[0], tile_var_offsets_num * sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading variable tile offsets "
+        "failed"));
   }
   return Status::Ok();
 }
 
 // ===== FORMAT =====
-// tile_var_sizes_attr#0_num (uint64_t)
-// tile_var_sizes_attr#0_#1 (uint64_t) tile_sizes_attr#0_#2 (uint64_t) ...
-// ...
-// tile_var_sizes_attr#<attribute_num-1>_num(uint64_t)
-// tile_var_sizes__attr#<attribute_num-1>_#1 (uint64_t)
-//     tile_var_sizes_attr#<attribute_num-1>_#2 (uint64_t) ...
-Status FragmentMetadata::load_tile_var_sizes(ConstBuffer* buff) {
-  Status st;
-  unsigned int attribute_num = array_metadata_->attribute_num();
+// tile_var_sizes_attr#<attribute_id>_num (uint64_t)
+// tile_var_sizes_attr#<attribute_id>_#1 (uint64_t)
+// tile_var_sizes_attr#<attribute_id>_#2 (uint64_t) ...
+Status FragmentMetadata::read_tile_var_sizes(
+    unsigned int attribute_id, ConstBuffer* buff) {
+  // Get number of tile sizes
   uint64_t tile_var_sizes_num = 0;
+  Status st = buff->read(&tile_var_sizes_num, sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading number of variable tile "
+        "sizes failed"));
+  }
 
-  // Allocate tile sizes
-  tile_var_sizes_.resize(attribute_num);
-
-  // For all attributes, get the variable tile sizes
-  for (unsigned int i = 0; i < attribute_num; ++i) {
-    // Get number of tile sizes
-    st = buff->read(&tile_var_sizes_num, sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot load fragment metadata; Reading number of variable tile "
-          "sizes failed"));
-    }
-
-    if (tile_var_sizes_num == 0)
-      continue;
+  if (tile_var_sizes_num == 0)
+    return Status::Ok();
 
-    // Get variable tile sizes
-    tile_var_sizes_[i].resize(tile_var_sizes_num);
-    st = buff->read(
-        &tile_var_sizes_[i][0], tile_var_sizes_num * sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot load fragment metadata; Reading variable tile sizes failed"));
-    }
+  // Get variable tile sizes
+  auto& tile_var_sizes = tile_var_sizes_[attribute_id];
+  tile_var_sizes.resize(tile_var_sizes_num);
+  st = buff->read(&tile_var_sizes[0], tile_var_sizes_num * sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading variable tile sizes failed"));
   }
   return Status::Ok();
 }
@@ -691,114 +1014,92 @@ Status FragmentMetadata::write_non_empty_domain(Buffer* buff) {
 }
 
 // ===== FORMAT =====
-// tile_offsets_attr#0_num(uint64_t)
-// tile_offsets_attr#0_#1 (uint64_t) tile_offsets_attr#0_#2 (uint64_t) ...
-// ...
-// tile_offsets_attr#<attribute_num>_num(uint64_t)
-// tile_offsets_attr#<attribute_num>_#1 (uint64_t)
-// tile_offsets_attr#<attribute_num>_#2 (uint64_t) ...
-Status FragmentMetadata::write_tile_offsets(Buffer* buff) {
-  Status st;
-  unsigned int attribute_num = array_metadata_->attribute_num();
-
-  // Write tile offsets for each attribute
-  for (unsigned int i = 0; i < attribute_num + 1; ++i) {
-    // Write number of tile offsets
-    uint64_t tile_offsets_num = tile_offsets_[i].size();
-    st = buff->write(&tile_offsets_num, sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot serialize fragment metadata; Writing number of tile offsets "
-          "failed"));
-    }
+// tile_offsets_attr#<attribute_id>_num(uint64_t)
+// tile_offsets_attr#<attribute_id>_#1 (uint64_t)
+// tile_offsets_attr#<attribute_id>_#2 (uint64_t) ...
+Status FragmentMetadata::write_tile_offsets(
+    unsigned int attribute_id, Buffer* buff) {
+  // Write number of tile offsets
+  auto& tile_offsets = tile_offsets_[attribute_id];
+  uint64_t tile_offsets_num = tile_offsets.size();
+  Status st = buff->write(&tile_offsets_num, sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot serialize fragment metadata; Writing number of tile offsets "
+        "failed"));
+  }
 
-    if (tile_offsets_num == 0)
-      continue;
+  if (tile_offsets_num == 0)
+    return Status::Ok();
 
-    // Write tile offsets
-    st = buff->write(&tile_offsets_[i][0], tile_offsets_num * sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot serialize fragment metadata; Writing tile offsets failed"));
-    }
+  // Write tile offsets
+  st = buff->write(&tile_offsets[0], tile_offsets_num * sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot serialize fragment metadata; Writing tile offsets failed"));
   }
 
   return Status::Ok();
 }
 
 // ===== FORMAT =====
-// tile_var_offsets_attr#0_num(uint64_t)
-// tile_var_offsets_attr#0_#1 (uint64_t) tile_var_offsets_attr#0_#2 (uint64_t)
-// ...
-// ...
-// tile_var_offsets_attr#<attribute_num-1>_num(uint64_t)
-// tile_var_offsets_attr#<attribute_num-1>_#1 (uint64_t)
-//     tile_var_offsets_attr#<attribute_num-1>_#2 (uint64_t) ...
-Status FragmentMetadata::write_tile_var_offsets(Buffer* buff) {
-  Status st;
-  unsigned int attribute_num = array_metadata_->attribute_num();
-
-  // Write tile offsets for each attribute
-  for (unsigned int i = 0; i < attribute_num; ++i) {
-    // Write number of offsets
-    uint64_t tile_var_offsets_num = tile_var_offsets_[i].size();
-    st = buff->write(&tile_var_offsets_num, sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot serialize fragment metadata; Writing number of "
-          "variable tile offsets failed"));
-    }
+// tile_var_offsets_attr#<attribute_id>_num(uint64_t)
+// tile_var_offsets_attr#<attribute_id>_#1 (uint64_t)
+// tile_var_offsets_attr#<attribute_id>_#2 (uint64_t) ...
+Status FragmentMetadata::write_tile_var_offsets(
+    unsigned int attribute_id, Buffer* buff) {
+  // Write number of offsets
+  auto& tile_var_offsets = tile_var_offsets_[attribute_id];
+  uint64_t tile_var_offsets_num = tile_var_offsets.size();
+  Status st = buff->write(&tile_var_offsets_num, sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot serialize fragment metadata; Writing number of "
+        "variable tile offsets failed"));
+  }
 
-    if (tile_var_offsets_num == 0)
-      continue;
+  if (tile_var_offsets_num == 0)
+    return Status::Ok();
 
-    // Write tile offsets
-    st = buff->write(
-        &tile_var_offsets_[i][0], tile_var_offsets_num * sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot serialize fragment metadata; Writing "
-          "variable tile offsets failed"));
-    }
+  // Write tile offsets
+  st = buff->write(
+      &tile_var_offsets[0], tile_var_offsets_num * sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot serialize fragment metadata; Writing "
+        "variable tile offsets failed"));
   }
 
   return Status::Ok();
 }
 
 // ===== FORMAT =====
-// tile_var_sizes_attr#0_num(uint64_t)
-// tile_var_sizes_attr#0_#1 (uint64_t) tile_sizes_attr#0_#2 (uint64_t) ...
-// ...
-// tile_var_sizes_attr#<attribute_num-1>_num(uint64_t)
-// tile_var_sizes__attr#<attribute_num-1>_#1(uint64_t)
-//     tile_var_sizes_attr#<attribute_num-1>_#2 (uint64_t) ...
-Status FragmentMetadata::write_tile_var_sizes(Buffer* buff) {
-  Status st;
-  unsigned int attribute_num = array_metadata_->attribute_num();
-
-  // Write tile sizes for each attribute
-  for (unsigned int i = 0; i < attribute_num; ++i) {
-    // Write number of sizes
-    uint64_t tile_var_sizes_num = tile_var_sizes_[i].size();
-    st = buff->write(&tile_var_sizes_num, sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot serialize fragment metadata; Writing number of "
-          "variable tile sizes failed"));
-    }
+// tile_var_sizes_attr#<attribute_id>_num(uint64_t)
+// tile_var_sizes_attr#<attribute_id>_#1 (uint64_t)
+// tile_var_sizes_attr#<attribute_id>_#2 (uint64_t) ...
+Status FragmentMetadata::write_tile_var_sizes(
+    unsigned int attribute_id, Buffer* buff) {
+  // Write number of sizes
+  auto& tile_var_sizes = tile_var_sizes_[attribute_id];
+  uint64_t tile_var_sizes_num = tile_var_sizes.size();
+  Status st = buff->write(&tile_var_sizes_num, sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot serialize fragment metadata; Writing number of "
+        "variable tile sizes failed"));
+  }
 
-    if (tile_var_sizes_num == 0)
-      continue;
+  if (tile_var_sizes_num == 0)
+    return Status::Ok();
 
-    // Write tile sizes
-    st = buff->write(
-        &tile_var_sizes_[i][0], tile_var_sizes_num * sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(
-          Status::FragmentMetadataError("Cannot serialize fragment metadata; "
-                                        "Writing variable tile sizes failed"));
-    }
+  // Write tile sizes
+  st = buff->write(&tile_var_sizes[0], tile_var_sizes_num * sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(
+        Status::FragmentMetadataError("Cannot serialize fragment metadata; "
+                                      "Writing variable tile sizes failed"));
   }
+
   return Status::Ok();
 }
 
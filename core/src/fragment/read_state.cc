@@ -36,6 +36,8 @@
 #include "query.h"
 #include "utils.h"
 
+#include <algorithm>
+
 /* ****************************** */
 /*             MACROS             */
 /* ****************************** */
@@ -87,7 +89,9 @@ ReadState::ReadState(
   init_overflow();
   init_fetched_tiles();
   init_empty_attributes();
+  map_files();
   compute_tile_search_range();
+  compute_overlapping_tiles();
 <<<<<<< HEAD
 
   // Check empty attributes
@@ -103,6 +107,9 @@ ReadState::ReadState(
 }
 
 ReadState::~ReadState() {
+  for (unsigned int i = 0; i < attribute_num_ + 2; ++i)
+    unpin_tiles(i);
+
   if (last_tile_coords_ != nullptr)
     std::free(last_tile_coords_);
 
@@ -284,6 +291,16 @@ bool ReadState::done() const {
   return done_;
 }
 
+Status ReadState::fetch_tile(unsigned int attribute_id, uint64_t tile_i) {
+  // Trivial case
+  if (is_empty_attribute(attribute_id))
+    return Status::Ok();
+
+  if (attribute_id < attribute_num_ && array_metadata_->var_size(attribute_id))
+    return read_tile_var(attribute_id, tile_i);
+  return read_tile(attribute_id, tile_i);
+}
+
 void ReadState::get_bounding_coords(void* bounding_coords) const {
   // For easy reference
   uint64_t pos = search_tile_pos_;
@@ -535,12 +552,22 @@ Status ReadState::get_fragment_cell_ranges_sparse(
   auto search_tile_overlap_subarray =
       static_cast<const T*>(search_tile_overlap_subarray_);
 
-  // Create start and end coordinates for the overlap
+  // Create start and end coordinates for the overlap. In the Hilbert cell
+  // order, the overlap corners do not bound the overlap cells, so the range
+  // spans the first and last cell of the tile instead, and the cells are
+  // then filtered on the subarray
   auto start_coords = new T[dim_num];
   auto end_coords = new T[dim_num];
-  for (unsigned int i = 0; i < dim_num; ++i) {
-    start_coords[i] = search_tile_overlap_subarray[2 * i];
-    end_coords[i] = search_tile_overlap_subarray[2 * i + 1];
+  if (array_metadata_->cell_order() == Layout::HILBERT) {
+    auto bounding_coords =
+        static_cast<const T*>(metadata_->bounding_coords()[search_tile_pos_]);
+    std::memcpy(start_coords, bounding_coords, coords_size_);
+    std::memcpy(end_coords, &bounding_coords[dim_num], coords_size_);
+  } else {
+    for (unsigned int i = 0; i < dim_num; ++i) {
+      start_coords[i] = search_tile_overlap_subarray[2 * i];
+      end_coords[i] = search_tile_overlap_subarray[2 * i + 1];
+    }
   }
 
   // Get fragment cell ranges inside range [start_coords, end_coords]
@@ -745,29 +772,23 @@ void ReadState::get_next_overlapping_tile_sparse() {
   const std::vector<void*>& mbrs = metadata_->mbrs();
   auto subarray = static_cast<const T*>(query_->subarray());
 
-  // Update the search tile position
-  if (search_tile_pos_ == INVALID_UINT64)
-    search_tile_pos_ = tile_search_range_[0];
-  else
-    ++search_tile_pos_;
-
-  // Find the position to the next overlapping tile with the query range
-  for (;;) {
-    // No overlap - exit
-    if (search_tile_pos_ > tile_search_range_[1]) {
-      done_ = true;
-      return;
-    }
-
-    auto mbr = static_cast<const T*>(mbrs[search_tile_pos_]);
-    search_tile_overlap_ = array_metadata_->domain()->subarray_overlap(
-        subarray, mbr, static_cast<T*>(search_tile_overlap_subarray_));
-
-    if (!search_tile_overlap_)
-      ++search_tile_pos_;
-    else
-      return;
+  // Find the next overlapping tile with the query range, which are all
+  // computed upfront
+  auto it = (search_tile_pos_ == INVALID_UINT64) ?
+                overlapping_tiles_.begin() :
+                std::upper_bound(
+                    overlapping_tiles_.begin(),
+                    overlapping_tiles_.end(),
+                    search_tile_pos_);
+  if (it == overlapping_tiles_.end()) {
+    done_ = true;
+    return;
   }
+
+  search_tile_pos_ = *it;
+  auto mbr = static_cast<const T*>(mbrs[search_tile_pos_]);
+  search_tile_overlap_ = array_metadata_->domain()->subarray_overlap(
+      subarray, mbr, static_cast<T*>(search_tile_overlap_subarray_));
 }
 
 template <class T>
@@ -879,6 +900,10 @@ bool ReadState::mbr_overlaps_tile() const {
   return (bool)mbr_tile_overlap_;
 }
 
+const std::vector<uint64_t>& ReadState::overlapping_tiles() const {
+  return overlapping_tiles_;
+}
+
 bool ReadState::overflow(unsigned int attribute_id) const {
   return overflow_[attribute_id];
 }
@@ -989,47 +1014,142 @@ Status ReadState::compute_bytes_to_copy(
   return Status::Ok();
 }
 
-Status ReadState::compute_tile_compressed_size(
-    uint64_t tile_i,
-    unsigned int attribute_id,
-    TileIO* tile_io,
-    uint64_t* tile_compressed_size) const {
-  auto& tile_offsets = metadata_->tile_offsets();
-  uint64_t tile_num = metadata_->tile_num();
-  uint64_t file_size = 0;
+void ReadState::compute_overlapping_tiles() {
+  // For easy reference
+  Datatype coords_type = array_metadata_->coords_type();
 
-  assert(tile_num != 0);
+  // Trivial case
+  if (done_)
+    return;
 
-  RETURN_NOT_OK(tile_io->file_size(&file_size));
+  // Invoke the proper templated function
+  if (fragment_->dense()) {
+    if (coords_type == Datatype::INT32) {
+      compute_overlapping_tiles_dense<int>();
+    } else if (coords_type == Datatype::INT64) {
+      compute_overlapping_tiles_dense<int64_t>();
+    } else if (coords_type == Datatype::INT8) {
+      compute_overlapping_tiles_dense<int8_t>();
+    } else if (coords_type == Datatype::UINT8) {
+      compute_overlapping_tiles_dense<uint8_t>();
+    } else if (coords_type == Datatype::INT16) {
+      compute_overlapping_tiles_dense<int16_t>();
+    } else if (coords_type == Datatype::UINT16) {
+      compute_overlapping_tiles_dense<uint16_t>();
+    } else if (coords_type == Datatype::UINT32) {
+      compute_overlapping_tiles_dense<uint32_t>();
+    } else if (coords_type == Datatype::UINT64) {
+      compute_overlapping_tiles_dense<uint64_t>();
+    } else {
+      // The code should never reach here
+      assert(0);
+    }
+  } else {
+    if (coords_type == Datatype::INT32) {
+      compute_overlapping_tiles_sparse<int>();
+    } else if (coords_type == Datatype::INT64) {
+      compute_overlapping_tiles_sparse<int64_t>();
+    } else if (coords_type == Datatype::FLOAT32) {
+      compute_overlapping_tiles_sparse<float>();
+    } else if (coords_type == Datatype::FLOAT64) {
+      compute_overlapping_tiles_sparse<double>();
+    } else if (coords_type == Datatype::INT8) {
+      compute_overlapping_tiles_sparse<int8_t>();
+    } else if (coords_type == Datatype::UINT8) {
+      compute_overlapping_tiles_sparse<uint8_t>();
+    } else if (coords_type == Datatype::INT16) {
+      compute_overlapping_tiles_sparse<int16_t>();
+    } else if (coords_type == Datatype::UINT16) {
+      compute_overlapping_tiles_sparse<uint16_t>();
+    } else if (coords_type == Datatype::UINT32) {
+      compute_overlapping_tiles_sparse<uint32_t>();
+    } else if (coords_type == Datatype::UINT64) {
+      compute_overlapping_tiles_sparse<uint64_t>();
+    } else {
+      // The code should never reach here
+      assert(0);
+    }
+  }
+}
 
-  *tile_compressed_size = (tile_i == tile_num - 1) ?
-                              file_size - tile_offsets[attribute_id][tile_i] :
-                              tile_offsets[attribute_id][tile_i + 1] -
-                                  tile_offsets[attribute_id][tile_i];
+template <class T>
+void ReadState::compute_overlapping_tiles_dense() {
+  // For easy reference
+  unsigned int dim_num = array_metadata_->dim_num();
+  auto domain = array_metadata_->domain();
+  auto tile_extents = static_cast<const T*>(domain->tile_extents());
+  auto subarray = static_cast<const T*>(query_->subarray());
+  auto metadata_domain = static_cast<const T*>(metadata_->domain());
 
-  return Status::Ok();
-}
+  // Compute the overlap of the subarray with the fragment domain
+  auto overlap_subarray = new T[2 * dim_num];
+  if (!domain->subarray_overlap(subarray, metadata_domain, overlap_subarray)) {
+    delete[] overlap_subarray;
+    return;
+  }
 
-Status ReadState::compute_tile_compressed_var_size(
-    uint64_t tile_i,
-    unsigned int attribute_id,
-    TileIO* tile_io,
-    uint64_t* tile_compressed_size) const {
-  auto& tile_var_offsets = metadata_->tile_var_offsets();
-  uint64_t file_size = 0;
-  uint64_t tile_num = metadata_->tile_num();
+  // Compute the overlapping tile domain, normalized to the fragment domain
+  auto tile_domain = new T[2 * dim_num];
+  auto tile_coords = new T[dim_num];
+  for (unsigned int i = 0; i < dim_num; ++i) {
+    tile_domain[2 * i] =
+        (overlap_subarray[2 * i] - metadata_domain[2 * i]) / tile_extents[i];
+    tile_domain[2 * i + 1] =
+        (overlap_subarray[2 * i + 1] - metadata_domain[2 * i]) /
+        tile_extents[i];
+    tile_coords[i] = tile_domain[2 * i];
+  }
 
-  assert(tile_num != 0);
+  // Collect the tile positions
+  for (;;) {
+    bool in_domain = true;
+    for (unsigned int i = 0; i < dim_num && in_domain; ++i)
+      in_domain = tile_coords[i] <= tile_domain[2 * i + 1];
+    if (!in_domain)
+      break;
+    overlapping_tiles_.push_back(
+        domain->get_tile_pos(metadata_domain, tile_coords));
+    domain->get_next_tile_coords(tile_domain, tile_coords);
+  }
+  std::sort(overlapping_tiles_.begin(), overlapping_tiles_.end());
 
-  RETURN_NOT_OK(tile_io->file_size(&file_size));
+  // Clean up
+  delete[] overlap_subarray;
+  delete[] tile_domain;
+  delete[] tile_coords;
+}
 
-  *tile_compressed_size =
-      (tile_i == tile_num - 1) ?
-          file_size - tile_var_offsets[attribute_id][tile_i] :
-          tile_var_offsets[attribute_id][tile_i + 1] -
-              tile_var_offsets[attribute_id][tile_i];
+template <class T>
+void ReadState::compute_overlapping_tiles_sparse() {
+  // For easy reference
+  unsigned int dim_num = array_metadata_->dim_num();
+  auto domain = array_metadata_->domain();
+  const std::vector<void*>& mbrs = metadata_->mbrs();
+  auto subarray = static_cast<const T*>(query_->subarray());
 
-  return Status::Ok();
+  // Look the overlapping tiles up in the R-tree, keeping those in the
+  // search range
+  auto rtree = metadata_->rtree();
+  if (rtree != nullptr) {
+    std::vector<uint64_t> tile_pos;
+    rtree->query(subarray, &tile_pos);
+    for (auto pos : tile_pos) {
+      if (pos >= tile_search_range_[0] && pos <= tile_search_range_[1])
+        overlapping_tiles_.push_back(pos);
+    }
+    return;
+  }
+
+  // Collect the tiles in the search range whose MBR overlaps the subarray
+  auto overlap_subarray = new T[2 * dim_num];
+  for (uint64_t i = tile_search_range_[0]; i <= tile_search_range_[1]; ++i) {
+    auto mbr = static_cast<const T*>(mbrs[i]);
+    if (domain->subarray_overlap(subarray, mbr, overlap_subarray))
+      overlapping_tiles_.push_back(i);
+  }
+
+  // Clean up
+  delete[] overlap_subarray;
 }
 
 void ReadState::compute_tile_search_range() {
@@ -1069,8 +1189,15 @@ void ReadState::compute_tile_search_range() {
 
 template <class T>
 void ReadState::compute_tile_search_range() {
-  // Initialize the tile search range
-  compute_tile_search_range_col_or_row<T>();
+  // Initialize the tile search range. In the Hilbert cell order, the
+  // subarray corners do not bound the subarray cells, so all tiles are
+  // searched, relying on their MBRs
+  if (array_metadata_->cell_order() == Layout::HILBERT) {
+    tile_search_range_[0] = 0;
+    tile_search_range_[1] = metadata_->tile_num() - 1;
+  } else {
+    compute_tile_search_range_col_or_row<T>();
+  }
 
   // Handle no overlap
   if (tile_search_range_[0] == INVALID_UINT64 ||
@@ -1379,6 +1506,9 @@ Status ReadState::get_offset(
 void ReadState::init_tiles() {
   auto dim_num = array_metadata_->domain()->dim_num();
 
+  cached_tiles_.resize(attribute_num_ + 2, nullptr);
+  cached_tiles_var_.resize(attribute_num_, nullptr);
+
   for (unsigned int i = 0; i < attribute_num_; ++i) {
     const Attribute* attr = array_metadata_->attribute(i);
     bool var_size = attr->var_size();
@@ -1391,11 +1521,15 @@ void ReadState::init_tiles() {
         (var_size) ? constants::cell_var_offset_size : attr->cell_size(),
         0));
 
-    if (var_size)
+    // The filters apply to the attribute values, not to their offsets
+    if (var_size) {
       tiles_var_.emplace_back(new Tile(
           attr->type(), attr->compressor(), datatype_size(attr->type()), 0));
-    else
+      tiles_var_.back()->set_filters(attr->filters());
+    } else {
+      tiles_.back()->set_filters(attr->filters());
       tiles_var_.emplace_back(nullptr);
+    }
   }
   tiles_.emplace_back(new Tile(
       array_metadata_->coords_type(),
@@ -1435,6 +1569,46 @@ bool ReadState::is_empty_attribute(unsigned int attribute_id) const {
   return is_empty_attribute_[attribute_id];
 }
 
+void ReadState::map_files() {
+  if (query_->storage_manager()->config()->read_method() != IOMethod::MMAP)
+    return;
+
+  // Attribute files being read
+  for (auto i : query_->attribute_ids()) {
+    if (i == attribute_num_ || is_empty_attribute_[i])
+      continue;
+    map_file(fragment_->attr_uri(i), {tile_io_[i]});
+    if (tile_io_var_[i] != nullptr)
+      map_file(fragment_->attr_var_uri(i), {tile_io_var_[i]});
+  }
+
+  // The coordinates are read (at least for the overlap checks) through two
+  // Tile I/O objects, which share a single mapping
+  if (!is_empty_attribute_[attribute_num_])
+    map_file(
+        fragment_->coords_uri(),
+        {tile_io_[attribute_num_], tile_io_[attribute_num_ + 1]});
+}
+
+void ReadState::map_file(
+    const URI& uri, const std::vector<TileIO*>& tile_io) {
+  if (!uri.is_posix())
+    return;
+
+  void* data;
+  uint64_t size;
+  Status st = metadata_->map_file(uri, &data, &size);
+  if (!st.ok()) {
+    LOG_ERROR(
+        "Cannot map file '" + uri.to_string() +
+        "'; Reading its tiles with regular I/O instead");
+    return;
+  }
+
+  for (auto t : tile_io)
+    t->set_mapped_file(data, size);
+}
+
 Status ReadState::read_from_tile(
     unsigned int attribute_id,
     void* buffer,
@@ -1460,21 +1634,38 @@ Status ReadState::read_tile(unsigned int attribute_id, uint64_t tile_i) {
   unsigned int attribute_id_real =
       (attribute_id == attribute_num_ + 1) ? attribute_num_ : attribute_id;
 
-  uint64_t tile_compressed_size;
-  RETURN_NOT_OK(compute_tile_compressed_size(
-      tile_i, attribute_id_real, tile_io, &tile_compressed_size));
+  // Release the previously fetched tile and look for the tile in the cache
+  unpin_tiles(attribute_id);
+  auto& tile_cache = global_tile_cache();
+  std::string key = TileCache::key(
+      fragment_->fragment_uri(), attribute_id_real, tile_i, false);
+  auto entry = tile_cache.pin(key);
+  if (entry != nullptr) {
+    tile->alias(entry->data_, entry->size_);
+    cached_tiles_[attribute_id] = entry;
+    fetched_tile_[attribute_id] = tile_i;
+    return Status::Ok();
+  }
 
-  uint64_t file_offset = metadata_->tile_offsets()[attribute_id_real][tile_i];
   uint64_t tile_size = metadata_->cell_num(tile_i) *
                        array_metadata_->cell_size(attribute_id_real);
 
-  Status st = tile_io->read(tile, file_offset, tile_compressed_size, tile_size);
+  RETURN_NOT_OK(tile_io->read(
+      tile,
+      tile_i,
+      metadata_->tile_offsets()[attribute_id_real],
+      overlapping_tiles_,
+      tile_size));
+
+  // Cache the tile, unless it aliases a mapped file. A failed insertion
+  // (already logged) only means the tile is read again on a later miss.
+  if (!tile->aliased())
+    tile_cache.insert(key, tile->data(), tile->size());
 
   // Mark as fetched
-  if (st.ok())
-    fetched_tile_[attribute_id] = tile_i;
+  fetched_tile_[attribute_id] = tile_i;
 
-  return st;
+  return Status::Ok();
 }
 
 Status ReadState::read_tile_var(unsigned int attribute_id, uint64_t tile_i) {
@@ -1488,40 +1679,66 @@ Status ReadState::read_tile_var(unsigned int attribute_id, uint64_t tile_i) {
 
   auto tile = tiles_[attribute_id];
   auto tile_io = tile_io_[attribute_id];
+  auto tile_var = tiles_var_[attribute_id];
+  auto tile_io_var = tile_io_var_[attribute_id];
+
+  // Release the previously fetched tiles and look for the tiles in the
+  // cache, where the offsets are stored already shifted
+  unpin_tiles(attribute_id);
+  auto& tile_cache = global_tile_cache();
+  std::string key =
+      TileCache::key(fragment_->fragment_uri(), attribute_id, tile_i, false);
+  std::string key_var =
+      TileCache::key(fragment_->fragment_uri(), attribute_id, tile_i, true);
+  auto entry = tile_cache.pin(key);
+  auto entry_var = (entry != nullptr) ? tile_cache.pin(key_var) : nullptr;
+  if (entry_var != nullptr) {
+    tile->alias(entry->data_, entry->size_);
+    tile_var->alias(entry_var->data_, entry_var->size_);
+    cached_tiles_[attribute_id] = entry;
+    cached_tiles_var_[attribute_id] = entry_var;
+    fetched_tile_[attribute_id] = tile_i;
+    return Status::Ok();
+  }
+  if (entry != nullptr)
+    tile_cache.unpin(entry);
 
-  uint64_t tile_compressed_size;
-  RETURN_NOT_OK(compute_tile_compressed_size(
-      tile_i, attribute_id, tile_io, &tile_compressed_size));
 <<<<<<< HEAD
-  off_t file_offset = bookkeeping_->tile_offsets()[attribute_id][tile_i];
   size_t tile_size =
       bookkeeping_->cell_num(tile_i) * constants::cell_var_offset_size;
 =======
-  uint64_t file_offset = metadata_->tile_offsets()[attribute_id][tile_i];
   uint64_t tile_size =
       metadata_->cell_num(tile_i) * constants::cell_var_offset_size;
 >>>>>>> upstream/dev
 
-  RETURN_NOT_OK(
-      tile_io->read(tile, file_offset, tile_compressed_size, tile_size));
-
-  auto tile_var = tiles_var_[attribute_id];
-  auto tile_io_var = tile_io_var_[attribute_id];
+  RETURN_NOT_OK(tile_io->read(
+      tile,
+      tile_i,
+      metadata_->tile_offsets()[attribute_id],
+      overlapping_tiles_,
+      tile_size));
 
   // Get size of decompressed tile
-  uint64_t tile_compressed_var_size;
-  RETURN_NOT_OK(compute_tile_compressed_var_size(
-      tile_i, attribute_id, tile_io_var, &tile_compressed_var_size));
   uint64_t tile_var_size = metadata_->tile_var_sizes()[attribute_id][tile_i];
-  uint64_t file_var_offset =
-      metadata_->tile_var_offsets()[attribute_id][tile_i];
 
   RETURN_NOT_OK(tile_io_var->read(
-      tile_var, file_var_offset, tile_compressed_var_size, tile_var_size));
-
-  // Shift variable cell offsets
+      tile_var,
+      tile_i,
+      metadata_->tile_var_offsets()[attribute_id],
+      overlapping_tiles_,
+      tile_var_size));
+
+  // Shift variable cell offsets (in a copy, if the tile aliases a mapping)
+  RETURN_NOT_OK(tile->detach());
   shift_var_offsets(attribute_id);
 
+  // Cache the tiles, unless the values alias a mapped file. As above, a
+  // failed insertion is treated as a cache miss, and the values are not
+  // cached without their offsets.
+  if (!tile_var->aliased() &&
+      tile_cache.insert(key, tile->data(), tile->size()).ok())
+    tile_cache.insert(key_var, tile_var->data(), tile_var->size());
+
   // Mark as fetched
   fetched_tile_[attribute_id] = tile_i;
 
@@ -1556,6 +1773,20 @@ void ReadState::shift_var_offsets(
     buffer_s[i] = buffer_s[i] - start_offset + new_start_offset;
 }
 
+void ReadState::unpin_tiles(unsigned int attribute_id) {
+  auto& tile_cache = global_tile_cache();
+  if (cached_tiles_[attribute_id] != nullptr) {
+    tile_cache.unpin(cached_tiles_[attribute_id]);
+    cached_tiles_[attribute_id] = nullptr;
+    fetched_tile_[attribute_id] = INVALID_UINT64;
+  }
+  if (attribute_id < attribute_num_ &&
+      cached_tiles_var_[attribute_id] != nullptr) {
+    tile_cache.unpin(cached_tiles_var_[attribute_id]);
+    cached_tiles_var_[attribute_id] = nullptr;
+  }
+}
+
 // Explicit template instantiations
 template Status ReadState::get_coords_after<int>(
     const int* coords, int* coords_after, bool* coords_retrieved);
@@ -0,0 +1,291 @@
+/**
+ * @file   rtree.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class RTree.
+ */
+
+#include "rtree.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+RTree::RTree(Datatype type, unsigned int dim_num, unsigned int fanout)
+    : dim_num_(dim_num)
+    , fanout_(fanout)
+    , type_(type) {
+  assert(fanout_ > 1);
+  mbrs_ = nullptr;
+}
+
+RTree::~RTree() = default;
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status RTree::build(const std::vector<void*>* mbrs) {
+  mbrs_ = mbrs;
+  leaves_.clear();
+  levels_.clear();
+
+  // Nothing to index
+  if (mbrs_->empty())
+    return Status::Ok();
+
+  // Invoke the proper templated function
+  if (type_ == Datatype::INT32) {
+    build<int>();
+  } else if (type_ == Datatype::INT64) {
+    build<int64_t>();
+  } else if (type_ == Datatype::FLOAT32) {
+    build<float>();
+  } else if (type_ == Datatype::FLOAT64) {
+    build<double>();
+  } else if (type_ == Datatype::INT8) {
+    build<int8_t>();
+  } else if (type_ == Datatype::UINT8) {
+    build<uint8_t>();
+  } else if (type_ == Datatype::INT16) {
+    build<int16_t>();
+  } else if (type_ == Datatype::UINT16) {
+    build<uint16_t>();
+  } else if (type_ == Datatype::UINT32) {
+    build<uint32_t>();
+  } else if (type_ == Datatype::UINT64) {
+    build<uint64_t>();
+  } else {
+    return LOG_STATUS(
+        Status::Error("Cannot build R-tree; Unsupported coordinates type"));
+  }
+
+  return Status::Ok();
+}
+
+uint64_t RTree::memory_size() const {
+  uint64_t size = sizeof(RTree) + leaves_.size() * sizeof(uint64_t);
+  for (auto& level : levels_)
+    size += sizeof(Level) + level.mbrs_.size() +
+            (level.child_start_.size() + level.child_end_.size()) *
+                sizeof(uint64_t);
+
+  return size;
+}
+
+void RTree::query(const void* subarray, std::vector<uint64_t>* tile_pos) const {
+  tile_pos->clear();
+
+  // Invoke the proper templated function
+  if (type_ == Datatype::INT32) {
+    search(static_cast<const int*>(subarray), tile_pos);
+  } else if (type_ == Datatype::INT64) {
+    search(static_cast<const int64_t*>(subarray), tile_pos);
+  } else if (type_ == Datatype::FLOAT32) {
+    search(static_cast<const float*>(subarray), tile_pos);
+  } else if (type_ == Datatype::FLOAT64) {
+    search(static_cast<const double*>(subarray), tile_pos);
+  } else if (type_ == Datatype::INT8) {
+    search(static_cast<const int8_t*>(subarray), tile_pos);
+  } else if (type_ == Datatype::UINT8) {
+    search(static_cast<const uint8_t*>(subarray), tile_pos);
+  } else if (type_ == Datatype::INT16) {
+    search(static_cast<const int16_t*>(subarray), tile_pos);
+  } else if (type_ == Datatype::UINT16) {
+    search(static_cast<const uint16_t*>(subarray), tile_pos);
+  } else if (type_ == Datatype::UINT32) {
+    search(static_cast<const uint32_t*>(subarray), tile_pos);
+  } else if (type_ == Datatype::UINT64) {
+    search(static_cast<const uint64_t*>(subarray), tile_pos);
+  } else {
+    // The code should never reach here
+    assert(0);
+  }
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+template <class T>
+void RTree::build() {
+  // For easy reference
+  uint64_t mbr_size = 2 * dim_num_ * sizeof(T);
+
+  // The entries to pack are initially the tile MBRs
+  std::vector<const T*> mbrs;
+  for (auto mbr : *mbrs_)
+    mbrs.push_back(static_cast<const T*>(mbr));
+
+  // Pack each level into the nodes of the next, until a single root remains
+  for (;;) {
+    // Sort the entries in STR order
+    uint64_t entry_num = mbrs.size();
+    std::vector<uint64_t> entries(entry_num);
+    std::iota(entries.begin(), entries.end(), 0);
+    str_sort(mbrs, 0, entry_num, 0, &entries);
+
+    // Group every *fanout_* consecutive entries into a node
+    Level parent;
+    uint64_t node_num = (entry_num + fanout_ - 1) / fanout_;
+    parent.mbrs_.resize(node_num * mbr_size);
+    for (uint64_t i = 0; i < node_num; ++i) {
+      uint64_t start = i * fanout_;
+      uint64_t end = std::min(start + fanout_, entry_num);
+      parent.child_start_.push_back(start);
+      parent.child_end_.push_back(end);
+
+      // The node MBR is the union of the MBRs of its children
+      auto node_mbr = reinterpret_cast<T*>(&parent.mbrs_[i * mbr_size]);
+      std::memcpy(node_mbr, mbrs[entries[start]], mbr_size);
+      for (uint64_t c = start + 1; c < end; ++c) {
+        const T* mbr = mbrs[entries[c]];
+        for (unsigned int d = 0; d < dim_num_; ++d) {
+          node_mbr[2 * d] = std::min(node_mbr[2 * d], mbr[2 * d]);
+          node_mbr[2 * d + 1] = std::max(node_mbr[2 * d + 1], mbr[2 * d + 1]);
+        }
+      }
+    }
+
+    // Reorder the packed level, so that the children of each node are
+    // contiguous
+    if (levels_.empty()) {
+      leaves_ = entries;
+    } else {
+      Level& level = levels_.back();
+      Level sorted;
+      sorted.mbrs_.resize(level.mbrs_.size());
+      for (uint64_t i = 0; i < entry_num; ++i) {
+        sorted.child_start_.push_back(level.child_start_[entries[i]]);
+        sorted.child_end_.push_back(level.child_end_[entries[i]]);
+        std::memcpy(
+            &sorted.mbrs_[i * mbr_size],
+            &level.mbrs_[entries[i] * mbr_size],
+            mbr_size);
+      }
+      level = std::move(sorted);
+    }
+    levels_.push_back(std::move(parent));
+
+    if (node_num == 1)
+      break;
+
+    // The nodes of the new level are the entries to pack next
+    auto& level_mbrs = levels_.back().mbrs_;
+    mbrs.clear();
+    for (uint64_t i = 0; i < node_num; ++i)
+      mbrs.push_back(reinterpret_cast<const T*>(&level_mbrs[i * mbr_size]));
+  }
+}
+
+template <class T>
+bool RTree::overlap(const T* a, const T* b) const {
+  for (unsigned int d = 0; d < dim_num_; ++d) {
+    if (a[2 * d] > b[2 * d + 1] || a[2 * d + 1] < b[2 * d])
+      return false;
+  }
+
+  return true;
+}
+
+template <class T>
+void RTree::search(const T* subarray, std::vector<uint64_t>* tile_pos) const {
+  // Trivial case
+  if (levels_.empty())
+    return;
+
+  // For easy reference
+  uint64_t mbr_size = 2 * dim_num_ * sizeof(T);
+
+  // Traverse the nodes that overlap the subarray, starting from the root
+  std::vector<std::pair<uint64_t, uint64_t>> stack;
+  stack.emplace_back(levels_.size() - 1, 0);
+  while (!stack.empty()) {
+    uint64_t l = stack.back().first;
+    uint64_t node = stack.back().second;
+    stack.pop_back();
+
+    const Level& level = levels_[l];
+    auto node_mbr =
+        reinterpret_cast<const T*>(&level.mbrs_[node * mbr_size]);
+    if (!overlap(subarray, node_mbr))
+      continue;
+
+    for (uint64_t c = level.child_start_[node]; c < level.child_end_[node];
+         ++c) {
+      if (l > 0) {
+        stack.emplace_back(l - 1, c);
+      } else {
+        auto mbr = static_cast<const T*>((*mbrs_)[leaves_[c]]);
+        if (overlap(subarray, mbr))
+          tile_pos->push_back(leaves_[c]);
+      }
+    }
+  }
+
+  std::sort(tile_pos->begin(), tile_pos->end());
+}
+
+template <class T>
+void RTree::str_sort(
+    const std::vector<const T*>& mbrs,
+    uint64_t begin,
+    uint64_t end,
+    unsigned int dim,
+    std::vector<uint64_t>* entries) const {
+  // Sort along the dimension, on the MBR centers
+  std::sort(
+      entries->begin() + begin,
+      entries->begin() + end,
+      [&](uint64_t a, uint64_t b) {
+        return (double)mbrs[a][2 * dim] + (double)mbrs[a][2 * dim + 1] <
+               (double)mbrs[b][2 * dim] + (double)mbrs[b][2 * dim + 1];
+      });
+
+  // Split into slabs, sorted along the next dimension
+  uint64_t entry_num = end - begin;
+  if (dim + 1 == dim_num_ || entry_num <= fanout_)
+    return;
+  uint64_t node_num = (entry_num + fanout_ - 1) / fanout_;
+  auto slab_num = (uint64_t)std::ceil(
+      std::pow((double)node_num, 1.0 / (double)(dim_num_ - dim)));
+  uint64_t slab_size = fanout_ * ((node_num + slab_num - 1) / slab_num);
+  for (uint64_t slab = begin; slab < end; slab += slab_size)
+    str_sort(mbrs, slab, std::min(slab + slab_size, end), dim + 1, entries);
+}
+
+}  // namespace tiledb
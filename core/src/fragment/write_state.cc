@@ -37,7 +37,7 @@
 #include <cstring>
 #include <iostream>
 
-#include "comparators.h"
+#include "cell_sorter.h"
 #include "const_buffer.h"
 #include "logger.h"
 #include "posix_filesystem.h"
@@ -55,6 +55,7 @@ namespace tiledb {
 WriteState::WriteState(const Fragment* fragment)
     : fragment_(fragment) {
   metadata_ = fragment_->metadata();
+  queued_size_ = 0;
 
   init_tiles();
   init_tile_io();
@@ -87,6 +88,11 @@ WriteState::WriteState(const Fragment* fragment)
 }
 
 WriteState::~WriteState() {
+  for (auto& queued : queued_tiles_) {
+    delete queued.tile_;
+    delete queued.buffer_;
+  }
+
   for (auto& tile : tiles_)
     delete tile;
 
@@ -121,6 +127,15 @@ Status WriteState::finalize() {
   // Write last tile (applicable only to the sparse case)
   if (!tiles_[attribute_num]->empty())
     RETURN_NOT_OK(write_last_tile());
+  RETURN_NOT_OK(write_queued_tiles());
+
+  // Write the tile data still staged for direct I/O
+  for (auto tile_io : tile_io_)
+    RETURN_NOT_OK(tile_io->flush());
+  for (auto tile_io : tile_io_var_) {
+    if (tile_io != nullptr)
+      RETURN_NOT_OK(tile_io->flush());
+  }
 
   // Sync all attributes
   RETURN_NOT_OK(sync());
@@ -136,20 +151,20 @@ Status WriteState::sync() {
   auto attribute_ids = fragment_->query()->attribute_ids();
   auto storage_manager = fragment_->query()->storage_manager();
 
-  // Sync all attributes
+  // Sync all attribute files at once
+  std::vector<URI> uris;
   for (auto attribute_id : attribute_ids) {
     // For all attributes
-    if (attribute_id == attribute_num) {
-      RETURN_NOT_OK(storage_manager->sync(fragment_->coords_uri()));
-    } else {
-      RETURN_NOT_OK(storage_manager->sync(fragment_->attr_uri(attribute_id)));
-    }
+    if (attribute_id == attribute_num)
+      uris.push_back(fragment_->coords_uri());
+    else
+      uris.push_back(fragment_->attr_uri(attribute_id));
 
     // Only for variable-size attributes (they have an extra file)
     if (array_metadata->var_size(attribute_id))
-      RETURN_NOT_OK(
-          storage_manager->sync(fragment_->attr_var_uri(attribute_id)));
+      uris.push_back(fragment_->attr_var_uri(attribute_id));
   }
+  RETURN_NOT_OK(storage_manager->sync_batch(uris));
 
   // Sync fragment directory
   RETURN_NOT_OK(storage_manager->sync(fragment_->fragment_uri()));
@@ -192,16 +207,15 @@ Status WriteState::write(void** buffers, uint64_t* buffer_sizes) {
         buffer_i += 2;
       }
     }
-
-    // Success
-    return Status::Ok();
+  } else if (layout == Layout::UNORDERED) {  // UNORDERED
+    RETURN_NOT_OK(write_sparse_unsorted(buffers, buffer_sizes));
+  } else {
+    return LOG_STATUS(
+        Status::WriteStateError("Cannot write to fragment; Invalid mode"));
   }
 
-  if (layout == Layout::UNORDERED)  // UNORDERED
-    return write_sparse_unsorted(buffers, buffer_sizes);
-
-  return LOG_STATUS(
-      Status::WriteStateError("Cannot write to fragment; Invalid mode"));
+  // Compress and write the tiles that filled up
+  return write_queued_tiles();
 }
 
 /* ****************************** */
@@ -231,38 +245,11 @@ void WriteState::init_tiles() {
   auto array_metadata = fragment_->query()->array_metadata();
   auto attribute_num = array_metadata->attribute_num();
   for (unsigned int i = 0; i < attribute_num; ++i) {
-    auto attr = array_metadata->attribute(i);
-    bool var_size = attr->var_size();
-
-    tiles_.emplace_back(new Tile(
-        (var_size) ? constants::cell_var_offset_type : attr->type(),
-        (var_size) ? array_metadata->cell_var_offsets_compression() :
-                     attr->compressor(),
-        (var_size) ? array_metadata->cell_var_offsets_compression_level() :
-                     attr->compression_level(),
-        fragment_->tile_size(i),
-        (var_size) ? constants::cell_var_offset_size : attr->cell_size(),
-        0));
-
-    if (var_size) {
-      tiles_var_.emplace_back(new Tile(
-          attr->type(),
-          attr->compressor(),
-          attr->compression_level(),
-          fragment_->tile_size(i),
-          datatype_size(attr->type()),
-          0));
-    } else {
-      tiles_var_.emplace_back(nullptr);
-    }
+    tiles_.emplace_back(new_tile(i, false));
+    tiles_var_.emplace_back(
+        (array_metadata->var_size(i)) ? new_tile(i, true) : nullptr);
   }
-  tiles_.emplace_back(new Tile(
-      array_metadata->coords_type(),
-      array_metadata->coords_compression(),
-      array_metadata->coords_compression_level(),
-      fragment_->tile_size(array_metadata->attribute_num()),
-      array_metadata->coords_size(),
-      array_metadata->domain()->dim_num()));
+  tiles_.emplace_back(new_tile(attribute_num, false));
 }
 
 void WriteState::init_tile_io() {
@@ -283,9 +270,92 @@ void WriteState::init_tile_io() {
   }
   tile_io_.emplace_back(
       new TileIO(query->storage_manager(), fragment_->coords_uri()));
+
+  // Divide the write-behind buffer budget of the fragment among its files
+  uint64_t file_num = tile_io_.size();
+  for (auto tile_io : tile_io_var_)
+    file_num += (tile_io != nullptr) ? 1 : 0;
+  uint64_t write_buffer_size = std::min(
+      constants::tile_write_buffer_size,
+      constants::fragment_write_buffer_size / file_num);
+  for (auto tile_io : tile_io_)
+    tile_io->set_write_buffer_size(write_buffer_size);
+  for (auto tile_io : tile_io_var_) {
+    if (tile_io != nullptr)
+      tile_io->set_write_buffer_size(write_buffer_size);
+  }
+
+  // Bypass the page cache if requested; on failure the buffered writes
+  // are used instead
+  if (query->storage_manager()->config()->write_method() == IOMethod::DIRECT) {
+    for (auto tile_io : tile_io_)
+      tile_io->set_direct_write();
+    for (auto tile_io : tile_io_var_) {
+      if (tile_io != nullptr)
+        tile_io->set_direct_write();
+    }
+  }
+}
+
+Tile* WriteState::new_tile(unsigned int attribute_id, bool var) const {
+  // For easy reference
+  auto array_metadata = fragment_->query()->array_metadata();
+  auto tile_size = fragment_->tile_size(attribute_id);
+
+  // Coordinates
+  if (attribute_id == array_metadata->attribute_num())
+    return new Tile(
+        array_metadata->coords_type(),
+        array_metadata->coords_compression(),
+        array_metadata->coords_compression_level(),
+        tile_size,
+        array_metadata->coords_size(),
+        array_metadata->domain()->dim_num());
+
+  // Variable-sized cell values
+  auto attr = array_metadata->attribute(attribute_id);
+  if (var) {
+    auto tile = new Tile(
+        attr->type(),
+        attr->compressor(),
+        attr->compression_level(),
+        tile_size,
+        datatype_size(attr->type()),
+        0);
+    tile->set_filters(attr->filters());
+    return tile;
+  }
+
+  // Fixed-sized cells, or offsets of variable-sized cells
+  bool var_size = attr->var_size();
+  auto tile = new Tile(
+      (var_size) ? constants::cell_var_offset_type : attr->type(),
+      (var_size) ? array_metadata->cell_var_offsets_compression() :
+                   attr->compressor(),
+      (var_size) ? array_metadata->cell_var_offsets_compression_level() :
+                   attr->compression_level(),
+      tile_size,
+      (var_size) ? constants::cell_var_offset_size : attr->cell_size(),
+      0);
+  if (!var_size)
+    tile->set_filters(attr->filters());
+  return tile;
+}
+
+Status WriteState::queue_tile(unsigned int attribute_id, bool var) {
+  auto& tile = (var) ? tiles_var_[attribute_id] : tiles_[attribute_id];
+  queued_size_ += tile->size();
+  queued_tiles_.push_back({attribute_id, new Buffer(), tile, var});
+  tile = new_tile(attribute_id, var);
+
+  // Bound the memory occupied by the queued tiles
+  if (queued_size_ >= constants::tile_compression_batch_size)
+    return write_queued_tiles();
+
+  return Status::Ok();
 }
 
-void WriteState::sort_cell_pos(
+Status WriteState::sort_cell_pos(
     const void* buffer,
     uint64_t buffer_size,
     std::vector<uint64_t>* cell_pos) const {
@@ -295,89 +365,58 @@ void WriteState::sort_cell_pos(
 
   // Invoke the proper templated function
   if (coords_type == Datatype::INT32)
-    sort_cell_pos<int>(buffer, buffer_size, cell_pos);
+    return sort_cell_pos<int>(buffer, buffer_size, cell_pos);
   else if (coords_type == Datatype::INT64)
-    sort_cell_pos<int64_t>(buffer, buffer_size, cell_pos);
+    return sort_cell_pos<int64_t>(buffer, buffer_size, cell_pos);
   else if (coords_type == Datatype::FLOAT32)
-    sort_cell_pos<float>(buffer, buffer_size, cell_pos);
+    return sort_cell_pos<float>(buffer, buffer_size, cell_pos);
   else if (coords_type == Datatype::FLOAT64)
-    sort_cell_pos<double>(buffer, buffer_size, cell_pos);
+    return sort_cell_pos<double>(buffer, buffer_size, cell_pos);
   else if (coords_type == Datatype::INT8)
-    sort_cell_pos<int8_t>(buffer, buffer_size, cell_pos);
+    return sort_cell_pos<int8_t>(buffer, buffer_size, cell_pos);
   else if (coords_type == Datatype::UINT8)
-    sort_cell_pos<uint8_t>(buffer, buffer_size, cell_pos);
+    return sort_cell_pos<uint8_t>(buffer, buffer_size, cell_pos);
   else if (coords_type == Datatype::INT16)
-    sort_cell_pos<int16_t>(buffer, buffer_size, cell_pos);
+    return sort_cell_pos<int16_t>(buffer, buffer_size, cell_pos);
   else if (coords_type == Datatype::UINT16)
-    sort_cell_pos<uint16_t>(buffer, buffer_size, cell_pos);
+    return sort_cell_pos<uint16_t>(buffer, buffer_size, cell_pos);
   else if (coords_type == Datatype::UINT32)
-    sort_cell_pos<uint32_t>(buffer, buffer_size, cell_pos);
+    return sort_cell_pos<uint32_t>(buffer, buffer_size, cell_pos);
   else if (coords_type == Datatype::UINT64)
-    sort_cell_pos<uint64_t>(buffer, buffer_size, cell_pos);
+    return sort_cell_pos<uint64_t>(buffer, buffer_size, cell_pos);
+
+  return LOG_STATUS(
+      Status::WriteStateError("Cannot sort cells; Invalid coordinates type"));
 }
 
 template <class T>
-void WriteState::sort_cell_pos(
+Status WriteState::sort_cell_pos(
     const void* buffer,
     uint64_t buffer_size,
     std::vector<uint64_t>* cell_pos) const {
   // For easy reference
-  auto array_metadata = fragment_->query()->array_metadata();
+  auto query = fragment_->query();
+  auto array_metadata = query->array_metadata();
   auto dim_num = array_metadata->dim_num();
   uint64_t coords_size = array_metadata->coords_size();
   uint64_t buffer_cell_num = buffer_size / coords_size;
-  Layout cell_order = array_metadata->cell_order();
   auto buffer_T = static_cast<const T*>(buffer);
   auto domain = array_metadata->domain();
-
-  // Populate cell_pos
-  cell_pos->resize(buffer_cell_num);
+  CellSorter cell_sorter(
+      query->storage_manager()->thread_pool(),
+      domain,
+      array_metadata->cell_order());
+
+  // NO TILE GRID
+  if (domain->tile_extents() == nullptr)
+    return cell_sorter.sort(buffer_T, buffer_cell_num, nullptr, cell_pos);
+
+  // TILE GRID: sort first on the tile ids
+  std::vector<uint64_t> ids;
+  ids.resize(buffer_cell_num);
   for (uint64_t i = 0; i < buffer_cell_num; ++i)
-    (*cell_pos)[i] = i;
-
-  // Invoke the proper sort function, based on the cell order
-  if (domain->tile_extents() == nullptr) {  // NO TILE GRID
-    // Sort cell positions
-    switch (cell_order) {
-      case Layout::ROW_MAJOR:
-        std::sort(
-            cell_pos->begin(),
-            cell_pos->end(),
-            SmallerRow<T>(buffer_T, dim_num));
-        break;
-      case Layout::COL_MAJOR:
-        std::sort(
-            cell_pos->begin(),
-            cell_pos->end(),
-            SmallerCol<T>(buffer_T, dim_num));
-        break;
-      default:  // Error
-        assert(0);
-    }
-  } else {  // TILE GRID
-    // Get tile ids
-    std::vector<uint64_t> ids;
-    ids.resize(buffer_cell_num);
-    for (uint64_t i = 0; i < buffer_cell_num; ++i)
-      ids[i] = domain->tile_id<T>(&buffer_T[i * dim_num], (T*)tile_coords_aux_);
-    // Sort cell positions
-    switch (cell_order) {
-      case Layout::ROW_MAJOR:
-        std::sort(
-            cell_pos->begin(),
-            cell_pos->end(),
-            SmallerIdRow<T>(buffer_T, dim_num, ids));
-        break;
-      case Layout::COL_MAJOR:
-        std::sort(
-            cell_pos->begin(),
-            cell_pos->end(),
-            SmallerIdCol<T>(buffer_T, dim_num, ids));
-        break;
-      default:  // Error
-        assert(0);
-    }
-  }
+    ids[i] = domain->tile_id<T>(&buffer_T[i * dim_num], (T*)tile_coords_aux_);
+  return cell_sorter.sort(buffer_T, buffer_cell_num, &ids, cell_pos);
 }
 
 void WriteState::update_bookkeeping(const void* buffer, uint64_t buffer_size) {
@@ -466,39 +505,27 @@ Status WriteState::write_attr(
 
   // Preparation
   auto buf = new ConstBuffer(buffer, buffer_size);
-  auto tile = tiles_[attribute_id];
-  auto tile_io = tile_io_[attribute_id];
 
-  // Fill tiles and dispatch them for writing
-  uint64_t bytes_written = 0;
+  // Fill tiles and queue them for writing
+  Status st;
   do {
-    RETURN_NOT_OK(tile->write(buf));
-    if (tile->full()) {
-      RETURN_NOT_OK(tile_io->write(tile, &bytes_written));
-      metadata_->append_tile_offset(attribute_id, bytes_written);
-      tile->reset_offset();
-      tile->set_size(0);
-    }
-  } while (!buf->end());
+    auto tile = tiles_[attribute_id];
+    st = tile->write(buf);
+    if (st.ok() && tile->full())
+      st = queue_tile(attribute_id, false);
+  } while (st.ok() && !buf->end());
 
   // Clean up
   delete buf;
 
-  return Status::Ok();
+  return st;
 }
 
 Status WriteState::write_attr_last(unsigned int attribute_id) {
-  auto tile = tiles_[attribute_id];
-  assert(!tile->empty());
-  auto tile_io = tile_io_[attribute_id];
+  assert(!tiles_[attribute_id]->empty());
 
-  // Fill tiles and dispatch them for writing
-  uint64_t bytes_written;
-  RETURN_NOT_OK(tile_io->write(tile, &bytes_written));
-  metadata_->append_tile_offset(attribute_id, bytes_written);
-  tile->reset_offset();
-
-  return Status::Ok();
+  // Queue the tile for writing
+  return queue_tile(attribute_id, false);
 }
 
 Status WriteState::write_attr_var(
@@ -517,15 +544,15 @@ Status WriteState::write_attr_var(
 
   uint64_t& buffer_var_offset = buffer_var_offsets_[attribute_id];
 
-  auto tile = tiles_[attribute_id];
-  auto tile_var = tiles_var_[attribute_id];
-  auto tile_io = tile_io_[attribute_id];
-  auto tile_io_var = tile_io_var_[attribute_id];
-
-  // Fill tiles and dispatch them for writing
-  uint64_t bytes_written, bytes_written_var, bytes_to_write_var;
+  // Fill tiles and queue them for writing
+  Status st;
+  uint64_t bytes_to_write_var;
   do {
-    RETURN_NOT_OK(tile->write_with_shift(buf, buffer_var_offset));
+    auto tile = tiles_[attribute_id];
+    auto tile_var = tiles_var_[attribute_id];
+    st = tile->write_with_shift(buf, buffer_var_offset);
+    if (!st.ok())
+      break;
 
     bytes_to_write_var =
         (buf->end()) ?
@@ -533,20 +560,13 @@ Status WriteState::write_attr_var(
             buffer_var_offset + buf->value<uint64_t>() -
                 tile->value<uint64_t>(0);
 
-    RETURN_NOT_OK(tile_var->write(buf_var, bytes_to_write_var));
-
-    if (tile->full()) {
-      RETURN_NOT_OK(tile_io->write(tile, &bytes_written));
-      RETURN_NOT_OK(tile_io_var->write(tile_var, &bytes_written_var));
-      metadata_->append_tile_offset(attribute_id, bytes_written);
-      metadata_->append_tile_var_offset(attribute_id, bytes_written_var);
-      metadata_->append_tile_var_size(attribute_id, tile_var->size());
-      tile->reset_offset();
-      tile->set_size(0);
-      tile_var->reset_offset();
-      tile_var->set_size(0);
+    st = tile_var->write(buf_var, bytes_to_write_var);
+    if (st.ok() && tile->full()) {
+      st = queue_tile(attribute_id, false);
+      if (st.ok())
+        st = queue_tile(attribute_id, true);
     }
-  } while (!buf->end());
+  } while (st.ok() && !buf->end());
 
   buffer_var_offset += buffer_var_size;
 
@@ -554,26 +574,13 @@ Status WriteState::write_attr_var(
   delete buf;
   delete buf_var;
 
-  return Status::Ok();
+  return st;
 }
 
 Status WriteState::write_attr_var_last(unsigned int attribute_id) {
-  auto tile = tiles_[attribute_id];
-  auto tile_var = tiles_var_[attribute_id];
-  auto tile_io = tile_io_[attribute_id];
-  auto tile_io_var = tile_io_var_[attribute_id];
-
-  // Fill tiles and dispatch them for writing
-  uint64_t bytes_written, bytes_written_var;
-  RETURN_NOT_OK(tile_io->write(tile, &bytes_written));
-  RETURN_NOT_OK(tile_io_var->write(tile_var, &bytes_written_var));
-  metadata_->append_tile_offset(attribute_id, bytes_written);
-  metadata_->append_tile_var_offset(attribute_id, bytes_written_var);
-  metadata_->append_tile_var_size(attribute_id, tile_var->size());
-  tile->reset_offset();
-  tile_var->reset_offset();
-
-  return Status::Ok();
+  // Queue the tiles for writing
+  RETURN_NOT_OK(queue_tile(attribute_id, false));
+  return queue_tile(attribute_id, true);
 }
 
 Status WriteState::write_last_tile() {
@@ -589,15 +596,54 @@ Status WriteState::write_last_tile() {
   // Flush the last tile for each compressed attribute (it is still in main
   // memory
   for (unsigned int i = 0; i < attribute_num + 1; ++i) {
-    RETURN_NOT_OK(write_attr_last(i));
-    if (array_metadata->var_size(i))
+    if (array_metadata->var_size(i)) {
       RETURN_NOT_OK(write_attr_var_last(i));
+    } else {
+      RETURN_NOT_OK(write_attr_last(i));
+    }
   }
 
   // Success
   return Status::Ok();
 }
 
+Status WriteState::write_queued_tiles() {
+  // Compress the queued tiles in parallel
+  auto thread_pool = fragment_->query()->storage_manager()->thread_pool();
+  Status st =
+      thread_pool->parallel_for(queued_tiles_.size(), [this](uint64_t i) {
+        auto& queued = queued_tiles_[i];
+        auto tile_io = (queued.var_) ? tile_io_var_[queued.attribute_id_] :
+                                       tile_io_[queued.attribute_id_];
+        return tile_io->compress(queued.tile_, queued.buffer_);
+      });
+
+  // Write the tiles in the order they were queued
+  uint64_t bytes_written;
+  for (auto& queued : queued_tiles_) {
+    auto attribute_id = queued.attribute_id_;
+    if (st.ok() && !queued.var_) {
+      st = tile_io_[attribute_id]->write_compressed(
+          queued.tile_, queued.buffer_, &bytes_written);
+      if (st.ok())
+        metadata_->append_tile_offset(attribute_id, bytes_written);
+    } else if (st.ok()) {
+      st = tile_io_var_[attribute_id]->write_compressed(
+          queued.tile_, queued.buffer_, &bytes_written);
+      if (st.ok()) {
+        metadata_->append_tile_var_offset(attribute_id, bytes_written);
+        metadata_->append_tile_var_size(attribute_id, queued.tile_->size());
+      }
+    }
+    delete queued.tile_;
+    delete queued.buffer_;
+  }
+  queued_tiles_.clear();
+  queued_size_ = 0;
+
+  return st;
+}
+
 Status WriteState::write_sparse_unsorted(
     void** buffers, uint64_t* buffer_sizes) {
   // For easy reference
@@ -612,8 +658,8 @@ Status WriteState::write_sparse_unsorted(
 
   // Sort cell positions
   std::vector<uint64_t> cell_pos;
-  sort_cell_pos(
-      buffers[coords_buffer_i], buffer_sizes[coords_buffer_i], &cell_pos);
+  RETURN_NOT_OK(sort_cell_pos(
+      buffers[coords_buffer_i], buffer_sizes[coords_buffer_i], &cell_pos));
 
   // Write each attribute individually
   int buffer_i = 0;
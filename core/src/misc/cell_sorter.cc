@@ -0,0 +1,399 @@
+/**
+ * @file   cell_sorter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class CellSorter.
+ */
+
+#include "cell_sorter.h"
+#include "comparators.h"
+#include "constants.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+CellSorter::CellSorter(
+    ThreadPool* thread_pool, const Domain* domain, Layout cell_order)
+    : cell_order_(cell_order)
+    , dim_num_(domain->dim_num())
+    , domain_(domain)
+    , thread_pool_(thread_pool) {
+  assert(thread_pool_ != nullptr);
+  assert(
+      cell_order_ == Layout::ROW_MAJOR || cell_order_ == Layout::COL_MAJOR ||
+      cell_order_ == Layout::HILBERT);
+}
+
+CellSorter::~CellSorter() = default;
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+template <class T>
+Status CellSorter::sort(
+    const T* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    std::vector<uint64_t>* cell_pos) const {
+  // Populate cell_pos
+  cell_pos->resize(cell_num);
+  for (uint64_t i = 0; i < cell_num; ++i)
+    (*cell_pos)[i] = i;
+
+  // Compute the Hilbert keys
+  std::vector<uint64_t> hilbert_keys;
+  if (cell_order_ == Layout::HILBERT)
+    RETURN_NOT_OK(compute_hilbert_keys(coords, cell_num, &hilbert_keys));
+
+  // Fall back to the comparators if the keys do not fit in 64 bits
+  std::vector<uint64_t> keys;
+  unsigned int bit_num;
+  RETURN_NOT_OK(
+      compute_keys(coords, cell_num, ids, hilbert_keys, &keys, &bit_num));
+  if (bit_num > 64) {
+    comparator_sort(coords, ids, hilbert_keys, cell_pos);
+    return Status::Ok();
+  }
+
+  RETURN_NOT_OK(radix_sort(bit_num, &keys, cell_pos));
+  if (cell_order_ == Layout::HILBERT)
+    sort_ties(coords, keys, cell_pos);
+
+  return Status::Ok();
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+uint64_t CellSorter::chunk_num(uint64_t cell_num) const {
+  uint64_t chunk_num = cell_num / constants::cell_sort_min_chunk_cell_num;
+  chunk_num =
+      std::min<uint64_t>(chunk_num, (uint64_t)thread_pool_->thread_num() + 1);
+  return std::max<uint64_t>(chunk_num, 1);
+}
+
+template <class T>
+void CellSorter::comparator_sort(
+    const T* coords,
+    const std::vector<uint64_t>* ids,
+    const std::vector<uint64_t>& hilbert_keys,
+    std::vector<uint64_t>* cell_pos) const {
+  if (cell_order_ == Layout::HILBERT)
+    std::sort(cell_pos->begin(), cell_pos->end(), [&](uint64_t a, uint64_t b) {
+      if (ids != nullptr && (*ids)[a] != (*ids)[b])
+        return (*ids)[a] < (*ids)[b];
+      if (hilbert_keys[a] != hilbert_keys[b])
+        return hilbert_keys[a] < hilbert_keys[b];
+      return SmallerRow<T>(coords, dim_num_)(a, b);
+    });
+  else if (ids == nullptr && cell_order_ == Layout::ROW_MAJOR)
+    std::sort(
+        cell_pos->begin(), cell_pos->end(), SmallerRow<T>(coords, dim_num_));
+  else if (ids == nullptr)
+    std::sort(
+        cell_pos->begin(), cell_pos->end(), SmallerCol<T>(coords, dim_num_));
+  else if (cell_order_ == Layout::ROW_MAJOR)
+    std::sort(
+        cell_pos->begin(),
+        cell_pos->end(),
+        SmallerIdRow<T>(coords, dim_num_, *ids));
+  else
+    std::sort(
+        cell_pos->begin(),
+        cell_pos->end(),
+        SmallerIdCol<T>(coords, dim_num_, *ids));
+}
+
+template <class T>
+Status CellSorter::compute_hilbert_keys(
+    const T* coords,
+    uint64_t cell_num,
+    std::vector<uint64_t>* hilbert_keys) const {
+  uint64_t chunk_num = this->chunk_num(cell_num);
+  uint64_t chunk_size = (cell_num + chunk_num - 1) / chunk_num;
+  hilbert_keys->resize(cell_num);
+  return thread_pool_->parallel_for(chunk_num, [&](uint64_t c) {
+    uint64_t end = std::min(cell_num, (c + 1) * chunk_size);
+    for (uint64_t i = c * chunk_size; i < end; ++i)
+      (*hilbert_keys)[i] = domain_->hilbert_key(&coords[i * dim_num_]);
+    return Status::Ok();
+  });
+}
+
+template <class T>
+Status CellSorter::compute_keys(
+    const T* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    const std::vector<uint64_t>& hilbert_keys,
+    std::vector<uint64_t>* keys,
+    unsigned int* bit_num) const {
+  // For easy reference
+  uint64_t chunk_num = this->chunk_num(cell_num);
+  uint64_t chunk_size = (cell_num + chunk_num - 1) / chunk_num;
+  bool hilbert = (cell_order_ == Layout::HILBERT);
+
+  // The values packed into the keys, i.e., the coordinates of each
+  // dimension (or the Hilbert keys instead) and the tile ids
+  const unsigned int ids_r = dim_num_;
+  const unsigned int hilbert_r = dim_num_ + 1;
+  auto value = [&](uint64_t i, unsigned int r) {
+    if (r == ids_r)
+      return (*ids)[i];
+    if (r == hilbert_r)
+      return hilbert_keys[i];
+    return ordered_key(coords[i * dim_num_ + r]);
+  };
+
+  // Pack the values starting from the most significant one, i.e., the tile
+  // ids followed by the dimensions in the cell order
+  std::vector<unsigned int> ranges;
+  if (ids != nullptr)
+    ranges.push_back(ids_r);
+  if (hilbert)
+    ranges.push_back(hilbert_r);
+  for (unsigned int d = 0; !hilbert && d < dim_num_; ++d)
+    ranges.push_back((cell_order_ == Layout::ROW_MAJOR) ? d : dim_num_ - d - 1);
+
+  // Compute the range of each value in each chunk
+  unsigned int range_num = dim_num_ + 2;
+  std::vector<uint64_t> mins(chunk_num * range_num, UINT64_MAX);
+  std::vector<uint64_t> maxs(chunk_num * range_num, 0);
+  RETURN_NOT_OK(thread_pool_->parallel_for(chunk_num, [&](uint64_t c) {
+    uint64_t* min = &mins[c * range_num];
+    uint64_t* max = &maxs[c * range_num];
+    uint64_t end = std::min(cell_num, (c + 1) * chunk_size);
+    for (uint64_t i = c * chunk_size; i < end; ++i) {
+      for (auto r : ranges) {
+        uint64_t v = value(i, r);
+        min[r] = std::min(min[r], v);
+        max[r] = std::max(max[r], v);
+      }
+    }
+    return Status::Ok();
+  }));
+
+  // Compute the number of bits each range needs
+  std::vector<uint64_t> min(range_num, UINT64_MAX);
+  std::vector<unsigned int> bits(range_num, 0);
+  *bit_num = 0;
+  for (auto r : ranges) {
+    uint64_t max = 0;
+    for (uint64_t c = 0; c < chunk_num; ++c) {
+      min[r] = std::min(min[r], mins[c * range_num + r]);
+      max = std::max(max, maxs[c * range_num + r]);
+    }
+    for (uint64_t range = max - min[r]; range != 0; range >>= 1)
+      ++bits[r];
+    *bit_num += bits[r];
+  }
+  if (*bit_num > 64 || cell_num == 0)
+    return Status::Ok();
+
+  keys->resize(cell_num);
+  return thread_pool_->parallel_for(chunk_num, [&](uint64_t c) {
+    uint64_t end = std::min(cell_num, (c + 1) * chunk_size);
+    for (uint64_t i = c * chunk_size; i < end; ++i) {
+      uint64_t key = 0;
+      for (auto r : ranges) {
+        // A range of 64 bits is the only one, so there is nothing to shift
+        uint64_t v = value(i, r) - min[r];
+        key = (bits[r] == 64) ? v : (key << bits[r]) | v;
+      }
+      (*keys)[i] = key;
+    }
+    return Status::Ok();
+  });
+}
+
+uint64_t CellSorter::ordered_key(float value) {
+  // Negative floats are ordered inversely to their bits
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(float));
+  return (bits & 0x80000000u) ? (uint32_t)~bits : (bits | 0x80000000u);
+}
+
+uint64_t CellSorter::ordered_key(double value) {
+  // Negative doubles are ordered inversely to their bits
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(double));
+  return (bits & 0x8000000000000000ull) ? ~bits :
+                                          (bits | 0x8000000000000000ull);
+}
+
+template <class T>
+uint64_t CellSorter::ordered_key(T value) {
+  // Flip the sign bit of signed integers, so that negatives come first
+  auto key = (uint64_t)(typename std::make_unsigned<T>::type)value;
+  if (std::is_signed<T>::value)
+    key ^= (uint64_t)1 << (8 * sizeof(T) - 1);
+  return key;
+}
+
+Status CellSorter::radix_sort(
+    unsigned int bit_num,
+    std::vector<uint64_t>* keys,
+    std::vector<uint64_t>* cell_pos) const {
+  // For easy reference
+  const unsigned int digit_bits = 8;
+  const uint64_t bucket_num = (uint64_t)1 << digit_bits;
+  uint64_t cell_num = keys->size();
+  uint64_t chunk_num = this->chunk_num(cell_num);
+  uint64_t chunk_size = (cell_num + chunk_num - 1) / chunk_num;
+
+  std::vector<uint64_t> keys_tmp(cell_num);
+  std::vector<uint64_t> cell_pos_tmp(cell_num);
+  std::vector<uint64_t> offsets(chunk_num * bucket_num);
+  for (unsigned int shift = 0; shift < bit_num; shift += digit_bits) {
+    // Count the digits in each chunk
+    std::fill(offsets.begin(), offsets.end(), 0);
+    RETURN_NOT_OK(thread_pool_->parallel_for(chunk_num, [&](uint64_t c) {
+      uint64_t* counts = &offsets[c * bucket_num];
+      uint64_t end = std::min(cell_num, (c + 1) * chunk_size);
+      for (uint64_t i = c * chunk_size; i < end; ++i)
+        ++counts[((*keys)[i] >> shift) & (bucket_num - 1)];
+      return Status::Ok();
+    }));
+
+    // Turn the counts into the positions where each chunk scatters each
+    // digit, skipping the digit if all keys agree on it
+    bool skip = false;
+    uint64_t offset = 0;
+    for (uint64_t b = 0; b < bucket_num; ++b) {
+      uint64_t count = 0;
+      for (uint64_t c = 0; c < chunk_num; ++c) {
+        uint64_t& chunk_offset = offsets[c * bucket_num + b];
+        uint64_t chunk_count = chunk_offset;
+        chunk_offset = offset;
+        offset += chunk_count;
+        count += chunk_count;
+      }
+      skip |= (count == cell_num);
+    }
+    if (skip)
+      continue;
+
+    // Scatter the cells in the order of the digit, which keeps the sort
+    // stable, as each chunk scatters its cells in order
+    RETURN_NOT_OK(thread_pool_->parallel_for(chunk_num, [&](uint64_t c) {
+      uint64_t* chunk_offsets = &offsets[c * bucket_num];
+      uint64_t end = std::min(cell_num, (c + 1) * chunk_size);
+      for (uint64_t i = c * chunk_size; i < end; ++i) {
+        uint64_t j = chunk_offsets[((*keys)[i] >> shift) & (bucket_num - 1)]++;
+        keys_tmp[j] = (*keys)[i];
+        cell_pos_tmp[j] = (*cell_pos)[i];
+      }
+      return Status::Ok();
+    }));
+    keys->swap(keys_tmp);
+    cell_pos->swap(cell_pos_tmp);
+  }
+
+  return Status::Ok();
+}
+
+template <class T>
+void CellSorter::sort_ties(
+    const T* coords,
+    const std::vector<uint64_t>& keys,
+    std::vector<uint64_t>* cell_pos) const {
+  uint64_t cell_num = keys.size();
+  for (uint64_t start = 0, end; start < cell_num; start = end) {
+    for (end = start + 1; end < cell_num && keys[end] == keys[start]; ++end)
+      ;
+    if (end - start > 1)
+      std::stable_sort(
+          cell_pos->begin() + start,
+          cell_pos->begin() + end,
+          SmallerRow<T>(coords, dim_num_));
+  }
+}
+
+// Explicit template instantiations
+template Status CellSorter::sort<int>(
+    const int* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    std::vector<uint64_t>* cell_pos) const;
+template Status CellSorter::sort<int64_t>(
+    const int64_t* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    std::vector<uint64_t>* cell_pos) const;
+template Status CellSorter::sort<float>(
+    const float* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    std::vector<uint64_t>* cell_pos) const;
+template Status CellSorter::sort<double>(
+    const double* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    std::vector<uint64_t>* cell_pos) const;
+template Status CellSorter::sort<int8_t>(
+    const int8_t* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    std::vector<uint64_t>* cell_pos) const;
+template Status CellSorter::sort<uint8_t>(
+    const uint8_t* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    std::vector<uint64_t>* cell_pos) const;
+template Status CellSorter::sort<int16_t>(
+    const int16_t* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    std::vector<uint64_t>* cell_pos) const;
+template Status CellSorter::sort<uint16_t>(
+    const uint16_t* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    std::vector<uint64_t>* cell_pos) const;
+template Status CellSorter::sort<uint32_t>(
+    const uint32_t* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    std::vector<uint64_t>* cell_pos) const;
+template Status CellSorter::sort<uint64_t>(
+    const uint64_t* coords,
+    uint64_t cell_num,
+    const std::vector<uint64_t>* ids,
+    std::vector<uint64_t>* cell_pos) const;
+
+}  // namespace tiledb
@@ -49,6 +49,33 @@ const char* array_metadata_filename = "__array_metadata.tdb";
 /** The fragment metadata file name. */
 const char* fragment_metadata_filename = "__fragment_metadata.tdb";
 
+/** Marks the end of a fragment metadata file that has a footer. */
+const uint64_t fragment_metadata_magic = 0x4154454d46424454;
+
+/**
+ * The format version of the fragment metadata files with a footer. Files
+ * without a footer have the original, single-tile format.
+ */
+const uint32_t fragment_metadata_version = 2;
+
+/**
+ * The total size of the write-behind buffers of a fragment being written,
+ * which is divided among the files of the fragment.
+ */
+const uint64_t fragment_write_buffer_size = 16777216;
+
+/**
+ * The interval (in microseconds) at which asynchronous I/O completions are
+ * polled after the kernel fails to wait for them.
+ */
+const unsigned int async_io_poll_interval = 1000;
+
+/**
+ * The maximum number of asynchronous I/O requests the VFS keeps in flight
+ * when reading a batch of file regions.
+ */
+const unsigned int async_io_queue_depth = 64;
+
 /** The default tile capacity. */
 const uint64_t capacity = 10000;
 
@@ -58,6 +85,9 @@ const uint64_t cell_var_offset_size = sizeof(uint64_t);
 /** The type of a variable cell offset. */
 const Datatype cell_var_offset_type = Datatype::UINT64;
 
+/** The minimum number of cells sorted by each thread in a radix sort. */
+const uint64_t cell_sort_min_chunk_cell_num = 65536;
+
 /** A special value indicating varibale size. */
 const uint64_t var_size = UINT64_MAX;
 
@@ -82,6 +112,18 @@ const char* coords = "__coords";
 /** The array filelock name. */
 const char* array_filelock_name = "__array_lock.tdb";
 
+/**
+ * The alignment (in bytes) of the buffers, file offsets and sizes of the
+ * direct I/O writes.
+ */
+const uint64_t direct_io_alignment = 4096;
+
+/**
+ * The size of the staging buffer that accumulates the tiles of a file
+ * written with direct I/O. It must be a multiple of direct_io_alignment.
+ */
+const uint64_t direct_io_buffer_size = 4194304;
+
 /** The special value for an empty int32. */
 const int empty_int32 = INT_MAX;
 
@@ -115,6 +157,9 @@ const uint32_t empty_uint32 = UINT32_MAX;
 /** The special value for an empty uint64. */
 const uint64_t empty_uint64 = UINT64_MAX;
 
+/** The maximum number of file descriptors cached by the VFS. */
+const uint64_t fd_cache_size = 256;
+
 /** The file suffix used in TileDB. */
 const char* file_suffix = ".tdb";
 
@@ -142,15 +187,48 @@ const uint64_t consolidation_buffer_size = 10000000;
 /** The maximum number of bytes written in a single I/O. */
 const uint64_t max_write_bytes = INT_MAX;
 
+/**
+ * The default size (in bytes) of the cache that keeps the metadata of the
+ * closed arrays.
+ */
+const uint64_t metadata_cache_size = 100000000;
+
 /** The maximum name length. */
 const unsigned name_max_len = 256;
 
+/** The size of each read issued by the read-ahead engine. */
+const uint64_t read_ahead_chunk_size = 1048576;
+
+/** The maximum number of files tracked by the read-ahead engine. */
+const unsigned int read_ahead_file_num = 16;
+
+/** The maximum read-ahead window of a file. */
+const uint64_t read_ahead_max_size = 16777216;
+
+/** The initial (and minimum) read-ahead window of a file. */
+const uint64_t read_ahead_min_size = 1048576;
+
+/** The default number of threads that fetch the tiles of a read query. */
+const unsigned int read_thread_num = 1;
+
+/** The maximum number of children of an R-tree node. */
+const unsigned int rtree_fanout = 16;
+
 /** The size of the buffer that holds the sorted cells. */
 const uint64_t sorted_buffer_size = 10000000;
 
 /** The size of the buffer that holds the sorted variable cells. */
 const uint64_t sorted_buffer_var_size = 10000000;
 
+/** The maximum number of threads that sync files concurrently. */
+const unsigned int sync_thread_num = 16;
+
+/**
+ * The default number of threads of the thread pool of a storage manager.
+ * Zero stands for the number of hardware threads.
+ */
+const unsigned int thread_pool_size = 0;
+
 /** Special value indicating a variable number of elements. */
 const unsigned int var_num = UINT_MAX;
 
@@ -193,6 +271,15 @@ const char* bzip2_str = "BZIP2";
 /** String describing DOUBLE_DELTA. */
 const char* double_delta_str = "DOUBLE_DELTA";
 
+/** String describing the DELTA filter. */
+const char* delta_str = "DELTA";
+
+/** String describing the BYTESHUFFLE filter. */
+const char* byteshuffle_str = "BYTESHUFFLE";
+
+/** String describing the BITSHUFFLE filter. */
+const char* bitshuffle_str = "BITSHUFFLE";
+
 /** The string representation for type int32. */
 const char* int32_str = "INT32";
 
@@ -244,14 +331,53 @@ const char* global_order_str = "global-order";
 /** The string representation for the unordered layout. */
 const char* unordered_str = "unordered";
 
+/** The string representation for the Hilbert layout. */
+const char* hilbert_str = "hilbert";
+
+/** The string representation for the Morton layout. */
+const char* morton_str = "morton";
+
 /** The string representation of null. */
 const char* null_str = "null";
 
 /** The version in format { major, minor, revision }. */
 const int version[3] = {1, 0, 0};
 
-/** The size of a tile chunk. */
-const uint64_t tile_chunk_size = INT_MAX;
+/** The default size of the chunks a tile is compressed in. */
+const uint64_t tile_chunk_size = 1048576;
+
+/** The default size (in bytes) of the shared decompressed-tile cache. */
+const uint64_t tile_cache_size = 10000000;
+
+/** The number of independently locked shards of the tile cache. */
+const unsigned int tile_cache_shard_num = 16;
+
+/**
+ * The default maximum gap (in bytes) between two tiles of the same file for
+ * them to be fetched with a single coalesced read.
+ */
+const uint64_t tile_coalesce_gap_size = 1048576;
+
+/** The maximum size of a coalesced tile read. */
+const uint64_t tile_coalesce_max_size = 10000000;
+
+/**
+ * The maximum number of separate file regions that a coalesced tile read
+ * fetches at once.
+ */
+const unsigned int tile_coalesce_region_num = 16;
+
+/**
+ * The total size of the full tiles a write accumulates before compressing
+ * them all at once.
+ */
+const uint64_t tile_compression_batch_size = 33554432;
+
+/**
+ * The maximum size of the buffer that accumulates the written tiles of a
+ * file before they are appended to it.
+ */
+const uint64_t tile_write_buffer_size = 4194304;
 
 }  // namespace constants
 
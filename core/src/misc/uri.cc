@@ -49,7 +49,7 @@ URI::URI() {
 URI::URI(const std::string& path) {
   if (URI::is_posix(path))
     uri_ = VFS::abs_path(path);
-  else if (URI::is_hdfs(path) || URI::is_s3(path))
+  else if (URI::is_hdfs(path) || URI::is_s3(path) || URI::is_mem(path))
     uri_ = path;
   else
     uri_ = "";
@@ -86,6 +86,14 @@ bool URI::is_hdfs() const {
   return utils::starts_with(uri_, "hdfs://");
 }
 
+bool URI::is_mem(const std::string& path) {
+  return utils::starts_with(path, "mem://");
+}
+
+bool URI::is_mem() const {
+  return utils::starts_with(uri_, "mem://");
+}
+
 bool URI::is_s3(const std::string& path) {
   return utils::starts_with(path, "s3://");
 }
@@ -113,6 +121,9 @@ std::string URI::to_path() const {
   if (is_posix())
     return uri_.substr(std::string("file://").size());
 
+  if (is_mem())
+    return uri_.substr(std::string("mem://").size());
+
   if (is_hdfs() || is_s3())
     return uri_;
 
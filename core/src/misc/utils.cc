@@ -685,6 +685,17 @@ bool is_unary_subarray(const T* subarray, unsigned int dim_num) {
   return true;
 }
 
+template <class T>
+bool overlap(const T* range_A, const T* range_B, unsigned int dim_num) {
+  for (unsigned int i = 0; i < dim_num; ++i) {
+    if (range_A[2 * i] > range_B[2 * i + 1] ||
+        range_A[2 * i + 1] < range_B[2 * i])
+      return false;
+  }
+
+  return true;
+}
+
 <<<<<<< HEAD
 const char* layout_str(Layout layout) {
   if (layout == Layout::COL_MAJOR)
@@ -1085,6 +1096,27 @@ template bool is_unary_subarray<uint32_t>(
 template bool is_unary_subarray<uint64_t>(
     const uint64_t* subarray, unsigned int dim_num);
 
+template bool overlap<int>(
+    const int* range_A, const int* range_B, unsigned int dim_num);
+template bool overlap<int64_t>(
+    const int64_t* range_A, const int64_t* range_B, unsigned int dim_num);
+template bool overlap<float>(
+    const float* range_A, const float* range_B, unsigned int dim_num);
+template bool overlap<double>(
+    const double* range_A, const double* range_B, unsigned int dim_num);
+template bool overlap<int8_t>(
+    const int8_t* range_A, const int8_t* range_B, unsigned int dim_num);
+template bool overlap<uint8_t>(
+    const uint8_t* range_A, const uint8_t* range_B, unsigned int dim_num);
+template bool overlap<int16_t>(
+    const int16_t* range_A, const int16_t* range_B, unsigned int dim_num);
+template bool overlap<uint16_t>(
+    const uint16_t* range_A, const uint16_t* range_B, unsigned int dim_num);
+template bool overlap<uint32_t>(
+    const uint32_t* range_A, const uint32_t* range_B, unsigned int dim_num);
+template bool overlap<uint64_t>(
+    const uint64_t* range_A, const uint64_t* range_B, unsigned int dim_num);
+
 }  // namespace utils
 
 }  // namespace tiledb
@@ -37,7 +37,7 @@
 #include <cmath>
 
 #include "array_ordered_read_state.h"
-#include "comparators.h"
+#include "cell_sorter.h"
 #include "logger.h"
 #include "utils.h"
 
@@ -80,6 +80,7 @@ ArrayOrderedReadState::ArrayOrderedReadState(Query* query)
   tile_domain_ = nullptr;
   for (unsigned int i = 0; i < 2; ++i) {
     async_query_[i] = nullptr;
+    async_task_id_[i] = 0;
     buffer_sizes_[i] = nullptr;
     buffer_sizes_tmp_[i] = nullptr;
     buffer_sizes_tmp_bak_[i] = nullptr;
@@ -441,6 +442,29 @@ Status ArrayOrderedReadState::init() {
       calculate_tile_slab_info_ = calculate_tile_slab_info_col<uint64_t>;
     else
       assert(0);
+  } else if (tile_order == Layout::MORTON) {
+    if (coords_type == Datatype::INT32)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<int>;
+    else if (coords_type == Datatype::INT64)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<int64_t>;
+    else if (coords_type == Datatype::FLOAT32)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<float>;
+    else if (coords_type == Datatype::FLOAT64)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<double>;
+    else if (coords_type == Datatype::INT8)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<int8_t>;
+    else if (coords_type == Datatype::UINT8)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<uint8_t>;
+    else if (coords_type == Datatype::INT16)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<int16_t>;
+    else if (coords_type == Datatype::UINT16)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<uint16_t>;
+    else if (coords_type == Datatype::UINT32)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<uint32_t>;
+    else if (coords_type == Datatype::UINT64)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<uint64_t>;
+    else
+      assert(0);
   } else {
     assert(0);
   }
@@ -633,6 +657,8 @@ Status ArrayOrderedReadState::async_submit_query(unsigned int id) {
     RETURN_NOT_OK(async_query_[id]->finalize());
   delete async_query_[id];
   async_query_[id] = new Query();
+  // The coordinates are added only to sparse arrays, as the buffers of dense
+  // arrays do not hold them (see *calculate_attribute_ids*)
   RETURN_NOT_OK(async_query_[id]->init(
       query_->storage_manager(),
       query_->array_metadata(),
@@ -643,19 +669,37 @@ Status ArrayOrderedReadState::async_submit_query(unsigned int id) {
       query_->attribute_ids(),
       buffers_[id],
       buffer_sizes_tmp_[id],
-      true));
+      !query_->array_metadata()->dense()));
   async_query_[id]->set_callback(async_done, &(async_data_[id]));
+  async_query_[id]->set_read_thread_num(query_->read_thread_num());
 
-  // Send the async query
-  RETURN_NOT_OK(storage_manager->async_push_query(async_query_[id], 1));
+  // Send the async query. The lock keeps the task id in sync with the
+  // query, in case the query is resubmitted before the id is recorded
+  std::lock_guard<std::mutex> lk(async_mtx_[id]);
+  RETURN_NOT_OK(
+      storage_manager->async_push_query(async_query_[id], &async_task_id_[id]));
+  async_cv_[id].notify_one();
 
   // Success
   return Status::Ok();
 }
 
 void ArrayOrderedReadState::async_wait(unsigned int id) {
+  auto thread_pool = query_->storage_manager()->thread_pool();
   std::unique_lock<std::mutex> lk(async_mtx_[id]);
-  async_cv_[id].wait(lk, [id, this] { return !async_wait_[id]; });
+  while (async_wait_[id]) {
+    // Execute the awaited query if it is still queued instead of blocking,
+    // so that the wait cannot stall the thread pool. Otherwise, wait until
+    // it is done, or until it is resubmitted after an overflow
+    uint64_t task_id = async_task_id_[id];
+    lk.unlock();
+    bool executed = thread_pool->execute(task_id);
+    lk.lock();
+    if (!executed)
+      async_cv_[id].wait(lk, [id, task_id, this] {
+        return !async_wait_[id] || async_task_id_[id] != task_id;
+      });
+  }
   lk.unlock();
 }
 
@@ -1068,6 +1112,94 @@ void ArrayOrderedReadState::calculate_tile_slab_info_col(unsigned int id) {
   }
 }
 
+template <class T>
+void* ArrayOrderedReadState::calculate_tile_slab_info_morton(void* data) {
+  ArrayOrderedReadState* asrs = ((ASRS_Data*)data)->asrs_;
+  unsigned int id = ((ASRS_Data*)data)->id_;
+  asrs->calculate_tile_slab_info_morton<T>(id);
+  return nullptr;
+}
+
+template <class T>
+void ArrayOrderedReadState::calculate_tile_slab_info_morton(unsigned int id) {
+  // For easy reference
+  auto domain = query_->array_metadata()->domain();
+  auto array_domain = (const T*)domain->domain();
+  auto tile_domain = (const T*)tile_domain_;
+  auto tile_coords = (T*)tile_coords_;
+  auto tile_extents = (const T*)domain->tile_extents();
+  auto range_overlap = (T**)tile_slab_info_[id].range_overlap_;
+  auto tile_slab = (const T*)tile_slab_norm_[id];
+  auto tile_slab_abs = (const T*)tile_slab_[id];
+  uint64_t tile_offset, tile_cell_num;
+  uint64_t total_cell_num = 0;
+  auto anum = (unsigned int)attribute_ids_.size();
+
+  // The tiles are visited in the Morton order of their coordinates in the
+  // array domain, but they are identified by their row-major position in
+  // the tile domain
+  auto morton_domain = new T[2 * dim_num_];
+  auto morton_coords = new T[dim_num_];
+  for (unsigned int i = 0; i < dim_num_; ++i) {
+    T offset = (tile_slab_abs[2 * i] - array_domain[2 * i]) / tile_extents[i];
+    morton_domain[2 * i] = tile_domain[2 * i] + offset;
+    morton_domain[2 * i + 1] = tile_domain[2 * i + 1] + offset;
+    morton_coords[i] = morton_domain[2 * i];
+  }
+
+  // Calculate tile offsets per dimension
+  tile_offset = 1;
+  tile_slab_info_[id].tile_offset_per_dim_[dim_num_ - 1] = tile_offset;
+  for (unsigned int i = dim_num_ - 1; i-- > 0;) {
+    tile_offset *=
+        (tile_domain[2 * (i + 1) + 1] - tile_domain[2 * (i + 1)] + 1);
+    tile_slab_info_[id].tile_offset_per_dim_[i] = tile_offset;
+  }
+
+  // Iterate over all tiles in the tile domain
+  while (morton_coords[0] <= morton_domain[1]) {
+    // Calculate tile coordinates and id
+    uint64_t tid = 0;  // Tile id
+    for (unsigned int i = 0; i < dim_num_; ++i) {
+      tile_coords[i] =
+          morton_coords[i] - morton_domain[2 * i] + tile_domain[2 * i];
+      tid += tile_coords[i] * tile_slab_info_[id].tile_offset_per_dim_[i];
+    }
+
+    // Calculate range overlap, number of cells in the tile
+    tile_cell_num = 1;
+    for (unsigned int i = 0; i < dim_num_; ++i) {
+      // Range overlap
+      range_overlap[tid][2 * i] =
+          MAX(tile_coords[i] * tile_extents[i], tile_slab[2 * i]);
+      range_overlap[tid][2 * i + 1] =
+          MIN((tile_coords[i] + 1) * tile_extents[i] - 1, tile_slab[2 * i + 1]);
+
+      // Number of cells in this tile
+      tile_cell_num *=
+          range_overlap[tid][2 * i + 1] - range_overlap[tid][2 * i] + 1;
+    }
+
+    // Calculate cell slab info
+    ASRS_Data asrs_data = {id, tid, this};
+    (*calculate_cell_slab_info_)(&asrs_data);
+
+    // Calculate start offsets
+    for (unsigned int aid = 0; aid < anum; ++aid) {
+      tile_slab_info_[id].start_offsets_[aid][tid] =
+          total_cell_num * attribute_sizes_[aid];
+    }
+    total_cell_num += tile_cell_num;
+
+    // Advance tile coordinates
+    domain->get_next_tile_coords(morton_domain, morton_coords);
+  }
+
+  // Clean up
+  delete[] morton_domain;
+  delete[] morton_coords;
+}
+
 template <class T>
 void* ArrayOrderedReadState::calculate_tile_slab_info_row(void* data) {
   ArrayOrderedReadState* asrs = ((ASRS_Data*)data)->asrs_;
@@ -2315,7 +2447,7 @@ Status ArrayOrderedReadState::read_sparse_sorted_col() {
     // Copy tile slab
     if (copy_tile_slab_done()) {
       reset_tile_slab_state<T>();
-      sort_cell_pos<T>();
+      RETURN_NOT_OK(sort_cell_pos<T>());
     }
 
   copy_label_1:  // Resume from the point the copy led to overflow
@@ -2334,7 +2466,7 @@ Status ArrayOrderedReadState::read_sparse_sorted_col() {
     async_wait(copy_id_);
     if (copy_tile_slab_done()) {
       reset_tile_slab_state<T>();
-      sort_cell_pos<T>();
+      RETURN_NOT_OK(sort_cell_pos<T>());
     }
 
   copy_label_2:  // Resume from the point the copy led to overflow
@@ -2390,7 +2522,7 @@ Status ArrayOrderedReadState::read_sparse_sorted_row() {
     // Copy tile slab
     if (copy_tile_slab_done()) {
       reset_tile_slab_state<T>();
-      sort_cell_pos<T>();
+      RETURN_NOT_OK(sort_cell_pos<T>());
     }
 
   copy_label_1:  // Resume from the point the copy led to overflow
@@ -2410,7 +2542,7 @@ Status ArrayOrderedReadState::read_sparse_sorted_row() {
     async_wait(copy_id_);
     if (copy_tile_slab_done()) {
       reset_tile_slab_state<T>();
-      sort_cell_pos<T>();
+      RETURN_NOT_OK(sort_cell_pos<T>());
     }
 
   copy_label_2:  // Resume from the point the copy led to overflow
@@ -2483,31 +2615,18 @@ void ArrayOrderedReadState::reset_tile_slab_state() {
 }
 
 template <class T>
-void ArrayOrderedReadState::sort_cell_pos() {
+Status ArrayOrderedReadState::sort_cell_pos() {
   // For easy reference
   auto array_metadata = query_->array_metadata();
-  auto dim_num = array_metadata->dim_num();
   uint64_t cell_num = buffer_sizes_tmp_[copy_id_][coords_buf_i_] / coords_size_;
-  Layout layout = query_->layout();
   auto buffer = static_cast<const T*>(buffers_[copy_id_][coords_buf_i_]);
 
-  // Populate cell_pos
-  cell_pos_.resize(cell_num);
-  for (uint64_t i = 0; i < cell_num; ++i)
-    cell_pos_[i] = i;
-
-  // Invoke the proper sort function, based on the mode
-  if (layout == Layout::ROW_MAJOR) {
-    // Sort cell positions
-    std::sort(
-        cell_pos_.begin(), cell_pos_.end(), SmallerRow<T>(buffer, dim_num));
-  } else if (layout == Layout::COL_MAJOR) {
-    // Sort cell positions
-    std::sort(
-        cell_pos_.begin(), cell_pos_.end(), SmallerCol<T>(buffer, dim_num));
-  } else {
-    assert(0);
-  }
+  // Sort cell positions in the query layout
+  CellSorter cell_sorter(
+      query_->storage_manager()->thread_pool(),
+      array_metadata->domain(),
+      query_->layout());
+  return cell_sorter.sort(buffer, cell_num, nullptr, &cell_pos_);
 }
 
 template <class T>
@@ -71,6 +71,7 @@ ArrayOrderedWriteState::ArrayOrderedWriteState(Query* query)
   buffers_ = nullptr;
   for (unsigned int i = 0; i < 2; ++i) {
     async_query_[i] = nullptr;
+    async_task_id_[i] = 0;
     tile_slab_[i] = std::malloc(2 * coords_size_);
     tile_slab_norm_[i] = std::malloc(2 * coords_size_);
     tile_slab_init_[i] = false;
@@ -297,6 +298,25 @@ Status ArrayOrderedWriteState::init() {
       calculate_tile_slab_info_ = calculate_tile_slab_info_col<uint64_t>;
     else
       assert(0);
+  } else if (tile_order == Layout::MORTON) {
+    if (coords_type == Datatype::INT32)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<int>;
+    else if (coords_type == Datatype::INT64)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<int64_t>;
+    else if (coords_type == Datatype::INT8)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<int8_t>;
+    else if (coords_type == Datatype::UINT8)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<uint8_t>;
+    else if (coords_type == Datatype::INT16)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<int16_t>;
+    else if (coords_type == Datatype::UINT16)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<uint16_t>;
+    else if (coords_type == Datatype::UINT32)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<uint32_t>;
+    else if (coords_type == Datatype::UINT64)
+      calculate_tile_slab_info_ = calculate_tile_slab_info_morton<uint64_t>;
+    else
+      assert(0);
   } else {
     assert(0);
   }
@@ -486,16 +506,33 @@ Status ArrayOrderedWriteState::async_submit_query(unsigned int id) {
     }
   }
 
-  // Send the async query
-  RETURN_NOT_OK(storage_manager->async_push_query(async_query_[id], 1));
+  // Send the async query. The lock keeps the task id in sync with the
+  // query, in case the query is resubmitted before the id is recorded
+  std::lock_guard<std::mutex> lk(async_mtx_[id]);
+  RETURN_NOT_OK(
+      storage_manager->async_push_query(async_query_[id], &async_task_id_[id]));
+  async_cv_[id].notify_one();
 
   // Success
   return Status::Ok();
 }
 
 void ArrayOrderedWriteState::async_wait(unsigned int id) {
+  auto thread_pool = query_->storage_manager()->thread_pool();
   std::unique_lock<std::mutex> lk(async_mtx_[id]);
-  async_cv_[id].wait(lk, [id, this] { return !async_wait_[id]; });
+  while (async_wait_[id]) {
+    // Execute the awaited query if it is still queued instead of blocking,
+    // so that the wait cannot stall the thread pool. Otherwise, wait until
+    // it is done, or until it is resubmitted after an overflow
+    uint64_t task_id = async_task_id_[id];
+    lk.unlock();
+    bool executed = thread_pool->execute(task_id);
+    lk.lock();
+    if (!executed)
+      async_cv_[id].wait(lk, [id, task_id, this] {
+        return !async_wait_[id] || async_task_id_[id] != task_id;
+      });
+  }
   lk.unlock();
 }
 
@@ -776,6 +813,93 @@ void ArrayOrderedWriteState::calculate_tile_slab_info_col(unsigned int id) {
   }
 }
 
+template <class T>
+void* ArrayOrderedWriteState::calculate_tile_slab_info_morton(void* data) {
+  ArrayOrderedWriteState* asws = ((ASWS_Data*)data)->asws_;
+  unsigned int id = ((ASWS_Data*)data)->id_;
+  asws->calculate_tile_slab_info_morton<T>(id);
+  return nullptr;
+}
+
+template <class T>
+void ArrayOrderedWriteState::calculate_tile_slab_info_morton(unsigned int id) {
+  // For easy reference
+  auto domain = query_->array_metadata()->domain();
+  auto array_domain = (const T*)domain->domain();
+  auto tile_domain = (const T*)tile_domain_;
+  auto tile_coords = (T*)tile_coords_;
+  auto tile_extents = (const T*)domain->tile_extents();
+  auto range_overlap = (T**)tile_slab_info_[id].range_overlap_;
+  auto tile_slab = (const T*)tile_slab_norm_[id];
+  auto tile_slab_abs = (const T*)tile_slab_[id];
+  uint64_t tile_offset, tile_cell_num;
+  uint64_t total_cell_num = 0;
+  auto anum = (unsigned int)attribute_ids_.size();
+
+  // The tiles are visited in the Morton order of their coordinates in the
+  // array domain, but they are identified by their row-major position in
+  // the tile domain
+  auto morton_domain = new T[2 * dim_num_];
+  auto morton_coords = new T[dim_num_];
+  for (unsigned int i = 0; i < dim_num_; ++i) {
+    T offset = (tile_slab_abs[2 * i] - array_domain[2 * i]) / tile_extents[i];
+    morton_domain[2 * i] = tile_domain[2 * i] + offset;
+    morton_domain[2 * i + 1] = tile_domain[2 * i + 1] + offset;
+    morton_coords[i] = morton_domain[2 * i];
+  }
+
+  // Calculate tile offsets per dimension
+  tile_offset = 1;
+  tile_slab_info_[id].tile_offset_per_dim_[dim_num_ - 1] = tile_offset;
+  for (unsigned int i = dim_num_ - 1; i-- > 0;) {
+    tile_offset *=
+        (tile_domain[2 * (i + 1) + 1] - tile_domain[2 * (i + 1)] + 1);
+    tile_slab_info_[id].tile_offset_per_dim_[i] = tile_offset;
+  }
+
+  // Iterate over all tiles in the tile domain
+  while (morton_coords[0] <= morton_domain[1]) {
+    // Calculate tile coordinates and id
+    uint64_t tid = 0;  // Tile id
+    for (unsigned int i = 0; i < dim_num_; ++i) {
+      tile_coords[i] =
+          morton_coords[i] - morton_domain[2 * i] + tile_domain[2 * i];
+      tid += tile_coords[i] * tile_slab_info_[id].tile_offset_per_dim_[i];
+    }
+
+    // Calculate range overlap, number of cells in the tile
+    tile_cell_num = 1;
+    for (unsigned int i = 0; i < dim_num_; ++i) {
+      // Range overlap
+      range_overlap[tid][2 * i] =
+          MAX(tile_coords[i] * tile_extents[i], tile_slab[2 * i]);
+      range_overlap[tid][2 * i + 1] =
+          MIN((tile_coords[i] + 1) * tile_extents[i] - 1, tile_slab[2 * i + 1]);
+
+      // Number of cells in this tile
+      tile_cell_num *= tile_extents[i];
+    }
+
+    // Calculate cell slab info
+    ASWS_Data asws_data = {id, tid, this};
+    (*calculate_cell_slab_info_)(&asws_data);
+
+    // Calculate start offsets
+    for (unsigned int aid = 0; aid < anum; ++aid) {
+      tile_slab_info_[id].start_offsets_[aid][tid] =
+          total_cell_num * attribute_sizes_[aid];
+    }
+    total_cell_num += tile_cell_num;
+
+    // Advance tile coordinates
+    domain->get_next_tile_coords(morton_domain, morton_coords);
+  }
+
+  // Clean up
+  delete[] morton_domain;
+  delete[] morton_coords;
+}
+
 template <class T>
 void* ArrayOrderedWriteState::calculate_tile_slab_info_row(void* data) {
   ArrayOrderedWriteState* asws = ((ASWS_Data*)data)->asws_;
@@ -1580,7 +1704,9 @@ bool ArrayOrderedWriteState::separate_fragments() const {
   Layout tile_order = query_->array_metadata()->tile_order();
   return (query_layout == Layout::COL_MAJOR &&
           tile_order == Layout::ROW_MAJOR) ||
-         (query_layout == Layout::ROW_MAJOR && tile_order == Layout::COL_MAJOR);
+         (query_layout == Layout::ROW_MAJOR &&
+          tile_order == Layout::COL_MAJOR) ||
+         tile_order == Layout::MORTON;
 }
 
 void ArrayOrderedWriteState::init_copy_state() {
@@ -1835,6 +1961,9 @@ Status ArrayOrderedWriteState::write_sorted_col() {
     reset_tile_slab_state<T>();
     reset_copy_state();
     copy_tile_slab();
+    // Both async queries write to the same fragment, so they must not
+    // overlap; the previous one writes while the tile slab is copied
+    async_wait((copy_id_ + 1) % 2);
     async_wait_[copy_id_] = true;
     async_submit_query(copy_id_);
     copy_id_ = (copy_id_ + 1) % 2;
@@ -1865,6 +1994,9 @@ Status ArrayOrderedWriteState::write_sorted_row() {
     reset_tile_slab_state<T>();
     reset_copy_state();
     copy_tile_slab();
+    // Both async queries write to the same fragment, so they must not
+    // overlap; the previous one writes while the tile slab is copied
+    async_wait((copy_id_ + 1) % 2);
     async_wait_[copy_id_] = true;
     async_submit_query(copy_id_);
     copy_id_ = (copy_id_ + 1) % 2;
@@ -152,6 +152,8 @@ Status ArrayReadState::read(void** buffers, uint64_t* buffer_sizes) {
   for (unsigned int i = 0; i < fragment_num_; ++i)
     fragment_read_states_[i]->reset_overflow();
 
+  if (query_->read_thread_num() > 1)  // PARALLEL
+    return read_parallel(buffers, buffer_sizes);
   if (array_metadata_->dense())  // DENSE
     return read_dense(buffers, buffer_sizes);
   return read_sparse(buffers, buffer_sizes);  // SPARSE
@@ -1143,6 +1145,90 @@ ArrayReadState::FragmentCellRanges ArrayReadState::empty_fragment_cell_ranges()
   return fragment_cell_ranges;
 }
 
+Status ArrayReadState::fetch_tiles(const std::vector<bool>& finished) {
+  // For easy reference
+  auto& attribute_ids = query_->attribute_ids();
+  auto attribute_id_num = (unsigned int)attribute_ids.size();
+
+  // Collect the tiles of the current read round of each unfinished
+  // attribute, at most one per fragment and attribute, since a fragment
+  // read state holds a single tile per attribute
+  std::vector<std::pair<FragmentInfo, unsigned int>> tiles;
+  std::vector<bool> collected(fragment_num_ * (attribute_num_ + 1), false);
+  for (unsigned int i = 0; i < attribute_id_num; ++i) {
+    if (finished[i])
+      continue;
+    unsigned int attribute_id = attribute_ids[i];
+    uint64_t pos = fragment_cell_pos_ranges_vec_pos_[attribute_id];
+    for (auto& fragment_cell_pos_range : *fragment_cell_pos_ranges_vec_[pos]) {
+      const FragmentInfo& fragment_info = fragment_cell_pos_range.first;
+      if (fragment_info.first == INVALID_UINT)
+        continue;
+      uint64_t c = fragment_info.first * (attribute_num_ + 1) + attribute_id;
+      if (!collected[c]) {
+        collected[c] = true;
+        tiles.emplace_back(fragment_info, attribute_id);
+      }
+    }
+  }
+
+  // A single tile is fetched when its cells are copied
+  if (tiles.size() <= 1)
+    return Status::Ok();
+
+  // Fetch the tiles in parallel
+  auto thread_pool = query_->storage_manager()->thread_pool();
+  return thread_pool->parallel_for(
+      tiles.size(),
+      [&](uint64_t i) {
+        const FragmentInfo& fragment_info = tiles[i].first;
+        return fragment_read_states_[fragment_info.first]->fetch_tile(
+            tiles[i].second, fragment_info.second);
+      },
+      query_->read_thread_num());
+}
+
+Status ArrayReadState::get_next_fragment_cell_ranges() {
+  // For easy reference
+  Datatype coords_type = array_metadata_->coords_type();
+  bool dense = array_metadata_->dense();
+
+  // Invoke the proper templated function
+  if (coords_type == Datatype::INT32)
+    return dense ? get_next_fragment_cell_ranges_dense<int>() :
+                   get_next_fragment_cell_ranges_sparse<int>();
+  if (coords_type == Datatype::INT64)
+    return dense ? get_next_fragment_cell_ranges_dense<int64_t>() :
+                   get_next_fragment_cell_ranges_sparse<int64_t>();
+  if (coords_type == Datatype::INT8)
+    return dense ? get_next_fragment_cell_ranges_dense<int8_t>() :
+                   get_next_fragment_cell_ranges_sparse<int8_t>();
+  if (coords_type == Datatype::UINT8)
+    return dense ? get_next_fragment_cell_ranges_dense<uint8_t>() :
+                   get_next_fragment_cell_ranges_sparse<uint8_t>();
+  if (coords_type == Datatype::INT16)
+    return dense ? get_next_fragment_cell_ranges_dense<int16_t>() :
+                   get_next_fragment_cell_ranges_sparse<int16_t>();
+  if (coords_type == Datatype::UINT16)
+    return dense ? get_next_fragment_cell_ranges_dense<uint16_t>() :
+                   get_next_fragment_cell_ranges_sparse<uint16_t>();
+  if (coords_type == Datatype::UINT32)
+    return dense ? get_next_fragment_cell_ranges_dense<uint32_t>() :
+                   get_next_fragment_cell_ranges_sparse<uint32_t>();
+  if (coords_type == Datatype::UINT64)
+    return dense ? get_next_fragment_cell_ranges_dense<uint64_t>() :
+                   get_next_fragment_cell_ranges_sparse<uint64_t>();
+  if (!dense && coords_type == Datatype::FLOAT32)
+    return get_next_fragment_cell_ranges_sparse<float>();
+  if (!dense && coords_type == Datatype::FLOAT64)
+    return get_next_fragment_cell_ranges_sparse<double>();
+
+  // Code should never reach here
+  assert(0);
+  return LOG_STATUS(
+      Status::ARSError("Invalid datatype when computing the next read round"));
+}
+
 template <class T>
 Status ArrayReadState::get_next_fragment_cell_ranges_dense() {
   // Trivial case
@@ -1621,6 +1707,85 @@ Status ArrayReadState::read_dense_attr_var(
   return Status::Ok();
 }
 
+Status ArrayReadState::read_parallel(void** buffers, uint64_t* buffer_sizes) {
+  // For easy reference
+  auto& attribute_ids = query_->attribute_ids();
+  auto attribute_id_num = (unsigned int)attribute_ids.size();
+
+  // Find the (first) buffer of each attribute
+  std::vector<unsigned int> buffer_i(attribute_id_num);
+  for (unsigned int i = 0, b = 0; i < attribute_id_num; ++i) {
+    buffer_i[i] = b;
+    b += array_metadata_->var_size(attribute_ids[i]) ? 2 : 1;
+  }
+
+  // Advance all attributes one read round at a time, until the read is done
+  // or there is a buffer overflow for each of them
+  std::vector<uint64_t> buffer_offsets(attribute_id_num, 0);
+  std::vector<uint64_t> buffer_var_offsets(attribute_id_num, 0);
+  std::vector<bool> finished(attribute_id_num, false);
+  unsigned int finished_num = 0;
+  while (finished_num < attribute_id_num) {
+    // Prepare the cell ranges of the next read round, unless the attribute
+    // continues from a previous unfinished read round
+    for (unsigned int i = 0; i < attribute_id_num; ++i) {
+      if (finished[i])
+        continue;
+      unsigned int attribute_id = attribute_ids[i];
+      if (fragment_cell_pos_ranges_vec_pos_[attribute_id] >=
+          uint64_t(fragment_cell_pos_ranges_vec_.size()))
+        RETURN_NOT_OK(get_next_fragment_cell_ranges());
+
+      // Check if read is done
+      if (done_ && fragment_cell_pos_ranges_vec_pos_[attribute_id] ==
+                       uint64_t(fragment_cell_pos_ranges_vec_.size())) {
+        finished[i] = true;
+        ++finished_num;
+      }
+    }
+
+    // Fetch the tiles of all attributes and fragments for the read round
+    RETURN_NOT_OK(fetch_tiles(finished));
+
+    // Copy cells to buffers
+    for (unsigned int i = 0; i < attribute_id_num; ++i) {
+      if (finished[i])
+        continue;
+      unsigned int attribute_id = attribute_ids[i];
+      unsigned int b = buffer_i[i];
+      if (!array_metadata_->var_size(attribute_id)) {  // FIXED CELLS
+        RETURN_NOT_OK(copy_cells(
+            attribute_id, buffers[b], buffer_sizes[b], &buffer_offsets[i]));
+      } else {  // VARIABLE-SIZED CELLS
+        RETURN_NOT_OK(copy_cells_var(
+            attribute_id,
+            buffers[b],
+            buffer_sizes[b],
+            &buffer_offsets[i],
+            buffers[b + 1],
+            buffer_sizes[b + 1],
+            &buffer_var_offsets[i]));
+      }
+
+      // Check for buffer overflow
+      if (overflow_[attribute_id]) {
+        finished[i] = true;
+        ++finished_num;
+      }
+    }
+  }
+
+  // Set the sizes of the useful data in the buffers
+  for (unsigned int i = 0; i < attribute_id_num; ++i) {
+    unsigned int b = buffer_i[i];
+    buffer_sizes[b] = buffer_offsets[i];
+    if (array_metadata_->var_size(attribute_ids[i]))
+      buffer_sizes[b + 1] = buffer_var_offsets[i];
+  }
+
+  return Status::Ok();
+}
+
 Status ArrayReadState::read_sparse(void** buffers, uint64_t* buffer_sizes) {
   // For easy reference
   auto attribute_ids = query_->attribute_ids();
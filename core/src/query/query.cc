@@ -35,6 +35,8 @@
 #include "utils.h"
 
 #include <sys/time.h>
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 
 /* ****************************** */
@@ -55,6 +57,7 @@ Query::Query() {
   storage_manager_ = nullptr;
   fragments_borrowed_ = false;
   consolidation_fragment_uri_ = URI();
+  read_thread_num_ = 0;
 }
 
 Query::Query(Query* common_query) {
@@ -73,6 +76,7 @@ Query::Query(Query* common_query) {
   layout_ = common_query->layout();
   status_ = QueryStatus::INPROGRESS;
   consolidation_fragment_uri_ = common_query->consolidation_fragment_uri_;
+  read_thread_num_ = common_query->read_thread_num_;
 }
 
 Query::~Query() {
@@ -395,6 +399,13 @@ Status Query::read(void** buffers, uint64_t* buffer_sizes) {
   return array_read_state_->read(buffers, buffer_sizes);
 }
 
+unsigned int Query::read_thread_num() const {
+  if (read_thread_num_ != 0)
+    return read_thread_num_;
+
+  return storage_manager_->config()->read_thread_num();
+}
+
 void Query::set_buffers(void** buffers, uint64_t* buffer_sizes) {
   buffers_ = buffers;
   buffer_sizes_ = buffer_sizes;
@@ -405,6 +416,10 @@ void Query::set_callback(void* (*callback)(void*), void* callback_data) {
   callback_data_ = callback_data;
 }
 
+void Query::set_read_thread_num(unsigned int read_thread_num) {
+  read_thread_num_ = read_thread_num;
+}
+
 void Query::set_status(QueryStatus status) {
   status_ = status;
 }
@@ -509,6 +524,11 @@ Status Query::init_fragments(
 }
 
 Status Query::init_states() {
+  // The Hilbert and Morton layouts are only cell and tile orders
+  if (layout_ == Layout::HILBERT || layout_ == Layout::MORTON)
+    return LOG_STATUS(
+        Status::QueryError("Cannot initialize query; Invalid layout"));
+
   // Initialize new fragment if needed
   if (type_ == QueryType::WRITE &&
       (layout_ == Layout::COL_MAJOR || layout_ == Layout::ROW_MAJOR)) {
@@ -564,6 +584,14 @@ std::string Query::new_fragment_name() const {
   struct timeval tp = {};
   gettimeofday(&tp, nullptr);
   uint64_t ms = (uint64_t)tp.tv_sec * 1000L + tp.tv_usec / 1000;
+
+  // A thread of the pool may create several fragments within the same
+  // millisecond, so the timestamps must strictly increase in the process
+  static std::atomic<uint64_t> last_ms(0);
+  uint64_t prev_ms = last_ms;
+  do {
+    ms = std::max(ms, prev_ms + 1);
+  } while (!last_ms.compare_exchange_weak(prev_ms, ms));
   char fragment_name[constants::name_max_len];
 
   std::stringstream ss;
@@ -32,6 +32,9 @@
  */
 
 #include "open_array.h"
+#include "utils.h"
+
+#include <set>
 
 namespace tiledb {
 
@@ -41,10 +44,13 @@ namespace tiledb {
 
 OpenArray::OpenArray() {
   array_metadata_ = nullptr;
+  array_metadata_file_size_ = 0;
   cnt_ = 0;
 }
 
 OpenArray::~OpenArray() {
+  for (auto& metadata : fragment_metadata_)
+    delete metadata.second.first;
   delete array_metadata_;
 }
 
@@ -56,6 +62,10 @@ const ArrayMetadata* OpenArray::array_metadata() const {
   return array_metadata_;
 }
 
+uint64_t OpenArray::array_metadata_file_size() const {
+  return array_metadata_file_size_;
+}
+
 const URI& OpenArray::array_uri() const {
   return array_metadata_->array_uri();
 }
@@ -73,6 +83,27 @@ void OpenArray::fragment_metadata_add(FragmentMetadata* metadata) {
       std::pair<FragmentMetadata*, uint64_t>(metadata, 1);
 }
 
+void OpenArray::fragment_metadata_evict(const URI& uri) {
+  std::string uri_str = uri.to_string();
+  for (auto it = fragment_metadata_.begin(); it != fragment_metadata_.end();) {
+    const std::string& fragment_str = it->first;
+    bool overlap = fragment_str == uri_str ||
+                   utils::starts_with(fragment_str, uri_str + "/") ||
+                   utils::starts_with(uri_str, fragment_str + "/");
+    if (overlap && it->second.second == 0) {
+      delete it->second.first;
+      it = fragment_metadata_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool OpenArray::fragment_metadata_exists(const URI& fragment_uri) const {
+  return fragment_metadata_.find(fragment_uri.to_string()) !=
+         fragment_metadata_.end();
+}
+
 FragmentMetadata* OpenArray::fragment_metadata_get(const URI& fragment_uri) {
   auto it = fragment_metadata_.find(fragment_uri.to_string());
   if (it == fragment_metadata_.end())
@@ -90,12 +121,21 @@ void OpenArray::fragment_metadata_rm(const URI& fragment_uri) {
 
   // Decrement counter
   --(it->second.second);
+}
 
-  // Potentially remove metadata from main memory
-  // TODO: The following may be left to a cache manager
-  if (it->second.second == 0) {
-    delete it->second.first;
-    fragment_metadata_.erase(it);
+void OpenArray::fragment_metadata_retain(
+    const std::vector<URI>& fragment_uris) {
+  std::set<std::string> retained;
+  for (auto& uri : fragment_uris)
+    retained.insert(uri.to_string());
+
+  for (auto it = fragment_metadata_.begin(); it != fragment_metadata_.end();) {
+    if (it->second.second == 0 && retained.count(it->first) == 0) {
+      delete it->second.first;
+      it = fragment_metadata_.erase(it);
+    } else {
+      ++it;
+    }
   }
 }
 
@@ -103,6 +143,14 @@ void OpenArray::incr_cnt() {
   ++cnt_;
 }
 
+uint64_t OpenArray::memory_size() const {
+  uint64_t size = sizeof(OpenArray);
+  for (auto& metadata : fragment_metadata_)
+    size += metadata.first.size() + metadata.second.first->memory_size();
+
+  return size;
+}
+
 void OpenArray::mtx_lock() {
   mtx_.lock();
 }
@@ -111,8 +159,10 @@ void OpenArray::mtx_unlock() {
   mtx_.unlock();
 }
 
-void OpenArray::set_array_metadata(const ArrayMetadata* array_metadata) {
+void OpenArray::set_array_metadata(
+    const ArrayMetadata* array_metadata, uint64_t file_size) {
   array_metadata_ = array_metadata;
+  array_metadata_file_size_ = file_size;
 }
 
 /* ****************************** */
@@ -36,6 +36,7 @@
 
 #include "logger.h"
 #include "storage_manager.h"
+#include "tile_cache.h"
 #include "utils.h"
 
 namespace tiledb {
@@ -45,18 +46,19 @@ namespace tiledb {
 /* ****************************** */
 
 StorageManager::StorageManager() {
-  async_done_ = false;
-  async_thread_[0] = nullptr;
-  async_thread_[1] = nullptr;
+  config_ = nullptr;
   consolidator_ = new Consolidator(this);
+  thread_pool_ = new ThreadPool();
   vfs_ = nullptr;
   blosc_init();
 }
 
 StorageManager::~StorageManager() {
-  async_stop();
-  delete async_thread_[0];
-  delete async_thread_[1];
+  global_tile_cache().release_budget(this);
+  delete thread_pool_;
+  for (auto& array_uri : closed_arrays_)
+    delete open_arrays_[array_uri];
+  delete config_;
   delete vfs_;
   blosc_destroy();
 }
@@ -102,6 +104,7 @@ Status StorageManager::array_create(ArrayMetadata* array_metadata) {
 
   // Create array directory
   const URI& array_uri = array_metadata->array_uri();
+  metadata_cache_invalidate(array_uri);
   RETURN_NOT_OK(vfs_->create_dir(array_uri));
 
   // Store array metadata
@@ -184,20 +187,17 @@ Status StorageManager::array_unlock(const URI& array_uri, bool shared) {
   return st;
 }
 
-Status StorageManager::async_push_query(Query* query, int i) {
+Status StorageManager::async_push_query(Query* query, uint64_t* task_id) {
   // Set the request status
   query->set_status(QueryStatus::INPROGRESS);
 
-  // Push request
-  {
-    std::lock_guard<std::mutex> lock(async_mtx_[i]);
-    async_queue_[i].emplace(query);
-  }
-
-  // Signal AIO thread
-  async_cv_[i].notify_one();
+  // Queue the query in the thread pool
+  return thread_pool_->enqueue(
+      [this, query]() { async_process_query(query); }, task_id);
+}
 
-  return Status::Ok();
+const Config* StorageManager::config() const {
+  return config_;
 }
 
 Status StorageManager::create_dir(const URI& uri) {
@@ -208,30 +208,38 @@ Status StorageManager::create_file(const URI& uri) {
   return vfs_->create_file(uri);
 }
 
-Status StorageManager::delete_fragment(const URI& uri) const {
+Status StorageManager::delete_fragment(const URI& uri) {
   if (!is_fragment(uri)) {
     return LOG_STATUS(Status::StorageManagerError(
         "Cannot delete fragment directory; '" + uri.to_string() +
         "' is not a TileDB fragment"));
   }
+  global_tile_cache().invalidate(uri);
+  metadata_cache_invalidate(uri);
   return vfs_->remove_path(uri);
 }
 
-Status StorageManager::remove_path(const URI& uri) const {
+Status StorageManager::remove_path(const URI& uri) {
   if (object_type(uri) == ObjectType::INVALID) {
     return LOG_STATUS(Status::StorageManagerError(
         "Not a valid TileDB object: " + uri.to_string()));
   }
+  global_tile_cache().invalidate(uri);
+  metadata_cache_invalidate(uri);
   return vfs_->remove_path(uri);
 }
 
 Status StorageManager::move(
-    const URI& old_uri, const URI& new_uri, bool force) const {
+    const URI& old_uri, const URI& new_uri, bool force) {
   if (object_type(old_uri) == ObjectType::INVALID) {
     return LOG_STATUS(Status::StorageManagerError(
         "Not a valid TileDB object: " + old_uri.to_string()));
   }
 
+  global_tile_cache().invalidate(old_uri);
+  global_tile_cache().invalidate(new_uri);
+  metadata_cache_invalidate(old_uri);
+  metadata_cache_invalidate(new_uri);
   return vfs_->move_path(old_uri, new_uri);
 }
 
@@ -257,11 +265,10 @@ Status StorageManager::group_create(const std::string& group) const {
 }
 
 Status StorageManager::init() {
-  async_thread_[0] = new std::thread(async_start, this, 0);
-  async_thread_[1] = new std::thread(async_start, this, 1);
+  config_ = new Config();
   vfs_ = new VFS();
 
-  return Status::Ok();
+  return thread_pool_->set_thread_num(config_->thread_pool_size());
 }
 
 bool StorageManager::is_dir(const URI& uri) {
@@ -329,6 +336,23 @@ Status StorageManager::load(FragmentMetadata* fragment_metadata) {
   URI fragment_metadata_uri = fragment_uri.join_path(
       std::string(constants::fragment_metadata_filename));
 
+  // Load the sections on demand if the file has a footer
+  bool has_footer;
+  std::vector<uint64_t> section_offsets;
+  auto basic = new Buffer();
+  RETURN_NOT_OK_ELSE(
+      load_fragment_metadata_footer(
+          fragment_metadata, &has_footer, &section_offsets, basic),
+      delete basic);
+  if (has_footer) {
+    auto cbuff = new ConstBuffer(basic);
+    Status st = fragment_metadata->init_sections(this, section_offsets, cbuff);
+    delete cbuff;
+    delete basic;
+    return st;
+  }
+  delete basic;
+
   // Read from file
   auto tile = (Tile*)nullptr;
   auto tile_io = new TileIO(this, fragment_metadata_uri);
@@ -337,7 +361,7 @@ Status StorageManager::load(FragmentMetadata* fragment_metadata) {
   // Deserialize
   tile->reset_offset();
   auto cbuff = new ConstBuffer(tile->buffer());
-  Status st = fragment_metadata->deserialize(cbuff);
+  Status st = fragment_metadata->deserialize(this, cbuff);
 
   delete cbuff;
   delete tile;
@@ -346,8 +370,34 @@ Status StorageManager::load(FragmentMetadata* fragment_metadata) {
   return st;
 }
 
+Status StorageManager::map_file(
+    const URI& uri, void** data, uint64_t* size) const {
+  return vfs_->map_file(uri, data, size);
+}
+
+bool StorageManager::metadata_cached(const URI& array_uri) {
+  std::lock_guard<std::mutex> lock(open_array_mtx_);
+  return std::find(
+             closed_arrays_.begin(),
+             closed_arrays_.end(),
+             array_uri.to_string()) != closed_arrays_.end();
+}
+
+uint64_t StorageManager::metadata_cache_size() {
+  std::lock_guard<std::mutex> lock(open_array_mtx_);
+  uint64_t size = 0;
+  for (auto& array_uri : closed_arrays_)
+    size += open_arrays_[array_uri]->memory_size();
+
+  return size;
+}
+
 Status StorageManager::move_path(
     const URI& old_uri, const URI& new_uri, bool force) {
+  global_tile_cache().invalidate(old_uri);
+  global_tile_cache().invalidate(new_uri);
+  metadata_cache_invalidate(old_uri);
+  metadata_cache_invalidate(new_uri);
   return vfs_->move_path(old_uri, new_uri);
 }
 
@@ -526,7 +576,12 @@ Status StorageManager::query_submit_async(
     Query* query, void* (*callback)(void*), void* callback_data) {
   // Push the query into the async queue
   query->set_callback(callback, callback_data);
-  return async_push_query(query, 0);
+  return async_push_query(query);
+}
+
+Status StorageManager::read_batch(
+    const URI& uri, const std::vector<VFS::ReadRegion>& regions) const {
+  return vfs_->read_batch(uri, regions);
 }
 
 Status StorageManager::read_from_file(
@@ -539,6 +594,19 @@ Status StorageManager::read_from_file(
   return Status::Ok();
 }
 
+Status StorageManager::set_config(const Config* config) {
+  delete config_;
+  config_ = new Config(config);
+  if (vfs_ != nullptr) {
+    vfs_->set_mem_spill(config_->mem_spill_size(), config_->mem_spill_dir());
+    vfs_->set_read_ahead(config_->read_ahead());
+  }
+  global_tile_cache().request_budget(this, config_->tile_cache_size());
+  RETURN_NOT_OK(thread_pool_->set_thread_num(config_->thread_pool_size()));
+
+  return Status::Ok();
+}
+
 Status StorageManager::store(ArrayMetadata* array_metadata) {
   URI array_metadata_uri =
       array_metadata->array_uri().join_path(constants::array_metadata_filename);
@@ -562,7 +630,8 @@ Status StorageManager::store(ArrayMetadata* array_metadata) {
       buff,
       false);
   auto tile_io = new TileIO(this, array_metadata_uri);
-  Status st = tile_io->write_generic(tile);
+  uint64_t bytes_written;
+  Status st = tile_io->write_generic(tile, &bytes_written);
 
   delete tile;
   delete tile_io;
@@ -577,28 +646,57 @@ Status StorageManager::store(FragmentMetadata* metadata) {
   if (!vfs_->is_dir(fragment_uri))
     return Status::Ok();
 
-  // Serialize
-  auto buff = new Buffer();
-  RETURN_NOT_OK_ELSE(metadata->serialize(buff), delete buff);
-
-  // Write to file
   URI fragment_metadata_uri = fragment_uri.join_path(
       std::string(constants::fragment_metadata_filename));
-  buff->reset_offset();
-  auto tile = new Tile(
-      constants::generic_tile_datatype,
-      constants::generic_tile_compressor,
-      constants::generic_tile_compression_level,
-      constants::generic_tile_cell_size,
-      0,
-      buff,
-      false);
-
   auto tile_io = new TileIO(this, fragment_metadata_uri);
-  Status st = tile_io->write_generic(tile);
 
-  delete tile;
+  // Write each section as a generic tile
+  unsigned int section_num = metadata->section_num();
+  std::vector<uint64_t> section_offsets(section_num);
+  uint64_t file_offset = 0;
+  Status st;
+  for (unsigned int i = 0; i < section_num && st.ok(); ++i) {
+    auto buff = new Buffer();
+    st = metadata->serialize(i, buff);
+    if (st.ok()) {
+      buff->reset_offset();
+      auto tile = new Tile(
+          constants::generic_tile_datatype,
+          constants::generic_tile_compressor,
+          constants::generic_tile_compression_level,
+          constants::generic_tile_cell_size,
+          0,
+          buff,
+          false);
+      uint64_t bytes_written;
+      section_offsets[i] = file_offset;
+      st = tile_io->write_generic(tile, &bytes_written);
+      file_offset += bytes_written;
+      delete tile;
+    }
+    delete buff;
+  }
   delete tile_io;
+  RETURN_NOT_OK(st);
+
+  // Write the footer
+  auto buff = new Buffer();
+  uint64_t section_num_64 = section_num;
+  st = metadata->serialize(0, buff);
+  uint64_t basic_size = buff->size();
+  if (st.ok())
+    st = buff->write(&section_offsets[0], section_num * sizeof(uint64_t));
+  if (st.ok())
+    st = buff->write(&basic_size, sizeof(uint64_t));
+  if (st.ok())
+    st = buff->write(&section_num_64, sizeof(uint64_t));
+  if (st.ok())
+    st = buff->write(&constants::fragment_metadata_version, sizeof(uint32_t));
+  if (st.ok())
+    st = buff->write(&constants::fragment_metadata_magic, sizeof(uint64_t));
+  if (st.ok())
+    st = write_to_file(fragment_metadata_uri, buff);
+
   delete buff;
 
   return st;
@@ -608,10 +706,34 @@ Status StorageManager::sync(const URI& uri) {
   return vfs_->sync(uri);
 }
 
+Status StorageManager::sync_batch(const std::vector<URI>& uris) {
+  return vfs_->sync_batch(uris, thread_pool_);
+}
+
+ThreadPool* StorageManager::thread_pool() const {
+  return thread_pool_;
+}
+
+Status StorageManager::truncate_file(const URI& uri, uint64_t size) const {
+  return vfs_->truncate_file(uri, size);
+}
+
+Status StorageManager::unmap_file(void* data, uint64_t size) const {
+  return vfs_->unmap_file(data, size);
+}
+
 Status StorageManager::write_to_file(const URI& uri, Buffer* buffer) const {
   return vfs_->write_to_file(uri, buffer->data(), buffer->size());
 }
 
+Status StorageManager::write_to_file_direct(
+    const URI& uri,
+    uint64_t offset,
+    const void* buffer,
+    uint64_t buffer_size) const {
+  return vfs_->write_to_file_direct(uri, offset, buffer, buffer_size);
+}
+
 /* ****************************** */
 /*         PRIVATE METHODS        */
 /* ****************************** */
@@ -644,12 +766,11 @@ Status StorageManager::array_close(
   for (auto& metadata : fragment_metadata)
     open_array->fragment_metadata_rm(metadata->fragment_uri());
 
-  // Potentially remove open array entry
+  // Potentially cache the open array entry, within the cache budget
   if (open_array->cnt() == 0) {
-    // TODO: we may want to leave this to a cache manager
     open_array->mtx_unlock();
-    delete open_array;
-    open_arrays_.erase(it);
+    closed_arrays_.push_back(array_uri.to_string());
+    metadata_cache_evict(config_->metadata_cache_size());
   } else {
     // Unlock the mutex of the array
     open_array->mtx_unlock();
@@ -748,32 +869,6 @@ void StorageManager::async_process_query(Query* query) {
 >>>>>>> upstream/dev
 }
 
-void StorageManager::async_process_queries(int i) {
-  while (!async_done_) {
-    std::unique_lock<std::mutex> lock(async_mtx_[i]);
-    async_cv_[i].wait(
-        lock, [this, i] { return !async_queue_[i].empty() || async_done_; });
-    if (async_done_)
-      break;
-    auto query = async_queue_[i].front();
-    async_queue_[i].pop();
-    lock.unlock();
-    async_process_query(query);
-  }
-}
-
-void StorageManager::async_start(StorageManager* storage_manager, int i) {
-  storage_manager->async_process_queries(i);
-}
-
-void StorageManager::async_stop() {
-  async_done_ = true;
-  async_cv_[0].notify_one();
-  async_cv_[1].notify_one();
-  async_thread_[0]->join();
-  async_thread_[1]->join();
-}
-
 <<<<<<< HEAD
   // TODO: abstract framgent IO
   // Make old fragments invisible to new reads
@@ -787,19 +882,17 @@ void StorageManager::async_stop() {
     RETURN_NOT_OK(vfs::delete_file(old_fragment_filename));
 =======
 Status StorageManager::get_fragment_uris(
-    const URI& array_uri,
-    const void* subarray,
-    std::vector<URI>* fragment_uris) const {
+    const OpenArray* open_array, std::vector<URI>* fragment_uris) const {
   // Get all uris in the array directory
   std::vector<URI> uris;
-  RETURN_NOT_OK(vfs_->ls(array_uri, &uris));
+  RETURN_NOT_OK(vfs_->ls(open_array->array_uri(), &uris));
 
   // Get only the fragment uris
   for (auto& uri : uris) {
-    // TODO: check here if the fragment overlaps subarray
     if (utils::starts_with(uri.last_path_part(), "."))
       continue;
-    if (vfs_->is_file(uri.join_path(constants::fragment_metadata_filename)))
+    if (open_array->fragment_metadata_exists(uri) ||
+        vfs_->is_file(uri.join_path(constants::fragment_metadata_filename)))
       fragment_uris->push_back(uri);
 >>>>>>> upstream/dev
   }
@@ -807,6 +900,124 @@ Status StorageManager::get_fragment_uris(
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+// basic section (see FragmentMetadata::serialize)
+// section_offset#0 (uint64_t) ... section_offset#<section_num-1> (uint64_t)
+// basic_size (uint64_t)
+// section_num (uint64_t)
+// version (uint32_t)
+// magic (uint64_t)
+Status StorageManager::load_fragment_metadata_footer(
+    FragmentMetadata* metadata,
+    bool* has_footer,
+    std::vector<uint64_t>* section_offsets,
+    Buffer* basic) const {
+  URI fragment_metadata_uri = metadata->fragment_uri().join_path(
+      std::string(constants::fragment_metadata_filename));
+  uint64_t trailer_size = 3 * sizeof(uint64_t) + sizeof(uint32_t);
+  *has_footer = false;
+
+  uint64_t file_size;
+  RETURN_NOT_OK(vfs_->file_size(fragment_metadata_uri, &file_size));
+  if (file_size < trailer_size)
+    return Status::Ok();
+
+  // Read the fixed-size end of the footer
+  uint64_t basic_size;
+  uint64_t section_num;
+  uint32_t version;
+  uint64_t magic;
+  auto buff = new Buffer();
+  RETURN_NOT_OK_ELSE(
+      read_from_file(
+          fragment_metadata_uri, file_size - trailer_size, buff, trailer_size),
+      delete buff);
+  buff->read(&basic_size, sizeof(uint64_t));
+  buff->read(&section_num, sizeof(uint64_t));
+  buff->read(&version, sizeof(uint32_t));
+  buff->read(&magic, sizeof(uint64_t));
+  delete buff;
+  if (magic != constants::fragment_metadata_magic)
+    return Status::Ok();
+
+  uint64_t offsets_size = section_num * sizeof(uint64_t);
+  if (version != constants::fragment_metadata_version ||
+      section_num != metadata->section_num() ||
+      file_size < trailer_size + offsets_size + basic_size)
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot load fragment metadata; Unsupported or corrupt footer"));
+
+  // Read the basic section and the section offsets
+  RETURN_NOT_OK(read_from_file(
+      fragment_metadata_uri,
+      file_size - trailer_size - offsets_size - basic_size,
+      basic,
+      basic_size + offsets_size));
+  section_offsets->resize(section_num);
+  std::memcpy(
+      &(*section_offsets)[0],
+      (char*)basic->data() + basic_size,
+      offsets_size);
+  basic->set_size(basic_size);
+  *has_footer = true;
+
+  return Status::Ok();
+}
+
+void StorageManager::metadata_cache_evict(uint64_t budget) {
+  uint64_t size = 0;
+  for (auto& array_uri : closed_arrays_)
+    size += open_arrays_[array_uri]->memory_size();
+
+  while (size > budget) {
+    auto it = open_arrays_.find(closed_arrays_.front());
+    size -= it->second->memory_size();
+    delete it->second;
+    open_arrays_.erase(it);
+    closed_arrays_.pop_front();
+  }
+}
+
+bool StorageManager::metadata_cache_is_valid(
+    const URI& array_uri, const OpenArray* open_array) const {
+  uint64_t file_size;
+  URI array_metadata_uri =
+      array_uri.join_path(constants::array_metadata_filename);
+  return vfs_->file_size(array_metadata_uri, &file_size).ok() &&
+         file_size == open_array->array_metadata_file_size();
+}
+
+void StorageManager::metadata_cache_invalidate(const URI& uri) {
+  std::lock_guard<std::mutex> lock(open_array_mtx_);
+  std::string uri_str = uri.to_string();
+  for (auto it = open_arrays_.begin(); it != open_arrays_.end();) {
+    const std::string& array_str = it->first;
+    bool in_uri = array_str == uri_str ||
+                  utils::starts_with(array_str, uri_str + "/");
+    bool in_array = utils::starts_with(uri_str, array_str + "/");
+    if (!in_uri && !in_array) {
+      ++it;
+      continue;
+    }
+
+    // Delete the entry of a closed array altogether
+    auto closed_it =
+        std::find(closed_arrays_.begin(), closed_arrays_.end(), array_str);
+    if (in_uri && closed_it != closed_arrays_.end()) {
+      closed_arrays_.erase(closed_it);
+      delete it->second;
+      it = open_arrays_.erase(it);
+      continue;
+    }
+
+    // Otherwise, evict the affected fragment metadata
+    it->second->mtx_lock();
+    it->second->fragment_metadata_evict(uri);
+    it->second->mtx_unlock();
+    ++it;
+  }
+}
+
 Status StorageManager::open_array_get_entry(
     const URI& array_uri, OpenArray** open_array) {
   // Find the open array entry
@@ -817,6 +1028,21 @@ Status StorageManager::open_array_get_entry(
     open_arrays_[array_uri.to_string()] = *open_array;
   } else {
     *open_array = it->second;
+    auto closed_it = std::find(
+        closed_arrays_.begin(), closed_arrays_.end(), array_uri.to_string());
+    if (closed_it != closed_arrays_.end()) {
+      closed_arrays_.erase(closed_it);
+
+      // Replace a stale entry of a closed array with a new one, dropping
+      // any cached data of the old array files as well
+      if (!metadata_cache_is_valid(array_uri, *open_array)) {
+        vfs_->invalidate(array_uri);
+        global_tile_cache().invalidate(array_uri);
+        delete *open_array;
+        *open_array = new OpenArray();
+        it->second = *open_array;
+      }
+    }
   }
 
   return Status::Ok();
@@ -828,10 +1054,14 @@ Status StorageManager::open_array_load_metadata(
   if (open_array->array_metadata() != nullptr)
     return Status::Ok();
 
+  // The file size is recorded to validate the entry when it is cached
+  uint64_t file_size;
+  RETURN_NOT_OK(vfs_->file_size(
+      array_uri.join_path(constants::array_metadata_filename), &file_size));
   auto array_metadata = new ArrayMetadata(array_uri);
   RETURN_NOT_OK_ELSE(
       load(array_uri.to_string(), array_metadata), delete array_metadata);
-  open_array->set_array_metadata(array_metadata);
+  open_array->set_array_metadata(array_metadata, file_size);
 
   return Status::Ok();
 }
@@ -842,29 +1072,56 @@ Status StorageManager::open_array_load_fragment_metadata(
     std::vector<FragmentMetadata*>* fragment_metadata) {
   // Get all the fragment uris, sorted by timestamp
   std::vector<URI> fragment_uris;
-  const URI& array_uri = open_array->array_uri();
-  RETURN_NOT_OK(get_fragment_uris(array_uri, subarray, &fragment_uris));
+  RETURN_NOT_OK(get_fragment_uris(open_array, &fragment_uris));
   sort_fragment_uris(&fragment_uris);
 
+  // Drop the cached metadata of the fragments that no longer exist
+  open_array->fragment_metadata_retain(fragment_uris);
+
   if (fragment_uris.empty())
     return Status::Ok();
 
-  // Load the metadata for each fragment
-  for (auto& uri : fragment_uris) {
-    // Find metadata entry in open array
-    auto metadata = open_array->fragment_metadata_get(uri);
-    // If not found, load metadata and store in open array
-    if (metadata == nullptr) {
-      URI coords_uri = uri.join_path(
-          std::string("/") + constants::coords + constants::file_suffix);
-      bool dense = !vfs_->is_file(coords_uri);
-      metadata = new FragmentMetadata(open_array->array_metadata(), dense, uri);
-      RETURN_NOT_OK_ELSE(load(metadata), delete metadata);
+  // Find the fragments whose metadata is not in the open array
+  uint64_t fragment_num = fragment_uris.size();
+  std::vector<FragmentMetadata*> loaded(fragment_num, nullptr);
+  std::vector<uint64_t> to_load;
+  for (uint64_t i = 0; i < fragment_num; ++i) {
+    if (!open_array->fragment_metadata_exists(fragment_uris[i]))
+      to_load.push_back(i);
+  }
+
+  // Load the missing metadata in parallel
+  Status st = thread_pool_->parallel_for(to_load.size(), [&](uint64_t i) {
+    const URI& uri = fragment_uris[to_load[i]];
+    URI coords_uri = uri.join_path(
+        std::string("/") + constants::coords + constants::file_suffix);
+    bool dense = !vfs_->is_file(coords_uri);
+    auto metadata =
+        new FragmentMetadata(open_array->array_metadata(), dense, uri);
+    loaded[to_load[i]] = metadata;
+    return load(metadata);
+  });
+  if (!st.ok()) {
+    for (auto metadata : loaded)
+      delete metadata;
+    return st;
+  }
+
+  // Collect the metadata in timestamp order, storing the loaded metadata in
+  // the open array
+  for (uint64_t i = 0; i < fragment_num; ++i) {
+    const URI& uri = fragment_uris[i];
+    auto metadata = loaded[i];
+    if (metadata == nullptr)
+      metadata = open_array->fragment_metadata_get(uri);
+    else
       open_array->fragment_metadata_add(metadata);
-    }
 
-    // Add to list
-    fragment_metadata->push_back(metadata);
+    // Add to list only if the fragment overlaps the subarray
+    if (metadata->overlaps(subarray))
+      fragment_metadata->push_back(metadata);
+    else
+      open_array->fragment_metadata_rm(uri);
   }
 
   return Status::Ok();
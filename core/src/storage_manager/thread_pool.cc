@@ -0,0 +1,204 @@
+/**
+ * @file   thread_pool.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class ThreadPool.
+ */
+
+#include "thread_pool.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+ThreadPool::ThreadPool() {
+  next_task_id_ = 0;
+  thread_num_ = 0;
+}
+
+ThreadPool::~ThreadPool() {
+  // Terminate all threads
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    thread_num_ = 0;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_)
+    thread.join();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status ThreadPool::enqueue(std::function<void()>&& task, uint64_t* task_id) {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (thread_num_ == 0)
+      return LOG_STATUS(
+          Status::Error("Cannot enqueue task; Thread pool has no threads"));
+    if (task_id != nullptr)
+      *task_id = next_task_id_;
+    tasks_.emplace_back(next_task_id_++, std::move(task));
+  }
+  cv_.notify_one();
+
+  return Status::Ok();
+}
+
+bool ThreadPool::execute(uint64_t task_id) {
+  std::function<void()> task;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = std::find_if(
+        tasks_.begin(),
+        tasks_.end(),
+        [task_id](const std::pair<uint64_t, std::function<void()>>& t) {
+          return t.first == task_id;
+        });
+    if (it == tasks_.end())
+      return false;
+    task = std::move(it->second);
+    tasks_.erase(it);
+  }
+  task();
+
+  return true;
+}
+
+Status ThreadPool::parallel_for(
+    uint64_t task_num,
+    const std::function<Status(uint64_t)>& func,
+    unsigned int max_thread_num) {
+  // Trivial case
+  if (task_num == 0)
+    return Status::Ok();
+
+  // The loop state is shared with the helper tasks, which may start only
+  // after the loop is over
+  struct Loop {
+    const std::function<Status(uint64_t)>* func_;
+    std::atomic<uint64_t> next_;
+    uint64_t done_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    Status st_;
+    uint64_t task_num_;
+  };
+  auto loop = std::make_shared<Loop>();
+  loop->func_ = &func;
+  loop->next_ = 0;
+  loop->done_ = 0;
+  loop->task_num_ = task_num;
+  auto run = [loop]() {
+    for (uint64_t i = loop->next_++; i < loop->task_num_; i = loop->next_++) {
+      Status st = (*loop->func_)(i);
+      std::lock_guard<std::mutex> lock(loop->mtx_);
+      if (!st.ok() && loop->st_.ok())
+        loop->st_ = st;
+      if (++loop->done_ == loop->task_num_)
+        loop->cv_.notify_all();
+    }
+  };
+
+  // Queue the helper tasks
+  uint64_t helper_num = std::min<uint64_t>(
+      std::min<uint64_t>(task_num, max_thread_num), thread_num() + 1);
+  if (helper_num > 0)
+    --helper_num;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (uint64_t i = 0; i < helper_num; ++i)
+      tasks_.emplace_back(next_task_id_++, run);
+  }
+  for (uint64_t i = 0; i < helper_num; ++i)
+    cv_.notify_one();
+
+  // Take part in the loop and wait for the indices taken by the helpers
+  run();
+  std::unique_lock<std::mutex> lock(loop->mtx_);
+  loop->cv_.wait(lock, [&loop] { return loop->done_ == loop->task_num_; });
+
+  return loop->st_;
+}
+
+Status ThreadPool::set_thread_num(unsigned int thread_num) {
+  std::lock_guard<std::mutex> resize_lock(resize_mtx_);
+  if (thread_num == 0)
+    thread_num = std::max(1u, std::thread::hardware_concurrency());
+
+  // Spawn new threads
+  std::unique_lock<std::mutex> lock(mtx_);
+  auto old_thread_num = thread_num_;
+  thread_num_ = thread_num;
+  for (unsigned int i = old_thread_num; i < thread_num; ++i)
+    threads_.emplace_back(&ThreadPool::worker, this, i);
+  lock.unlock();
+
+  // Terminate the excess threads
+  if (thread_num < old_thread_num) {
+    cv_.notify_all();
+    for (unsigned int i = thread_num; i < old_thread_num; ++i)
+      threads_[i].join();
+    threads_.resize(thread_num);
+  }
+
+  return Status::Ok();
+}
+
+unsigned int ThreadPool::thread_num() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return thread_num_;
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+void ThreadPool::worker(unsigned int i) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  for (;;) {
+    cv_.wait(lock, [this, i] { return i >= thread_num_ || !tasks_.empty(); });
+    if (i >= thread_num_)
+      return;
+    auto task = std::move(tasks_.front().second);
+    tasks_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+}  // namespace tiledb
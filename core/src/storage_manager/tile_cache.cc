@@ -0,0 +1,250 @@
+/**
+ * @file   tile_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class TileCache.
+ */
+
+#include "tile_cache.h"
+#include "constants.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+TileCache::TileCache() {
+  budget_ = constants::tile_cache_size;
+  for (unsigned int i = 0; i < constants::tile_cache_shard_num; ++i) {
+    auto shard = new Shard();
+    shard->size_ = 0;
+    shards_.push_back(shard);
+  }
+}
+
+TileCache::~TileCache() {
+  for (auto shard : shards_) {
+    for (auto& entry : shard->entries_) {
+      std::free(entry.second->data_);
+      delete entry.second;
+    }
+    delete shard;
+  }
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+uint64_t TileCache::budget() const {
+  return budget_;
+}
+
+Status TileCache::insert(
+    const std::string& key, const void* data, uint64_t size) {
+  if (size == 0 || size > shard_budget())
+    return Status::Ok();
+
+  unsigned int shard_i = std::hash<std::string>()(key) % shards_.size();
+  auto shard = shards_[shard_i];
+  std::lock_guard<std::mutex> lock(shard->mtx_);
+
+  // The tile may have been cached by a concurrent reader
+  if (shard->entries_.find(key) != shard->entries_.end())
+    return Status::Ok();
+
+  // Make room, giving up if the pinned entries do not leave enough
+  evict(shard, size);
+  if (shard->size_ + size > shard_budget())
+    return Status::Ok();
+
+  auto entry = new Entry();
+  entry->data_ = std::malloc(size);
+  if (entry->data_ == nullptr) {
+    delete entry;
+    return LOG_STATUS(Status::MemError(
+        "Cannot cache tile; Memory allocation failed"));
+  }
+  std::memcpy(entry->data_, data, size);
+  entry->key_ = key;
+  entry->pin_cnt_ = 0;
+  entry->removed_ = false;
+  entry->shard_ = shard_i;
+  entry->size_ = size;
+  shard->lru_.push_front(entry);
+  entry->lru_it_ = shard->lru_.begin();
+  shard->entries_[key] = entry;
+  shard->size_ += size;
+
+  return Status::Ok();
+}
+
+void TileCache::invalidate(const URI& uri) {
+  std::string prefix = uri.to_string() + "/";
+  for (auto shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mtx_);
+    for (auto it = shard->entries_.begin(); it != shard->entries_.end();) {
+      auto entry = (it++)->second;
+      if (entry->key_.compare(0, prefix.size(), prefix) == 0)
+        remove(shard, entry);
+    }
+  }
+}
+
+std::string TileCache::key(
+    const URI& fragment_uri,
+    unsigned int attribute_id,
+    uint64_t tile_i,
+    bool var) {
+  return fragment_uri.to_string() + "/" + std::to_string(attribute_id) +
+         ((var) ? "_var/" : "/") + std::to_string(tile_i);
+}
+
+TileCache::Entry* TileCache::pin(const std::string& key) {
+  if (budget_ == 0)
+    return nullptr;
+
+  auto shard = shards_[std::hash<std::string>()(key) % shards_.size()];
+  std::lock_guard<std::mutex> lock(shard->mtx_);
+  auto it = shard->entries_.find(key);
+  if (it == shard->entries_.end())
+    return nullptr;
+
+  // Mark the entry as the most recently used
+  auto entry = it->second;
+  shard->lru_.splice(shard->lru_.begin(), shard->lru_, entry->lru_it_);
+  ++entry->pin_cnt_;
+
+  return entry;
+}
+
+void TileCache::release_budget(const void* owner) {
+  std::lock_guard<std::mutex> lock(budget_requests_mtx_);
+  if (budget_requests_.erase(owner) > 0)
+    apply_budget_requests();
+}
+
+void TileCache::request_budget(const void* owner, uint64_t budget) {
+  std::lock_guard<std::mutex> lock(budget_requests_mtx_);
+  budget_requests_[owner] = budget;
+  apply_budget_requests();
+}
+
+void TileCache::set_budget(uint64_t budget) {
+  budget_ = budget;
+  for (auto shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mtx_);
+    evict(shard, 0);
+  }
+}
+
+uint64_t TileCache::size() const {
+  uint64_t size = 0;
+  for (auto shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mtx_);
+    size += shard->size_;
+  }
+
+  return size;
+}
+
+void TileCache::unpin(Entry* entry) {
+  auto shard = shards_[entry->shard_];
+  std::lock_guard<std::mutex> lock(shard->mtx_);
+  assert(entry->pin_cnt_ > 0);
+  --entry->pin_cnt_;
+
+  // Delete an entry removed while pinned, once no reader uses it
+  if (entry->removed_ && entry->pin_cnt_ == 0) {
+    std::free(entry->data_);
+    delete entry;
+  }
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+void TileCache::apply_budget_requests() {
+  uint64_t budget = 0;
+  for (auto& request : budget_requests_)
+    budget = std::max(budget, request.second);
+  if (budget_requests_.empty())
+    budget = constants::tile_cache_size;
+  set_budget(budget);
+}
+
+void TileCache::evict(Shard* shard, uint64_t size) {
+  uint64_t budget = shard_budget();
+  auto it = shard->lru_.end();
+  while (it != shard->lru_.begin() && shard->size_ + size > budget) {
+    auto entry = *(--it);
+    if (entry->pin_cnt_ == 0) {
+      auto next = std::next(it);
+      remove(shard, entry);
+      it = next;
+    }
+  }
+}
+
+void TileCache::remove(Shard* shard, Entry* entry) {
+  shard->entries_.erase(entry->key_);
+  shard->lru_.erase(entry->lru_it_);
+  shard->size_ -= entry->size_;
+
+  if (entry->pin_cnt_ == 0) {
+    std::free(entry->data_);
+    delete entry;
+  } else {
+    entry->removed_ = true;
+  }
+}
+
+uint64_t TileCache::shard_budget() const {
+  return budget_ / shards_.size();
+}
+
+/* ****************************** */
+/*             GLOBAL             */
+/* ****************************** */
+
+TileCache& global_tile_cache() {
+  static TileCache tile_cache;
+  return tile_cache;
+}
+
+}  // namespace tiledb
@@ -42,6 +42,7 @@ namespace tiledb {
 /* ****************************** */
 
 Tile::Tile(unsigned int dim_num) {
+  aliased_ = false;
   buffer_ = nullptr;
   cell_size_ = 0;
   compressor_ = Compressor::NO_COMPRESSION;
@@ -59,7 +60,8 @@ Tile::Tile(
     unsigned int dim_num,
     Buffer* buff,
     bool owns_buff)
-    : buffer_(buff)
+    : aliased_(false)
+    , buffer_(buff)
     , cell_size_(cell_size)
     , compressor_(compressor)
     , compression_level_(compression_level)
@@ -75,7 +77,8 @@ Tile::Tile(
     uint64_t tile_size,
     uint64_t cell_size,
     unsigned int dim_num)
-    : cell_size_(cell_size)
+    : aliased_(false)
+    , cell_size_(cell_size)
     , compressor_(compressor)
     , compression_level_(compression_level)
     , dim_num_(dim_num)
@@ -90,7 +93,8 @@ Tile::Tile(
     Compressor compressor,
     uint64_t cell_size,
     unsigned int dim_num)
-    : cell_size_(cell_size)
+    : aliased_(false)
+    , cell_size_(cell_size)
     , compressor_(compressor)
     , dim_num_(dim_num)
     , type_(type) {
@@ -112,6 +116,18 @@ void Tile::advance_offset(uint64_t nbytes) {
   buffer_->advance_offset(nbytes);
 }
 
+void Tile::alias(void* data, uint64_t size) {
+  if (owns_buff_)
+    delete buffer_;
+  buffer_ = new Buffer(data, size, false);
+  owns_buff_ = true;
+  aliased_ = true;
+}
+
+bool Tile::aliased() const {
+  return aliased_;
+}
+
 Buffer* Tile::buffer() const {
   return buffer_;
 }
@@ -136,6 +152,21 @@ void* Tile::data() const {
   return buffer_->data();
 }
 
+Status Tile::detach() {
+  if (!aliased_)
+    return Status::Ok();
+
+  auto buff = new Buffer();
+  RETURN_NOT_OK_ELSE(
+      buff->write(buffer_->data(), buffer_->size()), delete buff);
+  buff->set_offset(buffer_->offset());
+  delete buffer_;
+  buffer_ = buff;
+  aliased_ = false;
+
+  return Status::Ok();
+}
+
 unsigned int Tile::dim_num() const {
   return dim_num_;
 }
@@ -144,6 +175,10 @@ bool Tile::empty() const {
   return buffer_->size() == 0;
 }
 
+const std::vector<Filter>& Tile::filters() const {
+  return filters_;
+}
+
 bool Tile::full() const {
   return (buffer_->size() != 0) &&
          (buffer_->offset() == buffer_->alloced_size());
@@ -154,6 +189,13 @@ uint64_t Tile::offset() const {
 }
 
 Status Tile::realloc(uint64_t nbytes) {
+  // Stop aliasing external data
+  if (aliased_) {
+    delete buffer_;
+    buffer_ = new Buffer();
+    aliased_ = false;
+  }
+
   return buffer_->realloc(nbytes);
 }
 
@@ -171,6 +213,10 @@ void Tile::reset_size() {
   buffer_->reset_size();
 }
 
+void Tile::set_filters(const std::vector<Filter>& filters) {
+  filters_ = filters;
+}
+
 void Tile::set_offset(uint64_t offset) {
   buffer_->set_offset(offset);
 }
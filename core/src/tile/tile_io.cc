@@ -34,12 +34,18 @@
 #include "blosc_compressor.h"
 #include "bzip_compressor.h"
 #include "dd_compressor.h"
+#include "filter_pipeline.h"
 #include "gzip_compressor.h"
 #include "logger.h"
 #include "lz4_compressor.h"
 #include "rle_compressor.h"
 #include "zstd_compressor.h"
 
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 /* ****************************** */
@@ -64,21 +70,74 @@ TileIO::TileIO(StorageManager* storage_manager, const URI& uri)
     : uri_(uri)
     , storage_manager_(storage_manager) {
   buffer_ = new Buffer();
+  coalesced_buffer_ = new Buffer();
+  file_size_ = UINT64_MAX;
+  mapped_data_ = nullptr;
+  staging_buffer_ = nullptr;
+  staging_offset_ = 0;
+  staging_size_ = 0;
+  write_buffer_ = nullptr;
+  write_buffer_size_ = constants::tile_write_buffer_size;
 >>>>>>> upstream/dev
 }
 
 TileIO::~TileIO() {
   delete buffer_;
+  delete coalesced_buffer_;
+  std::free(staging_buffer_);
+  delete write_buffer_;
 }
 
 /* ****************************** */
 /*               API              */
 /* ****************************** */
 
+Status TileIO::compress(Tile* tile, Buffer* buffer) const {
+  // Reset the tile and buffer offset
+  tile->reset_offset();
+  buffer->reset_size();
+  buffer->reset_offset();
+
+  // Compress tile
+  if (tile->compressor() != Compressor::NO_COMPRESSION)
+    RETURN_NOT_OK(compress_tile(tile, buffer));
+
+  return Status::Ok();
+}
+
 Status TileIO::file_size(uint64_t* size) const {
   return storage_manager_->file_size(uri_, size);
 }
 
+Status TileIO::flush() {
+  // Append the buffered tiles
+  if (write_buffer_ != nullptr && write_buffer_->size() > 0) {
+    RETURN_NOT_OK(storage_manager_->write_to_file(uri_, write_buffer_));
+    write_buffer_->reset_size();
+    write_buffer_->reset_offset();
+  }
+
+  if (staging_size_ == 0)
+    return Status::Ok();
+
+  // Pad the staged data to the alignment and truncate the padding afterwards
+  uint64_t alignment = constants::direct_io_alignment;
+  uint64_t padded_size =
+      (staging_size_ + alignment - 1) / alignment * alignment;
+  std::memset(
+      static_cast<char*>(staging_buffer_) + staging_size_,
+      0,
+      padded_size - staging_size_);
+  RETURN_NOT_OK(storage_manager_->write_to_file_direct(
+      uri_, staging_offset_, staging_buffer_, padded_size));
+  RETURN_NOT_OK(
+      storage_manager_->truncate_file(uri_, staging_offset_ + staging_size_));
+  staging_offset_ += staging_size_;
+  staging_size_ = 0;
+
+  return Status::Ok();
+}
+
 Status TileIO::read(
     Tile* tile,
     uint64_t file_offset,
@@ -98,12 +157,99 @@ Status TileIO::read(
   tile->reset_size();
   buffer_->reset_offset();
   RETURN_NOT_OK(tile->realloc(tile_size));
-  RETURN_NOT_OK(decompress_tile(tile));
+  RETURN_NOT_OK(decompress_tile(buffer_, tile));
   tile->reset_offset();
 
   return Status::Ok();
 }
 
+Status TileIO::read(
+    Tile* tile,
+    uint64_t tile_i,
+    const std::vector<uint64_t>& tile_offsets,
+    const std::vector<uint64_t>& tile_plan,
+    uint64_t tile_size) {
+  // For easy reference
+  uint64_t tile_num = tile_offsets.size();
+  if (file_size_ == UINT64_MAX)
+    RETURN_NOT_OK(file_size(&file_size_));
+  uint64_t tile_start = tile_offsets[tile_i];
+  uint64_t tile_end =
+      (tile_i == tile_num - 1) ? file_size_ : tile_offsets[tile_i + 1];
+
+  // The whole file is mapped
+  if (mapped_data_ != nullptr)
+    return read_from_memory(
+        tile,
+        (char*)mapped_data_ + tile_start,
+        tile_end - tile_start,
+        tile_size,
+        true);
+
+  // Look for the tile in the data fetched by the last coalesced read
+  const Segment* segment = nullptr;
+  for (auto& s : coalesced_segments_) {
+    if (tile_start >= s.file_offset_ && tile_end <= s.file_offset_ + s.size_) {
+      segment = &s;
+      break;
+    }
+  }
+
+  // On a miss, fetch the tile along with the planned tiles that follow it
+  if (segment == nullptr) {
+    uint64_t gap_size =
+        (storage_manager_ != nullptr) ?
+            storage_manager_->config()->tile_coalesce_gap_size() :
+            constants::tile_coalesce_gap_size;
+    coalesced_segments_.clear();
+    Segment cur = {tile_start, tile_end - tile_start, 0};
+    uint64_t total_size = cur.size_;
+    auto it = std::upper_bound(tile_plan.begin(), tile_plan.end(), tile_i);
+    for (; it != tile_plan.end(); ++it) {
+      uint64_t next_start = tile_offsets[*it];
+      uint64_t next_end =
+          (*it == tile_num - 1) ? file_size_ : tile_offsets[*it + 1];
+      uint64_t cur_end = cur.file_offset_ + cur.size_;
+      bool nearby = next_start - cur_end <= gap_size;
+      uint64_t added = next_end - (nearby ? cur_end : next_start);
+      if (total_size + added > constants::tile_coalesce_max_size)
+        break;
+      if (nearby) {
+        cur.size_ = next_end - cur.file_offset_;
+      } else {
+        if (coalesced_segments_.size() + 1 >=
+            constants::tile_coalesce_region_num)
+          break;
+        coalesced_segments_.push_back(cur);
+        cur = {next_start, next_end - next_start, total_size};
+      }
+      total_size += added;
+    }
+    coalesced_segments_.push_back(cur);
+
+    // Read all the segments at once
+    std::vector<VFS::ReadRegion> regions;
+    RETURN_NOT_OK_ELSE(
+        coalesced_buffer_->realloc(total_size), coalesced_segments_.clear());
+    for (auto& s : coalesced_segments_)
+      regions.push_back(
+          {s.file_offset_, s.size_, coalesced_buffer_->data(s.buffer_offset_)});
+    RETURN_NOT_OK_ELSE(
+        storage_manager_->read_batch(uri_, regions),
+        coalesced_segments_.clear());
+    coalesced_buffer_->set_size(total_size);
+    segment = &coalesced_segments_[0];
+  }
+
+  return read_from_memory(
+      tile,
+      coalesced_buffer_->data(
+          segment->buffer_offset_ + tile_start - segment->file_offset_),
+      tile_end - tile_start,
+      tile_size,
+      false);
+}
+
 Status TileIO::read_generic(Tile** tile, uint64_t file_offset) {
   uint64_t tile_size;
   uint64_t compressed_size;
@@ -159,48 +305,79 @@ Status TileIO::read_generic_tile_header(
   return Status::Ok();
 }
 
-Status TileIO::write(Tile* tile, uint64_t* bytes_written) {
-  // Reset the tile and buffer offset
-  tile->reset_offset();
-  buffer_->reset_size();
-  buffer_->reset_offset();
+Status TileIO::set_direct_write() {
+  if (staging_buffer_ != nullptr || !uri_.is_posix())
+    return Status::Ok();
+
+  if (posix_memalign(
+          &staging_buffer_,
+          constants::direct_io_alignment,
+          constants::direct_io_buffer_size) != 0) {
+    staging_buffer_ = nullptr;
+    return LOG_STATUS(Status::TileIOError(
+        "Cannot enable direct I/O; Staging buffer allocation failed"));
+  }
 
-  // Compress tile
-  Compressor compressor = tile->compressor();
-  if (compressor != Compressor::NO_COMPRESSION)
-    RETURN_NOT_OK(compress_tile(tile));
+  return Status::Ok();
+}
+
+void TileIO::set_mapped_file(void* data, uint64_t size) {
+  mapped_data_ = data;
+  file_size_ = size;
+}
+
+void TileIO::set_write_buffer_size(uint64_t size) {
+  write_buffer_size_ = size;
+}
 
+Status TileIO::write(Tile* tile, uint64_t* bytes_written) {
+  RETURN_NOT_OK(compress(tile, buffer_));
+  return write_compressed(tile, buffer_, bytes_written);
+}
+
+Status TileIO::write_compressed(
+    Tile* tile, Buffer* buffer, uint64_t* bytes_written) {
   // Prepare to write
-  auto buffer =
-      (compressor == Compressor::NO_COMPRESSION) ? tile->buffer() : buffer_;
+  if (tile->compressor() == Compressor::NO_COMPRESSION)
+    buffer = tile->buffer();
   *bytes_written = buffer->size();
 
-  RETURN_NOT_OK(storage_manager_->write_to_file(uri_, buffer));
+  if (staging_buffer_ != nullptr)
+    return stage(buffer->data(), buffer->size());
+
+  // Large tiles are appended directly, after the buffered ones
+  if (buffer->size() >= write_buffer_size_) {
+    RETURN_NOT_OK(flush());
+    return storage_manager_->write_to_file(uri_, buffer);
+  }
+
+  // Buffer the tile, appending the buffer to the file once it fills up
+  if (write_buffer_ == nullptr)
+    write_buffer_ = new Buffer();
+  if (write_buffer_->size() + buffer->size() > write_buffer_size_)
+    RETURN_NOT_OK(flush());
+  RETURN_NOT_OK(write_buffer_->write(buffer->data(), buffer->size()));
 
   return Status::Ok();
 }
 
-Status TileIO::write_generic(Tile* tile) {
-  // Reset the tile and buffer offset
-  tile->reset_offset();
-  buffer_->reset_size();
-  buffer_->reset_offset();
-
+Status TileIO::write_generic(Tile* tile, uint64_t* bytes_written) {
   // Compress tile
-  Compressor compressor = tile->compressor();
-  if (compressor != Compressor::NO_COMPRESSION)
-    RETURN_NOT_OK(compress_tile(tile));
-
-  auto buffer =
-      (compressor == Compressor::NO_COMPRESSION) ? tile->buffer() : buffer_;
+  RETURN_NOT_OK(compress(tile, buffer_));
+  auto buffer = (tile->compressor() == Compressor::NO_COMPRESSION) ?
+                    tile->buffer() :
+                    buffer_;
 
-  RETURN_NOT_OK(write_generic_tile_header(tile, buffer->size()));
+  uint64_t header_size;
+  RETURN_NOT_OK(write_generic_tile_header(tile, buffer->size(), &header_size));
   RETURN_NOT_OK(storage_manager_->write_to_file(uri_, buffer));
+  *bytes_written = header_size + buffer->size();
 
   return Status::Ok();
 }
 
-Status TileIO::write_generic_tile_header(Tile* tile, uint64_t compressed_size) {
+Status TileIO::write_generic_tile_header(
+    Tile* tile, uint64_t compressed_size, uint64_t* header_size) {
   // Initializations
   uint64_t tile_size = tile->size();
   auto datatype = (char)tile->type();
@@ -219,6 +396,7 @@ Status TileIO::write_generic_tile_header(Tile* tile, uint64_t compressed_size) {
   RETURN_NOT_OK_ELSE(buff->write(&compression_level, sizeof(int)), delete buff);
 
   // Write to file
+  *header_size = buff->size();
   Status st = storage_manager_->write_to_file(uri_, buff);
 
   delete buff;
@@ -230,10 +408,10 @@ Status TileIO::write_generic_tile_header(Tile* tile, uint64_t compressed_size) {
 /*          PRIVATE METHODS       */
 /* ****************************** */
 
-Status TileIO::compress_tile(Tile* tile) {
+Status TileIO::compress_tile(Tile* tile, Buffer* buffer) const {
   // Simple case - No coordinates
   if (!tile->stores_coords())
-    return compress_one_tile(tile);
+    return compress_one_tile(tile, buffer);
 
   // Split coordinates
   tile->split_coordinates();
@@ -253,7 +431,7 @@ Status TileIO::compress_tile(Tile* tile) {
         dim_num,
         buff,
         false);
-    st = compress_one_tile(dim_tile);
+    st = compress_one_tile(dim_tile, buffer);
     delete buff;
     delete dim_tile;
     RETURN_NOT_OK(st);
@@ -263,13 +441,8 @@ Status TileIO::compress_tile(Tile* tile) {
   return Status::Ok();
 }
 
-Status TileIO::compress_one_tile(Tile* tile) {
+Status TileIO::compress_one_tile(Tile* tile, Buffer* buffer) const {
   // For easy reference
-  auto level = tile->compression_level();
-  auto type_size = datatype_size(tile->type());
-  auto compressor = tile->compressor();
-  auto type = tile->type();
-  auto cell_size = tile->cell_size();
   auto tile_size = tile->size();
 
   // Compute necessary info for chunking
@@ -277,121 +450,149 @@ Status TileIO::compress_one_tile(Tile* tile) {
   RETURN_NOT_OK(
       compute_chunking_info(tile, &chunk_num, &max_chunk_size, &overhead));
 
-  // Properly reallocate buffer
-  RETURN_NOT_OK(buffer_->realloc(buffer_->size() + tile_size + overhead));
+  // Compress the chunks in parallel, each into a separate buffer
+  auto data = static_cast<char*>(tile->cur_data());
+  std::vector<Buffer*> chunk_buffers(chunk_num, nullptr);
+  Status st = for_each_chunk(chunk_num, [&](uint64_t i) {
+    auto chunk_size = MIN(tile_size - i * max_chunk_size, max_chunk_size);
+    chunk_buffers[i] = new Buffer();
+    RETURN_NOT_OK(chunk_buffers[i]->realloc(
+        chunk_size + this->overhead(tile, chunk_size)));
+    ConstBuffer input_buffer(data + i * max_chunk_size, chunk_size);
+    return compress_chunk(tile, &input_buffer, chunk_buffers[i]);
+  });
+
+  // Write the number of chunks, followed by the original size, the
+  // compressed size and the compressed data of each chunk
+  if (st.ok())
+    st = buffer->realloc(buffer->size() + tile_size + overhead);
+  if (st.ok())
+    st = buffer->write(&chunk_num, sizeof(uint64_t));
+  for (uint64_t i = 0; i < chunk_num && st.ok(); ++i) {
+    auto chunk_size = MIN(tile_size - i * max_chunk_size, max_chunk_size);
+    auto compressed_chunk_size = chunk_buffers[i]->size();
+    st = buffer->write(&chunk_size, sizeof(uint64_t));
+    if (st.ok())
+      st = buffer->write(&compressed_chunk_size, sizeof(uint64_t));
+    if (st.ok())
+      st = buffer->write(chunk_buffers[i]->data(), compressed_chunk_size);
+  }
+  if (st.ok())
+    tile->advance_offset(tile_size);
 
-  // Write number of chunks
-  RETURN_NOT_OK(buffer_->write(&chunk_num, sizeof(uint64_t)));
+  // Clean up
+  for (auto chunk_buffer : chunk_buffers)
+    delete chunk_buffer;
 
-  // Compress in chunks
-  Status st;
-  uint64_t compressed_chunk_size = 0;
-  uint64_t buffer_offset;
-  uint64_t left_to_compress = tile_size;
-  for (uint64_t i = 0; i < chunk_num; ++i) {
-    // Write chunk info
-    auto chunk_size = MIN(left_to_compress, max_chunk_size);
+  return st;
+}
 
-    RETURN_NOT_OK(buffer_->write(&chunk_size, sizeof(uint64_t)));
-    buffer_offset = buffer_->offset();  // Will be used later
-    RETURN_NOT_OK(buffer_->write(&compressed_chunk_size, sizeof(uint64_t)));
+Status TileIO::compress_chunk(
+    Tile* tile, ConstBuffer* input_buffer, Buffer* output_buffer) const {
+  // For easy reference
+  auto level = tile->compression_level();
+  auto type_size = datatype_size(tile->type());
+  auto type = tile->type();
+  auto cell_size = tile->cell_size();
 
-    // Create const buffer
-    auto input_buffer = new ConstBuffer(tile->cur_data(), chunk_size);
+  // Run the filters, and compress their output
+  Buffer filtered;
+  if (!tile->filters().empty())
+    RETURN_NOT_OK(FilterPipeline::run_forward(
+        tile->filters(), type, input_buffer, &filtered));
+  ConstBuffer filtered_input(&filtered);
+  if (!tile->filters().empty())
+    input_buffer = &filtered_input;
 
-    // Invoke the proper compressor
-    switch (compressor) {
-      case Compressor::GZIP:
-        st = GZip::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::ZSTD:
-        st = ZStd::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::LZ4:
-        st = LZ4::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::BLOSC:
-        st =
-            Blosc::compress("blosclz", type_size, level, input_buffer, buffer_);
-        break;
+  // Invoke the proper compressor
+  Status st;
+  switch (tile->compressor()) {
+    case Compressor::GZIP:
+      st = GZip::compress(level, input_buffer, output_buffer);
+      break;
+    case Compressor::ZSTD:
+      st = ZStd::compress(level, input_buffer, output_buffer);
+      break;
+    case Compressor::LZ4:
+      st = LZ4::compress(level, input_buffer, output_buffer);
+      break;
+    case Compressor::BLOSC:
+      st = Blosc::compress(
+          "blosclz", type_size, level, input_buffer, output_buffer);
+      break;
 #undef BLOSC_LZ4
-      case Compressor::BLOSC_LZ4:
-        st = Blosc::compress("lz4", type_size, level, input_buffer, buffer_);
-        break;
+    case Compressor::BLOSC_LZ4:
+      st = Blosc::compress(
+          "lz4", type_size, level, input_buffer, output_buffer);
+      break;
 #undef BLOSC_LZ4HC
-      case Compressor::BLOSC_LZ4HC:
-        st = Blosc::compress("lz4hc", type_size, level, input_buffer, buffer_);
-        break;
+    case Compressor::BLOSC_LZ4HC:
+      st = Blosc::compress(
+          "lz4hc", type_size, level, input_buffer, output_buffer);
+      break;
 #undef BLOSC_SNAPPY
-      case Compressor::BLOSC_SNAPPY:
-        st = Blosc::compress("snappy", type_size, level, input_buffer, buffer_);
-        break;
+    case Compressor::BLOSC_SNAPPY:
+      st = Blosc::compress(
+          "snappy", type_size, level, input_buffer, output_buffer);
+      break;
 #undef BLOSC_ZLIB
-      case Compressor::BLOSC_ZLIB:
-        st = Blosc::compress("zlib", type_size, level, input_buffer, buffer_);
-        break;
+    case Compressor::BLOSC_ZLIB:
+      st = Blosc::compress(
+          "zlib", type_size, level, input_buffer, output_buffer);
+      break;
 #undef BLOSC_ZSTD
-      case Compressor::BLOSC_ZSTD:
-        st = Blosc::compress("zstd", type_size, level, input_buffer, buffer_);
-        break;
-      case Compressor::RLE:
-        st = RLE::compress(cell_size, input_buffer, buffer_);
-        break;
-      case Compressor::BZIP2:
-        st = BZip::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::DOUBLE_DELTA:
-        st = DoubleDelta::compress(type, input_buffer, buffer_);
-        break;
-      default:
-        assert(0);
-    }
-
-    delete input_buffer;
-    RETURN_NOT_OK(st);
-
-    // Write compressed chunk size
-    compressed_chunk_size =
-        buffer_->size() - (buffer_offset + sizeof(uint64_t));
-    std::memcpy(
-        buffer_->data(buffer_offset), &compressed_chunk_size, sizeof(uint64_t));
-
-    // Update
-    left_to_compress -= chunk_size;
-    tile->advance_offset(chunk_size);
+    case Compressor::BLOSC_ZSTD:
+      st = Blosc::compress(
+          "zstd", type_size, level, input_buffer, output_buffer);
+      break;
+    case Compressor::RLE:
+      st = RLE::compress(cell_size, input_buffer, output_buffer);
+      break;
+    case Compressor::BZIP2:
+      st = BZip::compress(level, input_buffer, output_buffer);
+      break;
+    case Compressor::DOUBLE_DELTA:
+      st = DoubleDelta::compress(type, input_buffer, output_buffer);
+      break;
+    default:
+      assert(0);
   }
 
-  assert(left_to_compress == 0);
-
-  return Status::Ok();
+  return st;
 }
 
 Status TileIO::compute_chunking_info(
     Tile* tile,
     uint64_t* chunk_num,
     uint64_t* max_chunk_size,
-    uint64_t* overhead) {
+    uint64_t* overhead) const {
   // For easy reference
   auto cell_size = tile->cell_size();
   auto tile_size = tile->size();
+  uint64_t chunk_size = (storage_manager_ != nullptr) ?
+                            storage_manager_->config()->tile_chunk_size() :
+                            constants::tile_chunk_size;
 
-  // Compute max chunk size
-  *max_chunk_size = MIN(constants::tile_chunk_size, tile_size);
+  // Compute max chunk size, which must hold at least one cell
+  *max_chunk_size = MIN(chunk_size, tile_size);
   *max_chunk_size = *max_chunk_size / cell_size * cell_size;
+  if (*max_chunk_size == 0)
+    *max_chunk_size = cell_size;
   uint64_t chunk_overhead = this->overhead(tile, *max_chunk_size);
 
-  // Adjust max chunk size
-  if (*max_chunk_size + chunk_overhead > constants::tile_chunk_size) {
+  // Adjust max chunk size, so that the compressed chunk size fits in the
+  // (int) sizes the compressors work with
+  if (*max_chunk_size + chunk_overhead > INT_MAX) {
     *max_chunk_size -= chunk_overhead;
     *max_chunk_size = (*max_chunk_size) / cell_size * cell_size;
     chunk_overhead = this->overhead(tile, *max_chunk_size);
   }
 
   // Handle special error
-  if (*max_chunk_size + chunk_overhead > constants::tile_chunk_size) {
+  if (*max_chunk_size == 0 || *max_chunk_size + chunk_overhead > INT_MAX) {
     return LOG_STATUS(
-        Status::TileIOError("Compute chunking info failed; Consider adjusting "
-                            "constants::tile_chunk_size"));
+        Status::TileIOError("Compute chunking info failed; Cell size is too "
+                            "large for compression"));
   }
 
   // Compute number of chunks
@@ -402,20 +603,20 @@ Status TileIO::compute_chunking_info(
   // values per chunk that store the original and compressed chunk size,
   // plus a single value in the beginning for the total number of chunks.
   *overhead =
-      (*chunk_num) * chunk_overhead * 2 * sizeof(uint64_t) + sizeof(uint64_t);
+      (*chunk_num) * (chunk_overhead + 2 * sizeof(uint64_t)) + sizeof(uint64_t);
 
   return Status::Ok();
 }
 
-Status TileIO::decompress_tile(Tile* tile) {
+Status TileIO::decompress_tile(Buffer* buffer, Tile* tile) const {
   // Simple case - No coordinates
   if (!tile->stores_coords())
-    return decompress_one_tile(tile);
+    return decompress_one_tile(buffer, tile);
 
   // Decompress each dimension tile
   auto dim_num = tile->dim_num();
   for (unsigned int i = 0; i < dim_num; ++i)
-    RETURN_NOT_OK(decompress_one_tile(tile));
+    RETURN_NOT_OK(decompress_one_tile(buffer, tile));
 
   // Zip coordinates
   tile->zip_coordinates();
@@ -423,69 +624,120 @@ Status TileIO::decompress_tile(Tile* tile) {
   return Status::Ok();
 }
 
-Status TileIO::decompress_one_tile(Tile* tile) {
+Status TileIO::decompress_one_tile(Buffer* buffer, Tile* tile) const {
   // Read number of chunks
   uint64_t chunk_num;
-
-  RETURN_NOT_OK(buffer_->read(&chunk_num, sizeof(uint64_t)));
+  RETURN_NOT_OK(buffer->read(&chunk_num, sizeof(uint64_t)));
   assert(chunk_num > 0);
 
-  Status st;
-  Datatype type = tile->type();
+  // Locate the chunks in the compressed data, as well as their final
+  // positions in the tile
+  std::vector<void*> chunk_data(chunk_num);
+  std::vector<uint64_t> chunk_sizes(chunk_num);
+  std::vector<uint64_t> compressed_chunk_sizes(chunk_num);
+  std::vector<uint64_t> tile_offsets(chunk_num);
+  auto tile_buffer = tile->buffer();
+  uint64_t tile_offset = tile_buffer->offset();
   for (uint64_t i = 0; i < chunk_num; ++i) {
-    // Read original and compressed chunk size
-    uint64_t chunk_size, compressed_chunk_size;
-    RETURN_NOT_OK(buffer_->read(&chunk_size, sizeof(uint64_t)));
-    RETURN_NOT_OK(buffer_->read(&compressed_chunk_size, sizeof(uint64_t)));
-
-    auto input_buffer =
-        new ConstBuffer(buffer_->cur_data(), compressed_chunk_size);
-
-    // Invoke the proper decompressor
-    switch (tile->compressor()) {
-      case Compressor::NO_COMPRESSION:
-        assert(0);
-        break;
-      case Compressor::GZIP:
-        st = GZip::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::ZSTD:
-        st = ZStd::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::LZ4:
-        st = LZ4::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::BLOSC:
+    RETURN_NOT_OK(buffer->read(&chunk_sizes[i], sizeof(uint64_t)));
+    RETURN_NOT_OK(buffer->read(&compressed_chunk_sizes[i], sizeof(uint64_t)));
+    if (buffer->offset() + compressed_chunk_sizes[i] > buffer->size())
+      return LOG_STATUS(Status::TileIOError(
+          "Cannot decompress tile; Chunk exceeds the compressed data"));
+    chunk_data[i] = buffer->cur_data();
+    buffer->advance_offset(compressed_chunk_sizes[i]);
+    tile_offsets[i] = tile_offset;
+    tile_offset += chunk_sizes[i];
+  }
+  if (tile_offset > tile_buffer->alloced_size())
+    return LOG_STATUS(Status::TileIOError(
+        "Cannot decompress tile; Chunks exceed the tile size"));
+
+  // Decompress the chunks in parallel, directly into the tile
+  RETURN_NOT_OK(for_each_chunk(chunk_num, [&](uint64_t i) {
+    ConstBuffer input_buffer(chunk_data[i], compressed_chunk_sizes[i]);
+    Buffer output_buffer(
+        tile_buffer->data(tile_offsets[i]), chunk_sizes[i], false);
+    output_buffer.reset_size();
+    RETURN_NOT_OK(decompress_chunk(tile, &input_buffer, &output_buffer));
+    if (output_buffer.size() != chunk_sizes[i])
+      return LOG_STATUS(Status::TileIOError(
+          "Cannot decompress tile; Chunk size mismatch"));
+    return Status::Ok();
+  }));
+
+  // Account for the decompressed data in the tile
+  tile_buffer->advance_offset(tile_offset - tile_buffer->offset());
+  tile_buffer->set_size(std::max(tile_buffer->size(), tile_offset));
+
+  return Status::Ok();
+}
+
+Status TileIO::decompress_chunk(
+    Tile* tile, ConstBuffer* input_buffer, Buffer* output_buffer) const {
+  // With filters, decompress into a separate buffer and reverse the
+  // filters from there into the output
+  Buffer filtered;
+  Buffer* decompressed = output_buffer;
+  if (!tile->filters().empty()) {
+    RETURN_NOT_OK(filtered.realloc(output_buffer->free_space()));
+    decompressed = &filtered;
+  }
+
+  Status st;
+  switch (tile->compressor()) {
+    case Compressor::NO_COMPRESSION:
+      assert(0);
+      break;
+    case Compressor::GZIP:
+      st = GZip::decompress(input_buffer, decompressed);
+      break;
+    case Compressor::ZSTD:
+      st = ZStd::decompress(input_buffer, decompressed);
+      break;
+    case Compressor::LZ4:
+      st = LZ4::decompress(input_buffer, decompressed);
+      break;
+    case Compressor::BLOSC:
 #undef BLOSC_LZ4
-      case Compressor::BLOSC_LZ4:
+    case Compressor::BLOSC_LZ4:
 #undef BLOSC_LZ4HC
-      case Compressor::BLOSC_LZ4HC:
+    case Compressor::BLOSC_LZ4HC:
 #undef BLOSC_SNAPPY
-      case Compressor::BLOSC_SNAPPY:
+    case Compressor::BLOSC_SNAPPY:
 #undef BLOSC_ZLIB
-      case Compressor::BLOSC_ZLIB:
+    case Compressor::BLOSC_ZLIB:
 #undef BLOSC_ZSTD
-      case Compressor::BLOSC_ZSTD:
-        st = Blosc::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::RLE:
-        st = RLE::decompress(tile->cell_size(), input_buffer, tile->buffer());
-        break;
-      case Compressor::BZIP2:
-        st = BZip::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::DOUBLE_DELTA:
-        st = DoubleDelta::decompress(type, input_buffer, tile->buffer());
-        break;
-    }
+    case Compressor::BLOSC_ZSTD:
+      st = Blosc::decompress(input_buffer, decompressed);
+      break;
+    case Compressor::RLE:
+      st = RLE::decompress(tile->cell_size(), input_buffer, decompressed);
+      break;
+    case Compressor::BZIP2:
+      st = BZip::decompress(input_buffer, decompressed);
+      break;
+    case Compressor::DOUBLE_DELTA:
+      st = DoubleDelta::decompress(tile->type(), input_buffer, decompressed);
+      break;
+  }
 
-    delete input_buffer;
-    RETURN_NOT_OK(st);
+  if (!st.ok() || tile->filters().empty())
+    return st;
+  ConstBuffer filtered_input(&filtered);
+  return FilterPipeline::run_reverse(
+      tile->filters(), tile->type(), &filtered_input, output_buffer);
+}
 
-    buffer_->advance_offset(compressed_chunk_size);
-  }
+Status TileIO::for_each_chunk(
+    uint64_t chunk_num, const std::function<Status(uint64_t)>& func) const {
+  if (storage_manager_ != nullptr)
+    return storage_manager_->thread_pool()->parallel_for(chunk_num, func);
 
-  return st;
+  for (uint64_t i = 0; i < chunk_num; ++i)
+    RETURN_NOT_OK(func(i));
+
+  return Status::Ok();
 }
 
 uint64_t TileIO::overhead(Tile* tile, uint64_t nbytes) const {
@@ -519,4 +771,66 @@ uint64_t TileIO::overhead(Tile* tile, uint64_t nbytes) const {
   }
 }
 
+Status TileIO::stage(const void* data, uint64_t nbytes) {
+  // Only the tail of the file may be unaligned, i.e., after a flush
+  if (staging_offset_ % constants::direct_io_alignment != 0)
+    return LOG_STATUS(Status::TileIOError(
+        "Cannot write tile with direct I/O; The file has been flushed"));
+
+  auto data_c = static_cast<const char*>(data);
+  while (nbytes > 0) {
+    uint64_t bytes_to_copy =
+        std::min(nbytes, constants::direct_io_buffer_size - staging_size_);
+    std::memcpy(
+        static_cast<char*>(staging_buffer_) + staging_size_,
+        data_c,
+        bytes_to_copy);
+    staging_size_ += bytes_to_copy;
+    data_c += bytes_to_copy;
+    nbytes -= bytes_to_copy;
+
+    // Write the full buffer
+    if (staging_size_ == constants::direct_io_buffer_size) {
+      RETURN_NOT_OK(storage_manager_->write_to_file_direct(
+          uri_, staging_offset_, staging_buffer_, staging_size_));
+      staging_offset_ += staging_size_;
+      staging_size_ = 0;
+    }
+  }
+
+  return Status::Ok();
+}
+
+Status TileIO::read_from_memory(
+    Tile* tile,
+    void* data,
+    uint64_t compressed_size,
+    uint64_t tile_size,
+    bool alias) {
+  tile->reset_offset();
+  tile->reset_size();
+
+  // No compression
+  if (tile->compressor() == Compressor::NO_COMPRESSION) {
+    if (alias) {
+      tile->alias(data, tile_size);
+      return Status::Ok();
+    }
+    RETURN_NOT_OK(tile->realloc(tile_size));
+    RETURN_NOT_OK(tile->buffer()->write(data, tile_size));
+    tile->reset_offset();
+    return Status::Ok();
+  }
+
+  // Decompress directly from the input data
+  auto buffer = new Buffer(data, compressed_size, false);
+  RETURN_NOT_OK_ELSE(tile->realloc(tile_size), delete buffer);
+  RETURN_NOT_OK_ELSE(decompress_tile(buffer, tile), delete buffer);
+  tile->reset_offset();
+
+  delete buffer;
+
+  return Status::Ok();
+}
+
 }  // namespace tiledb
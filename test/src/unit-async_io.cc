@@ -0,0 +1,108 @@
+#include <async_io.h>
+#include <catch.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace tiledb;
+
+TEST_CASE("AsyncIO: Test batched writes and reads", "[async_io]") {
+  const char* filename = "async_io_test.tdb";
+  const uint64_t chunk_num = 200;
+  const uint64_t chunk_size = 4096;
+  int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+  REQUIRE(fd != -1);
+
+  // Write the chunks in reverse order, more than the queue depth
+  AsyncIO async_io(16);
+  std::vector<char> data(chunk_num * chunk_size);
+  for (uint64_t i = 0; i < data.size(); ++i)
+    data[i] = (char)(i * 7 + i / chunk_size);
+  std::vector<AsyncIO::Request> requests;
+  for (uint64_t i = chunk_num; i > 0; --i) {
+    AsyncIO::Request request;
+    request.fd_ = fd;
+    request.offset_ = (i - 1) * chunk_size;
+    request.iov_.push_back({&data[(i - 1) * chunk_size], chunk_size});
+    request.write_ = true;
+    requests.push_back(request);
+  }
+  Status st = async_io.execute(&requests);
+  REQUIRE(st.ok());
+
+  // Read back, each request scattering into two buffers
+  std::vector<char> result(data.size(), 0);
+  requests.clear();
+  for (uint64_t i = 0; i < chunk_num; ++i) {
+    AsyncIO::Request request;
+    request.fd_ = fd;
+    request.offset_ = i * chunk_size;
+    request.iov_.push_back({&result[i * chunk_size], 100});
+    request.iov_.push_back({&result[i * chunk_size + 100], chunk_size - 100});
+    request.write_ = false;
+    requests.push_back(request);
+  }
+  st = async_io.execute(&requests);
+  REQUIRE(st.ok());
+  CHECK(std::memcmp(&data[0], &result[0], data.size()) == 0);
+
+  // Reading past the end of the file fails
+  char c;
+  requests.clear();
+  AsyncIO::Request request;
+  request.fd_ = fd;
+  request.offset_ = data.size();
+  request.iov_.push_back({&c, 1});
+  request.write_ = false;
+  requests.push_back(request);
+  st = async_io.execute(&requests);
+  CHECK(!st.ok());
+
+  close(fd);
+  unlink(filename);
+}
+
+TEST_CASE("AsyncIO: Test concurrent batches", "[async_io]") {
+  const char* filename = "async_io_test.tdb";
+  const unsigned int thread_num = 8;
+  const uint64_t chunk_num = 100;
+  const uint64_t chunk_size = 4096;
+  int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+  REQUIRE(fd != -1);
+  std::vector<char> data(thread_num * chunk_num * chunk_size);
+  for (uint64_t i = 0; i < data.size(); ++i)
+    data[i] = (char)(i * 7 + i / chunk_size);
+  REQUIRE(pwrite(fd, &data[0], data.size(), 0) == (ssize_t)data.size());
+
+  // Each thread reads its own part of the file in a batch of its own
+  AsyncIO async_io(16);
+  std::vector<char> result(data.size(), 0);
+  std::vector<int> ok(thread_num, 0);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&, t]() {
+      std::vector<AsyncIO::Request> requests;
+      for (uint64_t i = 0; i < chunk_num; ++i) {
+        uint64_t offset = (t * chunk_num + i) * chunk_size;
+        AsyncIO::Request request;
+        request.fd_ = fd;
+        request.offset_ = offset;
+        request.iov_.push_back({&result[offset], chunk_size});
+        request.write_ = false;
+        requests.push_back(request);
+      }
+      ok[t] = async_io.execute(&requests).ok();
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  for (unsigned int t = 0; t < thread_num; ++t)
+    CHECK(ok[t]);
+  CHECK(std::memcmp(&data[0], &result[0], data.size()) == 0);
+
+  close(fd);
+  unlink(filename);
+}
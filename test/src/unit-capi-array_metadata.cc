@@ -425,3 +425,82 @@ TEST_CASE_METHOD(
   rc = tiledb_array_metadata_free(ctx_, array_metadata);
   REQUIRE(rc == TILEDB_OK);
 }
+
+TEST_CASE_METHOD(
+    ArraySchemaFx, "C API: Test attribute filters", "[metadata]") {
+  int rc = tiledb_array_metadata_create(
+      ctx_, &array_metadata_, ARRAY_PATH.c_str());
+  REQUIRE(rc == TILEDB_OK);
+
+  // Set domain
+  tiledb_domain_t* domain;
+  rc = tiledb_domain_create(ctx_, &domain, DIM_TYPE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_domain_add_dimension(
+      ctx_, domain, DIM1_NAME, &DIM_DOMAIN[0], &TILE_EXTENTS[0]);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_metadata_set_domain(ctx_, array_metadata_, domain);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Set an attribute with filters
+  tiledb_attribute_t* attr;
+  rc = tiledb_attribute_create(ctx_, &attr, ATTR_NAME, ATTR_TYPE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_add_filter(ctx_, attr, TILEDB_DELTA);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_add_filter(ctx_, attr, TILEDB_BITSHUFFLE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_metadata_add_attribute(ctx_, array_metadata_, attr);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Filters are invalid without a compressor
+  rc = tiledb_array_metadata_check(ctx_, array_metadata_);
+  REQUIRE(rc != TILEDB_OK);
+
+  // Add a compressor and create the array
+  tiledb_array_metadata_free(ctx_, array_metadata_);
+  rc = tiledb_array_metadata_create(
+      ctx_, &array_metadata_, ARRAY_PATH.c_str());
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_metadata_set_domain(ctx_, array_metadata_, domain);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_set_compressor(ctx_, attr, TILEDB_GZIP, -1);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_metadata_add_attribute(ctx_, array_metadata_, attr);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_create(ctx_, array_metadata_);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_attribute_free(ctx_, attr);
+  tiledb_domain_free(ctx_, domain);
+
+  // The filters are loaded with the array metadata
+  tiledb_array_metadata_t* array_metadata;
+  rc = tiledb_array_metadata_load(ctx_, &array_metadata, ARRAY_PATH.c_str());
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_attribute_iter_t* attr_it;
+  rc = tiledb_attribute_iter_create(ctx_, array_metadata, &attr_it);
+  REQUIRE(rc == TILEDB_OK);
+  const tiledb_attribute_t* loaded_attr;
+  rc = tiledb_attribute_iter_here(ctx_, attr_it, &loaded_attr);
+  REQUIRE(rc == TILEDB_OK);
+
+  unsigned int filter_num;
+  rc = tiledb_attribute_get_filter_num(ctx_, loaded_attr, &filter_num);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(filter_num == 2);
+  tiledb_filter_t filter;
+  rc = tiledb_attribute_get_filter(ctx_, loaded_attr, 0, &filter);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(filter == TILEDB_DELTA);
+  rc = tiledb_attribute_get_filter(ctx_, loaded_attr, 1, &filter);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(filter == TILEDB_BITSHUFFLE);
+  rc = tiledb_attribute_get_filter(ctx_, loaded_attr, 2, &filter);
+  CHECK(rc != TILEDB_OK);
+
+  // Clean up
+  rc = tiledb_attribute_iter_free(ctx_, attr_it);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_metadata_free(ctx_, array_metadata);
+  REQUIRE(rc == TILEDB_OK);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file   unit-capi-config.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB Inc.
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests for the C API config.
+ */
+
+#include "catch.hpp"
+#include "tiledb.h"
+
+TEST_CASE("C API: Test config", "[capi], [config]") {
+  tiledb_ctx_t* ctx;
+  int rc = tiledb_ctx_create(&ctx);
+  REQUIRE(rc == TILEDB_OK);
+
+  tiledb_config_t* config;
+  rc = tiledb_config_create(ctx, &config);
+  REQUIRE(rc == TILEDB_OK);
+
+  SECTION("- thread pool size") {
+    rc = tiledb_config_set_thread_pool_size(ctx, config, 3);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_ctx_set_config(ctx, config);
+    CHECK(rc == TILEDB_OK);
+
+    // The pool can be resized again, including to the hardware threads
+    rc = tiledb_config_set_thread_pool_size(ctx, config, 0);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_ctx_set_config(ctx, config);
+    CHECK(rc == TILEDB_OK);
+  }
+
+  SECTION("- metadata cache size") {
+    rc = tiledb_config_set_metadata_cache_size(ctx, config, 0);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_ctx_set_config(ctx, config);
+    CHECK(rc == TILEDB_OK);
+  }
+
+  SECTION("- tile cache size") {
+    rc = tiledb_config_set_tile_cache_size(ctx, config, 1000000);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_ctx_set_config(ctx, config);
+    CHECK(rc == TILEDB_OK);
+  }
+
+  SECTION("- tile coalesce gap size") {
+    rc = tiledb_config_set_tile_coalesce_gap_size(ctx, config, 4096);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_ctx_set_config(ctx, config);
+    CHECK(rc == TILEDB_OK);
+  }
+
+  SECTION("- read-ahead") {
+    rc = tiledb_config_set_read_ahead(ctx, config, 0);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_ctx_set_config(ctx, config);
+    CHECK(rc == TILEDB_OK);
+  }
+
+  SECTION("- read thread num") {
+    rc = tiledb_config_set_read_thread_num(ctx, config, 4);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_ctx_set_config(ctx, config);
+    CHECK(rc == TILEDB_OK);
+  }
+
+  SECTION("- tile chunk size") {
+    rc = tiledb_config_set_tile_chunk_size(ctx, config, 65536);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_ctx_set_config(ctx, config);
+    CHECK(rc == TILEDB_OK);
+  }
+
+  SECTION("- invalid config") {
+    rc = tiledb_ctx_set_config(ctx, nullptr);
+    CHECK(rc == TILEDB_ERR);
+
+    tiledb_error_t* err;
+    rc = tiledb_error_last(ctx, &err);
+    REQUIRE(rc == TILEDB_OK);
+    const char* errmsg;
+    rc = tiledb_error_message(ctx, err, &errmsg);
+    CHECK(rc == TILEDB_OK);
+    CHECK_THAT(errmsg, Catch::Equals("Error: Invalid TileDB config struct"));
+    tiledb_error_free(ctx, err);
+  }
+
+  // Clean up
+  CHECK(tiledb_config_free(ctx, config) == TILEDB_OK);
+  CHECK(tiledb_ctx_free(ctx) == TILEDB_OK);
+}
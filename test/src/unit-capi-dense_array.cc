@@ -36,16 +36,19 @@
 #include "tiledb.h"
 
 #include <sys/time.h>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <ctime>
 #include <iostream>
 #include <map>
 #include <sstream>
+#include <vector>
 
 struct DenseArrayFx {
   // Constant parameters
   const char* ATTR_NAME = "a";
+  const char* ATTR_VAR_NAME = "b";
   const tiledb_datatype_t ATTR_TYPE = TILEDB_INT32;
   const char* DIM1_NAME = "x";
   const char* DIM2_NAME = "y";
@@ -247,6 +250,69 @@ struct DenseArrayFx {
     REQUIRE(rc == TILEDB_OK);
   }
 
+  /**
+   * Creates a 2D dense array with a fixed-sized and a variable-sized
+   * attribute, in the row-major order.
+   *
+   * @param domain_size The domain size of both dimensions.
+   * @param tile_extent The tile extent of both dimensions.
+   * @param compressor The compressor of both attributes.
+   */
+  void create_dense_array_var_2D(
+      const int64_t domain_size,
+      const int64_t tile_extent,
+      const tiledb_compressor_t compressor) {
+    int64_t dim_domain[] = {0, domain_size - 1, 0, domain_size - 1};
+
+    // Create attributes
+    tiledb_attribute_t* a;
+    int rc = tiledb_attribute_create(ctx_, &a, ATTR_NAME, ATTR_TYPE);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_attribute_set_compressor(ctx_, a, compressor, -1);
+    REQUIRE(rc == TILEDB_OK);
+    tiledb_attribute_t* b;
+    rc = tiledb_attribute_create(ctx_, &b, ATTR_VAR_NAME, TILEDB_CHAR);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_attribute_set_cell_val_num(ctx_, b, TILEDB_VAR_NUM);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_attribute_set_compressor(ctx_, b, compressor, -1);
+    REQUIRE(rc == TILEDB_OK);
+
+    // Create domain
+    tiledb_domain_t* domain;
+    rc = tiledb_domain_create(ctx_, &domain, DIM_TYPE);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_domain_add_dimension(
+        ctx_, domain, DIM1_NAME, &dim_domain[0], &tile_extent);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_domain_add_dimension(
+        ctx_, domain, DIM2_NAME, &dim_domain[2], &tile_extent);
+    REQUIRE(rc == TILEDB_OK);
+
+    // Create the array
+    rc = tiledb_array_metadata_create(
+        ctx_, &array_metadata_, array_name_.c_str());
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_metadata_add_attribute(ctx_, array_metadata_, a);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_metadata_add_attribute(ctx_, array_metadata_, b);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_metadata_set_domain(ctx_, array_metadata_, domain);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_create(ctx_, array_metadata_);
+    REQUIRE(rc == TILEDB_OK);
+
+    // Clean up
+    rc = tiledb_attribute_free(ctx_, a);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_attribute_free(ctx_, b);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_domain_free(ctx_, domain);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_metadata_free(ctx_, array_metadata_);
+    REQUIRE(rc == TILEDB_OK);
+  }
+
   /**
    * Generates a 1D buffer containing the cell values of a 2D array.
    * Each cell value equals (row index * total number of columns + col index).
@@ -377,6 +443,83 @@ struct DenseArrayFx {
   }
 
   /** Sets the array name for the current test. */
+  /**
+   * Reads both attributes of an array created by *create_dense_array_var_2D*
+   * in a subarray, resubmitting the query for as long as it is incomplete.
+   *
+   * @param subarray The subarray to be read.
+   * @param layout The query layout.
+   * @param read_thread_num The number of threads that fetch the tiles, where
+   *     zero keeps the number set in the context config.
+   * @param cell_num The number of cells that fit in the query buffers.
+   * @param a The values read for the fixed-sized attribute.
+   * @param b The values read for the variable-sized attribute.
+   * @return The number of submissions.
+   */
+  int read_dense_array_var_2D(
+      const int64_t* subarray,
+      const tiledb_layout_t layout,
+      const unsigned int read_thread_num,
+      const uint64_t cell_num,
+      std::vector<int>* a,
+      std::vector<std::string>* b) {
+    // Prepare the buffers, which fit each variable-sized value
+    const char* attributes[] = {ATTR_NAME, ATTR_VAR_NAME};
+    std::vector<int> buffer_a(cell_num);
+    std::vector<uint64_t> buffer_b(cell_num);
+    std::vector<char> buffer_b_var(3 * cell_num);
+    void* buffers[] = {&buffer_a[0], &buffer_b[0], &buffer_b_var[0]};
+    uint64_t buffer_sizes[3];
+
+    // Create query
+    tiledb_query_t* query;
+    int rc = tiledb_query_create(
+        ctx_,
+        &query,
+        array_name_.c_str(),
+        TILEDB_READ,
+        layout,
+        subarray,
+        attributes,
+        2,
+        buffers,
+        buffer_sizes);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_read_thread_num(ctx_, query, read_thread_num);
+    REQUIRE(rc == TILEDB_OK);
+
+    // Submit the query until it completes, collecting the results
+    int submit_num = 0;
+    tiledb_query_status_t status;
+    do {
+      buffer_sizes[0] = buffer_a.size() * sizeof(int);
+      buffer_sizes[1] = buffer_b.size() * sizeof(uint64_t);
+      buffer_sizes[2] = buffer_b_var.size();
+      rc = tiledb_query_reset_buffers(ctx_, query, buffers, buffer_sizes);
+      REQUIRE(rc == TILEDB_OK);
+      rc = tiledb_query_submit(ctx_, query);
+      REQUIRE(rc == TILEDB_OK);
+      ++submit_num;
+
+      a->insert(
+          a->end(), &buffer_a[0], &buffer_a[0] + buffer_sizes[0] / sizeof(int));
+      uint64_t b_num = buffer_sizes[1] / sizeof(uint64_t);
+      for (uint64_t i = 0; i < b_num; ++i) {
+        uint64_t end = (i + 1 < b_num) ? buffer_b[i + 1] : buffer_sizes[2];
+        b->push_back(
+            std::string(&buffer_b_var[buffer_b[i]], end - buffer_b[i]));
+      }
+
+      rc = tiledb_query_get_status(ctx_, query, &status);
+      REQUIRE(rc == TILEDB_OK);
+    } while (status == TILEDB_INCOMPLETE);
+    CHECK(status == TILEDB_COMPLETED);
+
+    rc = tiledb_query_free(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+    return submit_num;
+  }
+
   void set_array_name(const char* name) {
     array_name_ = URI_PREFIX + TEMP_DIR + GROUP + name;
   }
@@ -555,6 +698,58 @@ struct DenseArrayFx {
     return rc;
   }
 
+  /**
+   * Writes a fragment to an array created by *create_dense_array_var_2D*,
+   * covering a subarray in the row-major order. The fixed-sized value of
+   * cell (i,j) is value_offset+i*domain_size+j, and its variable-sized
+   * value has 1 to 3 characters.
+   *
+   * @param domain_size The domain size of both dimensions.
+   * @param subarray The subarray to be written.
+   * @param value_offset The offset of the fixed-sized values.
+   */
+  void write_dense_array_var_2D(
+      const int64_t domain_size,
+      const int64_t* subarray,
+      const int value_offset) {
+    // Generate the cells
+    std::vector<int> buffer_a;
+    std::vector<uint64_t> buffer_b;
+    std::string buffer_b_var;
+    for (int64_t i = subarray[0]; i <= subarray[1]; ++i) {
+      for (int64_t j = subarray[2]; j <= subarray[3]; ++j) {
+        int value = value_offset + (int)(i * domain_size + j);
+        buffer_a.push_back(value);
+        buffer_b.push_back(buffer_b_var.size());
+        buffer_b_var.append((i + j) % 3 + 1, (char)('a' + value % 26));
+      }
+    }
+
+    // Write the fragment
+    const char* attributes[] = {ATTR_NAME, ATTR_VAR_NAME};
+    void* buffers[] = {&buffer_a[0], &buffer_b[0], &buffer_b_var[0]};
+    uint64_t buffer_sizes[] = {buffer_a.size() * sizeof(int),
+                               buffer_b.size() * sizeof(uint64_t),
+                               buffer_b_var.size()};
+    tiledb_query_t* query;
+    int rc = tiledb_query_create(
+        ctx_,
+        &query,
+        array_name_.c_str(),
+        TILEDB_WRITE,
+        TILEDB_ROW_MAJOR,
+        subarray,
+        attributes,
+        2,
+        buffers,
+        buffer_sizes);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_submit(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_free(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+  }
+
   /**
    * Writes a 2D dense subarray.
    *
@@ -876,3 +1071,166 @@ TEST_CASE_METHOD(DenseArrayFx, "C API: Test random dense updates", "[dense]") {
   delete[] buffer_a1;
   delete[] buffer_coords;
 }
+
+/**
+ * Tests sorted writes and reads of random 2D subarrays on an array with the
+ * Morton tile order, whose tile grid is not a power of two.
+ */
+TEST_CASE_METHOD(
+    DenseArrayFx, "C API: Test dense Morton tile order", "[dense]") {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 100;
+  int64_t domain_size_1 = 120;
+  int64_t tile_extent_0 = 10;
+  int64_t tile_extent_1 = 10;
+  uint64_t capacity = 1000;
+  int iter_num = 10;
+
+  // Set array name
+  set_array_name("dense_test_morton_100x120_10x10");
+
+  // Create a dense integer array
+  create_dense_array_2D(
+      tile_extent_0,
+      tile_extent_1,
+      0,
+      domain_size_0 - 1,
+      0,
+      domain_size_1 - 1,
+      capacity,
+      TILEDB_ROW_MAJOR,
+      TILEDB_MORTON);
+
+  // Write array cells with value = row id * COLUMNS + col id
+  int64_t subarray[] = {0, domain_size_0 - 1, 0, domain_size_1 - 1};
+  int64_t cell_num = domain_size_0 * domain_size_1;
+  auto buffer = new int[cell_num];
+  for (int64_t i = 0; i < cell_num; ++i)
+    buffer[i] = (int)i;
+  uint64_t buffer_sizes[] = {cell_num * sizeof(int)};
+  rc = write_dense_subarray_2D(
+      subarray, TILEDB_WRITE, TILEDB_ROW_MAJOR, buffer, buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  delete[] buffer;
+
+  // Read random subarrays in row- and column-major order and check them
+  for (int iter = 0; iter < iter_num; ++iter) {
+    int64_t d0_lo = std::rand() % domain_size_0;
+    int64_t d1_lo = std::rand() % domain_size_1;
+    int64_t d0_hi = d0_lo + std::rand() % (domain_size_0 - d0_lo);
+    int64_t d1_hi = d1_lo + std::rand() % (domain_size_1 - d1_lo);
+
+    int* row_buffer = read_dense_array_2D(
+        d0_lo, d0_hi, d1_lo, d1_hi, TILEDB_READ, TILEDB_ROW_MAJOR);
+    REQUIRE(row_buffer != NULL);
+    int* col_buffer = read_dense_array_2D(
+        d0_lo, d0_hi, d1_lo, d1_hi, TILEDB_READ, TILEDB_COL_MAJOR);
+    REQUIRE(col_buffer != NULL);
+
+    bool allok = true;
+    int64_t rows = d0_hi - d0_lo + 1, cols = d1_hi - d1_lo + 1;
+    for (int64_t i = 0; i < rows && allok; ++i) {
+      for (int64_t j = 0; j < cols && allok; ++j) {
+        int value = (int)((d0_lo + i) * domain_size_1 + d1_lo + j);
+        allok = row_buffer[i * cols + j] == value &&
+                col_buffer[j * rows + i] == value;
+      }
+    }
+    CHECK(allok);
+
+    delete[] row_buffer;
+    delete[] col_buffer;
+  }
+
+  // Overwrite random subarrays, then read them back
+  for (int iter = 0; iter < iter_num; ++iter) {
+    int64_t d0_lo = std::rand() % domain_size_0;
+    int64_t d1_lo = std::rand() % domain_size_1;
+    int64_t d0_hi = d0_lo + std::rand() % (domain_size_0 - d0_lo);
+    int64_t d1_hi = d1_lo + std::rand() % (domain_size_1 - d1_lo);
+    int64_t update_subarray[] = {d0_lo, d0_hi, d1_lo, d1_hi};
+    int64_t update_num = (d0_hi - d0_lo + 1) * (d1_hi - d1_lo + 1);
+    auto update = new int[update_num];
+    for (int64_t i = 0; i < update_num; ++i)
+      update[i] = -(std::rand() % 999999);
+    uint64_t update_sizes[] = {update_num * sizeof(int)};
+    rc = write_dense_subarray_2D(
+        update_subarray, TILEDB_WRITE, TILEDB_ROW_MAJOR, update, update_sizes);
+    REQUIRE(rc == TILEDB_OK);
+
+    int* read_buffer = read_dense_array_2D(
+        d0_lo, d0_hi, d1_lo, d1_hi, TILEDB_READ, TILEDB_ROW_MAJOR);
+    REQUIRE(read_buffer != NULL);
+    CHECK(std::equal(update, update + update_num, read_buffer));
+
+    delete[] update;
+    delete[] read_buffer;
+  }
+}
+
+/**
+ * Reads with several threads fetching the tiles across the attributes and
+ * the overlapping fragments must return the same cells as a serial read,
+ * also when the query buffers overflow and the query is resubmitted.
+ */
+TEST_CASE_METHOD(
+    DenseArrayFx, "C API: Test parallel dense reads", "[dense]") {
+  int64_t domain_size = 40;
+  set_array_name("dense_test_parallel");
+  create_dense_array_var_2D(domain_size, 10, TILEDB_RLE);
+  const int64_t subarray_1[] = {0, 39, 0, 39};
+  const int64_t subarray_2[] = {5, 24, 12, 33};
+  const int64_t subarray_3[] = {20, 27, 0, 9};
+  write_dense_array_var_2D(domain_size, subarray_1, 0);
+  write_dense_array_var_2D(domain_size, subarray_2, 100000);
+  write_dense_array_var_2D(domain_size, subarray_3, 200000);
+
+  // The parallel reads take the number of threads from the context config
+  tiledb_config_t* config;
+  int rc = tiledb_config_create(ctx_, &config);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_config_set_read_thread_num(ctx_, config, 4);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_ctx_set_config(ctx_, config);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_config_free(ctx_, config);
+  REQUIRE(rc == TILEDB_OK);
+
+  tiledb_layout_t layout = TILEDB_GLOBAL_ORDER;
+  SECTION("- global order") {
+    layout = TILEDB_GLOBAL_ORDER;
+  }
+
+  SECTION("- row-major") {
+    layout = TILEDB_ROW_MAJOR;
+  }
+
+  const int64_t subarray[] = {3, 37, 5, 38};
+  uint64_t cell_num = 35 * 34;
+  std::vector<int> serial_a;
+  std::vector<std::string> serial_b;
+  CHECK(
+      read_dense_array_var_2D(
+          subarray, layout, 1, cell_num, &serial_a, &serial_b) == 1);
+  REQUIRE(serial_a.size() == cell_num);
+  REQUIRE(serial_b.size() == cell_num);
+  CHECK(serial_a[0] == 3 * domain_size + 5);
+  CHECK(serial_b[0] == "vvv");
+
+  // Buffers that fit all the results
+  std::vector<int> a;
+  std::vector<std::string> b;
+  CHECK(read_dense_array_var_2D(subarray, layout, 0, cell_num, &a, &b) == 1);
+  CHECK(a == serial_a);
+  CHECK(b == serial_b);
+
+  // Buffers that overflow
+  a.clear();
+  b.clear();
+  CHECK(read_dense_array_var_2D(subarray, layout, 0, 17, &a, &b) > 1);
+  CHECK(a == serial_a);
+  CHECK(b == serial_b);
+}
@@ -36,16 +36,20 @@
 #include "tiledb.h"
 
 #include <sys/time.h>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <ctime>
 #include <iostream>
 #include <map>
+#include <numeric>
 #include <sstream>
+#include <vector>
 
 struct SparseArrayFx {
   // Constant parameters
   const char* ATTR_NAME = "a";
+  const char* ATTR_VAR_NAME = "b";
   const char* DIM1_NAME = "x";
   const char* DIM2_NAME = "y";
   const tiledb_datatype_t ATTR_TYPE = TILEDB_INT32;
@@ -195,6 +199,78 @@ struct SparseArrayFx {
     REQUIRE(rc == TILEDB_OK);
   }
 
+  /**
+   * Creates a 2D sparse array with a fixed-sized and a variable-sized
+   * attribute, in the row-major order.
+   *
+   * @param domain_size The domain size of both dimensions.
+   * @param tile_extent The tile extent of both dimensions.
+   * @param capacity The tile capacity.
+   * @param compressor The compressor of both attributes.
+   */
+  void create_sparse_array_var_2D(
+      const int64_t domain_size,
+      const int64_t tile_extent,
+      const uint64_t capacity,
+      const tiledb_compressor_t compressor) {
+    int64_t dim_domain[] = {0, domain_size - 1, 0, domain_size - 1};
+
+    // Create attributes
+    tiledb_attribute_t* a;
+    int rc = tiledb_attribute_create(ctx_, &a, ATTR_NAME, ATTR_TYPE);
+    REQUIRE(rc == TILEDB_OK);
+    rc =
+        tiledb_attribute_set_compressor(ctx_, a, compressor, COMPRESSION_LEVEL);
+    REQUIRE(rc == TILEDB_OK);
+    tiledb_attribute_t* b;
+    rc = tiledb_attribute_create(ctx_, &b, ATTR_VAR_NAME, TILEDB_CHAR);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_attribute_set_cell_val_num(ctx_, b, TILEDB_VAR_NUM);
+    REQUIRE(rc == TILEDB_OK);
+    rc =
+        tiledb_attribute_set_compressor(ctx_, b, compressor, COMPRESSION_LEVEL);
+    REQUIRE(rc == TILEDB_OK);
+
+    // Create domain
+    tiledb_domain_t* domain;
+    rc = tiledb_domain_create(ctx_, &domain, DIM_TYPE);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_domain_add_dimension(
+        ctx_, domain, DIM1_NAME, &dim_domain[0], &tile_extent);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_domain_add_dimension(
+        ctx_, domain, DIM2_NAME, &dim_domain[2], &tile_extent);
+    REQUIRE(rc == TILEDB_OK);
+
+    // Create the array
+    rc = tiledb_array_metadata_create(
+        ctx_, &array_metadata_, array_name_.c_str());
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_metadata_set_capacity(ctx_, array_metadata_, capacity);
+    REQUIRE(rc == TILEDB_OK);
+    rc =
+        tiledb_array_metadata_set_array_type(ctx_, array_metadata_, ARRAY_TYPE);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_metadata_add_attribute(ctx_, array_metadata_, a);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_metadata_add_attribute(ctx_, array_metadata_, b);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_metadata_set_domain(ctx_, array_metadata_, domain);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_create(ctx_, array_metadata_);
+    REQUIRE(rc == TILEDB_OK);
+
+    // Clean up
+    rc = tiledb_attribute_free(ctx_, a);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_attribute_free(ctx_, b);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_domain_free(ctx_, domain);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_metadata_free(ctx_, array_metadata_);
+    REQUIRE(rc == TILEDB_OK);
+  }
+
   /**
    * Reads a subarray oriented by the input boundaries and outputs the buffer
    * containing the attribute values of the corresponding cells.
@@ -277,6 +353,82 @@ struct SparseArrayFx {
     return buffer_a1;
   }
 
+  /**
+   * Reads both attributes of an array created by *create_sparse_array_var_2D*
+   * in a subarray, resubmitting the query for as long as it is incomplete.
+   *
+   * @param subarray The subarray to be read.
+   * @param layout The query layout.
+   * @param read_thread_num The number of threads that fetch the tiles.
+   * @param cell_num The number of cells that fit in the query buffers.
+   * @param a The values read for the fixed-sized attribute.
+   * @param b The values read for the variable-sized attribute.
+   * @return The number of submissions.
+   */
+  int read_sparse_array_var_2D(
+      const int64_t* subarray,
+      const tiledb_layout_t layout,
+      const unsigned int read_thread_num,
+      const uint64_t cell_num,
+      std::vector<int>* a,
+      std::vector<std::string>* b) {
+    // Prepare the buffers, which fit each variable-sized value
+    const char* attributes[] = {ATTR_NAME, ATTR_VAR_NAME};
+    std::vector<int> buffer_a(cell_num);
+    std::vector<uint64_t> buffer_b(cell_num);
+    std::vector<char> buffer_b_var(3 * cell_num);
+    void* buffers[] = {&buffer_a[0], &buffer_b[0], &buffer_b_var[0]};
+    uint64_t buffer_sizes[3];
+
+    // Create query
+    tiledb_query_t* query;
+    int rc = tiledb_query_create(
+        ctx_,
+        &query,
+        array_name_.c_str(),
+        TILEDB_READ,
+        layout,
+        subarray,
+        attributes,
+        2,
+        buffers,
+        buffer_sizes);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_read_thread_num(ctx_, query, read_thread_num);
+    REQUIRE(rc == TILEDB_OK);
+
+    // Submit the query until it completes, collecting the results
+    int submit_num = 0;
+    tiledb_query_status_t status;
+    do {
+      buffer_sizes[0] = buffer_a.size() * sizeof(int);
+      buffer_sizes[1] = buffer_b.size() * sizeof(uint64_t);
+      buffer_sizes[2] = buffer_b_var.size();
+      rc = tiledb_query_reset_buffers(ctx_, query, buffers, buffer_sizes);
+      REQUIRE(rc == TILEDB_OK);
+      rc = tiledb_query_submit(ctx_, query);
+      REQUIRE(rc == TILEDB_OK);
+      ++submit_num;
+
+      a->insert(
+          a->end(), &buffer_a[0], &buffer_a[0] + buffer_sizes[0] / sizeof(int));
+      uint64_t b_num = buffer_sizes[1] / sizeof(uint64_t);
+      for (uint64_t i = 0; i < b_num; ++i) {
+        uint64_t end = (i + 1 < b_num) ? buffer_b[i + 1] : buffer_sizes[2];
+        b->push_back(
+            std::string(&buffer_b_var[buffer_b[i]], end - buffer_b[i]));
+      }
+
+      rc = tiledb_query_get_status(ctx_, query, &status);
+      REQUIRE(rc == TILEDB_OK);
+    } while (status == TILEDB_INCOMPLETE);
+    CHECK(status == TILEDB_COMPLETED);
+
+    rc = tiledb_query_free(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+    return submit_num;
+  }
+
   /** Sets the array name for the current test. */
   void set_array_name(const char* name) {
     array_name_ = URI_PREFIX + TEMP_DIR + GROUP + name;
@@ -349,6 +501,67 @@ struct SparseArrayFx {
     return TILEDB_OK;
   }
 
+  /**
+   * Writes a fragment to an array created by *create_sparse_array_var_2D*,
+   * with every cell of a range of rows, in unsorted mode. The fixed-sized
+   * value of cell (i,j) is value_offset+i*domain_size+j, and its
+   * variable-sized value has 1 to 3 characters.
+   *
+   * @param domain_size The domain size of both dimensions.
+   * @param row_lo The first row to be written.
+   * @param row_hi The last row to be written.
+   * @param value_offset The offset of the fixed-sized values.
+   */
+  void write_sparse_array_var_2D(
+      const int64_t domain_size,
+      const int64_t row_lo,
+      const int64_t row_hi,
+      const int value_offset) {
+    // Generate the cells in the reverse order
+    std::vector<int> buffer_a;
+    std::vector<uint64_t> buffer_b;
+    std::string buffer_b_var;
+    std::vector<int64_t> buffer_coords;
+    for (int64_t i = row_hi; i >= row_lo; --i) {
+      for (int64_t j = domain_size - 1; j >= 0; --j) {
+        int value = value_offset + (int)(i * domain_size + j);
+        buffer_a.push_back(value);
+        buffer_b.push_back(buffer_b_var.size());
+        buffer_b_var.append((i + j) % 3 + 1, (char)('a' + value % 26));
+        buffer_coords.push_back(i);
+        buffer_coords.push_back(j);
+      }
+    }
+
+    // Write the fragment
+    const char* attributes[] = {ATTR_NAME, ATTR_VAR_NAME, TILEDB_COORDS};
+    void* buffers[] = {&buffer_a[0],
+                       &buffer_b[0],
+                       &buffer_b_var[0],
+                       &buffer_coords[0]};
+    uint64_t buffer_sizes[] = {buffer_a.size() * sizeof(int),
+                               buffer_b.size() * sizeof(uint64_t),
+                               buffer_b_var.size(),
+                               buffer_coords.size() * sizeof(int64_t)};
+    tiledb_query_t* query;
+    int rc = tiledb_query_create(
+        ctx_,
+        &query,
+        array_name_.c_str(),
+        TILEDB_WRITE,
+        TILEDB_UNORDERED,
+        nullptr,
+        attributes,
+        3,
+        buffers,
+        buffer_sizes);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_submit(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_free(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+  }
+
   bool test_random_subarrays(
       int64_t domain_size_0, int64_t domain_size_1, int ntests) {
     // write array_metadata cells with value = row id * columns + col id to disk
@@ -473,6 +686,21 @@ TEST_CASE_METHOD(
     CHECK(test_random_subarrays(domain_size_0, domain_size_1, ntests));
   }
 
+  SECTION("- no compression hilbert") {
+    create_sparse_array_2D(
+        tile_extent_0,
+        tile_extent_1,
+        domain_0_lo,
+        domain_0_hi,
+        domain_1_lo,
+        domain_1_hi,
+        capacity,
+        TILEDB_NO_COMPRESSION,
+        TILEDB_HILBERT,
+        TILEDB_ROW_MAJOR);
+    CHECK(test_random_subarrays(domain_size_0, domain_size_1, ntests));
+  }
+
   SECTION("- gzip compression row-major") {
     create_sparse_array_2D(
         tile_extent_0,
@@ -610,3 +838,105 @@ TEST_CASE_METHOD(
     CHECK(test_random_subarrays(domain_size_0, domain_size_1, ntests));
   }
 }
+
+/**
+ * On a 4x4 domain, the Hilbert curve visits cell (1,1) before (1,0), so the
+ * corners of a subarray or of a tile MBR do not bound its cells in the
+ * Hilbert order.
+ */
+TEST_CASE_METHOD(
+    SparseArrayFx, "C API: Test sparse Hilbert reads", "[sparse]") {
+  int64_t domain_size = 4;
+  uint64_t capacity = 0;
+  set_array_name("sparse_test_4x4_hilbert");
+
+  SECTION("- partial tile overlap") {
+    capacity = 16;
+  }
+
+  SECTION("- full tile overlap") {
+    capacity = 4;
+  }
+
+  create_sparse_array_2D(
+      domain_size,
+      domain_size,
+      0,
+      domain_size - 1,
+      0,
+      domain_size - 1,
+      capacity,
+      TILEDB_NO_COMPRESSION,
+      TILEDB_HILBERT,
+      TILEDB_ROW_MAJOR);
+  int rc = write_sparse_array_unsorted_2D(domain_size, domain_size);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Read subarray [1,2]x[0,1], and the whole domain, in the global order
+  int* buffer =
+      read_sparse_array_2D(1, 2, 0, 1, TILEDB_READ, TILEDB_GLOBAL_ORDER);
+  REQUIRE(buffer != nullptr);
+  std::vector<int> result(buffer, buffer + 4);
+  std::sort(result.begin(), result.end());
+  CHECK(result == std::vector<int>({4, 5, 8, 9}));
+  delete[] buffer;
+
+  buffer = read_sparse_array_2D(0, 3, 0, 3, TILEDB_READ, TILEDB_GLOBAL_ORDER);
+  REQUIRE(buffer != nullptr);
+  result.assign(buffer, buffer + 16);
+  std::sort(result.begin(), result.end());
+  std::vector<int> expected(16);
+  std::iota(expected.begin(), expected.end(), 0);
+  CHECK(result == expected);
+  delete[] buffer;
+}
+
+/**
+ * Reads with several threads fetching the tiles across the attributes and
+ * the overlapping fragments must return the same cells as a serial read,
+ * also when the query buffers overflow and the query is resubmitted.
+ */
+TEST_CASE_METHOD(
+    SparseArrayFx, "C API: Test parallel sparse reads", "[sparse]") {
+  int64_t domain_size = 40;
+  set_array_name("sparse_test_parallel");
+  create_sparse_array_var_2D(domain_size, 10, 30, TILEDB_GZIP);
+  write_sparse_array_var_2D(domain_size, 0, 24, 0);
+  write_sparse_array_var_2D(domain_size, 16, 39, 100000);
+  write_sparse_array_var_2D(domain_size, 8, 11, 200000);
+
+  tiledb_layout_t layout = TILEDB_GLOBAL_ORDER;
+  SECTION("- global order") {
+    layout = TILEDB_GLOBAL_ORDER;
+  }
+
+  SECTION("- row-major") {
+    layout = TILEDB_ROW_MAJOR;
+  }
+
+  const int64_t subarray[] = {3, 37, 5, 38};
+  uint64_t cell_num = 35 * 34;
+  std::vector<int> serial_a;
+  std::vector<std::string> serial_b;
+  CHECK(
+      read_sparse_array_var_2D(
+          subarray, layout, 1, cell_num, &serial_a, &serial_b) == 1);
+  REQUIRE(serial_a.size() == cell_num);
+  REQUIRE(serial_b.size() == cell_num);
+  CHECK(serial_a[0] == 3 * domain_size + 5);
+  CHECK(serial_b[0] == "vvv");
+
+  // Buffers that fit all the results
+  std::vector<int> a;
+  std::vector<std::string> b;
+  CHECK(read_sparse_array_var_2D(subarray, layout, 4, cell_num, &a, &b) == 1);
+  CHECK(a == serial_a);
+  CHECK(b == serial_b);
+
+  // Buffers that overflow
+  a.clear();
+  b.clear();
+  CHECK(read_sparse_array_var_2D(subarray, layout, 4, 17, &a, &b) > 1);
+  CHECK(a == serial_a);
+  CHECK(b == serial_b);
+}
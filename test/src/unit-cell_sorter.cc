@@ -0,0 +1,157 @@
+#include <catch.hpp>
+#include <cell_sorter.h>
+#include <comparators.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace tiledb;
+
+template <class T>
+static void init_domain(
+    Domain* domain,
+    const std::vector<T>& coords,
+    unsigned int dim_num,
+    Layout cell_order) {
+  // The dimension domains are the ranges of the coordinates
+  for (unsigned int d = 0; d < dim_num; ++d) {
+    T dim_domain[2] = {coords[d], coords[d]};
+    for (uint64_t i = d; i < coords.size(); i += dim_num) {
+      dim_domain[0] = std::min(dim_domain[0], coords[i]);
+      dim_domain[1] = std::max(dim_domain[1], coords[i]);
+    }
+    auto name = std::string("d") + std::to_string(d);
+    REQUIRE(domain->add_dimension(name.c_str(), dim_domain, nullptr).ok());
+  }
+  REQUIRE(domain->init(cell_order, Layout::ROW_MAJOR).ok());
+}
+
+template <class T>
+static void check_sort(
+    ThreadPool* thread_pool,
+    Datatype type,
+    const std::vector<T>& coords,
+    unsigned int dim_num,
+    Layout cell_order,
+    const std::vector<uint64_t>* ids) {
+  uint64_t cell_num = coords.size() / dim_num;
+  Domain domain(type);
+  init_domain(&domain, coords, dim_num, cell_order);
+  CellSorter cell_sorter(thread_pool, &domain, cell_order);
+  std::vector<uint64_t> cell_pos;
+  REQUIRE(cell_sorter.sort(coords.data(), cell_num, ids, &cell_pos).ok());
+
+  // The cells are a permutation in the order of the comparators
+  std::vector<uint64_t> sorted(cell_pos), expected(cell_num);
+  std::sort(sorted.begin(), sorted.end());
+  std::iota(expected.begin(), expected.end(), 0);
+  CHECK(sorted == expected);
+  if (cell_order == Layout::HILBERT)
+    CHECK(std::is_sorted(
+        cell_pos.begin(), cell_pos.end(), [&](uint64_t a, uint64_t b) {
+          if (ids != nullptr && (*ids)[a] != (*ids)[b])
+            return (*ids)[a] < (*ids)[b];
+          return domain.cell_order_cmp(
+                     &coords[a * dim_num], &coords[b * dim_num]) < 0;
+        }));
+  else if (ids == nullptr && cell_order == Layout::ROW_MAJOR)
+    CHECK(std::is_sorted(
+        cell_pos.begin(),
+        cell_pos.end(),
+        SmallerRow<T>(coords.data(), dim_num)));
+  else if (ids == nullptr)
+    CHECK(std::is_sorted(
+        cell_pos.begin(),
+        cell_pos.end(),
+        SmallerCol<T>(coords.data(), dim_num)));
+  else if (cell_order == Layout::ROW_MAJOR)
+    CHECK(std::is_sorted(
+        cell_pos.begin(),
+        cell_pos.end(),
+        SmallerIdRow<T>(coords.data(), dim_num, *ids)));
+  else
+    CHECK(std::is_sorted(
+        cell_pos.begin(),
+        cell_pos.end(),
+        SmallerIdCol<T>(coords.data(), dim_num, *ids)));
+}
+
+template <class T, class D>
+static void check_sorts(
+    ThreadPool* thread_pool, Datatype type, D distribution) {
+  const unsigned int dim_num = 3;
+  const uint64_t cell_num = 200000;
+  std::mt19937 gen(7);
+  std::vector<T> coords(cell_num * dim_num);
+  std::vector<uint64_t> ids(cell_num);
+  for (auto& c : coords)
+    c = (T)distribution(gen);
+  for (auto& id : ids)
+    id = gen() % 100;
+
+  for (auto cell_order :
+       {Layout::ROW_MAJOR, Layout::COL_MAJOR, Layout::HILBERT}) {
+    check_sort(thread_pool, type, coords, dim_num, cell_order, nullptr);
+    check_sort(thread_pool, type, coords, dim_num, cell_order, &ids);
+  }
+}
+
+TEST_CASE("CellSorter: Test sort", "[cellsorter]") {
+  ThreadPool thread_pool;
+  REQUIRE(thread_pool.set_thread_num(4).ok());
+
+  check_sorts<int>(
+      &thread_pool,
+      Datatype::INT32,
+      std::uniform_int_distribution<int>(-50, 50));
+  check_sorts<int8_t>(
+      &thread_pool,
+      Datatype::INT8,
+      std::uniform_int_distribution<int>(-128, 127));
+  check_sorts<uint64_t>(
+      &thread_pool,
+      Datatype::UINT64,
+      std::uniform_int_distribution<uint64_t>(1000, 5000));
+  check_sorts<float>(
+      &thread_pool,
+      Datatype::FLOAT32,
+      std::uniform_real_distribution<float>(-10, 10));
+
+  // Keys beyond 64 bits fall back to the comparators
+  check_sorts<double>(
+      &thread_pool,
+      Datatype::FLOAT64,
+      std::uniform_real_distribution<double>(-1e6, 1e6));
+  check_sorts<int64_t>(
+      &thread_pool,
+      Datatype::INT64,
+      std::uniform_int_distribution<int64_t>(INT64_MIN, INT64_MAX));
+}
+
+TEST_CASE("CellSorter: Test stability", "[cellsorter]") {
+  ThreadPool thread_pool;
+  REQUIRE(thread_pool.set_thread_num(2).ok());
+
+  // Cells with equal coordinates keep their input order
+  std::vector<int> coords;
+  for (int i = 0; i < 300000; ++i) {
+    coords.push_back(i % 3);
+    coords.push_back(-(i % 5));
+  }
+  Domain domain(Datatype::INT32);
+  init_domain(&domain, coords, 2, Layout::ROW_MAJOR);
+  CellSorter cell_sorter(&thread_pool, &domain, Layout::ROW_MAJOR);
+  std::vector<uint64_t> cell_pos;
+  REQUIRE(cell_sorter.sort(coords.data(), 300000, nullptr, &cell_pos).ok());
+  bool stable = true;
+  for (uint64_t i = 1; i < cell_pos.size(); ++i) {
+    auto a = &coords[2 * cell_pos[i - 1]];
+    auto b = &coords[2 * cell_pos[i]];
+    if (a[0] == b[0] && a[1] == b[1] && cell_pos[i - 1] > cell_pos[i])
+      stable = false;
+  }
+  CHECK(stable);
+}
@@ -35,7 +35,10 @@
 #include "catch.hpp"
 #include "dd_compressor.h"
 
+#include <cstring>
+#include <ctime>
 #include <iostream>
+#include <vector>
 
 TEST_CASE("Compression-DoubleDelta: Test 1-element case", "[double-delta]") {
   // Compress
@@ -196,3 +199,102 @@ TEST_CASE("Compression-DoubleDelta: Test n-element case", "[double-delta]") {
   delete decomp_out_buff;
   delete[] data;
 }
+
+TEST_CASE(
+    "Compression-DoubleDelta: Test previous format", "[double-delta]") {
+  // Values 1, 2, 4, 7, 11 have double deltas 1, 1, 1, each written as a
+  // sign bit and a 1-bit absolute value, starting from the MSB of a chunk
+  int data[] = {1, 2, 4, 7, 11};
+  char bitsize = 1;
+  uint64_t num = 5;
+  uint64_t chunk = uint64_t(0x15) << 58;
+  auto comp_out_buff = new tiledb::Buffer();
+  REQUIRE(comp_out_buff->write(&bitsize, sizeof(char)).ok());
+  REQUIRE(comp_out_buff->write(&num, sizeof(uint64_t)).ok());
+  REQUIRE(comp_out_buff->write(data, 2 * sizeof(int)).ok());
+  REQUIRE(comp_out_buff->write(&chunk, sizeof(uint64_t)).ok());
+
+  // Decompress
+  auto decomp_in_buff =
+      new tiledb::ConstBuffer(comp_out_buff->data(), comp_out_buff->size());
+  auto decomp_out_buff = new tiledb::Buffer();
+  auto st = tiledb::DoubleDelta::decompress(
+      tiledb::Datatype::INT32, decomp_in_buff, decomp_out_buff);
+  REQUIRE(st.ok());
+
+  // Check data
+  REQUIRE(decomp_out_buff->size() == sizeof(data));
+  REQUIRE(std::memcmp(decomp_out_buff->data(), data, sizeof(data)) == 0);
+
+  // Clean up
+  delete comp_out_buff;
+  delete decomp_in_buff;
+  delete decomp_out_buff;
+}
+
+/**
+ * Compresses and decompresses values, which start from *start* and advance
+ * by a step that varies by up to *jitter*.
+ */
+template <class T>
+static void check_round_trip(
+    tiledb::Datatype type, uint64_t n, T start, int64_t jitter) {
+  std::vector<T> data(n);
+  uint64_t step = 1000;
+  data[0] = start;
+  for (uint64_t i = 1; i < n; ++i) {
+    int64_t r = ((int64_t)std::rand() << 31) | std::rand();
+    step += (uint64_t)(r % (2 * jitter + 1) - jitter);
+    data[i] = (T)(data[i - 1] + step);
+  }
+
+  // Compress
+  auto comp_in_buff = new tiledb::ConstBuffer(&data[0], n * sizeof(T));
+  auto comp_out_buff = new tiledb::Buffer();
+  auto st = tiledb::DoubleDelta::compress(type, comp_in_buff, comp_out_buff);
+  REQUIRE(st.ok());
+  CHECK(
+      comp_out_buff->size() <=
+      n * sizeof(T) + tiledb::DoubleDelta::overhead(n * sizeof(T)));
+
+  // Decompress
+  auto decomp_in_buff =
+      new tiledb::ConstBuffer(comp_out_buff->data(), comp_out_buff->size());
+  auto decomp_out_buff = new tiledb::Buffer();
+  st = tiledb::DoubleDelta::decompress(type, decomp_in_buff, decomp_out_buff);
+  REQUIRE(st.ok());
+
+  // Check data
+  REQUIRE(decomp_out_buff->size() == n * sizeof(T));
+  REQUIRE(std::memcmp(&data[0], decomp_out_buff->data(), n * sizeof(T)) == 0);
+
+  // Clean up
+  delete comp_in_buff;
+  delete comp_out_buff;
+  delete decomp_in_buff;
+  delete decomp_out_buff;
+}
+
+TEST_CASE(
+    "Compression-DoubleDelta: Test blocks and datatypes", "[double-delta]") {
+  std::srand(std::time(0));
+
+  // Around the block boundaries, with constant and varying steps
+  for (uint64_t n : {3, 4, 255, 257, 258, 259, 514, 1000, 4099}) {
+    check_round_trip<int64_t>(tiledb::Datatype::INT64, n, 1500000000000, 0);
+    check_round_trip<int64_t>(tiledb::Datatype::INT64, n, -(1LL << 40), 50);
+    check_round_trip<int>(tiledb::Datatype::INT32, n, 7, 3);
+  }
+
+  // Values that wrap around and double deltas that need all bits
+  check_round_trip<uint64_t>(
+      tiledb::Datatype::UINT64, 10000, ~uint64_t(0) - 5000, 20);
+  check_round_trip<int64_t>(
+      tiledb::Datatype::INT64, 10000, 0, int64_t(1) << 61);
+  check_round_trip<uint32_t>(tiledb::Datatype::UINT32, 10000, 5, 1 << 20);
+  check_round_trip<int16_t>(tiledb::Datatype::INT16, 10000, -300, 2);
+  check_round_trip<uint16_t>(tiledb::Datatype::UINT16, 10000, 300, 200);
+  check_round_trip<int8_t>(tiledb::Datatype::INT8, 10000, 1, 0);
+  check_round_trip<uint8_t>(tiledb::Datatype::UINT8, 10000, 1, 100);
+  check_round_trip<char>(tiledb::Datatype::CHAR, 10000, 'a', 1);
+}
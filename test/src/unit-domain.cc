@@ -0,0 +1,92 @@
+#include <catch.hpp>
+#include <domain.h>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace tiledb;
+
+/** Interleaves the bits of the tile coordinates, first dimension first. */
+static uint64_t morton_code(const std::vector<int64_t>& tile_coords) {
+  uint64_t code = 0;
+  auto dim_num = (unsigned int)tile_coords.size();
+  for (unsigned int b = 64 / dim_num; b-- > 0;) {
+    for (unsigned int i = 0; i < dim_num; ++i)
+      code = (code << 1) | (((uint64_t)tile_coords[i] >> b) & 1);
+  }
+  return code;
+}
+
+static void check_morton(
+    const std::vector<int64_t>& tile_nums,
+    const std::vector<int64_t>& sub_tile_domain) {
+  const int64_t tile_extent = 3;
+  auto dim_num = (unsigned int)tile_nums.size();
+
+  Domain domain(Datatype::INT64);
+  for (unsigned int i = 0; i < dim_num; ++i) {
+    int64_t dim_domain[] = {0, tile_nums[i] * tile_extent - 1};
+    auto name = std::string("d") + std::to_string(i);
+    REQUIRE(domain.add_dimension(name.c_str(), dim_domain, &tile_extent).ok());
+  }
+  REQUIRE(domain.init(Layout::ROW_MAJOR, Layout::MORTON).ok());
+
+  // The tiles of the sub-domain, sorted on their Morton codes
+  std::vector<std::vector<int64_t>> expected;
+  std::vector<int64_t> tile_coords(dim_num);
+  for (unsigned int i = 0; i < dim_num; ++i)
+    tile_coords[i] = sub_tile_domain[2 * i];
+  for (;;) {
+    expected.push_back(tile_coords);
+    unsigned int i = dim_num - 1;
+    for (; ++tile_coords[i] > sub_tile_domain[2 * i + 1] && i > 0; --i)
+      tile_coords[i] = sub_tile_domain[2 * i];
+    if (tile_coords[0] > sub_tile_domain[1])
+      break;
+  }
+  std::sort(
+      expected.begin(),
+      expected.end(),
+      [](const std::vector<int64_t>& a, const std::vector<int64_t>& b) {
+        return morton_code(a) < morton_code(b);
+      });
+
+  // The tiles are visited in Morton order, and their positions in the
+  // sub-domain follow the visiting order
+  std::vector<int64_t> sub_domain(2 * dim_num);
+  for (unsigned int i = 0; i < dim_num; ++i) {
+    sub_domain[2 * i] = sub_tile_domain[2 * i] * tile_extent;
+    sub_domain[2 * i + 1] = (sub_tile_domain[2 * i + 1] + 1) * tile_extent - 1;
+  }
+  std::vector<std::vector<int64_t>> visited;
+  bool positions_ok = true;
+  for (unsigned int i = 0; i < dim_num; ++i)
+    tile_coords[i] = sub_tile_domain[2 * i];
+  while (tile_coords[0] <= sub_tile_domain[1] &&
+         visited.size() <= expected.size()) {
+    std::vector<int64_t> tile_coords_norm(dim_num);
+    for (unsigned int i = 0; i < dim_num; ++i)
+      tile_coords_norm[i] = tile_coords[i] - sub_tile_domain[2 * i];
+    if (domain.get_tile_pos(sub_domain.data(), tile_coords_norm.data()) !=
+        visited.size())
+      positions_ok = false;
+    visited.push_back(tile_coords);
+    domain.get_next_tile_coords(sub_tile_domain.data(), tile_coords.data());
+  }
+  CHECK(visited == expected);
+  CHECK(positions_ok);
+}
+
+TEST_CASE("Domain: Test Morton tile order", "[domain]") {
+  // Whole domains, with tile grids that are not powers of two
+  check_morton({7, 12}, {0, 6, 0, 11});
+  check_morton({5, 6, 3}, {0, 4, 0, 5, 0, 2});
+  check_morton({3, 4, 2, 5}, {0, 2, 0, 3, 0, 1, 0, 4});
+
+  // Sub-domains, as those of fragments
+  check_morton({16, 16}, {3, 9, 5, 13});
+  check_morton({10, 10, 10}, {1, 6, 2, 2, 4, 9});
+  check_morton({6, 6, 6, 6}, {1, 3, 2, 5, 0, 0, 3, 4});
+}
@@ -0,0 +1,36 @@
+#include <catch.hpp>
+#include <fd_cache.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
+
+using namespace tiledb;
+
+TEST_CASE("FDCache: Test destruction with descriptors in use", "[fd_cache]") {
+  char cwd[PATH_MAX];
+  REQUIRE(getcwd(cwd, PATH_MAX) != nullptr);
+  std::string filename_1 = std::string(cwd) + "/fd_cache_test_1.tdb";
+  std::string filename_2 = std::string(cwd) + "/fd_cache_test_2.tdb";
+  for (auto& filename : {filename_1, filename_2}) {
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU);
+    REQUIRE(fd != -1);
+    close(fd);
+  }
+
+  // The second descriptor evicts the first while it is still in use, and
+  // the cache is destroyed with both of them acquired
+  auto fd_cache = new FDCache(1);
+  int fd_1, fd_2;
+  REQUIRE(fd_cache->acquire(filename_1, FDCache::Mode::READ, &fd_1).ok());
+  REQUIRE(fd_cache->acquire(filename_2, FDCache::Mode::READ, &fd_2).ok());
+  CHECK(fd_1 != fd_2);
+  delete fd_cache;
+
+  // Both descriptors were closed exactly once
+  CHECK(fcntl(fd_1, F_GETFD) == -1);
+  CHECK(fcntl(fd_2, F_GETFD) == -1);
+
+  unlink(filename_1.c_str());
+  unlink(filename_2.c_str());
+}
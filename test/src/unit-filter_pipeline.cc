@@ -0,0 +1,93 @@
+#include <catch.hpp>
+#include <filter_pipeline.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace tiledb;
+
+/** Runs the filters forward and in reverse, and checks the round trip. */
+template <class T>
+static void check_round_trip(
+    const std::vector<Filter>& filters, Datatype type, uint64_t extra_bytes) {
+  // Slowly growing values with some noise, followed by a few trailing bytes
+  const uint64_t value_num = 1000;
+  uint64_t nbytes = value_num * sizeof(T) + extra_bytes;
+  std::vector<char> data(nbytes);
+  for (uint64_t i = 0; i < value_num; ++i) {
+    auto value = (T)(i * 3 + (i * 7919) % 5);
+    std::memcpy(&data[i * sizeof(T)], &value, sizeof(T));
+  }
+  for (uint64_t i = value_num * sizeof(T); i < nbytes; ++i)
+    data[i] = (char)(i * 31);
+
+  ConstBuffer input(data.data(), nbytes);
+  Buffer filtered;
+  REQUIRE(FilterPipeline::run_forward(filters, type, &input, &filtered).ok());
+  CHECK(filtered.size() == nbytes);
+
+  ConstBuffer filtered_input(&filtered);
+  Buffer output;
+  REQUIRE(FilterPipeline::run_reverse(filters, type, &filtered_input, &output)
+              .ok());
+  REQUIRE(output.size() == nbytes);
+  CHECK(std::memcmp(output.data(), data.data(), nbytes) == 0);
+}
+
+TEST_CASE("FilterPipeline: Test shuffle layouts", "[filter_pipeline]") {
+  std::vector<int> values(8, 1);
+  ConstBuffer input(values.data(), values.size() * sizeof(int));
+
+  // Byte shuffle: the least significant bytes come first
+  Buffer byte_shuffled;
+  REQUIRE(FilterPipeline::run_forward(
+              {Filter::BYTESHUFFLE}, Datatype::INT32, &input, &byte_shuffled)
+              .ok());
+  auto bytes = static_cast<unsigned char*>(byte_shuffled.data());
+  for (unsigned int i = 0; i < 32; ++i)
+    CHECK(bytes[i] == (i < 8 ? 1 : 0));
+
+  // Bit shuffle: the least significant bits of the 8 values fill one byte
+  ConstBuffer bit_input(values.data(), values.size() * sizeof(int));
+  Buffer bit_shuffled;
+  REQUIRE(FilterPipeline::run_forward(
+              {Filter::BITSHUFFLE}, Datatype::INT32, &bit_input, &bit_shuffled)
+              .ok());
+  bytes = static_cast<unsigned char*>(bit_shuffled.data());
+  CHECK(bytes[0] == 0xFF);
+  for (unsigned int i = 1; i < 32; ++i)
+    CHECK(bytes[i] == 0);
+
+  // Delta: the first value is kept, the rest become zero
+  ConstBuffer delta_input(values.data(), values.size() * sizeof(int));
+  Buffer deltas;
+  REQUIRE(FilterPipeline::run_forward(
+              {Filter::DELTA}, Datatype::INT32, &delta_input, &deltas)
+              .ok());
+  auto delta_values = static_cast<int*>(deltas.data());
+  CHECK(delta_values[0] == 1);
+  for (unsigned int i = 1; i < 8; ++i)
+    CHECK(delta_values[i] == 0);
+}
+
+TEST_CASE("FilterPipeline: Test round trips", "[filter_pipeline]") {
+  std::vector<std::vector<Filter>> pipelines = {
+      {},
+      {Filter::DELTA},
+      {Filter::BYTESHUFFLE},
+      {Filter::BITSHUFFLE},
+      {Filter::DELTA, Filter::BITSHUFFLE},
+      {Filter::DELTA, Filter::BYTESHUFFLE, Filter::BITSHUFFLE},
+  };
+
+  for (auto& filters : pipelines) {
+    for (uint64_t extra_bytes : {0, 1, 7}) {
+      check_round_trip<int8_t>(filters, Datatype::INT8, extra_bytes);
+      check_round_trip<uint16_t>(filters, Datatype::UINT16, extra_bytes);
+      check_round_trip<int32_t>(filters, Datatype::INT32, extra_bytes);
+      check_round_trip<float>(filters, Datatype::FLOAT32, extra_bytes);
+      check_round_trip<int64_t>(filters, Datatype::INT64, extra_bytes);
+      check_round_trip<double>(filters, Datatype::FLOAT64, extra_bytes);
+    }
+  }
+}
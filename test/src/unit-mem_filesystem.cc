@@ -0,0 +1,109 @@
+#include <catch.hpp>
+#include <mem_filesystem.h>
+
+#include <unistd.h>
+#include <climits>
+#include <cstring>
+#include <thread>
+
+using namespace tiledb;
+
+TEST_CASE("MemFilesystem: Test directories and files", "[mem_filesystem]") {
+  MemFilesystem mem_fs;
+  Status st;
+
+  CHECK(mem_fs.is_dir("/"));
+  CHECK(mem_fs.create_dir("/a").ok());
+  CHECK(!mem_fs.create_dir("/a").ok());
+  CHECK(!mem_fs.create_dir("/b/c").ok());
+  CHECK(mem_fs.create_dir("/a/b").ok());
+  CHECK(mem_fs.create_file("/a/f").ok());
+  CHECK(mem_fs.is_file("/a/f"));
+  CHECK(!mem_fs.is_dir("/a/f"));
+
+  // Append and read
+  const char data[] = "0123456789";
+  CHECK(mem_fs.write_to_file("/a/b/g", data, 5).ok());
+  CHECK(mem_fs.write_to_file("/a/b/g", data + 5, 5).ok());
+  uint64_t size;
+  CHECK(mem_fs.file_size("/a/b/g", &size).ok());
+  CHECK(size == 10);
+  char result[10];
+  CHECK(mem_fs.read_from_file("/a/b/g", 2, result, 8).ok());
+  CHECK(std::memcmp(result, data + 2, 8) == 0);
+  CHECK(!mem_fs.read_from_file("/a/b/g", 4, result, 8).ok());
+  CHECK(mem_fs.truncate_file("/a/b/g", 3).ok());
+  CHECK(mem_fs.file_size("/a/b/g", &size).ok());
+  CHECK(size == 3);
+
+  // List
+  std::vector<std::string> paths;
+  CHECK(mem_fs.ls("/a", &paths).ok());
+  CHECK(paths == std::vector<std::string>({"/a/b", "/a/f"}));
+
+  // Move
+  CHECK(!mem_fs.move_path("/a", "/a/b/c").ok());
+  CHECK(mem_fs.move_path("/a/b", "/c").ok());
+  CHECK(mem_fs.is_file("/c/g"));
+  CHECK(!mem_fs.is_dir("/a/b"));
+
+  // Remove
+  CHECK(!mem_fs.remove_file("/c").ok());
+  CHECK(mem_fs.remove_file("/c/g").ok());
+  CHECK(mem_fs.remove_path("/a").ok());
+  CHECK(!mem_fs.is_file("/a/f"));
+  CHECK(!mem_fs.remove_path("/a").ok());
+}
+
+TEST_CASE("MemFilesystem: Test file locks", "[mem_filesystem]") {
+  MemFilesystem mem_fs;
+  CHECK(mem_fs.create_file("/lock").ok());
+
+  int fd1, fd2, fd3;
+  CHECK(mem_fs.filelock_lock("/lock", &fd1, true).ok());
+  CHECK(mem_fs.filelock_lock("/lock", &fd2, true).ok());
+
+  // The exclusive lock waits for the shared locks to be released
+  bool locked = false;
+  std::thread t([&]() {
+    CHECK(mem_fs.filelock_lock("/lock", &fd3, false).ok());
+    locked = true;
+    CHECK(mem_fs.filelock_unlock("/lock", fd3).ok());
+  });
+  CHECK(mem_fs.filelock_unlock("/lock", fd1).ok());
+  CHECK(mem_fs.filelock_unlock("/lock", fd2).ok());
+  t.join();
+  CHECK(locked);
+}
+
+TEST_CASE("MemFilesystem: Test spilling to disk", "[mem_filesystem]") {
+  char cwd[PATH_MAX];
+  REQUIRE(getcwd(cwd, PATH_MAX) != nullptr);
+
+  MemFilesystem mem_fs;
+  mem_fs.set_spill(100, cwd);
+
+  std::vector<char> data(300);
+  for (uint64_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i);
+  CHECK(mem_fs.write_to_file("/f", &data[0], 60).ok());
+  CHECK(mem_fs.write_to_file("/g", &data[0], 60).ok());
+  CHECK(mem_fs.write_to_file("/g", &data[60], 240).ok());
+
+  std::vector<char> result(data.size());
+  CHECK(mem_fs.read_from_file("/g", 0, &result[0], result.size()).ok());
+  CHECK(result == data);
+  CHECK(mem_fs.read_from_file("/f", 0, &result[0], 60).ok());
+  CHECK(std::memcmp(&result[0], &data[0], 60) == 0);
+  CHECK(mem_fs.truncate_file("/g", 10).ok());
+  uint64_t size;
+  CHECK(mem_fs.file_size("/g", &size).ok());
+  CHECK(size == 10);
+
+  // The spilled file is deleted along with the in-memory one
+  std::string spill_path = std::string(cwd) + "/__mem_" +
+                           std::to_string(getpid()) + "_0";
+  CHECK(access(spill_path.c_str(), F_OK) == 0);
+  CHECK(mem_fs.remove_file("/g").ok());
+  CHECK(access(spill_path.c_str(), F_OK) != 0);
+}
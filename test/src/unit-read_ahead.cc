@@ -0,0 +1,121 @@
+#include <catch.hpp>
+#include <constants.h>
+#include <read_ahead.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
+#include <cstring>
+
+using namespace tiledb;
+
+TEST_CASE("ReadAhead: Test sequential and random reads", "[read_ahead]") {
+  char cwd[PATH_MAX];
+  REQUIRE(getcwd(cwd, PATH_MAX) != nullptr);
+  std::string filename = std::string(cwd) + "/read_ahead_test.tdb";
+
+  // Create a file spanning several read-ahead windows
+  const uint64_t file_size = 4 * constants::read_ahead_max_size + 1000;
+  std::vector<char> data(file_size);
+  for (uint64_t i = 0; i < file_size; ++i)
+    data[i] = static_cast<char>(i % 251);
+  int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU);
+  REQUIRE(fd != -1);
+  REQUIRE(write(fd, &data[0], file_size) == int64_t(file_size));
+  close(fd);
+
+  FDCache fd_cache(4);
+  ReadAhead read_ahead(&fd_cache);
+
+  // Nothing is prefetched before the reads become sequential
+  const uint64_t read_size = 100000;
+  std::vector<char> result(read_size);
+  CHECK(!read_ahead.read(filename, 0, &result[0], read_size));
+  read_ahead.access(filename, 0, read_size);
+  CHECK(!read_ahead.read(filename, read_size, &result[0], read_size));
+  read_ahead.access(filename, read_size, read_size);
+
+  // Scan the rest of the file, which is served by the read-ahead engine
+  uint64_t served = 0;
+  for (uint64_t offset = 2 * read_size; offset < file_size;
+       offset += read_size) {
+    uint64_t nbytes = std::min(read_size, file_size - offset);
+    if (read_ahead.read(filename, offset, &result[0], nbytes)) {
+      CHECK(std::memcmp(&result[0], &data[offset], nbytes) == 0);
+      ++served;
+    }
+    read_ahead.access(filename, offset, nbytes);
+  }
+  CHECK(served == (file_size - 1) / read_size - 1);
+
+  // A random read drops the prefetched data
+  read_ahead.access(filename, 1000, read_size);
+  CHECK(!read_ahead.read(filename, 1000 + read_size, &result[0], read_size));
+
+  // Invalidation drops the file state
+  read_ahead.access(filename, 1000 + read_size, read_size);
+  read_ahead.access(filename, 1000 + 2 * read_size, read_size);
+  read_ahead.invalidate(filename);
+  CHECK(!read_ahead.read(filename, 1000 + 3 * read_size, &result[0], 10));
+
+  unlink(filename.c_str());
+}
+
+TEST_CASE("ReadAhead: Test queued prefetches", "[read_ahead]") {
+  char cwd[PATH_MAX];
+  REQUIRE(getcwd(cwd, PATH_MAX) != nullptr);
+  std::string filenames[] = {std::string(cwd) + "/read_ahead_test_a.tdb",
+                             std::string(cwd) + "/read_ahead_test_b.tdb"};
+
+  const uint64_t file_size = 2 * constants::read_ahead_max_size;
+  std::vector<char> data(file_size);
+  for (uint64_t i = 0; i < file_size; ++i)
+    data[i] = static_cast<char>(i % 251);
+  for (auto& filename : filenames) {
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU);
+    REQUIRE(fd != -1);
+    REQUIRE(write(fd, &data[0], file_size) == int64_t(file_size));
+    close(fd);
+  }
+
+  FDCache fd_cache(4);
+  auto read_ahead = new ReadAhead(&fd_cache);
+  const uint64_t read_size = 100000;
+  std::vector<char> result(read_size);
+
+  SECTION("- reads behind the prefetches of other files") {
+    // The chunks of the second file are queued behind those of the first,
+    // and are fetched by the reader instead
+    for (auto& filename : filenames) {
+      read_ahead->access(filename, 0, read_size);
+      read_ahead->access(filename, read_size, read_size);
+    }
+    for (uint64_t offset = 2 * read_size; offset < 20 * read_size;
+         offset += read_size) {
+      REQUIRE(read_ahead->read(filenames[1], offset, &result[0], read_size));
+      CHECK(std::memcmp(&result[0], &data[offset], read_size) == 0);
+      read_ahead->access(filenames[1], offset, read_size);
+    }
+  }
+
+  SECTION("- disabled prefetching") {
+    read_ahead->access(filenames[0], 0, read_size);
+    read_ahead->access(filenames[0], read_size, read_size);
+    read_ahead->set_enabled(false);
+    CHECK(!read_ahead->read(filenames[0], 2 * read_size, &result[0], 10));
+    read_ahead->access(filenames[0], 2 * read_size, read_size);
+    read_ahead->access(filenames[0], 3 * read_size, read_size);
+    CHECK(!read_ahead->read(filenames[0], 4 * read_size, &result[0], 10));
+    read_ahead->set_enabled(true);
+  }
+
+  // The queued prefetches are discarded upon destruction
+  for (auto& filename : filenames) {
+    read_ahead->access(filename, 0, read_size);
+    read_ahead->access(filename, read_size, read_size);
+  }
+  delete read_ahead;
+
+  for (auto& filename : filenames)
+    unlink(filename.c_str());
+}
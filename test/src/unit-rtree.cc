@@ -0,0 +1,76 @@
+#include <catch.hpp>
+#include <rtree.h>
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace tiledb;
+
+template <class T>
+static void check_rtree(Datatype type, unsigned int fanout) {
+  const unsigned int dim_num = 2;
+  const uint64_t tile_num = 1000;
+  std::mt19937 gen(17);
+  std::uniform_int_distribution<int> coord(0, 999);
+  std::uniform_int_distribution<int> extent(0, 20);
+
+  // Tiles in row-major order, each covering a few rows
+  std::vector<void*> mbrs;
+  for (uint64_t i = 0; i < tile_num; ++i) {
+    auto mbr = static_cast<T*>(std::malloc(2 * dim_num * sizeof(T)));
+    mbr[0] = (T)i;
+    mbr[1] = (T)(i + extent(gen) / 10);
+    mbr[2] = (T)coord(gen);
+    mbr[3] = mbr[2] + (T)extent(gen);
+    mbrs.push_back(mbr);
+  }
+
+  RTree rtree(type, dim_num, fanout);
+  REQUIRE(rtree.build(&mbrs).ok());
+
+  // The tree returns exactly the tiles that a linear scan finds
+  for (int q = 0; q < 100; ++q) {
+    T subarray[4];
+    subarray[0] = (T)coord(gen);
+    subarray[1] = subarray[0] + (T)extent(gen);
+    subarray[2] = (T)coord(gen);
+    subarray[3] = subarray[2] + (T)(10 * extent(gen));
+
+    std::vector<uint64_t> expected;
+    for (uint64_t i = 0; i < tile_num; ++i) {
+      auto mbr = static_cast<const T*>(mbrs[i]);
+      if (mbr[0] <= subarray[1] && mbr[1] >= subarray[0] &&
+          mbr[2] <= subarray[3] && mbr[3] >= subarray[2])
+        expected.push_back(i);
+    }
+
+    std::vector<uint64_t> tile_pos;
+    rtree.query(subarray, &tile_pos);
+    CHECK(tile_pos == expected);
+  }
+
+  for (auto mbr : mbrs)
+    std::free(mbr);
+}
+
+TEST_CASE("RTree: Test query", "[rtree]") {
+  check_rtree<int>(Datatype::INT32, 16);
+  check_rtree<double>(Datatype::FLOAT64, 4);
+  check_rtree<uint64_t>(Datatype::UINT64, 2);
+}
+
+TEST_CASE("RTree: Test single tile", "[rtree]") {
+  int mbr[] = {1, 4, 1, 4};
+  std::vector<void*> mbrs = {mbr};
+  RTree rtree(Datatype::INT32, 2, 16);
+  REQUIRE(rtree.build(&mbrs).ok());
+
+  int overlapping[] = {4, 10, 0, 1};
+  int disjoint[] = {5, 10, 0, 1};
+  std::vector<uint64_t> tile_pos;
+  rtree.query(overlapping, &tile_pos);
+  CHECK(tile_pos == std::vector<uint64_t>{0});
+  rtree.query(disjoint, &tile_pos);
+  CHECK(tile_pos.empty());
+}
@@ -0,0 +1,497 @@
+#include <array_metadata.h>
+#include <catch.hpp>
+#include <fragment_metadata.h>
+#include <posix_filesystem.h>
+#include <storage_manager.h>
+#include <tiledb.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace tiledb;
+
+/**
+ * Creates and writes 2D arrays through the C API, and opens read queries on
+ * them through a separate storage manager, whose internal state (e.g., the
+ * fragments and read states of a query) can then be inspected.
+ */
+struct StorageManagerFx {
+  // The 4x4 domain of the arrays, with 2x2 space tiles
+  const int64_t DIM_DOMAIN[4] = {1, 4, 1, 4};
+  const int64_t TILE_EXTENT = 2;
+
+  // The directory of the arrays
+  const std::string TEMP_DIR =
+      tiledb::posix::current_dir() + "/storage_manager_test/";
+
+  // TileDB context that creates and writes the arrays
+  tiledb_ctx_t* ctx_;
+
+  // Storage manager that runs the read queries
+  StorageManager storage_manager_;
+
+  // The buffer of the read queries
+  std::vector<int> buffer_a_;
+  void* buffers_[1];
+  uint64_t buffer_sizes_[1];
+
+  StorageManagerFx() {
+    REQUIRE(tiledb_ctx_create(&ctx_) == TILEDB_OK);
+    REQUIRE(storage_manager_.init().ok());
+    REQUIRE(system(("rm -rf " + TEMP_DIR).c_str()) == 0);
+    REQUIRE(tiledb_group_create(ctx_, TEMP_DIR.c_str()) == TILEDB_OK);
+    buffer_a_.resize(16);
+  }
+
+  ~StorageManagerFx() {
+    tiledb_ctx_free(ctx_);
+    CHECK(system(("rm -rf " + TEMP_DIR).c_str()) == 0);
+  }
+
+  /**
+   * Creates an array over the 4x4 domain, with a single int32 attribute,
+   * in row-major tile and cell order.
+   *
+   * @param array_name The array name (within the test directory).
+   * @param array_type The array type.
+   * @param capacity The tile capacity (for sparse arrays).
+   * @param attribute_name The attribute name.
+   */
+  void create_array(
+      const std::string& array_name,
+      tiledb_array_type_t array_type,
+      uint64_t capacity,
+      const char* attribute_name = "a") {
+    tiledb_attribute_t* a;
+    REQUIRE(
+        tiledb_attribute_create(ctx_, &a, attribute_name, TILEDB_INT32) ==
+        TILEDB_OK);
+    tiledb_domain_t* domain;
+    REQUIRE(tiledb_domain_create(ctx_, &domain, TILEDB_INT64) == TILEDB_OK);
+    REQUIRE(
+        tiledb_domain_add_dimension(
+            ctx_, domain, "x", &DIM_DOMAIN[0], &TILE_EXTENT) == TILEDB_OK);
+    REQUIRE(
+        tiledb_domain_add_dimension(
+            ctx_, domain, "y", &DIM_DOMAIN[2], &TILE_EXTENT) == TILEDB_OK);
+    tiledb_array_metadata_t* array_metadata;
+    std::string uri = TEMP_DIR + array_name;
+    REQUIRE(
+        tiledb_array_metadata_create(ctx_, &array_metadata, uri.c_str()) ==
+        TILEDB_OK);
+    REQUIRE(
+        tiledb_array_metadata_set_array_type(
+            ctx_, array_metadata, array_type) == TILEDB_OK);
+    REQUIRE(
+        tiledb_array_metadata_set_capacity(ctx_, array_metadata, capacity) ==
+        TILEDB_OK);
+    REQUIRE(
+        tiledb_array_metadata_add_attribute(ctx_, array_metadata, a) ==
+        TILEDB_OK);
+    REQUIRE(
+        tiledb_array_metadata_set_domain(ctx_, array_metadata, domain) ==
+        TILEDB_OK);
+    REQUIRE(tiledb_array_create(ctx_, array_metadata) == TILEDB_OK);
+    tiledb_attribute_free(ctx_, a);
+    tiledb_domain_free(ctx_, domain);
+    tiledb_array_metadata_free(ctx_, array_metadata);
+  }
+
+  /**
+   * Writes a fragment with all the cells of a dense array, where each cell
+   * stores its position in the row-major order of the domain.
+   *
+   * @param array_name The array name (within the test directory).
+   */
+  void write_dense(const std::string& array_name) {
+    std::vector<int> a(16);
+    for (int i = 0; i < 16; ++i)
+      a[i] = i;
+    const char* attributes[] = {"a"};
+    void* buffers[] = {a.data()};
+    uint64_t buffer_sizes[] = {a.size() * sizeof(int)};
+    tiledb_query_t* query;
+    std::string uri = TEMP_DIR + array_name;
+    REQUIRE(
+        tiledb_query_create(
+            ctx_,
+            &query,
+            uri.c_str(),
+            TILEDB_WRITE,
+            TILEDB_ROW_MAJOR,
+            nullptr,
+            attributes,
+            1,
+            buffers,
+            buffer_sizes) == TILEDB_OK);
+    REQUIRE(tiledb_query_submit(ctx_, query) == TILEDB_OK);
+    REQUIRE(tiledb_query_free(ctx_, query) == TILEDB_OK);
+  }
+
+  /**
+   * Writes a fragment with the input cells to a sparse array, where each
+   * cell stores its position in the row-major order of the domain.
+   *
+   * @param array_name The array name (within the test directory).
+   * @param coords The cell coordinates.
+   */
+  void write_sparse(
+      const std::string& array_name, const std::vector<int64_t>& coords) {
+    std::vector<int> a;
+    for (size_t i = 0; i < coords.size(); i += 2)
+      a.push_back((int)((coords[i] - 1) * 4 + coords[i + 1] - 1));
+    const char* attributes[] = {"a", TILEDB_COORDS};
+    void* buffers[] = {a.data(), (void*)coords.data()};
+    uint64_t buffer_sizes[] = {a.size() * sizeof(int),
+                               coords.size() * sizeof(int64_t)};
+    tiledb_query_t* query;
+    std::string uri = TEMP_DIR + array_name;
+    REQUIRE(
+        tiledb_query_create(
+            ctx_,
+            &query,
+            uri.c_str(),
+            TILEDB_WRITE,
+            TILEDB_UNORDERED,
+            nullptr,
+            attributes,
+            2,
+            buffers,
+            buffer_sizes) == TILEDB_OK);
+    REQUIRE(tiledb_query_submit(ctx_, query) == TILEDB_OK);
+    REQUIRE(tiledb_query_free(ctx_, query) == TILEDB_OK);
+  }
+
+  /**
+   * Initializes a read query on attribute "a" of an array, without
+   * submitting it.
+   *
+   * @param array_name The array name (within the test directory).
+   * @param subarray The query subarray.
+   * @return The query, which must be finalized and deleted by the caller.
+   */
+  Query* open_query(
+      const std::string& array_name, const std::vector<int64_t>& subarray) {
+    Query* query;
+    REQUIRE(init_query(array_name, subarray, "a", &query).ok());
+    return query;
+  }
+
+  /**
+   * Initializes a read query on an attribute of an array, without
+   * submitting it.
+   *
+   * @param array_name The array name (within the test directory).
+   * @param subarray The query subarray.
+   * @param attribute_name The attribute name.
+   * @param query Set to the query, which must be finalized and deleted by
+   *     the caller if the initialization succeeds.
+   * @return Status
+   */
+  Status init_query(
+      const std::string& array_name,
+      const std::vector<int64_t>& subarray,
+      const char* attribute_name,
+      Query** query) {
+    const char* attributes[] = {attribute_name};
+    buffers_[0] = buffer_a_.data();
+    buffer_sizes_[0] = buffer_a_.size() * sizeof(int);
+    *query = new Query();
+    std::string uri = TEMP_DIR + array_name;
+    Status st = storage_manager_.query_init(
+        *query,
+        uri.c_str(),
+        QueryType::READ,
+        Layout::ROW_MAJOR,
+        subarray.data(),
+        attributes,
+        1,
+        buffers_,
+        buffer_sizes_);
+    if (!st.ok())
+      delete *query;
+    return st;
+  }
+
+  /**
+   * Returns the URI of the (single) fragment of an array.
+   *
+   * @param array_name The array name (within the test directory).
+   * @return The fragment URI.
+   */
+  URI fragment_uri(const std::string& array_name) {
+    std::vector<std::string> paths;
+    REQUIRE(posix::ls(TEMP_DIR + array_name, &paths).ok());
+    for (auto& path : paths) {
+      if (storage_manager_.is_fragment(URI(path)))
+        return URI(path);
+    }
+    FAIL("No fragment found");
+    return URI();
+  }
+
+  /** Finalizes and deletes a query returned by *open_query*. */
+  void close_query(Query* query) {
+    CHECK(storage_manager_.query_finalize(query).ok());
+    delete query;
+  }
+};
+
+TEST_CASE_METHOD(
+    StorageManagerFx,
+    "StorageManager: Test the tile read plan of dense fragments",
+    "[storage_manager]") {
+  create_array("dense", TILEDB_DENSE, 4);
+  write_dense("dense");
+
+  // A subarray within a single space tile
+  Query* query = open_query("dense", {1, 2, 3, 4});
+  REQUIRE(query->fragments().size() == 1);
+  auto read_state = query->fragments()[0]->read_state();
+  CHECK(read_state->overlapping_tiles() == std::vector<uint64_t>({1}));
+  close_query(query);
+
+  // A subarray that overlaps every space tile
+  query = open_query("dense", {2, 3, 2, 3});
+  read_state = query->fragments()[0]->read_state();
+  CHECK(read_state->overlapping_tiles() == std::vector<uint64_t>({0, 1, 2, 3}));
+  close_query(query);
+
+  // Two space tiles of the same tile column
+  query = open_query("dense", {1, 4, 4, 4});
+  read_state = query->fragments()[0]->read_state();
+  CHECK(read_state->overlapping_tiles() == std::vector<uint64_t>({1, 3}));
+  close_query(query);
+}
+
+TEST_CASE_METHOD(
+    StorageManagerFx,
+    "StorageManager: Test the tile read plan of sparse fragments",
+    "[storage_manager]") {
+  // With a capacity of 2, the data tiles in the global order hold cells
+  // (1,1)-(1,2), (2,1)-(2,2), (1,3)-(1,4), (2,3)-(2,4), (3,1)-(3,2), ...
+  create_array("sparse", TILEDB_SPARSE, 2);
+  std::vector<int64_t> coords;
+  for (int64_t i = 1; i <= 4; ++i) {
+    for (int64_t j = 1; j <= 4; ++j) {
+      coords.push_back(i);
+      coords.push_back(j);
+    }
+  }
+  write_sparse("sparse", coords);
+
+  // Only the data tiles whose MBR overlaps the subarray are planned
+  Query* query = open_query("sparse", {2, 3, 1, 2});
+  REQUIRE(query->fragments().size() == 1);
+  auto read_state = query->fragments()[0]->read_state();
+  CHECK(read_state->overlapping_tiles() == std::vector<uint64_t>({1, 4}));
+  close_query(query);
+
+  query = open_query("sparse", {1, 4, 4, 4});
+  read_state = query->fragments()[0]->read_state();
+  CHECK(read_state->overlapping_tiles() == std::vector<uint64_t>({2, 3, 6, 7}));
+  close_query(query);
+
+  query = open_query("sparse", {1, 1, 1, 1});
+  read_state = query->fragments()[0]->read_state();
+  CHECK(read_state->overlapping_tiles() == std::vector<uint64_t>({0}));
+  close_query(query);
+}
+
+TEST_CASE_METHOD(
+    StorageManagerFx,
+    "StorageManager: Test the metadata cache",
+    "[storage_manager]") {
+  std::vector<int64_t> coords = {1, 1, 2, 2, 3, 3, 4, 4};
+  for (auto name : {"array_a", "array_b"}) {
+    create_array(name, TILEDB_SPARSE, 2);
+    write_sparse(name, coords);
+  }
+  URI uri_a(TEMP_DIR + "array_a");
+  URI uri_b(TEMP_DIR + "array_b");
+  std::vector<int64_t> subarray = {1, 4, 1, 4};
+
+  // The metadata of a closed array are cached
+  close_query(open_query("array_a", subarray));
+  CHECK(storage_manager_.metadata_cached(uri_a));
+  uint64_t array_size = storage_manager_.metadata_cache_size();
+  CHECK(array_size > 0);
+
+  SECTION("- budget") {
+    // The least recently closed array is evicted
+    Config config;
+    config.set_metadata_cache_size(array_size * 3 / 2);
+    REQUIRE(storage_manager_.set_config(&config).ok());
+    close_query(open_query("array_b", subarray));
+    CHECK(!storage_manager_.metadata_cached(uri_a));
+    CHECK(storage_manager_.metadata_cached(uri_b));
+    CHECK(storage_manager_.metadata_cache_size() <= array_size * 3 / 2);
+  }
+
+  SECTION("- zero budget") {
+    Config config;
+    config.set_metadata_cache_size(0);
+    REQUIRE(storage_manager_.set_config(&config).ok());
+    close_query(open_query("array_b", subarray));
+    CHECK(!storage_manager_.metadata_cached(uri_a));
+    CHECK(!storage_manager_.metadata_cached(uri_b));
+    CHECK(storage_manager_.metadata_cache_size() == 0);
+  }
+
+  SECTION("- consolidation") {
+    // The metadata of the consolidated fragments are dropped
+    write_sparse("array_a", coords);
+    Query* query = open_query("array_a", subarray);
+    CHECK(query->fragment_metadata().size() == 2);
+    close_query(query);
+    REQUIRE(storage_manager_.array_consolidate(uri_a.to_string().c_str()).ok());
+    query = open_query("array_a", subarray);
+    CHECK(query->fragment_metadata().size() == 1);
+    close_query(query);
+  }
+
+  SECTION("- removal") {
+    REQUIRE(storage_manager_.remove_path(uri_a).ok());
+    CHECK(!storage_manager_.metadata_cached(uri_a));
+  }
+
+  SECTION("- array created again") {
+    // The array is deleted and created again with another attribute, behind
+    // the back of the storage manager
+    REQUIRE(tiledb_delete(ctx_, uri_a.to_string().c_str()) == TILEDB_OK);
+    create_array("array_a", TILEDB_SPARSE, 2, "attr_b");
+    Query* query;
+    CHECK(!init_query("array_a", subarray, "a", &query).ok());
+    REQUIRE(init_query("array_a", subarray, "attr_b", &query).ok());
+    CHECK(query->fragment_metadata().empty());
+    close_query(query);
+  }
+}
+
+TEST_CASE_METHOD(
+    StorageManagerFx,
+    "StorageManager: Test loading the fragment metadata on demand",
+    "[storage_manager]") {
+  // Three data tiles: (1,1)-(1,2), (2,1)-(3,3) and (4,4)
+  create_array("sparse", TILEDB_SPARSE, 2);
+  write_sparse("sparse", {1, 1, 1, 2, 2, 1, 3, 3, 4, 4});
+  ArrayMetadata array_metadata(URI(TEMP_DIR + "sparse"));
+  REQUIRE(storage_manager_.load(TEMP_DIR + "sparse", &array_metadata).ok());
+  FragmentMetadata metadata(&array_metadata, false, fragment_uri("sparse"));
+  REQUIRE(storage_manager_.load(&metadata).ok());
+
+  // Only the basic section is resident
+  CHECK(metadata.tile_num() == 3);
+  CHECK(metadata.last_tile_cell_num() == 1);
+  const int64_t non_empty_domain[] = {1, 4, 1, 4};
+  CHECK(
+      std::memcmp(
+          metadata.non_empty_domain(),
+          non_empty_domain,
+          sizeof(non_empty_domain)) == 0);
+  CHECK(metadata.mbrs().empty());
+  CHECK(metadata.bounding_coords().empty());
+  CHECK(metadata.tile_offsets()[0].empty());
+  CHECK(metadata.tile_offsets()[1].empty());
+
+  // The other sections are loaded on demand, one at a time
+  REQUIRE(metadata.load_tile_offsets(0).ok());
+  CHECK(metadata.tile_offsets()[0].size() == 3);
+  CHECK(metadata.tile_offsets()[1].empty());
+  CHECK(metadata.mbrs().empty());
+  REQUIRE(metadata.load_mbrs().ok());
+  REQUIRE(metadata.mbrs().size() == 3);
+  const int64_t mbr[] = {1, 1, 1, 2};
+  CHECK(std::memcmp(metadata.mbrs()[0], mbr, sizeof(mbr)) == 0);
+  CHECK(metadata.bounding_coords().empty());
+  CHECK(metadata.tile_offsets()[1].empty());
+}
+
+TEST_CASE_METHOD(
+    StorageManagerFx,
+    "StorageManager: Test loading legacy fragment metadata",
+    "[storage_manager]") {
+  std::vector<int64_t> coords = {1, 1, 1, 2, 2, 1, 3, 3, 4, 4};
+  create_array("legacy", TILEDB_SPARSE, 2);
+  write_sparse("legacy", coords);
+
+  // Replace the fragment metadata file with that of the same fragment in the
+  // original, single-tile format (without a footer)
+  URI uri = fragment_uri("legacy");
+  std::ifstream in(
+      tiledb::posix::current_dir() +
+          "/inputs/legacy_sparse_fragment/__fragment_metadata.tdb",
+      std::ios::binary);
+  REQUIRE(in.good());
+  std::ofstream out(
+      uri.join_path("__fragment_metadata.tdb").to_path(),
+      std::ios::binary | std::ios::trunc);
+  out << in.rdbuf();
+  out.close();
+
+  // All the sections are loaded at once
+  ArrayMetadata array_metadata(URI(TEMP_DIR + "legacy"));
+  REQUIRE(storage_manager_.load(TEMP_DIR + "legacy", &array_metadata).ok());
+  FragmentMetadata metadata(&array_metadata, false, uri);
+  REQUIRE(storage_manager_.load(&metadata).ok());
+  CHECK(metadata.tile_num() == 3);
+  CHECK(metadata.last_tile_cell_num() == 1);
+  CHECK(metadata.mbrs().size() == 3);
+  CHECK(metadata.bounding_coords().size() == 3);
+  CHECK(metadata.tile_offsets()[0].size() == 3);
+  CHECK(metadata.tile_offsets()[1].size() == 3);
+  CHECK(metadata.rtree() != nullptr);
+
+  // The fragment is read correctly
+  Query* query = open_query("legacy", {1, 4, 1, 4});
+  REQUIRE(storage_manager_.query_submit(query).ok());
+  CHECK(buffer_sizes_[0] == 5 * sizeof(int));
+  CHECK(
+      std::vector<int>(buffer_a_.begin(), buffer_a_.begin() + 5) ==
+      std::vector<int>({0, 1, 4, 10, 15}));
+  close_query(query);
+}
+
+TEST_CASE_METHOD(
+    StorageManagerFx,
+    "StorageManager: Test pruning fragments outside the subarray",
+    "[storage_manager]") {
+  // Two fragments, in the upper and the lower half of the domain
+  create_array("sparse", TILEDB_SPARSE, 2);
+  write_sparse("sparse", {1, 1, 1, 2, 2, 1, 2, 2});
+  write_sparse("sparse", {3, 3, 3, 4, 4, 3, 4, 4});
+
+  // Only the fragment that overlaps the subarray is involved in the query, as
+  // the non-empty domain of a sparse fragment is the union of its MBRs
+  Query* upper = open_query("sparse", {1, 2, 1, 4});
+  REQUIRE(upper->fragment_metadata().size() == 1);
+  auto upper_metadata = upper->fragment_metadata()[0];
+  const int64_t upper_domain[] = {1, 2, 1, 2};
+  CHECK(
+      std::memcmp(
+          upper_metadata->non_empty_domain(),
+          upper_domain,
+          sizeof(upper_domain)) == 0);
+  REQUIRE(storage_manager_.query_submit(upper).ok());
+  CHECK(buffer_sizes_[0] == 4 * sizeof(int));
+  CHECK(
+      std::vector<int>(buffer_a_.begin(), buffer_a_.begin() + 4) ==
+      std::vector<int>({0, 1, 4, 5}));
+
+  Query* lower = open_query("sparse", {3, 4, 3, 3});
+  REQUIRE(lower->fragment_metadata().size() == 1);
+  auto lower_metadata = lower->fragment_metadata()[0];
+  CHECK(lower_metadata != upper_metadata);
+
+  // A query over both fragments reuses their cached metadata
+  Query* both = open_query("sparse", {2, 3, 1, 4});
+  CHECK(
+      both->fragment_metadata() ==
+      std::vector<FragmentMetadata*>({upper_metadata, lower_metadata}));
+
+  close_query(both);
+  close_query(lower);
+  close_query(upper);
+}
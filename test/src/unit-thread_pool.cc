@@ -0,0 +1,96 @@
+#include <catch.hpp>
+#include <thread_pool.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace tiledb;
+
+TEST_CASE("ThreadPool: Test parallel_for", "[threadpool]") {
+  ThreadPool pool;
+  REQUIRE(pool.set_thread_num(4).ok());
+  CHECK(pool.thread_num() == 4);
+
+  // Every index is visited exactly once
+  std::vector<std::atomic<int>> visits(1000);
+  for (auto& v : visits)
+    v = 0;
+  CHECK(pool.parallel_for(visits.size(), [&](uint64_t i) {
+                ++visits[i];
+                return Status::Ok();
+              })
+            .ok());
+  for (auto& v : visits)
+    CHECK(v == 1);
+
+  // Errors are propagated
+  CHECK(!pool.parallel_for(100, [](uint64_t i) {
+               return (i == 42) ? Status::Error("Task failed") : Status::Ok();
+             })
+             .ok());
+
+  // Nested loops do not exhaust the pool
+  std::atomic<uint64_t> sum(0);
+  CHECK(pool.parallel_for(16, [&](uint64_t) {
+                return pool.parallel_for(16, [&](uint64_t j) {
+                  sum += j;
+                  return Status::Ok();
+                });
+              })
+            .ok());
+  CHECK(sum == 16 * 120);
+}
+
+TEST_CASE("ThreadPool: Test enqueue and resize", "[threadpool]") {
+  ThreadPool pool;
+  CHECK(!pool.enqueue([]() {}).ok());
+
+  std::atomic<int> done(0);
+  REQUIRE(pool.set_thread_num(2).ok());
+  for (int i = 0; i < 100; ++i)
+    REQUIRE(pool.enqueue([&]() { ++done; }).ok());
+  REQUIRE(pool.set_thread_num(1).ok());
+  CHECK(pool.thread_num() == 1);
+  while (done < 100)
+    std::this_thread::yield();
+  CHECK(done == 100);
+
+  REQUIRE(pool.set_thread_num(0).ok());
+  CHECK(pool.thread_num() > 0);
+}
+
+TEST_CASE("ThreadPool: Test executing a queued task", "[threadpool]") {
+  ThreadPool pool;
+  REQUIRE(pool.set_thread_num(1).ok());
+
+  // Keep the only thread busy, so that the tasks below stay queued
+  std::mutex mtx;
+  std::unique_lock<std::mutex> lock(mtx);
+  std::atomic<bool> started(false);
+  REQUIRE(pool.enqueue([&]() {
+                started = true;
+                std::lock_guard<std::mutex> blocked(mtx);
+              })
+              .ok());
+  while (!started)
+    std::this_thread::yield();
+
+  // Only the claimed task is executed by the calling thread
+  std::atomic<int> first(0), second(0);
+  uint64_t first_id, second_id;
+  REQUIRE(pool.enqueue([&]() { ++first; }, &first_id).ok());
+  REQUIRE(pool.enqueue([&]() { ++second; }, &second_id).ok());
+  CHECK(first_id != second_id);
+  CHECK(pool.execute(second_id));
+  CHECK(second == 1);
+  CHECK(first == 0);
+  CHECK(!pool.execute(second_id));
+
+  // The other task is left to the pool
+  lock.unlock();
+  while (first == 0)
+    std::this_thread::yield();
+  CHECK(!pool.execute(first_id));
+}
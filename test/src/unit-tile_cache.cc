@@ -0,0 +1,101 @@
+#include <catch.hpp>
+#include <constants.h>
+#include <tile_cache.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace tiledb;
+
+TEST_CASE("TileCache: Test pinning and eviction", "[tile_cache]") {
+  TileCache tile_cache;
+  URI fragment_uri("/tile_cache_test/array/__fragment");
+  std::vector<char> data(100);
+  for (uint64_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i);
+
+  // A cached tile is served from the cache
+  std::string key = TileCache::key(fragment_uri, 0, 0, false);
+  CHECK(tile_cache.pin(key) == nullptr);
+  CHECK(tile_cache.insert(key, &data[0], data.size()).ok());
+  auto entry = tile_cache.pin(key);
+  REQUIRE(entry != nullptr);
+  CHECK(entry->size_ == data.size());
+  CHECK(std::memcmp(entry->data_, &data[0], data.size()) == 0);
+  CHECK(tile_cache.pin(TileCache::key(fragment_uri, 0, 0, true)) == nullptr);
+  CHECK(tile_cache.pin(TileCache::key(fragment_uri, 1, 0, false)) == nullptr);
+
+  // The cache stays within its budget, but keeps the pinned tile
+  tile_cache.set_budget(10 * constants::tile_cache_shard_num * data.size());
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    std::string key_i = TileCache::key(fragment_uri, 0, i, false);
+    CHECK(tile_cache.insert(key_i, &data[0], data.size()).ok());
+    auto entry_i = tile_cache.pin(key_i);
+    REQUIRE(entry_i != nullptr);
+    tile_cache.unpin(entry_i);
+    CHECK(tile_cache.size() <= tile_cache.budget());
+  }
+  auto entry_again = tile_cache.pin(key);
+  CHECK(entry_again == entry);
+  tile_cache.unpin(entry_again);
+  tile_cache.unpin(entry);
+
+  // A zero budget disables the cache
+  tile_cache.set_budget(0);
+  CHECK(tile_cache.size() == 0);
+  CHECK(tile_cache.insert(key, &data[0], data.size()).ok());
+  CHECK(tile_cache.pin(key) == nullptr);
+}
+
+TEST_CASE("TileCache: Test invalidation", "[tile_cache]") {
+  TileCache tile_cache;
+  URI array_uri("/tile_cache_test/array");
+  URI other_array_uri("/tile_cache_test/array_2");
+  std::vector<char> data(100, 'a');
+
+  std::string key =
+      TileCache::key(array_uri.join_path("__fragment"), 0, 0, false);
+  std::string other_key =
+      TileCache::key(other_array_uri.join_path("__fragment"), 0, 0, false);
+  CHECK(tile_cache.insert(key, &data[0], data.size()).ok());
+  CHECK(tile_cache.insert(other_key, &data[0], data.size()).ok());
+
+  // A pinned tile remains readable after it is invalidated
+  auto entry = tile_cache.pin(key);
+  REQUIRE(entry != nullptr);
+  tile_cache.invalidate(array_uri);
+  CHECK(tile_cache.pin(key) == nullptr);
+  CHECK(std::memcmp(entry->data_, &data[0], data.size()) == 0);
+  tile_cache.unpin(entry);
+
+  // The tiles of other arrays are not affected
+  auto other_entry = tile_cache.pin(other_key);
+  REQUIRE(other_entry != nullptr);
+  tile_cache.unpin(other_entry);
+  CHECK(tile_cache.size() == data.size());
+}
+
+TEST_CASE("TileCache: Test budget requests", "[tile_cache]") {
+  TileCache tile_cache;
+  int owners[3];
+
+  // The largest requested budget wins, regardless of the request order
+  tile_cache.request_budget(&owners[0], 1000);
+  CHECK(tile_cache.budget() == 1000);
+  tile_cache.request_budget(&owners[1], 5000);
+  CHECK(tile_cache.budget() == 5000);
+  tile_cache.request_budget(&owners[2], 0);
+  CHECK(tile_cache.budget() == 5000);
+
+  // A new request replaces the previous request of the same owner
+  tile_cache.request_budget(&owners[1], 2000);
+  CHECK(tile_cache.budget() == 2000);
+
+  // Withdrawn requests no longer count
+  tile_cache.release_budget(&owners[1]);
+  CHECK(tile_cache.budget() == 1000);
+  tile_cache.release_budget(&owners[0]);
+  CHECK(tile_cache.budget() == 0);
+  tile_cache.release_budget(&owners[2]);
+  CHECK(tile_cache.budget() == constants::tile_cache_size);
+}
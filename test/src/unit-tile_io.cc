@@ -0,0 +1,368 @@
+#include <catch.hpp>
+#include <const_buffer.h>
+#include <constants.h>
+#include <posix_filesystem.h>
+#include <storage_manager.h>
+#include <tile.h>
+#include <tile_io.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace tiledb;
+
+/**
+ * Writes tiles to a test file through a storage manager, which is removed
+ * before and after each test.
+ */
+struct TileIOFx {
+  // The test file
+  const std::string FILENAME = posix::current_dir() + "/tile_io_test.tdb";
+
+  // Storage manager of the tile I/O objects
+  StorageManager storage_manager_;
+
+  TileIOFx() {
+    unlink(FILENAME.c_str());
+    REQUIRE(storage_manager_.init().ok());
+  }
+
+  ~TileIOFx() {
+    unlink(FILENAME.c_str());
+  }
+
+  /** Returns the contents of the test file. */
+  std::vector<char> file_contents() const {
+    std::ifstream file(FILENAME, std::ios::binary);
+    return std::vector<char>(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+  }
+
+  /** Returns the size of the test file, or 0 if it does not exist. */
+  uint64_t file_size() const {
+    struct stat st;
+    return (stat(FILENAME.c_str(), &st) == 0) ? st.st_size : 0;
+  }
+
+  /**
+   * Writes a tile with the input data.
+   *
+   * @param tile_io The tile I/O to write the tile with.
+   * @param type The tile type.
+   * @param compressor The tile compressor.
+   * @param data The tile data.
+   * @param tile_size The tile size.
+   * @param filters The filters of the tile.
+   * @return The number of bytes written.
+   */
+  uint64_t write_tile(
+      TileIO* tile_io,
+      Datatype type,
+      Compressor compressor,
+      const void* data,
+      uint64_t tile_size,
+      const std::vector<Filter>& filters = {}) {
+    Tile tile(type, compressor, -1, tile_size, datatype_size(type), 0);
+    tile.set_filters(filters);
+    ConstBuffer buff(data, tile_size);
+    REQUIRE(tile.write(&buff).ok());
+    uint64_t bytes_written;
+    REQUIRE(tile_io->write(&tile, &bytes_written).ok());
+    return bytes_written;
+  }
+};
+
+TEST_CASE_METHOD(TileIOFx, "TileIO: Test direct I/O writes", "[tile_io]") {
+  // Write tiles that span more than one staging buffer
+  const uint64_t tile_num = 3;
+  const uint64_t tile_size = 3 * 1024 * 1024 + 7;
+  std::vector<char> data(tile_num * tile_size);
+  for (uint64_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i % 251);
+
+  auto tile_io = new TileIO(&storage_manager_, URI(FILENAME));
+  CHECK(tile_io->set_direct_write().ok());
+  for (uint64_t i = 0; i < tile_num; ++i) {
+    uint64_t bytes_written = write_tile(
+        tile_io,
+        Datatype::CHAR,
+        Compressor::NO_COMPRESSION,
+        &data[i * tile_size],
+        tile_size);
+    CHECK(bytes_written == tile_size);
+  }
+  CHECK(tile_io->flush().ok());
+  delete tile_io;
+
+  // The file holds exactly the tile data, without the alignment padding
+  CHECK(file_size() == data.size());
+  CHECK(file_contents() == data);
+}
+
+TEST_CASE_METHOD(TileIOFx, "TileIO: Test write-behind buffering", "[tile_io]") {
+  // Write many small tiles, followed by one larger than the buffer
+  const uint64_t tile_num = 2000;
+  const uint64_t tile_size = 3001;
+  const uint64_t large_tile_size = 5 * 1024 * 1024;
+  std::vector<char> data(tile_num * tile_size + large_tile_size);
+  for (uint64_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i % 251);
+
+  auto tile_io = new TileIO(&storage_manager_, URI(FILENAME));
+  uint64_t buffer_size = constants::tile_write_buffer_size;
+  SECTION("- default buffer size") {
+  }
+  SECTION("- bounded buffer size") {
+    buffer_size = 10 * tile_size + 5;
+    tile_io->set_write_buffer_size(buffer_size);
+  }
+
+  // The data not yet in the file never exceed the buffer size
+  uint64_t total_written = 0;
+  for (uint64_t i = 0; i <= tile_num; ++i) {
+    uint64_t size = (i < tile_num) ? tile_size : large_tile_size;
+    uint64_t bytes_written = write_tile(
+        tile_io,
+        Datatype::CHAR,
+        Compressor::NO_COMPRESSION,
+        &data[i * tile_size],
+        size);
+    CHECK(bytes_written == size);
+    total_written += bytes_written;
+    CHECK(total_written - file_size() <= buffer_size);
+  }
+  CHECK(tile_io->flush().ok());
+  delete tile_io;
+
+  CHECK(file_contents() == data);
+}
+
+TEST_CASE_METHOD(TileIOFx, "TileIO: Test filtered tiles", "[tile_io]") {
+  // Slowly growing values, in a tile that spans more than one chunk
+  const uint64_t value_num = 300000;
+  const uint64_t tile_size = value_num * sizeof(int64_t);
+  std::vector<int64_t> data(value_num);
+  for (uint64_t i = 0; i < value_num; ++i)
+    data[i] = (int64_t)(1000000 + i * 5 + i % 3);
+
+  // Write the values without and with filters
+  std::vector<Filter> filters = {Filter::DELTA, Filter::BITSHUFFLE};
+  uint64_t bytes_written[2];
+  auto tile_io = new TileIO(&storage_manager_, URI(FILENAME));
+  for (int i = 0; i < 2; ++i) {
+    bytes_written[i] = write_tile(
+        tile_io,
+        Datatype::INT64,
+        Compressor::GZIP,
+        data.data(),
+        tile_size,
+        (i == 1) ? filters : std::vector<Filter>());
+  }
+  CHECK(tile_io->flush().ok());
+  CHECK(bytes_written[1] < bytes_written[0]);
+
+  // Read the filtered tile back
+  Tile tile(Datatype::INT64, Compressor::GZIP, -1, tile_size, 8, 0);
+  tile.set_filters(filters);
+  REQUIRE(tile_io->read(&tile, bytes_written[0], bytes_written[1], tile_size)
+              .ok());
+  std::vector<int64_t> result(value_num);
+  REQUIRE(tile.read(result.data(), tile_size).ok());
+  CHECK(result == data);
+  delete tile_io;
+}
+
+TEST_CASE_METHOD(TileIOFx, "TileIO: Test chunked compression", "[tile_io]") {
+  // A chunk size that is not a multiple of the cell size
+  Config config;
+  config.set_tile_chunk_size(1001);
+  REQUIRE(storage_manager_.set_config(&config).ok());
+
+  // Runs of increasing values, in a tile whose last chunk is partial
+  const uint64_t value_num = 10001;
+  const uint64_t tile_size = value_num * sizeof(int64_t);
+  std::vector<int64_t> data(value_num);
+  for (uint64_t i = 0; i < value_num; ++i)
+    data[i] = (int64_t)(i / 7 * 3);
+
+  // Write a tile with each compressor
+  Compressor compressors[] = {Compressor::GZIP,
+                              Compressor::BZIP2,
+                              Compressor::RLE,
+                              Compressor::DOUBLE_DELTA};
+  std::vector<uint64_t> tile_offsets;
+  uint64_t file_offset = 0;
+  auto tile_io = new TileIO(&storage_manager_, URI(FILENAME));
+  for (auto compressor : compressors) {
+    tile_offsets.push_back(file_offset);
+    file_offset += write_tile(
+        tile_io, Datatype::INT64, compressor, data.data(), tile_size);
+  }
+  tile_offsets.push_back(file_offset);
+  CHECK(tile_io->flush().ok());
+
+  // Every tile is split into chunks of 125 cells, and is read back intact
+  std::ifstream file(FILENAME, std::ios::binary);
+  for (int i = 0; i < 4; ++i) {
+    uint64_t chunk_num;
+    file.seekg(tile_offsets[i]);
+    file.read(reinterpret_cast<char*>(&chunk_num), sizeof(chunk_num));
+    CHECK(chunk_num == 81);
+
+    Tile tile(Datatype::INT64, compressors[i], -1, tile_size, 8, 0);
+    uint64_t compressed_size = tile_offsets[i + 1] - tile_offsets[i];
+    REQUIRE(
+        tile_io->read(&tile, tile_offsets[i], compressed_size, tile_size)
+            .ok());
+    std::vector<int64_t> result(value_num);
+    REQUIRE(tile.read(result.data(), tile_size).ok());
+    CHECK(result == data);
+  }
+  delete tile_io;
+}
+
+TEST_CASE_METHOD(TileIOFx, "TileIO: Test mapped reads", "[tile_io]") {
+  // Reading with mmap is opt-in
+  Config config;
+  CHECK(config.read_method() == IOMethod::READ);
+  config.set_read_method(IOMethod::MMAP);
+  REQUIRE(storage_manager_.set_config(&config).ok());
+
+  // Write an uncompressed and a compressed tile
+  const uint64_t tile_size = 100000;
+  std::vector<char> data(2 * tile_size);
+  for (uint64_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i % 251);
+  Compressor compressors[] = {Compressor::NO_COMPRESSION, Compressor::GZIP};
+  std::vector<uint64_t> tile_offsets;
+  uint64_t file_offset = 0;
+  auto tile_io = new TileIO(&storage_manager_, URI(FILENAME));
+  for (int i = 0; i < 2; ++i) {
+    tile_offsets.push_back(file_offset);
+    file_offset += write_tile(
+        tile_io,
+        Datatype::CHAR,
+        compressors[i],
+        &data[i * tile_size],
+        tile_size);
+  }
+  CHECK(tile_io->flush().ok());
+  delete tile_io;
+
+  // Read the tiles back from the mapped file: the uncompressed tile aliases
+  // the mapped data, whereas the compressed one is decompressed from them
+  void* mapped_data;
+  uint64_t mapped_size;
+  REQUIRE(
+      storage_manager_.map_file(URI(FILENAME), &mapped_data, &mapped_size)
+          .ok());
+  CHECK(mapped_size == file_offset);
+  tile_io = new TileIO(&storage_manager_, URI(FILENAME));
+  tile_io->set_mapped_file(mapped_data, mapped_size);
+  std::vector<uint64_t> tile_plan = {0, 1};
+  for (uint64_t i = 0; i < 2; ++i) {
+    Tile tile(Datatype::CHAR, compressors[i], -1, tile_size, 1, 0);
+    REQUIRE(tile_io->read(&tile, i, tile_offsets, tile_plan, tile_size).ok());
+    CHECK(tile.aliased() == (compressors[i] == Compressor::NO_COMPRESSION));
+    std::vector<char> result(tile_size);
+    REQUIRE(tile.read(result.data(), tile_size).ok());
+    CHECK(std::memcmp(result.data(), &data[i * tile_size], tile_size) == 0);
+  }
+  delete tile_io;
+  CHECK(storage_manager_.unmap_file(mapped_data, mapped_size).ok());
+}
+
+TEST_CASE_METHOD(TileIOFx, "TileIO: Test coalesced reads", "[tile_io]") {
+  // Write uncompressed tiles, one after the other
+  const uint64_t tile_num = 40;
+  const uint64_t tile_size = 1000;
+  std::vector<char> data(tile_num * tile_size);
+  for (uint64_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i % 251);
+  std::vector<uint64_t> tile_offsets;
+  auto tile_io = new TileIO(&storage_manager_, URI(FILENAME));
+  for (uint64_t i = 0; i < tile_num; ++i) {
+    write_tile(
+        tile_io,
+        Datatype::CHAR,
+        Compressor::NO_COMPRESSION,
+        &data[i * tile_size],
+        tile_size);
+    tile_offsets.push_back(i * tile_size);
+  }
+  CHECK(tile_io->flush().ok());
+  delete tile_io;
+
+  // Overwrites the file behind the back of the storage manager, so that the
+  // tiles that were fetched already can be told apart from those read anew
+  auto overwrite_file = [&]() {
+    std::vector<char> new_data(data.size(), 'x');
+    FILE* file = fopen(FILENAME.c_str(), "r+");
+    REQUIRE(file != nullptr);
+    REQUIRE(fwrite(new_data.data(), 1, new_data.size(), file) == data.size());
+    fclose(file);
+  };
+
+  // Reads a tile and returns *true* if it holds the original data
+  auto read_original = [&](TileIO* tile_io,
+                           uint64_t tile_i,
+                           const std::vector<uint64_t>& tile_plan) {
+    Tile tile(Datatype::CHAR, Compressor::NO_COMPRESSION, 0, tile_size, 1, 0);
+    REQUIRE(
+        tile_io->read(&tile, tile_i, tile_offsets, tile_plan, tile_size).ok());
+    std::vector<char> result(tile_size);
+    REQUIRE(tile.read(result.data(), tile_size).ok());
+    return std::memcmp(
+               result.data(), &data[tile_i * tile_size], tile_size) == 0;
+  };
+
+  Config config;
+  tile_io = new TileIO(&storage_manager_, URI(FILENAME));
+
+  SECTION("- default gap") {
+    // The first read fetches the planned tiles along with the tiles in the
+    // small gaps between them
+    std::vector<uint64_t> tile_plan = {0, 1, 3};
+    CHECK(read_original(tile_io, 0, tile_plan));
+    overwrite_file();
+    CHECK(read_original(tile_io, 1, tile_plan));
+    CHECK(read_original(tile_io, 2, tile_plan));
+    CHECK(read_original(tile_io, 3, tile_plan));
+    CHECK(!read_original(tile_io, 4, tile_plan));
+  }
+
+  SECTION("- zero gap") {
+    // Only adjacent tiles are fetched as one region, so the tile in the gap
+    // is read anew
+    config.set_tile_coalesce_gap_size(0);
+    REQUIRE(storage_manager_.set_config(&config).ok());
+    std::vector<uint64_t> tile_plan = {0, 1, 3};
+    CHECK(read_original(tile_io, 0, tile_plan));
+    overwrite_file();
+    CHECK(read_original(tile_io, 1, tile_plan));
+    CHECK(read_original(tile_io, 3, tile_plan));
+    CHECK(!read_original(tile_io, 2, tile_plan));
+  }
+
+  SECTION("- region limit") {
+    // Each planned tile is a separate region, and only so many regions are
+    // fetched at once
+    config.set_tile_coalesce_gap_size(0);
+    REQUIRE(storage_manager_.set_config(&config).ok());
+    std::vector<uint64_t> tile_plan;
+    for (uint64_t i = 0; i < tile_num; i += 2)
+      tile_plan.push_back(i);
+    CHECK(read_original(tile_io, 0, tile_plan));
+    overwrite_file();
+    uint64_t last = 2 * (constants::tile_coalesce_region_num - 1);
+    CHECK(read_original(tile_io, last, tile_plan));
+    CHECK(!read_original(tile_io, last + 2, tile_plan));
+  }
+
+  delete tile_io;
+}
@@ -0,0 +1,203 @@
+#include <catch.hpp>
+#include <constants.h>
+#include <posix_filesystem.h>
+#include <thread_pool.h>
+#include <vfs.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <climits>
+#include <cstring>
+
+using namespace tiledb;
+
+TEST_CASE("VFS: Test batched reads", "[vfs]") {
+  char cwd[PATH_MAX];
+  REQUIRE(getcwd(cwd, PATH_MAX) != nullptr);
+  std::string filename = std::string(cwd) + "/vfs_read_batch_test.tdb";
+
+  const uint64_t file_size = 100000;
+  std::vector<char> data(file_size);
+  for (uint64_t i = 0; i < file_size; ++i)
+    data[i] = static_cast<char>(i % 251);
+  int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU);
+  REQUIRE(fd != -1);
+  REQUIRE(write(fd, &data[0], file_size) == int64_t(file_size));
+  close(fd);
+
+  VFS vfs;
+  URI uri(filename);
+  std::vector<char> result(file_size + 100, 0);
+  std::vector<VFS::ReadRegion> regions;
+  auto add_region = [&](uint64_t offset, uint64_t nbytes) {
+    VFS::ReadRegion region;
+    region.offset_ = offset;
+    region.nbytes_ = nbytes;
+    region.buffer_ = &result[offset];
+    regions.push_back(region);
+  };
+
+  SECTION("- unsorted and zero-length regions") {
+    // Two runs of adjacent regions in reverse order, a separate region and
+    // empty regions, one of which lies beyond the end of the file
+    add_region(5000, 100);
+    add_region(200, 50);
+    add_region(100, 100);
+    add_region(20000, 0);
+    add_region(0, 100);
+    add_region(4900, 100);
+    add_region(file_size + 10, 0);
+    REQUIRE(vfs.read_batch(uri, regions).ok());
+    CHECK(std::memcmp(&result[0], &data[0], 250) == 0);
+    CHECK(std::memcmp(&result[4900], &data[4900], 200) == 0);
+    CHECK(result[250] == 0);
+    CHECK(result[4899] == 0);
+    CHECK(result[5100] == 0);
+  }
+
+  SECTION("- more regions than IOV_MAX") {
+    // A single run of adjacent regions, along with every other region of
+    // another run, in shuffled order
+    const uint64_t region_num = IOV_MAX + 100, region_size = 8;
+    for (uint64_t i = 0; i < region_num; ++i)
+      add_region(((i * 7) % region_num) * region_size, region_size);
+    for (uint64_t i = 0; i < region_num; i += 2)
+      add_region(50000 + i * region_size, region_size);
+    REQUIRE(vfs.read_batch(uri, regions).ok());
+    CHECK(std::memcmp(&result[0], &data[0], region_num * region_size) == 0);
+    for (uint64_t i = 0; i < region_num; ++i) {
+      uint64_t offset = 50000 + i * region_size;
+      if (i % 2 == 0)
+        CHECK(std::memcmp(&result[offset], &data[offset], region_size) == 0);
+      else
+        CHECK(result[offset] == 0);
+    }
+  }
+
+  SECTION("- short read at the end of the file") {
+    // The part of the region that lies in the file is read, but the read
+    // fails as the rest cannot be read
+    add_region(0, 100);
+    add_region(file_size - 100, 200);
+    CHECK(!vfs.read_batch(uri, regions).ok());
+    uint64_t offset = file_size - 100;
+    CHECK(std::memcmp(&result[offset], &data[offset], 100) == 0);
+
+    // The descriptor is released, so the file can still be read
+    regions.back().nbytes_ = 100;
+    CHECK(vfs.read_batch(uri, regions).ok());
+  }
+
+  unlink(filename.c_str());
+}
+
+TEST_CASE("VFS: Test POSIX vectored reads", "[vfs]") {
+  char cwd[PATH_MAX];
+  REQUIRE(getcwd(cwd, PATH_MAX) != nullptr);
+  std::string filename = std::string(cwd) + "/vfs_preadv_test.tdb";
+
+  const uint64_t file_size = 3 * IOV_MAX;
+  std::vector<char> data(file_size);
+  for (uint64_t i = 0; i < file_size; ++i)
+    data[i] = static_cast<char>(i % 251);
+  int fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+  REQUIRE(fd != -1);
+  REQUIRE(write(fd, &data[0], file_size) == int64_t(file_size));
+
+  // Scatter the file, but its first byte, into more buffers than IOV_MAX,
+  // some of which are empty
+  std::vector<char> result(file_size, 0);
+  std::vector<iovec> iov;
+  uint64_t offset = 1;
+  while (offset < file_size) {
+    iovec v;
+    v.iov_base = &result[offset];
+    v.iov_len = std::min<uint64_t>(2, file_size - offset);
+    if (iov.size() % 3 == 0)
+      v.iov_len = 0;
+    iov.push_back(v);
+    offset += v.iov_len;
+  }
+  REQUIRE(iov.size() > (size_t)IOV_MAX);
+  CHECK(posix::read_from_file(fd, 1, iov).ok());
+  CHECK(result[0] == 0);
+  CHECK(std::memcmp(&result[1], &data[1], file_size - 1) == 0);
+
+  // A read past the end of the file fails
+  iovec v;
+  v.iov_base = &result[0];
+  v.iov_len = 100;
+  CHECK(!posix::read_from_file(fd, file_size - 50, {v}).ok());
+  CHECK(std::memcmp(&result[0], &data[file_size - 50], 50) == 0);
+
+  close(fd);
+  unlink(filename.c_str());
+}
+
+/** Returns the number of file descriptors open by the process. */
+static int open_fd_num() {
+  int num = 0;
+  DIR* dir = opendir("/proc/self/fd");
+  REQUIRE(dir != nullptr);
+  while (readdir(dir) != nullptr)
+    ++num;
+  closedir(dir);
+  return num;
+}
+
+TEST_CASE("VFS: Test batched syncs", "[vfs]") {
+  char cwd[PATH_MAX];
+  REQUIRE(getcwd(cwd, PATH_MAX) != nullptr);
+  URI existing(std::string(cwd) + "/vfs_sync_batch_test.tdb");
+  URI missing(std::string(cwd) + "/vfs_sync_batch_test_missing.tdb");
+  URI direct(std::string(cwd) + "/vfs_sync_batch_test_direct.tdb");
+  unlink(existing.to_path().c_str());
+  unlink(missing.to_path().c_str());
+  unlink(direct.to_path().c_str());
+
+  VFS vfs;
+  ThreadPool thread_pool;
+  REQUIRE(thread_pool.set_thread_num(2).ok());
+  int fd_num = open_fd_num();
+
+  // An existing file, and a file whose descriptor is held in the cache in
+  // DIRECT mode
+  std::vector<char> data(100, 'a');
+  REQUIRE(vfs.write_to_file(existing, &data[0], data.size()).ok());
+  void* aligned;
+  REQUIRE(
+      posix_memalign(
+          &aligned,
+          constants::direct_io_alignment,
+          constants::direct_io_alignment) == 0);
+  std::memset(aligned, 'b', constants::direct_io_alignment);
+  REQUIRE(vfs.write_to_file_direct(
+                 direct, 0, aligned, constants::direct_io_alignment)
+              .ok());
+  std::free(aligned);
+
+  SECTION("- existing, missing and cached files") {
+    // The missing file is ignored, rather than created
+    CHECK(vfs.sync_batch({existing, missing, direct}, &thread_pool).ok());
+    CHECK(!posix::is_file(missing.to_path()));
+    uint64_t size;
+    CHECK(vfs.file_size(direct, &size).ok());
+    CHECK(size == constants::direct_io_alignment);
+  }
+
+  SECTION("- error after acquiring descriptors") {
+    URI unsupported("s3://bucket/vfs_sync_batch_test.tdb");
+    CHECK(!vfs.sync_batch({existing, direct, unsupported}, &thread_pool).ok());
+  }
+
+  // Every acquired descriptor was released, therefore dropping the cached
+  // descriptors of the files closes them all
+  CHECK(vfs.sync(existing).ok());
+  CHECK(vfs.sync(direct).ok());
+  CHECK(open_fd_num() == fd_num);
+
+  unlink(existing.to_path().c_str());
+  unlink(direct.to_path().c_str());
+}